@@ -2,6 +2,10 @@
 
 #include "models.hpp"
 #include "baseModule.hpp"
+#include "ticketModule.hpp"
+#include "paymentModule.hpp"
+#include "feedbackModule.hpp"
+#include "concertModule.hpp"
 #include <iostream>
 #include <fstream>
 #include <memory>
@@ -10,6 +14,7 @@
 #include <stdexcept>
 #include <string>
 #include <sstream>
+#include <unordered_map>
 
 /**
  * @brief Module for managing Attendee entities
@@ -19,8 +24,31 @@
  * and attendee-specific search capabilities.
  */
 class AttendeeModule : public BaseModule<Model::Attendee> {
+private:
+    // Attendee ID -> attendee for O(1) profile lookups
+    std::unordered_map<int, std::shared_ptr<Model::Attendee>> attendeeById;
 
 public:
+    /**
+     * @brief Ticket line of the attendee overview, resolved to its concert
+     */
+    struct TicketLine {
+        std::shared_ptr<Model::Ticket> ticket;
+        int concert_id;
+        std::string concert_name;
+    };
+
+    /**
+     * @brief Joined support view of one attendee
+     */
+    struct AttendeeOverview {
+        std::shared_ptr<Model::Attendee> profile;
+        std::vector<TicketLine> tickets;
+        std::vector<std::shared_ptr<Model::Payment>> payments;  // Charges
+        std::vector<std::shared_ptr<Model::Payment>> refunds;   // Refund records (negative amounts)
+        std::vector<std::shared_ptr<Model::Feedback>> feedbacks;
+    };
+
     /**
      * @brief Constructor
      * Initializes the module and loads existing attendees
@@ -72,6 +100,7 @@ public:
         
         // Add to the collection
         entities.push_back(attendee);
+        attendeeById[newId] = attendee;
         
         // Save to file
         saveEntities();
@@ -88,6 +117,74 @@ public:
         return getById(id);
     }
 
+    /**
+     * @brief Get an attendee by ID from the ID index
+     * @param id Attendee ID to find
+     * @return std::shared_ptr<Model::Attendee> Pointer to attendee or nullptr
+     */
+    std::shared_ptr<Model::Attendee> getById(int id) override {
+        auto it = attendeeById.find(id);
+        if (it == attendeeById.end()) {
+            std::cerr << "Entity with ID " << id << " not found." << std::endl;
+            return nullptr;
+        }
+        return it->second;
+    }
+
+    /**
+     * @brief Assemble the attendee's profile, tickets, payments, refunds and feedback
+     *
+     * Every part is served from the per-attendee indexes of the other modules,
+     * so the cost depends on the attendee's own history, not on table sizes.
+     *
+     * @param id Attendee ID
+     * @param tickets Ticket module to read owned tickets from
+     * @param payments Payment module to read charges and refunds from
+     * @param feedback Feedback module to read submitted feedback from
+     * @param concerts Optional concert module used to resolve concert names
+     * @return AttendeeOverview with a null profile if the attendee doesn't exist
+     */
+    AttendeeOverview getAttendeeOverview(int id,
+                                         TicketManager::TicketModule& tickets,
+                                         PaymentManager::PaymentModule& payments,
+                                         FeedbackModule& feedback,
+                                         ConcertModule* concerts = nullptr) {
+        AttendeeOverview overview;
+        auto it = attendeeById.find(id);
+        if (it == attendeeById.end()) {
+            return overview;
+        }
+        overview.profile = it->second;
+        
+        // Resolve each distinct concert once
+        std::unordered_map<int, std::string> concertNames;
+        for (const auto& ticket : tickets.getTicketsByAttendee(id)) {
+            TicketLine line{ticket, TicketManager::TicketModule::extractConcertId(ticket->qr_code), ""};
+            auto name = concertNames.find(line.concert_id);
+            if (name == concertNames.end()) {
+                std::string resolved = "Concert #" + std::to_string(line.concert_id);
+                if (concerts && line.concert_id > 0) {
+                    auto concert = concerts->getConcertById(line.concert_id);
+                    if (concert) resolved = concert->name;
+                }
+                name = concertNames.emplace(line.concert_id, resolved).first;
+            }
+            line.concert_name = name->second;
+            overview.tickets.push_back(line);
+        }
+        
+        for (const auto& payment : payments.getPaymentsByAttendee(id)) {
+            if (payment->amount.minor < 0) {
+                overview.refunds.push_back(payment);
+            } else {
+                overview.payments.push_back(payment);
+            }
+        }
+        
+        overview.feedbacks = feedback.getFeedbackByAttendee(id);
+        return overview;
+    }
+
     /**
      * @brief Get all attendees
      * @return const std::vector<std::shared_ptr<Model::Attendee>>& Reference to attendee vector
@@ -183,6 +280,16 @@ public:
         return deleteEntity(id);
     }
 
+    /**
+     * @brief Delete an attendee and drop it from the ID index
+     * @param id Attendee ID to delete
+     * @return true if deletion successful
+     */
+    bool deleteEntity(int id) override {
+        attendeeById.erase(id);
+        return BaseModule<Model::Attendee>::deleteEntity(id);
+    }
+
 protected:
     /**
      * @brief Get the ID of an attendee
@@ -201,6 +308,7 @@ protected:
      */
     void loadEntities() override {
         entities.clear();
+        attendeeById.clear();
         std::ifstream file(dataFilePath, std::ios::binary);
         
         if (!file.is_open()) {
@@ -237,6 +345,7 @@ protected:
             );
             
             entities.push_back(attendee);
+            attendeeById[id] = attendee;
         }
         
         file.close();
@@ -11,7 +11,214 @@
 #include <random>
 #include <functional>
 #include <unordered_map>
+#include <set>
+#include <cstdint>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <queue>
+#include <chrono>
+#include <cstdio>
+#include <cmath>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
 #include "models.hpp"
+#include "workerPool.hpp"
+
+/**
+ * @brief In-tree primitives for password key derivation
+ *
+ * SHA-256 (FIPS 180-4), HMAC-SHA256 (RFC 2104) and PBKDF2-HMAC-SHA256 (RFC 8018).
+ * The iteration count is the tunable cost of the KDF.
+ */
+namespace AuthCrypto {
+
+    class Sha256 {
+    public:
+        static constexpr size_t DIGEST_SIZE = 32;
+        static constexpr size_t BLOCK_SIZE = 64;
+
+        Sha256() { reset(); }
+
+        void reset() {
+            static const uint32_t initial[8] = {
+                0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+            };
+            std::memcpy(state, initial, sizeof(state));
+            totalLength = 0;
+            bufferLength = 0;
+        }
+
+        void update(const unsigned char* data, size_t length) {
+            totalLength += length;
+            if (bufferLength > 0) {
+                size_t take = std::min(length, BLOCK_SIZE - bufferLength);
+                std::memcpy(buffer + bufferLength, data, take);
+                bufferLength += take;
+                data += take;
+                length -= take;
+                if (bufferLength == BLOCK_SIZE) {
+                    transform(buffer);
+                    bufferLength = 0;
+                }
+            }
+            while (length >= BLOCK_SIZE) {
+                transform(data);
+                data += BLOCK_SIZE;
+                length -= BLOCK_SIZE;
+            }
+            if (length > 0) {
+                std::memcpy(buffer, data, length);
+                bufferLength = length;
+            }
+        }
+
+        void finish(unsigned char* digest) {
+            uint64_t bitLength = totalLength * 8;
+            unsigned char pad = 0x80;
+            update(&pad, 1);
+            unsigned char zero = 0;
+            while (bufferLength != BLOCK_SIZE - 8) {
+                update(&zero, 1);
+            }
+            unsigned char lengthBytes[8];
+            for (int i = 0; i < 8; ++i) {
+                lengthBytes[i] = static_cast<unsigned char>(bitLength >> (56 - 8 * i));
+            }
+            update(lengthBytes, 8);
+            for (int i = 0; i < 8; ++i) {
+                digest[4 * i]     = static_cast<unsigned char>(state[i] >> 24);
+                digest[4 * i + 1] = static_cast<unsigned char>(state[i] >> 16);
+                digest[4 * i + 2] = static_cast<unsigned char>(state[i] >> 8);
+                digest[4 * i + 3] = static_cast<unsigned char>(state[i]);
+            }
+        }
+
+    private:
+        uint32_t state[8];
+        uint64_t totalLength;
+        unsigned char buffer[BLOCK_SIZE];
+        size_t bufferLength;
+
+        static uint32_t rotr(uint32_t x, int n) { return (x >> n) | (x << (32 - n)); }
+
+        void transform(const unsigned char* block) {
+            static const uint32_t k[64] = {
+                0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+                0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+                0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+                0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+                0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+                0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+                0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+                0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+            };
+            uint32_t w[64];
+            for (int i = 0; i < 16; ++i) {
+                w[i] = (uint32_t(block[4 * i]) << 24) | (uint32_t(block[4 * i + 1]) << 16) |
+                       (uint32_t(block[4 * i + 2]) << 8) | uint32_t(block[4 * i + 3]);
+            }
+            for (int i = 16; i < 64; ++i) {
+                uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+                uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+                w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+            }
+            uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+            uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+            for (int i = 0; i < 64; ++i) {
+                uint32_t t1 = h + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) + ((e & f) ^ (~e & g)) + k[i] + w[i];
+                uint32_t t2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+                h = g; g = f; f = e; e = d + t1;
+                d = c; c = b; b = a; a = t1 + t2;
+            }
+            state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+            state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+        }
+    };
+
+    /**
+     * @brief HMAC-SHA256 with the padded key absorbed once, so each MAC costs two compressions
+     */
+    class HmacSha256 {
+    public:
+        HmacSha256(const unsigned char* key, size_t keyLength) {
+            unsigned char block[Sha256::BLOCK_SIZE] = {0};
+            if (keyLength > Sha256::BLOCK_SIZE) {
+                Sha256 keyHash;
+                keyHash.update(key, keyLength);
+                keyHash.finish(block);
+            } else if (keyLength > 0) {
+                std::memcpy(block, key, keyLength);
+            }
+            unsigned char pad[Sha256::BLOCK_SIZE];
+            for (size_t i = 0; i < Sha256::BLOCK_SIZE; ++i) pad[i] = block[i] ^ 0x36;
+            inner.update(pad, Sha256::BLOCK_SIZE);
+            for (size_t i = 0; i < Sha256::BLOCK_SIZE; ++i) pad[i] = block[i] ^ 0x5c;
+            outer.update(pad, Sha256::BLOCK_SIZE);
+            std::memset(block, 0, sizeof(block));
+            std::memset(pad, 0, sizeof(pad));
+        }
+
+        void compute(const unsigned char* message, size_t length, unsigned char* mac) const {
+            Sha256 innerHash = inner;
+            innerHash.update(message, length);
+            unsigned char innerDigest[Sha256::DIGEST_SIZE];
+            innerHash.finish(innerDigest);
+            Sha256 outerHash = outer;
+            outerHash.update(innerDigest, Sha256::DIGEST_SIZE);
+            outerHash.finish(mac);
+        }
+
+    private:
+        Sha256 inner;
+        Sha256 outer;
+    };
+
+    /**
+     * @brief PBKDF2-HMAC-SHA256
+     * @param password Password bytes
+     * @param salt Salt bytes
+     * @param saltLength Length of salt
+     * @param iterations Cost parameter (must be >= 1)
+     * @param output Derived key buffer
+     * @param outputLength Bytes of key to derive
+     */
+    inline void pbkdf2Sha256(const std::string& password,
+                             const unsigned char* salt, size_t saltLength,
+                             uint32_t iterations,
+                             unsigned char* output, size_t outputLength) {
+        HmacSha256 prf(reinterpret_cast<const unsigned char*>(password.data()), password.size());
+        std::vector<unsigned char> firstBlock(saltLength + 4);
+        if (saltLength > 0) {
+            std::memcpy(firstBlock.data(), salt, saltLength);
+        }
+        unsigned char u[Sha256::DIGEST_SIZE];
+        unsigned char t[Sha256::DIGEST_SIZE];
+        for (uint32_t blockIndex = 1; outputLength > 0; ++blockIndex) {
+            firstBlock[saltLength]     = static_cast<unsigned char>(blockIndex >> 24);
+            firstBlock[saltLength + 1] = static_cast<unsigned char>(blockIndex >> 16);
+            firstBlock[saltLength + 2] = static_cast<unsigned char>(blockIndex >> 8);
+            firstBlock[saltLength + 3] = static_cast<unsigned char>(blockIndex);
+            prf.compute(firstBlock.data(), firstBlock.size(), u);
+            std::memcpy(t, u, sizeof(t));
+            for (uint32_t i = 1; i < iterations; ++i) {
+                prf.compute(u, sizeof(u), u);
+                for (size_t j = 0; j < sizeof(t); ++j) t[j] ^= u[j];
+            }
+            size_t take = std::min(outputLength, sizeof(t));
+            std::memcpy(output, t, take);
+            output += take;
+            outputLength -= take;
+        }
+        std::memset(u, 0, sizeof(u));
+        std::memset(t, 0, sizeof(t));
+    }
+}
 
 /**
  * @brief Module for handling authentication and authorization
@@ -21,10 +228,47 @@
  * It uses manual memory management with raw pointers for sensitive operations.
  */
 class AuthModule {
+public:
+    /**
+     * @brief Login throttling limits
+     *
+     * Each username has a token bucket (an attempt costs one token, a success
+     * refunds it) and consecutive failures trigger an exponentially growing
+     * lockout. A global bucket caps total verification work.
+     */
+    struct ThrottlePolicy {
+        bool enabled = true;
+        double globalBurst = 200.0;          // Attempts allowed back-to-back across all users
+        double globalRatePerSecond = 100.0;  // Sustained attempts per second across all users
+        double userBurst = 5.0;              // Attempts allowed back-to-back per username
+        double userRatePerSecond = 0.2;      // Sustained attempts per second per username
+        uint32_t lockoutThreshold = 5;       // Consecutive failures before lockout
+        double lockoutBaseSeconds = 1.0;     // First lockout; doubles with each further failure
+        double lockoutMaxSeconds = 900.0;    // Lockout cap
+    };
+    
+    /**
+     * @brief Throttle counters for the admin screen
+     */
+    struct ThrottleStats {
+        unsigned long long allowed = 0;          // Attempts let through to verification
+        unsigned long long rejectedGlobal = 0;   // Rejected by the global bucket
+        unsigned long long rejectedUser = 0;     // Rejected by a per-username bucket
+        unsigned long long rejectedLockout = 0;  // Rejected while a username was locked out
+        unsigned long long lockouts = 0;         // Lockouts started
+        unsigned long long evictions = 0;        // Table slots recycled under pressure
+        unsigned long long rejectedTableFull = 0; // Rejected because every candidate slot was locked out
+        size_t trackedUsernames = 0;             // Occupied slots in the fixed table
+        size_t tableSlots = 0;                   // Capacity of the fixed table
+    };
+
 private:
-    // Memory block for storing credential data
-    char* secureMemory = nullptr;
-    size_t memorySize = 0;
+    // Credential blocks live in fixed-size slabs. A block's logical offset is
+    // slabIndex * SLAB_BYTES + position, so growing never moves existing blocks.
+    std::vector<char*> slabs;
+    size_t memorySize = 0;          // Total slab capacity in bytes
+    size_t highWaterMark = 0;       // First offset never handed out
+    std::vector<size_t> freeBlocks; // Wiped blocks available for reuse
     
     // Encryption key (used for XOR operations)
     unsigned char* encryptionKey = nullptr;
@@ -33,16 +277,109 @@ private:
     // Authentication data file path
     std::string authDataFile;
     
-    // In-memory credential mapping (username -> offset in secureMemory)
+    // Incremental store: authDataFile holds a fixed header (magic, version, key)
+    // followed by each credential block at STORE_HEADER_BYTES + offset, and map
+    // changes are appended to authDataFile + ".journal". Only touched records are
+    // written; the journal is compacted once it is mostly superseded entries.
+    FILE* blockStore = nullptr;
+    FILE* mapJournal = nullptr;
+    bool storeAttached = false;
+    size_t journalRecords = 0;
+    
+    // In-memory credential mapping (username -> logical block offset)
     std::unordered_map<std::string, size_t> credentialMap;
     
+    // Role index: username -> user type plus sorted usernames overall and per
+    // role. Holds no hashes or salts; built from the blocks once at load and
+    // maintained on register, delete and role change, so listings never decrypt.
+    std::unordered_map<std::string, int> roleOfUser;
+    std::unordered_map<int, std::set<std::string>> usernamesByRole;
+    std::set<std::string> sortedUsernames;
+    
+    // Per-username throttle state in a fixed-size open-addressed table keyed by a
+    // seeded 64-bit hash of the username, so memory stays constant no matter how
+    // many usernames an attacker tries; full probe windows evict the stalest slot.
+    struct ThrottleSlot {
+        uint64_t key = 0;           // 0 = empty
+        double tokens = 0.0;
+        double lastRefill = 0.0;
+        double lastSeen = 0.0;
+        double lockedUntil = 0.0;
+        uint32_t failures = 0;
+    };
+    std::vector<ThrottleSlot> throttleTable;
+    uint64_t throttleSeed = 0;
+    double globalTokens = 0.0;
+    double globalLastRefill = -1.0;
+    ThrottlePolicy throttlePolicy;
+    ThrottleStats throttleStats;
+    mutable std::mutex throttleMutex;
+    
+    static constexpr size_t THROTTLE_TABLE_SLOTS = 4096; // power of two
+    static constexpr size_t THROTTLE_PROBE_LIMIT = 8;
+    
+    // Guards credential memory and map; recursive because public calls nest
+    // (e.g. changePassword -> authenticateUser). Never held during key derivation.
+    mutable std::recursive_mutex credentialMutex;
+    
+    // KDF cost (PBKDF2 iterations) applied to new and upgraded credentials
+    uint32_t kdfIterations = DEFAULT_KDF_ITERATIONS;
+    
+    // Lazily started pool for authenticateUserAsync
+    std::unique_ptr<WorkerPool> verificationPool;
+    
+    // Issued session, resolved by token without touching credential memory
+    struct SessionEntry {
+        std::string username;
+        int userType;
+        std::chrono::steady_clock::time_point expiresAt;
+    };
+    
+    // Session table (token -> session) and its expiry wheel. Each wheel slot holds
+    // the tokens expiring in that tick; a slot is swept when the clock passes it,
+    // so expiry costs O(expired) rather than a scan of every session.
+    std::unordered_map<std::string, SessionEntry> sessions;
+    std::vector<std::vector<std::string>> expiryWheel;
+    long long wheelTick = -1;
+    std::chrono::seconds sessionTimeout{DEFAULT_SESSION_TIMEOUT_SECONDS};
+    mutable std::mutex sessionMutex;
+    
+    static constexpr size_t SESSION_TOKEN_BYTES = 32;
+    static constexpr size_t EXPIRY_WHEEL_SLOTS = 256;
+    static constexpr long long EXPIRY_TICK_SECONDS = 10;
+    
     // Constants for memory layout
     static constexpr size_t CREDENTIAL_BLOCK_SIZE = 256;
     static constexpr size_t USERNAME_MAX_LENGTH = 64;
     static constexpr size_t PASSWORD_HASH_LENGTH = 64;
     static constexpr size_t SALT_LENGTH = 16;
     static constexpr size_t USER_TYPE_SIZE = 4;
+    static constexpr size_t KDF_COST_SIZE = 4;
+    static constexpr size_t SLAB_BLOCKS = 256;
+    static constexpr uint32_t STORE_MAGIC = 0x414F494D; // "MIOA"
+    static constexpr uint32_t STORE_VERSION = 2;
+    static constexpr size_t STORE_HEADER_BYTES = 512;
+    static constexpr size_t MAX_KEY_SIZE = 256;
+    static constexpr size_t COMPACTION_MIN_RECORDS = 1024;
+    static constexpr char JOURNAL_PUT = 'P';
+    static constexpr char JOURNAL_DELETE = 'D';
+    static constexpr size_t MAX_RECORD_NAME_LENGTH = 4096; // Longer name lengths in a file can only be corruption
+    static constexpr size_t SLAB_BYTES = SLAB_BLOCKS * CREDENTIAL_BLOCK_SIZE;
+    
+    // Field offsets: [username(64)][passwordHash(64)][salt(16)][userType(4)][kdfCost(4)][reserved(104)]
+    static constexpr size_t HASH_OFFSET = USERNAME_MAX_LENGTH;
+    static constexpr size_t SALT_OFFSET = HASH_OFFSET + PASSWORD_HASH_LENGTH;
+    static constexpr size_t USER_TYPE_OFFSET = SALT_OFFSET + SALT_LENGTH;
+    static constexpr size_t KDF_COST_OFFSET = USER_TYPE_OFFSET + USER_TYPE_SIZE;
     
+    // Cost 0 marks records hashed with the original mixing function
+    static constexpr uint32_t LEGACY_KDF_COST = 0;
+    
+public:
+    static constexpr uint32_t DEFAULT_KDF_ITERATIONS = 10000;
+    static constexpr long long DEFAULT_SESSION_TIMEOUT_SECONDS = 30 * 60;
+    
+private:
     /**
      * @brief Generates a secure random salt for password hashing
      * @param salt Pointer to buffer where salt will be stored
@@ -59,14 +396,51 @@ private:
     }
     
     /**
-     * @brief Compute a simple hash of password with salt
+     * @brief Derive the stored password hash at a given cost
+     * @param password The password to hash
+     * @param salt The salt to use
+     * @param cost PBKDF2 iterations, or LEGACY_KDF_COST for pre-KDF records
+     * @param output Pointer to PASSWORD_HASH_LENGTH-byte output buffer
+     */
+    static void derivePasswordHash(const std::string& password,
+                                   const unsigned char* salt,
+                                   uint32_t cost,
+                                   unsigned char* output) {
+        if (cost == LEGACY_KDF_COST) {
+            hashPassword(password, salt, SALT_LENGTH, output, PASSWORD_HASH_LENGTH);
+            return;
+        }
+        // One PBKDF2 block (32 bytes) carries the full strength; deriving more would
+        // only cost us extra work that an attacker can skip. The remainder stays zero.
+        std::memset(output, 0, PASSWORD_HASH_LENGTH);
+        AuthCrypto::pbkdf2Sha256(password, salt, SALT_LENGTH, cost,
+                                 output, AuthCrypto::Sha256::DIGEST_SIZE);
+    }
+    
+    /**
+     * @brief Compare two hashes without early exit
+     * @param a First hash
+     * @param b Second hash
+     * @return true if equal
+     */
+    static bool constantTimeEquals(const unsigned char* a, const unsigned char* b, size_t length) {
+        unsigned char diff = 0;
+        for (size_t i = 0; i < length; ++i) {
+            diff |= *(a + i) ^ *(b + i);
+        }
+        return diff == 0;
+    }
+    
+    /**
+     * @brief Compute the original (pre-KDF) hash of password with salt
+     * Kept only to verify records with LEGACY_KDF_COST until they are upgraded.
      * @param password The password to hash
      * @param salt The salt to use
      * @param saltLength The length of the salt
      * @param output Pointer to output buffer for hash
      * @param outputLength Length of output buffer
      */
-    void hashPassword(const std::string& password, 
+    static void hashPassword(const std::string& password, 
                       const unsigned char* salt, 
                       size_t saltLength,
                       unsigned char* output, 
@@ -112,78 +486,729 @@ private:
      * @param passwordHash The hashed password
      * @param salt The salt used for hashing
      * @param userType The type of user
+     * @param kdfCost KDF cost the hash was derived with
      * @return Offset in memory where credentials are stored
      */
     size_t storeCredential(const std::string& username, 
                           const unsigned char* passwordHash,
                           const unsigned char* salt,
-                          int userType) {
-        // Find next available memory block
-        size_t offset = credentialMap.size() * CREDENTIAL_BLOCK_SIZE;
-        
-        // Check if we have enough memory
-        if (offset + CREDENTIAL_BLOCK_SIZE > memorySize) {
-            resizeSecureMemory(memorySize * 2);
-        }
+                          int userType,
+                          uint32_t kdfCost) {
+        // Take a free block (reused or fresh)
+        size_t offset = allocateBlock();
         
         // Get pointer to the memory block
-        char* block = secureMemory + offset;
+        char* block = blockAt(offset);
         
-        // Layout: [username(64)][passwordHash(64)][salt(16)][userType(4)][reserved(108)]
+        // Layout: [username(64)][passwordHash(64)][salt(16)][userType(4)][kdfCost(4)][reserved(104)]
         
         // Clear the block
         std::memset(block, 0, CREDENTIAL_BLOCK_SIZE);
         
-        // Store username (truncate if necessary)
-        size_t usernameLen = std::min(username.length(), USERNAME_MAX_LENGTH - 1);
-        std::memcpy(block, username.c_str(), usernameLen);
+        // Store username (callers only pass names accepted by isStorableUsername)
+        std::memcpy(block, username.c_str(), std::min(username.length(), USERNAME_MAX_LENGTH - 1));
         
         // Store password hash
-        std::memcpy(block + USERNAME_MAX_LENGTH, passwordHash, PASSWORD_HASH_LENGTH);
+        std::memcpy(block + HASH_OFFSET, passwordHash, PASSWORD_HASH_LENGTH);
         
         // Store salt
-        std::memcpy(block + USERNAME_MAX_LENGTH + PASSWORD_HASH_LENGTH, salt, SALT_LENGTH);
+        std::memcpy(block + SALT_OFFSET, salt, SALT_LENGTH);
         
         // Store user type
-        int* userTypePtr = reinterpret_cast<int*>(block + USERNAME_MAX_LENGTH + PASSWORD_HASH_LENGTH + SALT_LENGTH);
+        int* userTypePtr = reinterpret_cast<int*>(block + USER_TYPE_OFFSET);
         *userTypePtr = userType;
         
+        // Store the KDF cost the hash was derived with
+        std::memcpy(block + KDF_COST_OFFSET, &kdfCost, KDF_COST_SIZE);
+        
         // Encrypt the block
         xorCrypt(reinterpret_cast<unsigned char*>(block), CREDENTIAL_BLOCK_SIZE);
         
         // Store mapping
         credentialMap[username] = offset;
+        indexRole(username, userType);
         
         return offset;
     }
     
     /**
-     * @brief Resize the secure memory buffer
-     * @param newSize New size for the memory buffer
+     * @brief Overwrite memory with zeros
+     * @param data Pointer to memory
+     * @param length Number of bytes
+     */
+    static void secureWipe(char* data, size_t length) {
+        volatile char* p = data;
+        for (size_t i = 0; i < length; ++i) {
+            *(p + i) = 0;
+        }
+    }
+    
+    /**
+     * @brief Wipe and free a set of slabs
+     * @param slabList Slabs to release (emptied on return)
+     */
+    static void releaseSlabs(std::vector<char*>& slabList) {
+        for (char* slab : slabList) {
+            secureWipe(slab, SLAB_BYTES);
+            delete[] slab;
+        }
+        slabList.clear();
+    }
+    
+    /**
+     * @brief Translate a logical offset to its block in the slabs
+     * @param offset Logical offset of a block
+     * @return Pointer to the block
+     */
+    char* blockAt(size_t offset) const {
+        return slabs[offset / SLAB_BYTES] + (offset % SLAB_BYTES);
+    }
+    
+    /**
+     * @brief Append one zeroed slab
+     */
+    void addSlab() {
+        char* slab = new char[SLAB_BYTES];
+        std::memset(slab, 0, SLAB_BYTES);
+        slabs.push_back(slab);
+        memorySize += SLAB_BYTES;
+    }
+    
+    /**
+     * @brief Hand out a credential block, reusing wiped blocks first
+     * @return Logical offset of the block
+     */
+    size_t allocateBlock() {
+        if (!freeBlocks.empty()) {
+            size_t offset = freeBlocks.back();
+            freeBlocks.pop_back();
+            return offset;
+        }
+        if (highWaterMark + CREDENTIAL_BLOCK_SIZE > memorySize) {
+            addSlab();
+        }
+        size_t offset = highWaterMark;
+        highWaterMark += CREDENTIAL_BLOCK_SIZE;
+        return offset;
+    }
+    
+    /**
+     * @brief Wipe a credential block and return it to the free-list
+     * @param offset Logical offset of the block
+     */
+    void releaseBlock(size_t offset) {
+        secureWipe(blockAt(offset), CREDENTIAL_BLOCK_SIZE);
+        freeBlocks.push_back(offset);
+    }
+    
+    /**
+     * @brief Add or move a user in the role index (caller holds credentialMutex)
+     */
+    void indexRole(const std::string& username, int userType) {
+        unindexRole(username);
+        roleOfUser[username] = userType;
+        usernamesByRole[userType].insert(username);
+        sortedUsernames.insert(username);
+    }
+    
+    /**
+     * @brief Remove a user from the role index (caller holds credentialMutex)
+     */
+    void unindexRole(const std::string& username) {
+        auto it = roleOfUser.find(username);
+        if (it == roleOfUser.end()) {
+            return;
+        }
+        usernamesByRole[it->second].erase(username);
+        sortedUsernames.erase(username);
+        roleOfUser.erase(it);
+    }
+    
+    /**
+     * @brief Rebuild the role index by decrypting each block once (caller holds credentialMutex)
+     */
+    void rebuildRoleIndex() {
+        roleOfUser.clear();
+        usernamesByRole.clear();
+        sortedUsernames.clear();
+        char block[CREDENTIAL_BLOCK_SIZE];
+        for (const auto& entry : credentialMap) {
+            std::memcpy(block, blockAt(entry.second), CREDENTIAL_BLOCK_SIZE);
+            xorCrypt(reinterpret_cast<unsigned char*>(block), CREDENTIAL_BLOCK_SIZE);
+            int userType;
+            std::memcpy(&userType, block + USER_TYPE_OFFSET, USER_TYPE_SIZE);
+            indexRole(entry.first, userType);
+        }
+        secureWipe(block, CREDENTIAL_BLOCK_SIZE);
+    }
+    
+    /**
+     * @brief Collect (username, type) pairs for one role from the index
+     */
+    std::vector<std::pair<std::string, int>> usersWithRole(int userType) {
+        std::lock_guard<std::recursive_mutex> lock(credentialMutex);
+        std::vector<std::pair<std::string, int>> users;
+        auto it = usernamesByRole.find(userType);
+        if (it != usernamesByRole.end()) {
+            users.reserve(it->second.size());
+            for (const auto& username : it->second) {
+                users.emplace_back(username, userType);
+            }
+        }
+        return users;
+    }
+    
+    /**
+     * @brief Seconds on the monotonic clock
+     */
+    static double monotonicSeconds() {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+    
+    /**
+     * @brief Seeded FNV-1a hash of a username (never 0, which marks empty slots)
+     */
+    uint64_t throttleKey(const std::string& username) const {
+        uint64_t hash = 1469598103934665603ULL ^ throttleSeed;
+        for (unsigned char c : username) {
+            hash ^= c;
+            hash *= 1099511628211ULL;
+        }
+        return hash == 0 ? 1 : hash;
+    }
+    
+    /**
+     * @brief Find a username's throttle slot (caller holds throttleMutex)
+     *
+     * When the probe window is full, a slot is evicted: first the stalest with
+     * no recorded failures, then the stalest whose lockout is over. A slot that
+     * is still locked out is never evicted, so spraying other usernames cannot
+     * lift a lockout.
+     *
+     * @param key Username hash
+     * @param create Claim a slot if absent
+     * @return Slot, or nullptr if absent and create is false, or if every
+     *         candidate slot is locked out
+     */
+    ThrottleSlot* findThrottleSlot(uint64_t key, bool create, double now) {
+        size_t start = static_cast<size_t>(key) & (THROTTLE_TABLE_SLOTS - 1);
+        ThrottleSlot* empty = nullptr;
+        ThrottleSlot* victim = nullptr;
+        for (size_t probe = 0; probe < THROTTLE_PROBE_LIMIT; ++probe) {
+            ThrottleSlot& slot = throttleTable[(start + probe) & (THROTTLE_TABLE_SLOTS - 1)];
+            if (slot.key == key) {
+                return &slot;
+            }
+            if (slot.key == 0) {
+                if (!empty) empty = &slot;
+            } else if (now >= slot.lockedUntil) {
+                bool clean = slot.failures == 0;
+                bool victimClean = victim && victim->failures == 0;
+                if (!victim || (clean && !victimClean) ||
+                    (clean == victimClean && slot.lastSeen < victim->lastSeen)) {
+                    victim = &slot;
+                }
+            }
+        }
+        if (!create) {
+            return nullptr;
+        }
+        ThrottleSlot* slot = empty;
+        if (!slot) {
+            if (!victim) {
+                return nullptr; // Only active lockouts left; caller fails closed
+            }
+            slot = victim;
+            ++throttleStats.evictions;
+        } else {
+            ++throttleStats.trackedUsernames;
+        }
+        *slot = ThrottleSlot();
+        slot->key = key;
+        slot->tokens = throttlePolicy.userBurst;
+        slot->lastRefill = now;
+        slot->lastSeen = now;
+        return slot;
+    }
+    
+    /**
+     * @brief Decide whether a login attempt may run the KDF
+     * @param username Username being tried
+     * @return true if admitted (tokens are consumed)
+     */
+    bool admitLoginAttempt(const std::string& username) {
+        std::lock_guard<std::mutex> lock(throttleMutex);
+        if (!throttlePolicy.enabled) {
+            ++throttleStats.allowed;
+            return true;
+        }
+        double now = monotonicSeconds();
+        
+        ThrottleSlot* slot = findThrottleSlot(throttleKey(username), true, now);
+        if (!slot) {
+            ++throttleStats.rejectedTableFull;
+            return false;
+        }
+        slot->lastSeen = now;
+        if (now < slot->lockedUntil) {
+            ++throttleStats.rejectedLockout;
+            return false;
+        }
+        slot->tokens = std::min(throttlePolicy.userBurst,
+                                slot->tokens + (now - slot->lastRefill) * throttlePolicy.userRatePerSecond);
+        slot->lastRefill = now;
+        if (slot->tokens < 1.0) {
+            ++throttleStats.rejectedUser;
+            return false;
+        }
+        
+        if (globalLastRefill < 0) {
+            globalTokens = throttlePolicy.globalBurst;
+        } else {
+            globalTokens = std::min(throttlePolicy.globalBurst,
+                                    globalTokens + (now - globalLastRefill) * throttlePolicy.globalRatePerSecond);
+        }
+        globalLastRefill = now;
+        if (globalTokens < 1.0) {
+            ++throttleStats.rejectedGlobal;
+            return false;
+        }
+        
+        slot->tokens -= 1.0;
+        globalTokens -= 1.0;
+        ++throttleStats.allowed;
+        return true;
+    }
+    
+    /**
+     * @brief Feed the outcome of an admitted attempt back into the throttle
+     * @param username Username that was tried
+     * @param success Whether the password matched
+     */
+    void recordLoginResult(const std::string& username, bool success) {
+        std::lock_guard<std::mutex> lock(throttleMutex);
+        if (!throttlePolicy.enabled) {
+            return;
+        }
+        double now = monotonicSeconds();
+        ThrottleSlot* slot = findThrottleSlot(throttleKey(username), false, now);
+        if (!slot) {
+            return; // evicted meanwhile
+        }
+        if (success) {
+            // Legitimate logins are not rate limited per user
+            slot->failures = 0;
+            slot->tokens = std::min(throttlePolicy.userBurst, slot->tokens + 1.0);
+            return;
+        }
+        ++slot->failures;
+        if (slot->failures >= throttlePolicy.lockoutThreshold) {
+            uint32_t doublings = std::min<uint32_t>(slot->failures - throttlePolicy.lockoutThreshold, 30);
+            double lockout = std::min(throttlePolicy.lockoutMaxSeconds,
+                                      throttlePolicy.lockoutBaseSeconds * static_cast<double>(1ULL << doublings));
+            slot->lockedUntil = now + lockout;
+            ++throttleStats.lockouts;
+        }
+    }
+    
+    /**
+     * @brief Whether a username survives a round trip through a block's username field
+     *
+     * The field holds a NUL-terminated name, and loading keeps only map entries
+     * whose block names the same user, so longer names, embedded NULs and the
+     * empty name would be lost on the next reload.
+     */
+    static bool isStorableUsername(const std::string& username) {
+        return !username.empty() && username.size() < USERNAME_MAX_LENGTH &&
+               username.find('\0') == std::string::npos;
+    }
+    
+    /**
+     * @brief Decrypt the username field of a raw block
+     * @param block Encrypted block
+     * @param key Encryption key
+     * @param length Key length
+     * @return Username, or empty string for a wiped block
+     */
+    static std::string blockOwner(const char* block, const unsigned char* key, size_t length) {
+        bool wiped = true;
+        for (size_t i = 0; i < CREDENTIAL_BLOCK_SIZE && wiped; ++i) {
+            wiped = *(block + i) == 0;
+        }
+        if (wiped) {
+            return "";
+        }
+        std::string owner;
+        for (size_t c = 0; c < USERNAME_MAX_LENGTH; ++c) {
+            char plain = static_cast<char>(*(block + c) ^ *(key + (c % length)));
+            if (plain == '\0') {
+                return owner;
+            }
+            owner.push_back(plain);
+        }
+        return ""; // no terminator - not a credential block
+    }
+    
+    /**
+     * @brief Read up to maxBytes of block data into fresh slabs
+     * @param file Input stream positioned at the block data
+     * @param maxBytes Upper bound on bytes to read
+     * @param out Receives the slabs
+     * @return Number of bytes read
+     */
+    static size_t readSlabs(std::ifstream& file, size_t maxBytes, std::vector<char*>& out) {
+        size_t loaded = 0;
+        while (loaded < maxBytes) {
+            size_t wanted = std::min(SLAB_BYTES, maxBytes - loaded);
+            char* slab = new char[SLAB_BYTES];
+            std::memset(slab, 0, SLAB_BYTES);
+            file.read(slab, wanted);
+            size_t got = static_cast<size_t>(file.gcount());
+            if (got == 0) {
+                delete[] slab;
+                break;
+            }
+            out.push_back(slab);
+            loaded += got;
+            if (got < wanted) {
+                break; // end of file
+            }
+        }
+        return loaded;
+    }
+    
+    static std::string journalPath(const std::string& path) {
+        return path + ".journal";
+    }
+    
+    /**
+     * @brief Flush a stream and force it to stable storage
+     */
+    static bool syncFile(FILE* file) {
+        if (!file || std::fflush(file) != 0) {
+            return false;
+        }
+#ifdef _WIN32
+        return _commit(_fileno(file)) == 0;
+#else
+        return fsync(fileno(file)) == 0;
+#endif
+    }
+    
+    /**
+     * @brief Replace a file with its freshly written temporary
+     */
+    static bool replaceFile(const std::string& tempPath, const std::string& path) {
+        if (std::rename(tempPath.c_str(), path.c_str()) == 0) {
+            return true;
+        }
+        std::remove(path.c_str()); // rename does not overwrite on Windows
+        return std::rename(tempPath.c_str(), path.c_str()) == 0;
+    }
+    
+    /**
+     * @brief Append one map change to a journal stream
+     */
+    static bool writeJournalRecord(FILE* journal, char op, const std::string& username, size_t offset) {
+        size_t usernameLength = username.length();
+        return std::fwrite(&op, 1, 1, journal) == 1 &&
+               std::fwrite(&offset, sizeof(offset), 1, journal) == 1 &&
+               std::fwrite(&usernameLength, sizeof(usernameLength), 1, journal) == 1 &&
+               std::fwrite(username.data(), 1, usernameLength, journal) == usernameLength;
+    }
+    
+    /**
+     * @brief Write the map as a compact journal (one put per user), atomically
+     * @param path Journal path
+     * @return true if successful
+     */
+    bool writeJournalSnapshot(const std::string& path) {
+        std::string tempPath = path + ".tmp";
+        FILE* journal = std::fopen(tempPath.c_str(), "wb");
+        if (!journal) {
+            return false;
+        }
+        bool ok = true;
+        for (const auto& entry : credentialMap) {
+            ok = ok && writeJournalRecord(journal, JOURNAL_PUT, entry.first, entry.second);
+        }
+        ok = syncFile(journal) && ok;
+        std::fclose(journal);
+        return ok && replaceFile(tempPath, path);
+    }
+    
+    /**
+     * @brief Write header, key and all blocks plus a compact journal to path
+     * @param path Block store path (journal goes next to it)
+     * @return true if successful
+     */
+    bool writeSnapshot(const std::string& path) {
+        std::string tempPath = path + ".tmp";
+        FILE* store = std::fopen(tempPath.c_str(), "wb");
+        if (!store) {
+            return false;
+        }
+        char header[STORE_HEADER_BYTES] = {0};
+        std::memcpy(header, &STORE_MAGIC, sizeof(STORE_MAGIC));
+        std::memcpy(header + 4, &STORE_VERSION, sizeof(STORE_VERSION));
+        std::memcpy(header + 8, &keySize, sizeof(keySize));
+        std::memcpy(header + 8 + sizeof(keySize), encryptionKey, keySize);
+        bool ok = std::fwrite(header, 1, STORE_HEADER_BYTES, store) == STORE_HEADER_BYTES;
+        for (size_t written = 0; ok && written < highWaterMark; written += SLAB_BYTES) {
+            size_t chunk = std::min(SLAB_BYTES, highWaterMark - written);
+            ok = std::fwrite(slabs[written / SLAB_BYTES], 1, chunk, store) == chunk;
+        }
+        ok = syncFile(store) && ok;
+        std::fclose(store);
+        secureWipe(header, STORE_HEADER_BYTES);
+        return ok && writeJournalSnapshot(journalPath(path)) && replaceFile(tempPath, path);
+    }
+    
+    /**
+     * @brief Close the incremental store handles
+     */
+    void closeStore() {
+        if (blockStore) {
+            syncFile(blockStore);
+            std::fclose(blockStore);
+            blockStore = nullptr;
+        }
+        if (mapJournal) {
+            syncFile(mapJournal);
+            std::fclose(mapJournal);
+            mapJournal = nullptr;
+        }
+        storeAttached = false;
+    }
+    
+    /**
+     * @brief Open authDataFile and its journal for in-place updates
+     * @return true if both are open
+     */
+    bool attachStore() {
+        closeStore();
+        blockStore = std::fopen(authDataFile.c_str(), "r+b");
+        mapJournal = std::fopen(journalPath(authDataFile).c_str(), "ab");
+        storeAttached = blockStore && mapJournal;
+        if (!storeAttached) {
+            closeStore();
+        }
+        return storeAttached;
+    }
+    
+    /**
+     * @brief Make sure authDataFile mirrors memory, writing a snapshot if it does not yet
+     * @return true if the store is ready for incremental writes
+     */
+    bool ensureStore() {
+        if (storeAttached) {
+            return true;
+        }
+        if (!writeSnapshot(authDataFile)) {
+            return false;
+        }
+        journalRecords = credentialMap.size();
+        return attachStore();
+    }
+    
+    /**
+     * @brief Write one block in place at its offset
+     * @param offset Logical offset of the block
+     */
+    void persistBlock(size_t offset) {
+        if (!ensureStore()) {
+            return;
+        }
+        std::fseek(blockStore, static_cast<long>(STORE_HEADER_BYTES + offset), SEEK_SET);
+        std::fwrite(blockAt(offset), 1, CREDENTIAL_BLOCK_SIZE, blockStore);
+    }
+    
+    /**
+     * @brief Append one map change to the journal
+     */
+    void appendJournal(char op, const std::string& username, size_t offset) {
+        if (!ensureStore()) {
+            return;
+        }
+        writeJournalRecord(mapJournal, op, username, offset);
+        ++journalRecords;
+    }
+    
+    /**
+     * @brief Make pending block and journal writes durable, compacting if due
+     */
+    void commitStore() {
+        if (!storeAttached) {
+            return;
+        }
+        syncFile(blockStore);
+        syncFile(mapJournal);
+        
+        // Compact once superseded records outnumber live ones
+        if (journalRecords >= COMPACTION_MIN_RECORDS && journalRecords > 2 * credentialMap.size()) {
+            std::fclose(mapJournal);
+            mapJournal = nullptr;
+            if (writeJournalSnapshot(journalPath(authDataFile))) {
+                journalRecords = credentialMap.size();
+            }
+            mapJournal = std::fopen(journalPath(authDataFile).c_str(), "ab");
+            if (!mapJournal) {
+                closeStore(); // next write re-snapshots
+            }
+        }
+    }
+    
+    /**
+     * @brief Copy and decrypt a user's credential block
+     * @param username Username
+     * @param block Output buffer of CREDENTIAL_BLOCK_SIZE bytes
+     * @param offset Receives the block's offset in secure memory
+     * @return true if the user exists
+     */
+    bool snapshotCredential(const std::string& username, char* block, size_t& offset) {
+        std::lock_guard<std::recursive_mutex> lock(credentialMutex);
+        auto it = credentialMap.find(username);
+        if (it == credentialMap.end()) {
+            return false;
+        }
+        offset = it->second;
+        std::memcpy(block, blockAt(offset), CREDENTIAL_BLOCK_SIZE);
+        xorCrypt(reinterpret_cast<unsigned char*>(block), CREDENTIAL_BLOCK_SIZE);
+        return true;
+    }
+    
+    /**
+     * @brief Read the KDF cost field of a decrypted block
+     */
+    static uint32_t blockKdfCost(const char* block) {
+        uint32_t cost;
+        std::memcpy(&cost, block + KDF_COST_OFFSET, KDF_COST_SIZE);
+        return cost;
+    }
+    
+    /**
+     * @brief Re-derive a verified password at the current cost and store it in place
+     *
+     * Skipped if the record changed since it was verified (password changed or user deleted).
+     * @param username Username
+     * @param password Password that was just verified
+     * @param verifiedSalt Salt of the block the password was verified against
+     */
+    void upgradeCredential(const std::string& username,
+                           const std::string& password,
+                           const unsigned char* verifiedSalt) {
+        uint32_t cost = getKdfIterations();
+        unsigned char salt[SALT_LENGTH];
+        generateSalt(salt, SALT_LENGTH);
+        unsigned char passwordHash[PASSWORD_HASH_LENGTH];
+        derivePasswordHash(password, salt, cost, passwordHash);
+        
+        std::lock_guard<std::recursive_mutex> lock(credentialMutex);
+        auto it = credentialMap.find(username);
+        if (it == credentialMap.end()) {
+            return;
+        }
+        char block[CREDENTIAL_BLOCK_SIZE];
+        std::memcpy(block, blockAt(it->second), CREDENTIAL_BLOCK_SIZE);
+        xorCrypt(reinterpret_cast<unsigned char*>(block), CREDENTIAL_BLOCK_SIZE);
+        if (std::memcmp(block + SALT_OFFSET, verifiedSalt, SALT_LENGTH) == 0) {
+            std::memcpy(block + HASH_OFFSET, passwordHash, PASSWORD_HASH_LENGTH);
+            std::memcpy(block + SALT_OFFSET, salt, SALT_LENGTH);
+            std::memcpy(block + KDF_COST_OFFSET, &cost, KDF_COST_SIZE);
+            xorCrypt(reinterpret_cast<unsigned char*>(block), CREDENTIAL_BLOCK_SIZE);
+            std::memcpy(blockAt(it->second), block, CREDENTIAL_BLOCK_SIZE);
+            persistBlock(it->second);
+            commitStore();
+        }
+        std::memset(block, 0, CREDENTIAL_BLOCK_SIZE);
+    }
+    
+    /**
+     * @brief Convert a time point to an expiry wheel tick
+     */
+    static long long toWheelTick(std::chrono::steady_clock::time_point when) {
+        return std::chrono::duration_cast<std::chrono::seconds>(when.time_since_epoch()).count()
+               / EXPIRY_TICK_SECONDS;
+    }
+    
+    /**
+     * @brief Sweep wheel slots the clock has passed (caller holds sessionMutex)
+     */
+    void advanceExpiryWheel(std::chrono::steady_clock::time_point now) {
+        long long nowTick = toWheelTick(now);
+        if (wheelTick < 0) {
+            wheelTick = nowTick;
+            return;
+        }
+        // Past a full revolution every slot is due once; no need to spin further
+        long long first = std::max(wheelTick + 1, nowTick - static_cast<long long>(EXPIRY_WHEEL_SLOTS) + 1);
+        for (long long tick = first; tick <= nowTick; ++tick) {
+            std::vector<std::string>& slot = expiryWheel[tick % EXPIRY_WHEEL_SLOTS];
+            std::vector<std::string> keep;
+            for (const auto& token : slot) {
+                auto it = sessions.find(token);
+                if (it == sessions.end()) {
+                    continue; // already revoked
+                }
+                if (it->second.expiresAt <= now) {
+                    sessions.erase(it);
+                } else {
+                    keep.push_back(token); // due on a later revolution
+                }
+            }
+            slot.swap(keep);
+        }
+        wheelTick = std::max(wheelTick, nowTick);
+    }
+    
+    /**
+     * @brief Look up a live session (caller holds sessionMutex)
+     * @return Pointer to the entry, or nullptr if unknown or expired
+     */
+    const SessionEntry* findSession(const std::string& token) {
+        auto now = std::chrono::steady_clock::now();
+        advanceExpiryWheel(now);
+        auto it = sessions.find(token);
+        if (it == sessions.end()) {
+            return nullptr;
+        }
+        if (it->second.expiresAt <= now) {
+            sessions.erase(it); // expired inside the current tick
+            return nullptr;
+        }
+        return &it->second;
+    }
+    
+    /**
+     * @brief Generate an opaque hex session token
+     */
+    static std::string generateSessionToken() {
+        static const char hexDigits[] = "0123456789abcdef";
+        std::random_device rd;
+        std::string token;
+        token.reserve(SESSION_TOKEN_BYTES * 2);
+        for (size_t i = 0; i < SESSION_TOKEN_BYTES; i += 4) {
+            uint32_t word = rd();
+            for (int b = 0; b < 4; ++b) {
+                unsigned char byte = static_cast<unsigned char>(word >> (8 * b));
+                token.push_back(hexDigits[byte >> 4]);
+                token.push_back(hexDigits[byte & 0x0F]);
+            }
+        }
+        return token;
+    }
+    
+    /**
+     * @brief Start the verification pool on first use
+     * @return The pool
      */
-    void resizeSecureMemory(size_t newSize) {
-        if (newSize <= memorySize) {
-            return;
-        }
-        
-        // Allocate new memory
-        char* newMemory = new char[newSize];
-        std::memset(newMemory, 0, newSize);
-        
-        // Copy existing data
-        if (secureMemory) {
-            std::memcpy(newMemory, secureMemory, memorySize);
-            
-            // Securely wipe old memory
-            for (size_t i = 0; i < memorySize; ++i) {
-                *(secureMemory + i) = 0;
-            }
-            
-            delete[] secureMemory;
+    WorkerPool& ensureVerificationPool() {
+        std::lock_guard<std::recursive_mutex> lock(credentialMutex);
+        if (!verificationPool) {
+            unsigned int cores = std::thread::hardware_concurrency();
+            verificationPool.reset(new WorkerPool(cores == 0 ? 2 : cores));
         }
-        
-        secureMemory = newMemory;
-        memorySize = newSize;
+        return *verificationPool;
     }
     
     /**
@@ -213,17 +1238,20 @@ private:
 public:
     /**
      * @brief Constructor
-     * @param initialMemorySize Initial size of secure memory buffer
+     * @param initialMemorySize Initial capacity reserved for credential slabs (bytes)
      * @param authFilePath Path to the authentication data file
      */
     AuthModule(size_t initialMemorySize = 4096, const std::string& authFilePath = "data/auth.dat") 
-        : authDataFile(authFilePath) {
-        // Allocate secure memory
-        secureMemory = new char[initialMemorySize];
-        memorySize = initialMemorySize;
+        : authDataFile(authFilePath), throttleTable(THROTTLE_TABLE_SLOTS),
+          expiryWheel(EXPIRY_WHEEL_SLOTS) {
+        std::random_device rd;
+        throttleSeed = (static_cast<uint64_t>(rd()) << 32) | rd();
+        throttleStats.tableSlots = THROTTLE_TABLE_SLOTS;
         
-        // Initialize memory with zeros
-        std::memset(secureMemory, 0, memorySize);
+        // Reserve enough zeroed slabs for the requested initial size
+        do {
+            addSlab();
+        } while (memorySize < initialMemorySize);
         
         // Generate encryption key
         generateEncryptionKey();
@@ -240,10 +1268,19 @@ public:
      * @brief Destructor - securely wipes memory before deallocation
      */
     ~AuthModule() {
-        // Save credentials before cleanup (safety backup)
+        // Drain pending asynchronous verifications before tearing down memory
+        verificationPool.reset();
+        
+        // Invalidate all issued sessions
+        sessions.clear();
+        expiryWheel.clear();
+        
+        // Records are persisted as they change; only an unattached store
+        // (e.g. after loading from another path) still needs a snapshot
         if (!credentialMap.empty()) {
-            saveCredentials(authDataFile);
+            ensureStore();
         }
+        closeStore();
         
         // Securely wipe encryption key
         if (encryptionKey) {
@@ -254,12 +1291,7 @@ public:
         }
         
         // Securely wipe credential memory
-        if (secureMemory) {
-            for (size_t i = 0; i < memorySize; ++i) {
-                *(secureMemory + i) = 0;
-            }
-            delete[] secureMemory;
-        }
+        releaseSlabs(slabs);
     }
     
     /**
@@ -270,8 +1302,8 @@ public:
      * @return True if registration successful
      */
     bool registerUser(const std::string& username, const std::string& password) {
-        // Check if username already exists
-        if (credentialMap.find(username) != credentialMap.end()) {
+        // Check the name fits a block and the username doesn't already exist
+        if (!isStorableUsername(username) || userExists(username)) {
             return false;
         }
         
@@ -279,19 +1311,98 @@ public:
         unsigned char salt[SALT_LENGTH];
         generateSalt(salt, SALT_LENGTH);
         
-        // Hash password
+        // Hash password (outside the lock - this is the expensive part)
+        uint32_t cost = getKdfIterations();
         unsigned char passwordHash[PASSWORD_HASH_LENGTH];
-        hashPassword(password, salt, SALT_LENGTH, passwordHash, PASSWORD_HASH_LENGTH);
+        derivePasswordHash(password, salt, cost, passwordHash);
+        
+        std::lock_guard<std::recursive_mutex> lock(credentialMutex);
+        if (credentialMap.find(username) != credentialMap.end()) {
+            return false;
+        }
         
         // Store in secure memory (userType = 0 for all users)
-        storeCredential(username, passwordHash, salt, 0);
+        size_t offset = storeCredential(username, passwordHash, salt, 0, cost);
         
-        // Save credentials to file immediately after registration
-        saveCredentials(authDataFile);
+        // Persist just this record
+        persistBlock(offset);
+        appendJournal(JOURNAL_PUT, username, offset);
+        commitStore();
         
         return true;
     }
     
+    /**
+     * @brief Register many users with a single durable commit
+     *
+     * Passwords are hashed in parallel on the verification pool, then all records
+     * are written and synced once. Existing, repeated or unstorable usernames
+     * (see isStorableUsername) are skipped.
+     * @param accounts (username, password) pairs
+     * @return Number of users registered
+     */
+    size_t registerUsers(const std::vector<std::pair<std::string, std::string>>& accounts) {
+        struct PendingAccount {
+            const std::string* username;
+            const std::string* password;
+            unsigned char salt[SALT_LENGTH];
+            unsigned char passwordHash[PASSWORD_HASH_LENGTH];
+        };
+        
+        std::vector<PendingAccount> pending;
+        {
+            std::lock_guard<std::recursive_mutex> lock(credentialMutex);
+            std::unordered_map<std::string, bool> seen;
+            for (const auto& account : accounts) {
+                if (!isStorableUsername(account.first) || credentialMap.count(account.first) ||
+                    !seen.emplace(account.first, true).second) {
+                    continue;
+                }
+                PendingAccount entry;
+                entry.username = &account.first;
+                entry.password = &account.second;
+                generateSalt(entry.salt, SALT_LENGTH);
+                pending.push_back(entry);
+            }
+        }
+        
+        // Derive hashes in parallel (no lock held)
+        uint32_t cost = getKdfIterations();
+        WorkerPool& pool = ensureVerificationPool();
+        std::vector<std::future<void>> done;
+        size_t chunk = (pending.size() + pool.size() - 1) / pool.size();
+        for (size_t begin = 0; begin < pending.size(); begin += chunk) {
+            size_t end = std::min(pending.size(), begin + chunk);
+            auto task = std::make_shared<std::packaged_task<void()>>([&pending, begin, end, cost]() {
+                for (size_t i = begin; i < end; ++i) {
+                    derivePasswordHash(*pending[i].password, pending[i].salt, cost, pending[i].passwordHash);
+                }
+            });
+            done.push_back(task->get_future());
+            pool.submit([task]() { (*task)(); });
+        }
+        for (auto& f : done) {
+            f.get();
+        }
+        
+        std::lock_guard<std::recursive_mutex> lock(credentialMutex);
+        size_t registered = 0;
+        for (auto& entry : pending) {
+            if (credentialMap.count(*entry.username)) {
+                continue; // registered concurrently
+            }
+            size_t offset = storeCredential(*entry.username, entry.passwordHash, entry.salt, 0, cost);
+            persistBlock(offset);
+            appendJournal(JOURNAL_PUT, *entry.username, offset);
+            ++registered;
+        }
+        for (auto& entry : pending) {
+            secureWipe(reinterpret_cast<char*>(entry.passwordHash), PASSWORD_HASH_LENGTH);
+        }
+        commitStore();
+        return registered;
+    }
+    
     /**
      * @brief Authenticate a user
      * @param username Username
@@ -299,48 +1410,276 @@ public:
      * @return true if authentication successful, false otherwise
      */
     bool authenticateUser(const std::string& username, const std::string& password) {
-        // Check if username exists
-        auto it = credentialMap.find(username);
-        if (it == credentialMap.end()) {
+        // Shed throttled attempts before doing any key derivation
+        if (!admitLoginAttempt(username)) {
             return false;
         }
         
-        // Get offset in secure memory
-        size_t offset = it->second;
-        
-        // Make a copy of the encrypted block
         char block[CREDENTIAL_BLOCK_SIZE];
-        std::memcpy(block, secureMemory + offset, CREDENTIAL_BLOCK_SIZE);
-        
-        // Decrypt the block
-        xorCrypt(reinterpret_cast<unsigned char*>(block), CREDENTIAL_BLOCK_SIZE);
+        size_t offset;
+        if (!snapshotCredential(username, block, offset)) {
+            recordLoginResult(username, false);
+            return false;
+        }
         
-        // Extract salt
-        const unsigned char* salt = reinterpret_cast<const unsigned char*>(
-            block + USERNAME_MAX_LENGTH + PASSWORD_HASH_LENGTH
-        );
+        // Extract salt, cost and stored hash
+        const unsigned char* salt = reinterpret_cast<const unsigned char*>(block + SALT_OFFSET);
+        const unsigned char* storedHash = reinterpret_cast<const unsigned char*>(block + HASH_OFFSET);
+        uint32_t storedCost = blockKdfCost(block);
         
-        // Hash the provided password
+        // Hash the provided password at the cost the record was stored with
         unsigned char inputHash[PASSWORD_HASH_LENGTH];
-        hashPassword(password, salt, SALT_LENGTH, inputHash, PASSWORD_HASH_LENGTH);
-        
-        // Get stored hash
-        const unsigned char* storedHash = reinterpret_cast<const unsigned char*>(
-            block + USERNAME_MAX_LENGTH
-        );
-        
-        // Compare hashes
-        bool passwordMatch = true;
-        for (size_t i = 0; i < PASSWORD_HASH_LENGTH; ++i) {
-            if (*(inputHash + i) != *(storedHash + i)) {
-                passwordMatch = false;
-                break;
-            }
+        derivePasswordHash(password, salt, storedCost, inputHash);
+        
+        bool passwordMatch = constantTimeEquals(inputHash, storedHash, PASSWORD_HASH_LENGTH);
+        recordLoginResult(username, passwordMatch);
+        
+        // Transparently move weaker records up to the configured cost
+        if (passwordMatch && storedCost < getKdfIterations()) {
+            upgradeCredential(username, password, salt);
         }
         
+        std::memset(block, 0, CREDENTIAL_BLOCK_SIZE);
         return passwordMatch;
     }
     
+    /**
+     * @brief Authenticate a user on the verification worker pool
+     *
+     * Key derivation is CPU-bound, so concurrent logins scale with cores instead of
+     * queueing behind one another on the caller's thread.
+     * @param username Username
+     * @param password Password
+     * @return Future resolving to the result of authenticateUser
+     */
+    std::future<bool> authenticateUserAsync(const std::string& username, const std::string& password) {
+        auto task = std::make_shared<std::packaged_task<bool()>>(
+            [this, username, password]() { return authenticateUser(username, password); });
+        std::future<bool> result = task->get_future();
+        ensureVerificationPool().submit([task]() { (*task)(); });
+        return result;
+    }
+    
+    /**
+     * @brief Set the KDF cost used for new and upgraded credentials
+     * @param iterations PBKDF2 iterations (must be >= 1)
+     * @return true if accepted
+     */
+    bool setKdfIterations(uint32_t iterations) {
+        if (iterations == 0) {
+            return false;
+        }
+        std::lock_guard<std::recursive_mutex> lock(credentialMutex);
+        kdfIterations = iterations;
+        return true;
+    }
+    
+    /**
+     * @brief Get the configured KDF cost
+     * @return PBKDF2 iterations
+     */
+    uint32_t getKdfIterations() const {
+        std::lock_guard<std::recursive_mutex> lock(credentialMutex);
+        return kdfIterations;
+    }
+    
+    /**
+     * @brief Get the KDF cost a user's credential is stored with
+     * @param username Username
+     * @return Stored cost (0 for legacy records), or -1 if user not found
+     */
+    long long getCredentialCost(const std::string& username) {
+        char block[CREDENTIAL_BLOCK_SIZE];
+        size_t offset;
+        if (!snapshotCredential(username, block, offset)) {
+            return -1;
+        }
+        uint32_t cost = blockKdfCost(block);
+        std::memset(block, 0, CREDENTIAL_BLOCK_SIZE);
+        return cost;
+    }
+    
+    /**
+     * @brief Authenticate a user and open a session
+     * @param username Username
+     * @param password Password
+     * @return Session token, or empty string if authentication failed
+     */
+    std::string login(const std::string& username, const std::string& password) {
+        if (!authenticateUser(username, password)) {
+            return "";
+        }
+        return createSession(username);
+    }
+    
+    /**
+     * @brief Open a session for an already authenticated user
+     *
+     * The role is captured from the role index here; later checks go
+     * through the session table only.
+     * @param username Username
+     * @return Session token, or empty string if the user does not exist
+     */
+    std::string createSession(const std::string& username) {
+        int userType = getUserType(username);
+        if (userType < 0) {
+            return "";
+        }
+        
+        std::lock_guard<std::mutex> lock(sessionMutex);
+        auto now = std::chrono::steady_clock::now();
+        advanceExpiryWheel(now);
+        
+        std::string token = generateSessionToken();
+        while (sessions.find(token) != sessions.end()) {
+            token = generateSessionToken();
+        }
+        SessionEntry entry{username, userType, now + sessionTimeout};
+        expiryWheel[toWheelTick(entry.expiresAt) % EXPIRY_WHEEL_SLOTS].push_back(token);
+        sessions.emplace(token, std::move(entry));
+        return token;
+    }
+    
+    /**
+     * @brief Check whether a session token is live
+     * @param token Session token
+     * @return true if the session exists and has not expired
+     */
+    bool validateSession(const std::string& token) {
+        std::lock_guard<std::mutex> lock(sessionMutex);
+        return findSession(token) != nullptr;
+    }
+    
+    /**
+     * @brief Get the user type bound to a session
+     * @param token Session token
+     * @return User type, or -1 if the session is invalid
+     */
+    int getSessionRole(const std::string& token) {
+        std::lock_guard<std::mutex> lock(sessionMutex);
+        const SessionEntry* entry = findSession(token);
+        return entry ? entry->userType : -1;
+    }
+    
+    /**
+     * @brief Get the username bound to a session
+     * @param token Session token
+     * @return Username, or empty string if the session is invalid
+     */
+    std::string getSessionUsername(const std::string& token) {
+        std::lock_guard<std::mutex> lock(sessionMutex);
+        const SessionEntry* entry = findSession(token);
+        return entry ? entry->username : "";
+    }
+    
+    /**
+     * @brief End a session
+     * @param token Session token
+     * @return true if the session existed
+     */
+    bool revokeSession(const std::string& token) {
+        std::lock_guard<std::mutex> lock(sessionMutex);
+        // The wheel slot keeps the stale token until its sweep, which skips it
+        return sessions.erase(token) > 0;
+    }
+    
+    /**
+     * @brief End every session of a user
+     * @param username Username
+     * @return Number of sessions revoked
+     */
+    size_t revokeUserSessions(const std::string& username) {
+        std::lock_guard<std::mutex> lock(sessionMutex);
+        size_t revoked = 0;
+        for (auto it = sessions.begin(); it != sessions.end();) {
+            if (it->second.username == username) {
+                it = sessions.erase(it);
+                ++revoked;
+            } else {
+                ++it;
+            }
+        }
+        return revoked;
+    }
+    
+    /**
+     * @brief Set the lifetime of newly created sessions
+     * @param seconds Timeout in seconds (must be > 0)
+     * @return true if accepted
+     */
+    bool setSessionTimeout(long long seconds) {
+        if (seconds <= 0) {
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(sessionMutex);
+        sessionTimeout = std::chrono::seconds(seconds);
+        return true;
+    }
+    
+    /**
+     * @brief Get number of live sessions
+     * @return Session count after expiring overdue entries
+     */
+    size_t getActiveSessionCount() {
+        std::lock_guard<std::mutex> lock(sessionMutex);
+        advanceExpiryWheel(std::chrono::steady_clock::now());
+        return sessions.size();
+    }
+    
+    /**
+     * @brief Replace the login throttling limits
+     * @param policy New limits
+     */
+    void setThrottlePolicy(const ThrottlePolicy& policy) {
+        std::lock_guard<std::mutex> lock(throttleMutex);
+        throttlePolicy = policy;
+    }
+    
+    /**
+     * @brief Get the login throttling limits
+     * @return Current policy
+     */
+    ThrottlePolicy getThrottlePolicy() const {
+        std::lock_guard<std::mutex> lock(throttleMutex);
+        return throttlePolicy;
+    }
+    
+    /**
+     * @brief Get throttle hit/miss counters
+     * @return Snapshot of the counters
+     */
+    ThrottleStats getThrottleStats() const {
+        std::lock_guard<std::mutex> lock(throttleMutex);
+        return throttleStats;
+    }
+    
+    /**
+     * @brief How long a username must wait before its next attempt is considered
+     * @param username Username
+     * @return Whole seconds to wait, 0 if an attempt would be admitted by its own limits
+     */
+    long long getRetryAfterSeconds(const std::string& username) {
+        std::lock_guard<std::mutex> lock(throttleMutex);
+        if (!throttlePolicy.enabled) {
+            return 0;
+        }
+        double now = monotonicSeconds();
+        ThrottleSlot* slot = findThrottleSlot(throttleKey(username), false, now);
+        if (!slot) {
+            return 0;
+        }
+        double wait = 0.0;
+        if (now < slot->lockedUntil) {
+            wait = slot->lockedUntil - now;
+        } else {
+            double tokens = slot->tokens + (now - slot->lastRefill) * throttlePolicy.userRatePerSecond;
+            if (tokens < 1.0 && throttlePolicy.userRatePerSecond > 0) {
+                wait = (1.0 - tokens) / throttlePolicy.userRatePerSecond;
+            }
+        }
+        return static_cast<long long>(std::ceil(wait));
+    }
+    
     /**
      * @brief Change user password
      * @param username Username
@@ -357,36 +1696,43 @@ public:
             return false;
         }
         
+        // Derive the new hash before taking the lock
+        uint32_t cost = getKdfIterations();
+        unsigned char newSalt[SALT_LENGTH];
+        generateSalt(newSalt, SALT_LENGTH);
+        unsigned char newHash[PASSWORD_HASH_LENGTH];
+        derivePasswordHash(newPassword, newSalt, cost, newHash);
+        
+        std::lock_guard<std::recursive_mutex> lock(credentialMutex);
+        auto it = credentialMap.find(username);
+        if (it == credentialMap.end()) {
+            return false;
+        }
+        
         // Get offset in secure memory
-        size_t offset = credentialMap[username];
+        size_t offset = it->second;
         
         // Make a copy of the encrypted block
         char block[CREDENTIAL_BLOCK_SIZE];
-        std::memcpy(block, secureMemory + offset, CREDENTIAL_BLOCK_SIZE);
+        std::memcpy(block, blockAt(offset), CREDENTIAL_BLOCK_SIZE);
         
         // Decrypt the block
         xorCrypt(reinterpret_cast<unsigned char*>(block), CREDENTIAL_BLOCK_SIZE);
         
-        // Generate new salt
-        unsigned char* salt = reinterpret_cast<unsigned char*>(
-            block + USERNAME_MAX_LENGTH + PASSWORD_HASH_LENGTH
-        );
-        generateSalt(salt, SALT_LENGTH);
-        
-        // Hash the new password
-        unsigned char* passwordHash = reinterpret_cast<unsigned char*>(
-            block + USERNAME_MAX_LENGTH
-        );
-        hashPassword(newPassword, salt, SALT_LENGTH, passwordHash, PASSWORD_HASH_LENGTH);
+        // Store new salt, hash and cost
+        std::memcpy(block + SALT_OFFSET, newSalt, SALT_LENGTH);
+        std::memcpy(block + HASH_OFFSET, newHash, PASSWORD_HASH_LENGTH);
+        std::memcpy(block + KDF_COST_OFFSET, &cost, KDF_COST_SIZE);
         
         // Re-encrypt the block
         xorCrypt(reinterpret_cast<unsigned char*>(block), CREDENTIAL_BLOCK_SIZE);
         
         // Store back in secure memory
-        std::memcpy(secureMemory + offset, block, CREDENTIAL_BLOCK_SIZE);
+        std::memcpy(blockAt(offset), block, CREDENTIAL_BLOCK_SIZE);
         
-        // Save credentials to file after password change
-        saveCredentials(authDataFile);
+        // Rewrite just this block on disk
+        persistBlock(offset);
+        commitStore();
         
         return true;
     }
@@ -397,6 +1743,7 @@ public:
      * @return True if deletion successful
      */
     bool deleteUser(const std::string& username) {
+        std::lock_guard<std::recursive_mutex> lock(credentialMutex);
         auto it = credentialMap.find(username);
         if (it == credentialMap.end()) {
             return false;
@@ -404,17 +1751,20 @@ public:
         
         size_t offset = it->second;
         
-        // Securely wipe the memory block
-        char* block = secureMemory + offset;
-        for (size_t i = 0; i < CREDENTIAL_BLOCK_SIZE; ++i) {
-            *(block + i) = 0;
-        }
+        // Securely wipe the memory block and make it reusable
+        releaseBlock(offset);
         
-        // Remove from map
+        // Remove from map and role index
         credentialMap.erase(it);
+        unindexRole(username);
         
-        // Save credentials to file after user deletion
-        saveCredentials(authDataFile);
+        // A deleted account must not keep working through an open session
+        revokeUserSessions(username);
+        
+        // Journal the removal, then overwrite the block on disk with the wiped copy
+        appendJournal(JOURNAL_DELETE, username, offset);
+        persistBlock(offset);
+        commitStore();
         
         return true;
     }
@@ -425,26 +1775,47 @@ public:
      * @return User type if found, -1 otherwise
      */
     int getUserType(const std::string& username) {
+        std::lock_guard<std::recursive_mutex> lock(credentialMutex);
+        auto it = roleOfUser.find(username);
+        return it == roleOfUser.end() ? -1 : it->second;
+    }
+    
+    /**
+     * @brief Change a user's type
+     * @param username Username
+     * @param userType New type (0 regular, 1 admin, 2 staff)
+     * @return True if the user exists and the type is valid
+     */
+    bool setUserType(const std::string& username, int userType) {
+        if (userType < 0 || userType > 2) {
+            return false;
+        }
+        
+        std::lock_guard<std::recursive_mutex> lock(credentialMutex);
         auto it = credentialMap.find(username);
         if (it == credentialMap.end()) {
-            return -1;
+            return false;
         }
         
-        size_t offset = it->second;
-        
-        // Make a copy of the encrypted block
         char block[CREDENTIAL_BLOCK_SIZE];
-        std::memcpy(block, secureMemory + offset, CREDENTIAL_BLOCK_SIZE);
-        
-        // Decrypt the block
+        std::memcpy(block, blockAt(it->second), CREDENTIAL_BLOCK_SIZE);
         xorCrypt(reinterpret_cast<unsigned char*>(block), CREDENTIAL_BLOCK_SIZE);
+        std::memcpy(block + USER_TYPE_OFFSET, &userType, USER_TYPE_SIZE);
+        xorCrypt(reinterpret_cast<unsigned char*>(block), CREDENTIAL_BLOCK_SIZE);
+        std::memcpy(blockAt(it->second), block, CREDENTIAL_BLOCK_SIZE);
+        persistBlock(it->second);
+        commitStore();
         
-        // Extract user type
-        const int* userTypePtr = reinterpret_cast<const int*>(
-            block + USERNAME_MAX_LENGTH + PASSWORD_HASH_LENGTH + SALT_LENGTH
-        );
+        indexRole(username, userType);
         
-        return *userTypePtr;
+        // Open sessions carry the role they were issued with
+        std::lock_guard<std::mutex> sessionLock(sessionMutex);
+        for (auto& session : sessions) {
+            if (session.second.username == username) {
+                session.second.userType = userType;
+            }
+        }
+        return true;
     }
     
     /**
@@ -453,6 +1824,7 @@ public:
      * @return True if username exists
      */
     bool userExists(const std::string& username) {
+        std::lock_guard<std::recursive_mutex> lock(credentialMutex);
         return credentialMap.find(username) != credentialMap.end();
     }
     
@@ -461,6 +1833,7 @@ public:
      * @return Number of registered users
      */
     size_t getUserCount() const {
+        std::lock_guard<std::recursive_mutex> lock(credentialMutex);
         return credentialMap.size();
     }
 
@@ -469,16 +1842,7 @@ public:
      * @return Vector of pairs containing username and user type for admin users
      */
     std::vector<std::pair<std::string, int>> getAdminUsers() {
-        std::vector<std::pair<std::string, int>> adminUsers;
-        
-        for (const auto& entry : credentialMap) {
-            int userType = getUserType(entry.first);
-            if (userType == 1) { // Admin user type
-                adminUsers.emplace_back(entry.first, userType);
-            }
-        }
-        
-        return adminUsers;
+        return usersWithRole(1);
     }
 
     /**
@@ -486,16 +1850,7 @@ public:
      * @return Vector of pairs containing username and user type for staff users
      */
     std::vector<std::pair<std::string, int>> getStaffUsers() {
-        std::vector<std::pair<std::string, int>> staffUsers;
-        
-        for (const auto& entry : credentialMap) {
-            int userType = getUserType(entry.first);
-            if (userType == 2) { // Staff user type
-                staffUsers.emplace_back(entry.first, userType);
-            }
-        }
-        
-        return staffUsers;
+        return usersWithRole(2);
     }
 
     /**
@@ -503,16 +1858,7 @@ public:
      * @return Vector of pairs containing username and user type for regular users
      */
     std::vector<std::pair<std::string, int>> getRegularUsers() {
-        std::vector<std::pair<std::string, int>> regularUsers;
-        
-        for (const auto& entry : credentialMap) {
-            int userType = getUserType(entry.first);
-            if (userType == 0) { // Regular user type
-                regularUsers.emplace_back(entry.first, userType);
-            }
-        }
-        
-        return regularUsers;
+        return usersWithRole(0);
     }
 
     /**
@@ -520,63 +1866,83 @@ public:
      * @return Vector of all registered usernames (no passwords exposed)
      */
     std::vector<std::string> getAllUsernames() {
-        std::vector<std::string> usernames;
-        
-        for (const auto& entry : credentialMap) {
-            usernames.push_back(entry.first);
+        std::lock_guard<std::recursive_mutex> lock(credentialMutex);
+        // Index is kept sorted alphabetically for display
+        return std::vector<std::string>(sortedUsernames.begin(), sortedUsernames.end());
+    }
+    
+    /**
+     * @brief Get one page of usernames in alphabetical order
+     * @param userType Role to list (0 regular, 1 admin, 2 staff), or -1 for all users
+     * @param after Cursor: return names strictly after this one ("" for the first page)
+     * @param limit Maximum number of names to return
+     * @return Usernames of the page; pass the last one as the next cursor
+     */
+    std::vector<std::string> getUsernamesPage(int userType, const std::string& after, size_t limit) {
+        std::lock_guard<std::recursive_mutex> lock(credentialMutex);
+        std::vector<std::string> page;
+        const std::set<std::string>* names = &sortedUsernames;
+        if (userType >= 0) {
+            auto it = usernamesByRole.find(userType);
+            if (it == usernamesByRole.end()) {
+                return page;
+            }
+            names = &it->second;
         }
-        
-        // Sort usernames alphabetically for better display
-        std::sort(usernames.begin(), usernames.end());
-        
-        return usernames;
+        auto it = after.empty() ? names->begin() : names->upper_bound(after);
+        for (; it != names->end() && page.size() < limit; ++it) {
+            page.push_back(*it);
+        }
+        return page;
+    }
+    
+    /**
+     * @brief Count users with a given role
+     * @param userType Role, or -1 for all users
+     * @return Number of users
+     */
+    size_t getUserCountByType(int userType) {
+        std::lock_guard<std::recursive_mutex> lock(credentialMutex);
+        if (userType < 0) {
+            return sortedUsernames.size();
+        }
+        auto it = usernamesByRole.find(userType);
+        return it == usernamesByRole.end() ? 0 : it->second.size();
     }
 
     /**
-     * @brief Save credentials to a file
+     * @brief Save a full snapshot of the credentials to a file
+     *
+     * Day-to-day changes are persisted incrementally; this writes the whole store
+     * (and its compact journal) to filePath, e.g. for backups.
      * @param filePath Path to save file
      * @return True if save successful
      */
     bool saveCredentials(const std::string& filePath) {
-        std::cout << "[SAVE] saveCredentials called for: " << filePath << std::endl;
-        std::cout << "[SAVE] keySize=" << keySize << ", mapSize=" << credentialMap.size() << std::endl;
-        
-        std::ofstream file(filePath, std::ios::binary);
-        if (!file) {
-            std::cout << "[SAVE] Failed to open file for writing!" << std::endl;
-            return false;
+        std::lock_guard<std::recursive_mutex> lock(credentialMutex);
+#ifdef DEBUG
+        std::cout << "[SAVE] saveCredentials called for: " << filePath
+                  << " (users=" << credentialMap.size() << ")" << std::endl;
+#endif
+        
+        bool isOwnStore = filePath == authDataFile;
+        if (isOwnStore) {
+            closeStore(); // handles would point at the replaced file
         }
-        
-        // Write memory size
-        file.write(reinterpret_cast<const char*>(&memorySize), sizeof(memorySize));
-        
-        // Write key size
-        file.write(reinterpret_cast<const char*>(&keySize), sizeof(keySize));
-        
-        // Write encryption key
-        file.write(reinterpret_cast<const char*>(encryptionKey), keySize);
-        
-        // Write secure memory
-        file.write(secureMemory, memorySize);
-        
-        // Write map size
-        size_t mapSize = credentialMap.size();
-        file.write(reinterpret_cast<const char*>(&mapSize), sizeof(mapSize));
-        
-        // Write map entries
-        for (const auto& entry : credentialMap) {
-            size_t usernameLength = entry.first.length();
-            file.write(reinterpret_cast<const char*>(&usernameLength), sizeof(usernameLength));
-            file.write(entry.first.c_str(), usernameLength);
-            file.write(reinterpret_cast<const char*>(&entry.second), sizeof(entry.second));
+        bool saved = writeSnapshot(filePath);
+        if (isOwnStore && saved) {
+            journalRecords = credentialMap.size();
+            attachStore();
         }
-        
-        std::cout << "[SAVE] File saved successfully!" << std::endl;
-        return true;
+        return saved;
     }
     
     /**
      * @brief Load credentials from a file
+     *
+     * Accepts the incremental store format and the original full-dump format.
+     * Whatever is loaded becomes the content of this module's own data file
+     * (older formats are migrated on the spot).
      * @param filePath Path to load file
      * @return True if load successful
      */
@@ -588,66 +1954,181 @@ public:
         }
         
         // Temporary variables to load into first
-        size_t tempMemorySize, tempKeySize;
+        size_t tempMemorySize = 0, tempKeySize = 0;
         unsigned char* tempEncryptionKey = nullptr;
-        char* tempSecureMemory = nullptr;
+        std::vector<char*> tempSlabs;
         std::unordered_map<std::string, size_t> tempCredentialMap;
+        size_t tempJournalRecords = 0;
+        bool incrementalFormat = false;
+        bool journalRebuilt = false;
         
         try {
-            // Read memory size
-            file.read(reinterpret_cast<char*>(&tempMemorySize), sizeof(tempMemorySize));
-            if (file.fail()) throw std::runtime_error("Failed to read memory size");
+            uint32_t magic = 0;
+            file.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+            if (file.fail()) throw std::runtime_error("Failed to read header");
             
-            // Read key size
-            file.read(reinterpret_cast<char*>(&tempKeySize), sizeof(tempKeySize));
-            if (file.fail()) throw std::runtime_error("Failed to read key size");
-            
-            // Validate loaded key size
-            if (tempKeySize == 0 || tempKeySize > 256) {
-                throw std::runtime_error("Invalid key size in file - file may be corrupted");
+            if (magic == STORE_MAGIC) {
+                incrementalFormat = true;
+                
+                // Fixed header: magic, version, key size, key
+                uint32_t version = 0;
+                file.read(reinterpret_cast<char*>(&version), sizeof(version));
+                file.read(reinterpret_cast<char*>(&tempKeySize), sizeof(tempKeySize));
+                if (file.fail() || version != STORE_VERSION) {
+                    throw std::runtime_error("Unsupported credential store version");
+                }
+                if (tempKeySize == 0 || tempKeySize > MAX_KEY_SIZE) {
+                    throw std::runtime_error("Invalid key size in file - file may be corrupted");
+                }
+                tempEncryptionKey = new unsigned char[tempKeySize];
+                file.read(reinterpret_cast<char*>(tempEncryptionKey), tempKeySize);
+                if (file.fail()) throw std::runtime_error("Failed to read encryption key");
+                
+                // Blocks run from the end of the header to the end of the file
+                file.seekg(static_cast<std::streamoff>(STORE_HEADER_BYTES));
+                if (file.fail()) throw std::runtime_error("Truncated credential store");
+                tempMemorySize = readSlabs(file, static_cast<size_t>(-1), tempSlabs);
+            } else {
+                // Original format: memory size, key size, key, memory, map
+                file.seekg(0);
+                file.read(reinterpret_cast<char*>(&tempMemorySize), sizeof(tempMemorySize));
+                if (file.fail()) throw std::runtime_error("Failed to read memory size");
+                
+                file.read(reinterpret_cast<char*>(&tempKeySize), sizeof(tempKeySize));
+                if (file.fail()) throw std::runtime_error("Failed to read key size");
+                
+                if (tempKeySize == 0 || tempKeySize > MAX_KEY_SIZE) {
+                    throw std::runtime_error("Invalid key size in file - file may be corrupted");
+                }
+                
+                tempEncryptionKey = new unsigned char[tempKeySize];
+                file.read(reinterpret_cast<char*>(tempEncryptionKey), tempKeySize);
+                if (file.fail()) throw std::runtime_error("Failed to read encryption key");
+                
+                if (readSlabs(file, tempMemorySize, tempSlabs) != tempMemorySize) {
+                    throw std::runtime_error("Failed to read secure memory");
+                }
+                
+                size_t mapSize;
+                file.read(reinterpret_cast<char*>(&mapSize), sizeof(mapSize));
+                if (file.fail()) throw std::runtime_error("Failed to read map size");
+                
+                for (size_t i = 0; i < mapSize; ++i) {
+                    size_t usernameLength;
+                    file.read(reinterpret_cast<char*>(&usernameLength), sizeof(usernameLength));
+                    if (file.fail() || usernameLength > MAX_RECORD_NAME_LENGTH) {
+                        throw std::runtime_error("Failed to read username length");
+                    }
+                    
+                    std::string username(usernameLength, '\0');
+                    file.read(&username[0], usernameLength);
+                    if (file.fail()) throw std::runtime_error("Failed to read username");
+                    
+                    size_t offset;
+                    file.read(reinterpret_cast<char*>(&offset), sizeof(offset));
+                    if (file.fail()) throw std::runtime_error("Failed to read offset");
+                    
+                    tempCredentialMap[username] = offset;
+                }
             }
+            size_t tempHighWater = (tempMemorySize / CREDENTIAL_BLOCK_SIZE) * CREDENTIAL_BLOCK_SIZE;
             
-            // Read encryption key
-            tempEncryptionKey = new unsigned char[tempKeySize];
-            file.read(reinterpret_cast<char*>(tempEncryptionKey), tempKeySize);
-            if (file.fail()) throw std::runtime_error("Failed to read encryption key");
-            
-            // Read secure memory
-            tempSecureMemory = new char[tempMemorySize];
-            file.read(tempSecureMemory, tempMemorySize);
-            if (file.fail()) throw std::runtime_error("Failed to read secure memory");
+            if (incrementalFormat) {
+                std::ifstream journal(journalPath(filePath), std::ios::binary);
+                if (journal) {
+                    // Replay map changes. Only a torn record at the tail (or an
+                    // impossible length) ends replay; a complete record with an
+                    // unknown op is skipped, and names too long for a block are
+                    // left to the owner check below.
+                    while (true) {
+                        char op;
+                        size_t offset, usernameLength;
+                        journal.read(&op, 1);
+                        journal.read(reinterpret_cast<char*>(&offset), sizeof(offset));
+                        journal.read(reinterpret_cast<char*>(&usernameLength), sizeof(usernameLength));
+                        if (!journal || usernameLength > MAX_RECORD_NAME_LENGTH) {
+                            break;
+                        }
+                        std::string username(usernameLength, '\0');
+                        journal.read(&username[0], usernameLength);
+                        if (!journal) {
+                            break;
+                        }
+                        ++tempJournalRecords;
+                        if (op == JOURNAL_PUT) {
+                            tempCredentialMap[username] = offset;
+                        } else if (op == JOURNAL_DELETE) {
+                            tempCredentialMap.erase(username);
+                        } else {
+#ifdef DEBUG
+                            std::cout << "[LOAD] skipped journal record with op " << static_cast<int>(op) << std::endl;
+#endif
+                        }
+                    }
+                } else {
+                    // Journal lost: blocks carry their username, so rebuild from them
+                    journalRebuilt = true;
+                    for (size_t offset = 0; offset < tempHighWater; offset += CREDENTIAL_BLOCK_SIZE) {
+                        const char* block = tempSlabs[offset / SLAB_BYTES] + (offset % SLAB_BYTES);
+                        std::string owner = blockOwner(block, tempEncryptionKey, tempKeySize);
+                        if (!owner.empty()) {
+                            tempCredentialMap[owner] = offset;
+                        }
+                    }
+                }
+            }
             
-            // Read map size
-            size_t mapSize;
-            file.read(reinterpret_cast<char*>(&mapSize), sizeof(mapSize));
-            if (file.fail()) throw std::runtime_error("Failed to read map size");
+            // Keep only mappings whose block actually holds that username. Files
+            // written before the free-list could map two users to one block (a
+            // registration after a deletion overwrote a live block). Builds that
+            // accepted over-long names stored them cut to the field; such users
+            // are kept under the stored name, the only one that round-trips.
+            std::vector<std::pair<std::string, size_t>> renamed;
+            for (auto it = tempCredentialMap.begin(); it != tempCredentialMap.end();) {
+                size_t offset = it->second;
+                std::string owner;
+                if (offset % CREDENTIAL_BLOCK_SIZE == 0 && offset + CREDENTIAL_BLOCK_SIZE <= tempHighWater) {
+                    owner = blockOwner(tempSlabs[offset / SLAB_BYTES] + (offset % SLAB_BYTES),
+                                       tempEncryptionKey, tempKeySize);
+                }
+                if (!owner.empty() && owner == it->first) {
+                    ++it;
+                    continue;
+                }
+                if (!owner.empty() && !isStorableUsername(it->first) && owner.size() == USERNAME_MAX_LENGTH - 1 &&
+                    it->first.compare(0, owner.size(), owner) == 0) {
+                    renamed.emplace_back(owner, offset);
+                }
+                it = tempCredentialMap.erase(it);
+            }
+            for (const auto& entry : renamed) {
+#ifdef DEBUG
+                std::cout << "[LOAD] over-long username kept as: " << entry.first << std::endl;
+#endif
+                tempCredentialMap.emplace(entry.first, entry.second);
+            }
             
-            // Read map entries
-            for (size_t i = 0; i < mapSize; ++i) {
-                size_t usernameLength;
-                file.read(reinterpret_cast<char*>(&usernameLength), sizeof(usernameLength));
-                if (file.fail()) throw std::runtime_error("Failed to read username length");
-                
-                std::string username(usernameLength, '\0');
-                file.read(&username[0], usernameLength);
-                if (file.fail()) throw std::runtime_error("Failed to read username");
-                
-                size_t offset;
-                file.read(reinterpret_cast<char*>(&offset), sizeof(offset));
-                if (file.fail()) throw std::runtime_error("Failed to read offset");
-                
-                tempCredentialMap[username] = offset;
+            // Every handed-out block not owned by a user is free for reuse
+            std::vector<bool> inUse(tempHighWater / CREDENTIAL_BLOCK_SIZE, false);
+            for (const auto& entry : tempCredentialMap) {
+                inUse[entry.second / CREDENTIAL_BLOCK_SIZE] = true;
+            }
+            std::vector<size_t> tempFreeBlocks;
+            for (size_t b = inUse.size(); b-- > 0;) {
+                if (!inUse[b]) {
+                    char* block = tempSlabs[(b * CREDENTIAL_BLOCK_SIZE) / SLAB_BYTES] +
+                                  ((b * CREDENTIAL_BLOCK_SIZE) % SLAB_BYTES);
+                    secureWipe(block, CREDENTIAL_BLOCK_SIZE);
+                    tempFreeBlocks.push_back(b * CREDENTIAL_BLOCK_SIZE);
+                }
             }
             
             // If we get here, loading was successful - now update the actual data
+            std::lock_guard<std::recursive_mutex> lock(credentialMutex);
+            closeStore();
             
             // Clean up existing data
-            if (secureMemory) {
-                for (size_t i = 0; i < memorySize; ++i) {
-                    *(secureMemory + i) = 0;
-                }
-                delete[] secureMemory;
-            }
+            releaseSlabs(slabs);
             
             if (encryptionKey) {
                 for (size_t i = 0; i < keySize; ++i) {
@@ -657,11 +2138,27 @@ public:
             }
             
             // Replace with loaded data
-            memorySize = tempMemorySize;
+            slabs = std::move(tempSlabs);
+            memorySize = slabs.size() * SLAB_BYTES;
+            highWaterMark = tempHighWater;
+            freeBlocks = std::move(tempFreeBlocks);
             keySize = tempKeySize;
             encryptionKey = tempEncryptionKey;
-            secureMemory = tempSecureMemory;
             credentialMap = std::move(tempCredentialMap);
+            rebuildRoleIndex();
+            if (slabs.empty()) {
+                addSlab();
+            }
+            
+            // Reuse our own store in place; anything else is snapshotted into it.
+            // A rebuilt map is written out first, or the next load would find
+            // the empty journal attachStore() creates and lose every user.
+            if (incrementalFormat && filePath == authDataFile &&
+                (!journalRebuilt || writeJournalSnapshot(journalPath(authDataFile))) && attachStore()) {
+                journalRecords = journalRebuilt ? credentialMap.size() : tempJournalRecords;
+            } else {
+                ensureStore();
+            }
             
             return true;
             
@@ -673,12 +2170,7 @@ public:
                 }
                 delete[] tempEncryptionKey;
             }
-            if (tempSecureMemory) {
-                for (size_t i = 0; i < tempMemorySize; ++i) {
-                    *(tempSecureMemory + i) = 0;
-                }
-                delete[] tempSecureMemory;
-            }
+            releaseSlabs(tempSlabs);
             
             return false;
         }
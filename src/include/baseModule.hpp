@@ -8,6 +8,7 @@
 #include <stdexcept>
 #include <string>
 #include <functional>
+#include <cstdint>
 
 /**
  * @brief Base template class for entity modules with common CRUD operations
@@ -188,6 +189,43 @@ protected:
             file.write(str.c_str(), len);
         }
     }
+
+    /**
+     * @brief Marker written before the record count of versioned data files
+     *
+     * Files written before versioning start directly with the record count, so a
+     * leading marker (an impossible count) is enough to tell the two layouts apart.
+     */
+    static constexpr uint32_t FORMAT_MAGIC = 0x464F494D; // "MIOF"
+
+    /**
+     * @brief Write the versioned file header
+     * @param file Output file stream
+     * @param version Format version of the records that follow
+     */
+    void writeFormatHeader(std::ofstream& file, uint32_t version) {
+        writeBinary(file, FORMAT_MAGIC);
+        writeBinary(file, version);
+    }
+
+    /**
+     * @brief Read the versioned file header if present
+     * @param file Input file stream positioned at the start of the file
+     * @return Format version, or 0 for legacy files (stream is rewound)
+     */
+    uint32_t readFormatVersion(std::ifstream& file) {
+        std::streampos start = file.tellg();
+        uint32_t magic = 0;
+        readBinary(file, magic);
+        if (file && magic == FORMAT_MAGIC) {
+            uint32_t version = 0;
+            readBinary(file, version);
+            return version;
+        }
+        file.clear();
+        file.seekg(start);
+        return 0;
+    }
 };
 
 
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <vector>
+#include <mutex>
+#include <utility>
+#include <functional>
+
+/**
+ * @brief Synchronous change notifications for one entity type
+ *
+ * Modules publish every change as a pair of deltas: the old image of the
+ * entity with direction -1 and the new image with direction +1 (creation
+ * publishes only +1, deletion only -1). A subscriber that keeps aggregates
+ * can therefore apply each event in O(1) without re-reading the module,
+ * the same way PaymentModule maintains its rollups.
+ *
+ * Listeners run on the publishing thread, possibly while the module holds
+ * its own lock, so they must be quick and must not call back into
+ * subscribe/unsubscribe. unsubscribe waits for deliveries in progress.
+ */
+template <typename Entity>
+class ChangeFeed {
+public:
+    using Listener = std::function<void(const Entity&, int direction)>;
+
+    ChangeFeed() = default;
+    ChangeFeed(const ChangeFeed&) = delete;
+    ChangeFeed& operator=(const ChangeFeed&) = delete;
+
+    /**
+     * @brief Register a listener
+     * @return Token for unsubscribe
+     */
+    int subscribe(Listener listener) {
+        std::lock_guard<std::mutex> lock(feedMutex);
+        listeners.emplace_back(++lastToken, std::move(listener));
+        return lastToken;
+    }
+
+    /**
+     * @brief Remove a listener
+     * @return true if the token was registered
+     */
+    bool unsubscribe(int token) {
+        std::lock_guard<std::mutex> lock(feedMutex);
+        for (auto it = listeners.begin(); it != listeners.end(); ++it) {
+            if (it->first == token) {
+                listeners.erase(it);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool hasListeners() const {
+        std::lock_guard<std::mutex> lock(feedMutex);
+        return !listeners.empty();
+    }
+
+    /**
+     * @brief Deliver one delta to every listener
+     * @param entity Entity image
+     * @param direction +1 to add the image, -1 to retract it
+     */
+    void publish(const Entity& entity, int direction) const {
+        std::lock_guard<std::mutex> lock(feedMutex);
+        for (const auto& listener : listeners) {
+            listener.second(entity, direction);
+        }
+    }
+
+private:
+    mutable std::mutex feedMutex;
+    std::vector<std::pair<int, Listener>> listeners;
+    int lastToken = 0;
+};
@@ -0,0 +1,701 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <array>
+#include <unordered_map>
+#include <fstream>
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace Columnar {
+
+    /**
+     * @brief Storage type of a column; every column is stored as int64 values
+     */
+    enum class ColumnType : uint32_t {
+        INT64 = 1,      // Plain integers (IDs, ratings, minor currency units)
+        STRING = 2,     // Codes into the column's dictionary
+        TIMESTAMP = 3   // Packed local time YYYYMMDDhhmmss, 0 if unknown
+    };
+
+    /**
+     * @brief Calendar bucket applied to a TIMESTAMP group-by column
+     */
+    enum class Bucket { NONE, DAY, MONTH, YEAR };
+
+    constexpr uint32_t BLOCK_ROWS = 65536;
+    constexpr char MAGIC[8] = {'M', 'U', 'S', 'E', 'C', 'O', 'L', '1'};
+
+    /**
+     * @brief Pack an ISO 8601 timestamp into YYYYMMDDhhmmss
+     *
+     * Only the digit positions are read, so this is a handful of integer
+     * operations per value. Missing trailing fields are filled with zeros, or
+     * with 99 when packing the upper bound of a range ("2030-12" as an upper
+     * bound covers the whole of December).
+     *
+     * @return Packed value, or 0 if the text does not start with a date
+     */
+    inline int64_t packTimestamp(std::string_view iso, bool upperBound = false) {
+        static const size_t positions[] = {0, 5, 8, 11, 14, 17};
+        static const int widths[] = {4, 2, 2, 2, 2, 2};
+        int64_t packed = 0;
+        for (int field = 0; field < 6; ++field) {
+            size_t start = positions[field];
+            int value = 0;
+            bool present = iso.size() >= start + widths[field];
+            for (int i = 0; present && i < widths[field]; ++i) {
+                char c = iso[start + i];
+                if (c < '0' || c > '9') {
+                    present = false;
+                }
+                value = value * 10 + (c - '0');
+            }
+            if (!present) {
+                if (field == 0) {
+                    return 0;
+                }
+                value = upperBound ? 99 : 0;
+            }
+            packed = packed * (field == 0 ? 1 : 100) + value;
+        }
+        return packed;
+    }
+
+    /**
+     * @brief Render a packed timestamp at a bucket's resolution
+     */
+    inline std::string formatBucket(int64_t value, Bucket bucket) {
+        char text[64];
+        switch (bucket) {
+            case Bucket::YEAR:
+                std::snprintf(text, sizeof(text), "%04lld", static_cast<long long>(value));
+                break;
+            case Bucket::MONTH:
+                std::snprintf(text, sizeof(text), "%04lld-%02lld", static_cast<long long>(value / 100),
+                              static_cast<long long>(value % 100));
+                break;
+            case Bucket::DAY:
+                std::snprintf(text, sizeof(text), "%04lld-%02lld-%02lld", static_cast<long long>(value / 10000),
+                              static_cast<long long>(value / 100 % 100), static_cast<long long>(value % 100));
+                break;
+            default:
+                std::snprintf(text, sizeof(text), "%04lld-%02lld-%02lldT%02lld:%02lld:%02lld",
+                              static_cast<long long>(value / 10000000000LL), static_cast<long long>(value / 100000000 % 100),
+                              static_cast<long long>(value / 1000000 % 100), static_cast<long long>(value / 10000 % 100),
+                              static_cast<long long>(value / 100 % 100), static_cast<long long>(value % 100));
+        }
+        return text;
+    }
+
+    inline int64_t applyBucket(int64_t value, Bucket bucket) {
+        switch (bucket) {
+            case Bucket::DAY: return value / 1000000;
+            case Bucket::MONTH: return value / 100000000;
+            case Bucket::YEAR: return value / 10000000000LL;
+            default: return value;
+        }
+    }
+
+    /**
+     * @brief Collects one table's rows column by column before writing
+     */
+    class TableBuilder {
+    public:
+        TableBuilder(const std::string& name, const std::vector<std::pair<std::string, ColumnType>>& columns)
+            : name(name), columns(columns), values(columns.size()), dictionaries(columns.size()), codes(columns.size()) {}
+
+        void appendInt(size_t column, int64_t value) {
+            values[column].push_back(value);
+        }
+
+        void appendString(size_t column, const std::string& value) {
+            auto inserted = codes[column].emplace(value, static_cast<int64_t>(dictionaries[column].size()));
+            if (inserted.second) {
+                dictionaries[column].push_back(value);
+            }
+            values[column].push_back(inserted.first->second);
+        }
+
+        void appendTimestamp(size_t column, const std::string& iso) {
+            values[column].push_back(packTimestamp(iso));
+        }
+
+        uint64_t rowCount() const {
+            return values.empty() ? 0 : values[0].size();
+        }
+
+    private:
+        friend bool writeSnapshot(const std::string&, const std::vector<const TableBuilder*>&);
+
+        std::string name;
+        std::vector<std::pair<std::string, ColumnType>> columns;
+        std::vector<std::vector<int64_t>> values;
+        std::vector<std::vector<std::string>> dictionaries;
+        std::vector<std::unordered_map<std::string, int64_t>> codes;
+    };
+
+    namespace detail {
+        inline void writeU32(std::ofstream& out, uint32_t value) { out.write(reinterpret_cast<const char*>(&value), sizeof(value)); }
+        inline void writeU64(std::ofstream& out, uint64_t value) { out.write(reinterpret_cast<const char*>(&value), sizeof(value)); }
+        inline void writeI64(std::ofstream& out, int64_t value) { out.write(reinterpret_cast<const char*>(&value), sizeof(value)); }
+        inline void writeString(std::ofstream& out, const std::string& value) {
+            writeU32(out, static_cast<uint32_t>(value.size()));
+            out.write(value.data(), value.size());
+        }
+    }
+
+    /**
+     * @brief Write tables to a snapshot file
+     *
+     * Layout: magic, then every column as a contiguous little-endian int64
+     * array (8-byte aligned, so a mapped file can be read in place), then a
+     * directory describing tables, columns, dictionaries and per-block
+     * min/max, then the directory offset and the magic again.
+     *
+     * @return false if the file could not be written
+     */
+    inline bool writeSnapshot(const std::string& path, const std::vector<const TableBuilder*>& tables) {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            return false;
+        }
+        out.write(MAGIC, sizeof(MAGIC));
+        uint64_t offset = sizeof(MAGIC);
+        std::vector<std::vector<uint64_t>> offsets;
+        for (const auto* table : tables) {
+            offsets.emplace_back();
+            for (const auto& column : table->values) {
+                offsets.back().push_back(offset);
+                out.write(reinterpret_cast<const char*>(column.data()), static_cast<std::streamsize>(column.size() * sizeof(int64_t)));
+                offset += column.size() * sizeof(int64_t);
+            }
+        }
+
+        uint64_t directory = offset;
+        detail::writeU32(out, static_cast<uint32_t>(tables.size()));
+        for (size_t t = 0; t < tables.size(); ++t) {
+            const TableBuilder& table = *tables[t];
+            uint64_t rows = table.rowCount();
+            detail::writeString(out, table.name);
+            detail::writeU64(out, rows);
+            detail::writeU32(out, BLOCK_ROWS);
+            detail::writeU32(out, static_cast<uint32_t>(table.columns.size()));
+            for (size_t c = 0; c < table.columns.size(); ++c) {
+                const auto& column = table.values[c];
+                detail::writeString(out, table.columns[c].first);
+                detail::writeU32(out, static_cast<uint32_t>(table.columns[c].second));
+                detail::writeU64(out, offsets[t][c]);
+                detail::writeU32(out, static_cast<uint32_t>(table.dictionaries[c].size()));
+                for (const auto& entry : table.dictionaries[c]) {
+                    detail::writeString(out, entry);
+                }
+                for (uint64_t start = 0; start < rows; start += BLOCK_ROWS) {
+                    auto first = column.begin() + static_cast<std::ptrdiff_t>(start);
+                    auto last = column.begin() + static_cast<std::ptrdiff_t>(std::min<uint64_t>(rows, start + BLOCK_ROWS));
+                    auto range = std::minmax_element(first, last);
+                    detail::writeI64(out, *range.first);
+                    detail::writeI64(out, *range.second);
+                }
+            }
+        }
+        detail::writeU64(out, directory);
+        out.write(MAGIC, sizeof(MAGIC));
+        return out.good();
+    }
+
+    /**
+     * @brief Read-only view of a snapshot file
+     *
+     * The file is memory-mapped where available, so only the pages of the
+     * columns a query touches are read from disk.
+     */
+    class Snapshot {
+    public:
+        struct Column {
+            std::string name;
+            ColumnType type;
+            uint64_t offset;
+            std::vector<std::string> dictionary;
+            std::vector<int64_t> blockMin;
+            std::vector<int64_t> blockMax;
+        };
+
+        struct Table {
+            std::string name;
+            uint64_t rows = 0;
+            uint32_t blockRows = BLOCK_ROWS;
+            std::vector<Column> columns;
+
+            const Column* column(const std::string& columnName) const {
+                for (const auto& entry : columns) {
+                    if (entry.name == columnName) return &entry;
+                }
+                return nullptr;
+            }
+        };
+
+        Snapshot() = default;
+        Snapshot(const Snapshot&) = delete;
+        Snapshot& operator=(const Snapshot&) = delete;
+
+        ~Snapshot() {
+            close();
+        }
+
+        /**
+         * @brief Open and validate a snapshot
+         * @return false if the file is missing or malformed
+         */
+        bool open(const std::string& path) {
+            close();
+            #ifndef _WIN32
+            int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0) {
+                return false;
+            }
+            struct stat info;
+            if (fstat(fd, &info) == 0 && info.st_size > 0) {
+                void* mapped = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+                if (mapped != MAP_FAILED) {
+                    base = static_cast<const char*>(mapped);
+                    size = static_cast<size_t>(info.st_size);
+                    mappedLength = size;
+                }
+            }
+            ::close(fd);
+            #endif
+            if (!base) {
+                std::ifstream in(path, std::ios::binary);
+                if (!in.is_open()) {
+                    return false;
+                }
+                buffer.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+                base = buffer.data();
+                size = buffer.size();
+            }
+            if (!parseDirectory()) {
+                close();
+                return false;
+            }
+            return true;
+        }
+
+        void close() {
+            #ifndef _WIN32
+            if (mappedLength > 0) {
+                munmap(const_cast<char*>(base), mappedLength);
+            }
+            #endif
+            mappedLength = 0;
+            base = nullptr;
+            size = 0;
+            buffer.clear();
+            tables.clear();
+        }
+
+        const std::vector<Table>& getTables() const { return tables; }
+
+        const Table* table(const std::string& name) const {
+            for (const auto& entry : tables) {
+                if (entry.name == name) return &entry;
+            }
+            return nullptr;
+        }
+
+        /**
+         * @brief Values of a column, valid while the snapshot is open
+         */
+        const int64_t* values(const Column& column) const {
+            return reinterpret_cast<const int64_t*>(base + column.offset);
+        }
+
+    private:
+        const char* base = nullptr;
+        size_t size = 0;
+        size_t mappedLength = 0;
+        std::vector<char> buffer;
+        std::vector<Table> tables;
+
+        bool parseDirectory() {
+            if (size < 2 * sizeof(MAGIC) + sizeof(uint64_t) || std::memcmp(base, MAGIC, sizeof(MAGIC)) != 0 ||
+                std::memcmp(base + size - sizeof(MAGIC), MAGIC, sizeof(MAGIC)) != 0) {
+                return false;
+            }
+            uint64_t directory;
+            std::memcpy(&directory, base + size - sizeof(MAGIC) - sizeof(uint64_t), sizeof(directory));
+            size_t end = size - sizeof(MAGIC) - sizeof(uint64_t);
+            if (directory < sizeof(MAGIC) || directory > end) {
+                return false;
+            }
+            size_t cursor = static_cast<size_t>(directory);
+            auto read = [&](void* target, size_t bytes) {
+                if (cursor + bytes > end) return false;
+                std::memcpy(target, base + cursor, bytes);
+                cursor += bytes;
+                return true;
+            };
+            auto readString = [&](std::string& value) {
+                uint32_t length;
+                if (!read(&length, sizeof(length)) || cursor + length > end) return false;
+                value.assign(base + cursor, length);
+                cursor += length;
+                return true;
+            };
+
+            uint32_t tableCount;
+            if (!read(&tableCount, sizeof(tableCount))) return false;
+            for (uint32_t t = 0; t < tableCount; ++t) {
+                Table table;
+                uint32_t columnCount;
+                if (!readString(table.name) || !read(&table.rows, sizeof(table.rows)) ||
+                    !read(&table.blockRows, sizeof(table.blockRows)) || !read(&columnCount, sizeof(columnCount)) ||
+                    table.blockRows == 0) {
+                    return false;
+                }
+                uint64_t blocks = (table.rows + table.blockRows - 1) / table.blockRows;
+                for (uint32_t c = 0; c < columnCount; ++c) {
+                    Column column;
+                    uint32_t type, dictionarySize;
+                    if (!readString(column.name) || !read(&type, sizeof(type)) || !read(&column.offset, sizeof(column.offset)) ||
+                        !read(&dictionarySize, sizeof(dictionarySize))) {
+                        return false;
+                    }
+                    column.type = static_cast<ColumnType>(type);
+                    if (column.offset % sizeof(int64_t) != 0 || column.offset + table.rows * sizeof(int64_t) > directory) {
+                        return false;
+                    }
+                    column.dictionary.resize(dictionarySize);
+                    for (auto& entry : column.dictionary) {
+                        if (!readString(entry)) return false;
+                    }
+                    column.blockMin.resize(blocks);
+                    column.blockMax.resize(blocks);
+                    for (uint64_t b = 0; b < blocks; ++b) {
+                        if (!read(&column.blockMin[b], sizeof(int64_t)) || !read(&column.blockMax[b], sizeof(int64_t))) {
+                            return false;
+                        }
+                    }
+                    table.columns.push_back(std::move(column));
+                }
+                tables.push_back(std::move(table));
+            }
+            return true;
+        }
+    };
+
+    struct GroupBy {
+        std::string column;
+        Bucket bucket = Bucket::NONE;
+    };
+
+    /**
+     * @brief Parse a "by=" list: column[:day|:month|:year],...
+     *
+     * Used by the snapshotQuery tool and QueryEngine::parseQuery. Whether a
+     * bucket fits the column's type is checked when the query is run.
+     *
+     * @return false with error set if an item is empty or names an unknown bucket
+     */
+    inline bool parseGroupBy(const std::string& list, std::vector<GroupBy>& groups, std::string& error) {
+        size_t start = 0;
+        while (true) {
+            size_t comma = list.find(',', start);
+            std::string item = list.substr(start, comma == std::string::npos ? std::string::npos : comma - start);
+            GroupBy group;
+            size_t colon = item.find(':');
+            group.column = item.substr(0, colon);
+            std::string bucket = colon == std::string::npos ? "" : item.substr(colon + 1);
+            if (bucket == "day") group.bucket = Bucket::DAY;
+            else if (bucket == "month") group.bucket = Bucket::MONTH;
+            else if (bucket == "year") group.bucket = Bucket::YEAR;
+            else if (!bucket.empty() || colon != std::string::npos) group.column.clear();
+            if (group.column.empty()) {
+                error = "bad group-by: " + item;
+                return false;
+            }
+            groups.push_back(group);
+            if (comma == std::string::npos) {
+                return true;
+            }
+            start = comma + 1;
+        }
+    }
+
+    /**
+     * @brief Group key of up to three bucketed column values
+     */
+    using GroupKey = std::array<int64_t, 3>;
+
+    struct GroupKeyHash {
+        size_t operator()(const GroupKey& key) const {
+            uint64_t hash = 1469598103934665603ULL;
+            for (int64_t part : key) {
+                hash = (hash ^ static_cast<uint64_t>(part)) * 1099511628211ULL;
+            }
+            return static_cast<size_t>(hash);
+        }
+    };
+
+    /**
+     * @brief Keep the selected rows of a block that pass one comparison
+     *
+     * Op is either engine's Filter::Op. The operator is chosen once per
+     * call, so each loop is a single compare and a branch-free store.
+     *
+     * @return Number of rows still selected
+     */
+    template <typename T, typename Op>
+    uint32_t narrowSelection(const T* data, Op op, T value, uint32_t* selection, uint32_t selected) {
+        uint32_t kept = 0;
+        switch (op) {
+            case Op::EQ: for (uint32_t i = 0; i < selected; ++i) { selection[kept] = selection[i]; kept += data[selection[i]] == value; } break;
+            case Op::NE: for (uint32_t i = 0; i < selected; ++i) { selection[kept] = selection[i]; kept += data[selection[i]] != value; } break;
+            case Op::LT: for (uint32_t i = 0; i < selected; ++i) { selection[kept] = selection[i]; kept += data[selection[i]] < value; } break;
+            case Op::LE: for (uint32_t i = 0; i < selected; ++i) { selection[kept] = selection[i]; kept += data[selection[i]] <= value; } break;
+            case Op::GT: for (uint32_t i = 0; i < selected; ++i) { selection[kept] = selection[i]; kept += data[selection[i]] > value; } break;
+            case Op::GE: for (uint32_t i = 0; i < selected; ++i) { selection[kept] = selection[i]; kept += data[selection[i]] >= value; } break;
+        }
+        return kept;
+    }
+
+    /**
+     * @brief How a group-by column's key values are shown and ordered
+     */
+    struct KeyFormat {
+        enum Kind { NUMBER, TEXT, TIME };
+        Kind kind = NUMBER;
+        const std::vector<std::string>* dictionary = nullptr; // TEXT only
+        Bucket bucket = Bucket::NONE;                           // TIME only
+    };
+
+    /**
+     * @brief Fill a result row's rawKeys and display keys from a group key
+     */
+    template <typename Row>
+    void setGroupKeys(Row& row, const GroupKey& key, const std::vector<KeyFormat>& formats) {
+        for (size_t k = 0; k < formats.size(); ++k) {
+            int64_t value = key[k];
+            row.rawKeys.push_back(value);
+            const KeyFormat& format = formats[k];
+            if (format.kind == KeyFormat::TEXT) {
+                row.keys.push_back(value >= 0 && static_cast<size_t>(value) < format.dictionary->size()
+                                   ? (*format.dictionary)[static_cast<size_t>(value)] : "");
+            } else if (format.kind == KeyFormat::TIME) {
+                row.keys.push_back(value == 0 ? "unknown" : formatBucket(value, format.bucket));
+            } else {
+                row.keys.push_back(std::to_string(value));
+            }
+        }
+    }
+
+    /**
+     * @brief Order result rows by key: text by its string, numbers and timestamps by value
+     */
+    template <typename Row>
+    void sortGroupRows(std::vector<Row>& rows, const std::vector<KeyFormat>& formats) {
+        std::sort(rows.begin(), rows.end(), [&formats](const Row& a, const Row& b) {
+            for (size_t k = 0; k < formats.size(); ++k) {
+                bool text = formats[k].kind == KeyFormat::TEXT;
+                if (text ? a.keys[k] != b.keys[k] : a.rawKeys[k] != b.rawKeys[k]) {
+                    return text ? a.keys[k] < b.keys[k] : a.rawKeys[k] < b.rawKeys[k];
+                }
+            }
+            return false;
+        });
+    }
+
+    /**
+     * @brief Row predicate on one column
+     *
+     * For STRING columns set text; it is looked up in the dictionary.
+     * For TIMESTAMP columns value is a packed timestamp (see packTimestamp).
+     */
+    struct Filter {
+        enum Op { EQ, NE, LT, LE, GT, GE };
+        std::string column;
+        Op op = EQ;
+        int64_t value = 0;
+        std::string text;
+    };
+
+    /**
+     * @brief Filtered count and sum grouped by up to three columns
+     */
+    struct Query {
+        std::string table;
+        std::vector<GroupBy> groupBy;
+        std::string sumColumn; // Empty to count only
+        std::vector<Filter> filters;
+    };
+
+    struct QueryResult {
+        bool ok = false;
+        std::string error;
+        std::vector<std::string> keyNames;
+        struct Row {
+            std::vector<std::string> keys;
+            std::vector<int64_t> rawKeys;
+            int64_t count = 0;
+            int64_t sum = 0;
+        };
+        std::vector<Row> rows; // Ordered by key
+        uint64_t blocksScanned = 0;
+        uint64_t blocksSkipped = 0;
+        uint64_t rowsMatched = 0;
+        double seconds = 0.0;
+    };
+
+    /**
+     * @brief Run a query, reading only the columns it names
+     *
+     * Blocks whose min/max rule out a filter are skipped without touching
+     * their values. In the remaining blocks each filter narrows a selection
+     * vector in one tight pass over its column, then the surviving rows are
+     * aggregated.
+     */
+    inline QueryResult runQuery(const Snapshot& snapshot, const Query& query) {
+        auto started = std::chrono::steady_clock::now();
+        QueryResult result;
+        const Snapshot::Table* table = snapshot.table(query.table);
+        if (!table) {
+            result.error = "unknown table " + query.table;
+            return result;
+        }
+        if (query.groupBy.size() > 3) {
+            result.error = "at most three group-by columns";
+            return result;
+        }
+
+        struct BoundFilter {
+            const Snapshot::Column* column;
+            const int64_t* data;
+            Filter::Op op;
+            int64_t value;
+        };
+        std::vector<BoundFilter> filters;
+        for (const auto& filter : query.filters) {
+            const Snapshot::Column* column = table->column(filter.column);
+            if (!column) {
+                result.error = "unknown column " + filter.column;
+                return result;
+            }
+            int64_t value = filter.value;
+            if (column->type == ColumnType::STRING) {
+                if (filter.op != Filter::EQ && filter.op != Filter::NE) {
+                    result.error = "only = and != apply to text column " + filter.column;
+                    return result;
+                }
+                auto found = std::find(column->dictionary.begin(), column->dictionary.end(), filter.text);
+                value = found == column->dictionary.end() ? -1 : found - column->dictionary.begin();
+            }
+            filters.push_back({column, snapshot.values(*column), filter.op, value});
+        }
+
+        std::vector<KeyFormat> keys;
+        std::vector<const int64_t*> keyData;
+        for (const auto& group : query.groupBy) {
+            const Snapshot::Column* column = table->column(group.column);
+            if (!column) {
+                result.error = "unknown column " + group.column;
+                return result;
+            }
+            if (group.bucket != Bucket::NONE && column->type != ColumnType::TIMESTAMP) {
+                result.error = "calendar buckets need a timestamp column, not " + group.column;
+                return result;
+            }
+            keys.push_back({column->type == ColumnType::STRING ? KeyFormat::TEXT :
+                            column->type == ColumnType::TIMESTAMP ? KeyFormat::TIME : KeyFormat::NUMBER,
+                            &column->dictionary, group.bucket});
+            keyData.push_back(snapshot.values(*column));
+            result.keyNames.push_back(group.column);
+        }
+        const int64_t* sumData = nullptr;
+        if (!query.sumColumn.empty()) {
+            const Snapshot::Column* column = table->column(query.sumColumn);
+            if (!column) {
+                result.error = "unknown column " + query.sumColumn;
+                return result;
+            }
+            sumData = snapshot.values(*column);
+        }
+
+        struct Aggregate { int64_t count = 0; int64_t sum = 0; };
+        std::unordered_map<GroupKey, Aggregate, GroupKeyHash> groups;
+
+        std::vector<uint32_t> selection(table->blockRows);
+        uint64_t blocks = (table->rows + table->blockRows - 1) / table->blockRows;
+        for (uint64_t block = 0; block < blocks; ++block) {
+            bool skip = false;
+            for (const auto& filter : filters) {
+                int64_t low = filter.column->blockMin[block], high = filter.column->blockMax[block];
+                switch (filter.op) {
+                    case Filter::EQ: skip = filter.value < low || filter.value > high; break;
+                    case Filter::NE: skip = low == high && low == filter.value; break;
+                    case Filter::LT: skip = low >= filter.value; break;
+                    case Filter::LE: skip = low > filter.value; break;
+                    case Filter::GT: skip = high <= filter.value; break;
+                    case Filter::GE: skip = high < filter.value; break;
+                }
+                if (skip) break;
+            }
+            if (skip) {
+                ++result.blocksSkipped;
+                continue;
+            }
+            ++result.blocksScanned;
+
+            uint64_t start = block * table->blockRows;
+            uint32_t count = static_cast<uint32_t>(std::min<uint64_t>(table->blockRows, table->rows - start));
+            for (uint32_t i = 0; i < count; ++i) {
+                selection[i] = i;
+            }
+            uint32_t selected = count;
+            for (const auto& filter : filters) {
+                selected = narrowSelection(filter.data + start, filter.op, filter.value, selection.data(), selected);
+            }
+
+            result.rowsMatched += selected;
+            GroupKey previous = {};
+            Aggregate* current = nullptr;
+            for (uint32_t i = 0; i < selected; ++i) {
+                uint64_t row = start + selection[i];
+                GroupKey key = {0, 0, 0};
+                for (size_t k = 0; k < keys.size(); ++k) {
+                    key[k] = applyBucket(keyData[k][row], query.groupBy[k].bucket);
+                }
+                // Neighbouring rows usually share a group; skip the hash lookup then
+                if (!current || key != previous) {
+                    current = &groups[key];
+                    previous = key;
+                }
+                ++current->count;
+                if (sumData) current->sum += sumData[row];
+            }
+        }
+
+        for (const auto& group : groups) {
+            QueryResult::Row row;
+            row.count = group.second.count;
+            row.sum = group.second.sum;
+            setGroupKeys(row, group.first, keys);
+            result.rows.push_back(std::move(row));
+        }
+        sortGroupRows(result.rows, keys);
+        result.ok = true;
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+        return result;
+    }
+}
@@ -2,6 +2,7 @@
 
 #include "models.hpp"
 #include "baseModule.hpp"
+#include "changeFeed.hpp"
 #include <iostream>
 #include <fstream>
 #include <memory>
@@ -24,6 +25,9 @@ class CrewModule : public BaseModule<Model::Crew> {
 private:
     // Map to store crew ID to job title mapping
     std::unordered_map<int, std::string> crewJobs;
+    
+    // Listeners for shift (check-in/check-out) changes
+    ChangeFeed<Model::Crew> changeFeed;
 
 public:
     /**
@@ -288,7 +292,9 @@ public:
             return false;
         }
         
+        changeFeed.publish(*crew, -1);
         crew->check_in_time = Model::DateTime::now();
+        changeFeed.publish(*crew, 1);
         
         // Save changes
         return saveEntities();
@@ -307,7 +313,9 @@ public:
             return false;
         }
         
+        changeFeed.publish(*crew, -1);
         crew->check_out_time = Model::DateTime::now();
+        changeFeed.publish(*crew, 1);
         
         // Save changes
         return saveEntities();
@@ -354,9 +362,21 @@ public:
     bool deleteCrewMember(int id) {
         // Remove job mapping when deleting crew member
         crewJobs.erase(id);
+        auto crew = getById(id);
+        if (crew) {
+            changeFeed.publish(*crew, -1);
+        }
         return deleteEntity(id);
     }
 
+    /**
+     * @brief Shift change notifications: old image (-1) then new image (+1)
+     *        on check-in and check-out, old image on deletion
+     */
+    ChangeFeed<Model::Crew>& getChangeFeed() {
+        return changeFeed;
+    }
+
     /**
      * @brief Remove a specific task from a crew member
      * 
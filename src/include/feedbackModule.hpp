@@ -2,6 +2,8 @@
 
 #include "models.hpp"
 #include "baseModule.hpp"
+#include "changeFeed.hpp"
+#include "keywordMatcher.hpp"
 #include <iostream>
 #include <fstream>
 #include <memory>
@@ -70,10 +72,17 @@ private:
     std::unordered_map<int, std::vector<ExtendedFeedback*>> feedbackByEvent;
     std::unordered_map<int, double> eventAverageRatings;
     
+    // Attendee ID -> submitted feedback (persisted via Feedback::attendee_id)
+    std::unordered_map<int, std::vector<std::shared_ptr<Model::Feedback>>> feedbackByAttendee;
+    
+    // Listeners for new and deleted feedback
+    ChangeFeed<Model::Feedback> changeFeed;
+    
     // Sentiment analysis keywords
     std::vector<std::string> positiveKeywords;
     std::vector<std::string> negativeKeywords;
     std::vector<std::string> criticalKeywords;
+    KeywordMatcher sentimentMatcher; // All three lists, compiled by compileSentimentKeywords()
 
 public:
     /**
@@ -133,9 +142,12 @@ public:
         feedback->rating = rating;
         feedback->comments = comments;
         feedback->submitted_at = Model::DateTime::now();
+        feedback->attendee_id = attendeeId;
+        feedback->concert_id = concertId;
         
         // Add to base collection
         entities.push_back(feedback);
+        feedbackByAttendee[attendeeId].push_back(feedback);
         
         // Create extended feedback for analysis
         auto* extFeedback = new ExtendedFeedback(feedback, concertId);
@@ -158,9 +170,38 @@ public:
         // Save to file
         saveEntities();
         saveEventSpecificFeedback(concertId);
+        changeFeed.publish(*feedback, 1);
         
         return feedback;
     }
+    
+    /**
+     * @brief Delete feedback by ID
+     * @param id Feedback ID
+     * @return true if successful, false if not found or save failed
+     */
+    bool deleteEntity(int id) override {
+        auto feedback = getById(id);
+        if (feedback) {
+            auto bucket = feedbackByAttendee.find(feedback->attendee_id);
+            if (bucket != feedbackByAttendee.end()) {
+                auto& submitted = bucket->second;
+                submitted.erase(std::remove(submitted.begin(), submitted.end(), feedback), submitted.end());
+                if (submitted.empty()) {
+                    feedbackByAttendee.erase(bucket);
+                }
+            }
+            changeFeed.publish(*feedback, -1);
+        }
+        return BaseModule<Model::Feedback>::deleteEntity(id);
+    }
+    
+    /**
+     * @brief Feedback change notifications (+1 when added, -1 when deleted)
+     */
+    ChangeFeed<Model::Feedback>& getChangeFeed() {
+        return changeFeed;
+    }
 
     /**
      * @brief Get feedback for a specific event
@@ -172,6 +213,16 @@ public:
         return (it != feedbackByEvent.end()) ? it->second : std::vector<ExtendedFeedback*>();
     }
 
+    /**
+     * @brief Get all feedback submitted by an attendee
+     * @param attendeeId Attendee ID
+     * @return Vector of feedback in submission order
+     */
+    std::vector<std::shared_ptr<Model::Feedback>> getFeedbackByAttendee(int attendeeId) {
+        auto it = feedbackByAttendee.find(attendeeId);
+        return (it != feedbackByAttendee.end()) ? it->second : std::vector<std::shared_ptr<Model::Feedback>>();
+    }
+
     /**
      * @brief Get average rating for an event
      * @param concertId Concert ID
@@ -260,6 +311,53 @@ public:
         // In production, you'd use a more sophisticated data structure
     }
 
+    /**
+     * @brief Replace the sentiment keywords with the ones listed in a file
+     *
+     * Each line is "<positive|negative|critical> <word or phrase>", with '#'
+     * starting a comment. A trailing '*' makes a prefix ("disappoint*").
+     * Feedback already analyzed is re-classified; feedback that becomes
+     * critical is escalated, and existing escalations are left as they are.
+     *
+     * @param path Lexicon file
+     * @return false if the file cannot be read, names an unknown category or
+     *         lists no keywords; the current keywords are then kept
+     */
+    bool loadSentimentLexicon(const std::string& path) {
+        std::ifstream file(path);
+        if (!file.is_open()) {
+            return false;
+        }
+        std::vector<std::string> positive, negative, critical;
+        std::string line;
+        while (std::getline(file, line)) {
+            line = line.substr(0, line.find('#'));
+            std::istringstream fields(line);
+            std::string category, keyword;
+            if (!(fields >> category)) {
+                continue;
+            }
+            std::getline(fields >> std::ws, keyword);
+            keyword.erase(keyword.find_last_not_of(" \t\r") + 1);
+            if (keyword.empty()) {
+                return false;
+            }
+            if (category == "positive") positive.push_back(keyword);
+            else if (category == "negative") negative.push_back(keyword);
+            else if (category == "critical") critical.push_back(keyword);
+            else return false;
+        }
+        if (positive.empty() && negative.empty() && critical.empty()) {
+            return false;
+        }
+        positiveKeywords = std::move(positive);
+        negativeKeywords = std::move(negative);
+        criticalKeywords = std::move(critical);
+        compileSentimentKeywords();
+        reclassifyAllFeedback();
+        return true;
+    }
+
 protected:
     /**
      * @brief Get the ID of a feedback (using submitted timestamp as pseudo-ID)
@@ -274,6 +372,7 @@ protected:
      */
     void loadEntities() override {
         entities.clear();
+        feedbackByAttendee.clear();
         std::ifstream file(dataFilePath, std::ios::binary);
         
         if (!file.is_open()) {
@@ -281,6 +380,9 @@ protected:
             return;
         }
         
+        // Version 1 adds attendee_id and concert_id to each record
+        uint32_t version = readFormatVersion(file);
+        
         int feedbackCount = 0;
         readBinary(file, feedbackCount);
         
@@ -290,8 +392,13 @@ protected:
             readBinary(file, feedback->rating);
             feedback->comments = readString(file);
             feedback->submitted_at.iso8601String = readString(file);
+            if (version >= 1) {
+                readBinary(file, feedback->attendee_id);
+                readBinary(file, feedback->concert_id);
+            }
             
             entities.push_back(feedback);
+            feedbackByAttendee[feedback->attendee_id].push_back(feedback);
         }
         
         file.close();
@@ -308,6 +415,8 @@ protected:
             return false;
         }
         
+        writeFormatHeader(file, 1);
+        
         int feedbackCount = static_cast<int>(entities.size());
         writeBinary(file, feedbackCount);
         
@@ -315,6 +424,8 @@ protected:
             writeBinary(file, feedback->rating);
             writeString(file, feedback->comments);
             writeString(file, feedback->submitted_at.iso8601String);
+            writeBinary(file, feedback->attendee_id);
+            writeBinary(file, feedback->concert_id);
         }
         
         file.close();
@@ -326,42 +437,46 @@ private:
      * @brief Initialize sentiment analysis keywords
      */
     void initializeSentimentKeywords() {
-        positiveKeywords = {"excellent", "amazing", "fantastic", "great", "wonderful", 
-                           "awesome", "perfect", "loved", "brilliant", "outstanding"};
-        negativeKeywords = {"terrible", "awful", "bad", "horrible", "disappointing", 
-                           "poor", "worst", "hate", "boring", "overpriced"};
-        criticalKeywords = {"unsafe", "emergency", "injury", "dangerous", "fire", 
-                           "violence", "theft", "medical", "security"};
+        // Keywords match whole words, so inflections are given as prefixes or
+        // listed; "fire*" would also catch "fireworks", so fire is spelled out.
+        positiveKeywords = {"excellent", "amazing", "fantastic", "great", "wonderful",
+                           "awesome", "perfect", "love", "loved", "loves", "loving",
+                           "brilliant", "outstanding"};
+        negativeKeywords = {"terrible", "awful", "bad", "horrible", "disappoint*",
+                           "poor", "worst", "hate", "hated", "hates", "boring", "overpriced"};
+        criticalKeywords = {"unsafe", "emergenc*", "injur*", "dangerous", "danger", "fire", "fires",
+                           "violen*", "theft", "thefts", "medical", "security"};
+        compileSentimentKeywords();
+    }
+
+    enum KeywordCategory { POSITIVE_KEYWORD, NEGATIVE_KEYWORD, CRITICAL_KEYWORD };
+
+    /**
+     * @brief Build the matcher from the keyword lists
+     */
+    void compileSentimentKeywords() {
+        sentimentMatcher.clear();
+        for (const auto& keyword : positiveKeywords) sentimentMatcher.addKeyword(keyword, POSITIVE_KEYWORD);
+        for (const auto& keyword : negativeKeywords) sentimentMatcher.addKeyword(keyword, NEGATIVE_KEYWORD);
+        for (const auto& keyword : criticalKeywords) sentimentMatcher.addKeyword(keyword, CRITICAL_KEYWORD);
+        sentimentMatcher.build();
     }
 
     /**
      * @brief Perform sentiment analysis on feedback
      */
     void analyzeSentiment(ExtendedFeedback* feedback) {
-        std::string comments = feedback->baseFeedback->comments;
-        std::transform(comments.begin(), comments.end(), comments.begin(), ::tolower);
-        
         int positiveScore = 0, negativeScore = 0, criticalScore = 0;
         
-        // Check for critical keywords first
-        for (const auto& keyword : criticalKeywords) {
-            if (comments.find(keyword) != std::string::npos) {
-                criticalScore += 3;
-            }
-        }
-        
-        // Check sentiment keywords
-        for (const auto& keyword : positiveKeywords) {
-            if (comments.find(keyword) != std::string::npos) {
-                positiveScore++;
-            }
-        }
-        
-        for (const auto& keyword : negativeKeywords) {
-            if (comments.find(keyword) != std::string::npos) {
-                negativeScore++;
-            }
-        }
+        // One pass over the comment; each distinct keyword scores once however often it appears
+        std::vector<bool> seen(sentimentMatcher.keywordCount(), false);
+        sentimentMatcher.scan(feedback->baseFeedback->comments, [&](int keyword, int category) {
+            if (seen[keyword]) return;
+            seen[keyword] = true;
+            if (category == CRITICAL_KEYWORD) criticalScore += 3;
+            else if (category == POSITIVE_KEYWORD) positiveScore++;
+            else negativeScore++;
+        });
         
         // Determine sentiment
         if (criticalScore > 0) {
@@ -404,6 +519,33 @@ private:
         // For now, it's a placeholder for the concept
     }
 
+    /**
+     * @brief Re-run sentiment analysis on all analyzed feedback after the keywords change
+     */
+    void reclassifyAllFeedback() {
+        for (auto& pair : feedbackByEvent) {
+            bool changed = false;
+            for (auto* fb : pair.second) {
+                SentimentType previous = fb->sentiment;
+                bool escalated = fb->requires_escalation;
+                std::string reason = fb->escalation_reason;
+                analyzeSentiment(fb);
+                if (fb->sentiment == SentimentType::CRITICAL && previous != SentimentType::CRITICAL) {
+                    if (!escalated) {
+                        urgentQueue.push(fb);
+                    }
+                } else {
+                    fb->requires_escalation = escalated;
+                    fb->escalation_reason = reason;
+                }
+                changed = changed || fb->sentiment != previous;
+            }
+            if (changed) {
+                saveEventSpecificFeedback(pair.first);
+            }
+        }
+    }
+
     /**
      * @brief Save event-specific feedback to separate file
      */
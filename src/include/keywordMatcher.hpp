@@ -0,0 +1,187 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <array>
+#include <queue>
+#include <cstdint>
+
+/**
+ * @brief Multi-keyword matcher (Aho–Corasick automaton) for whole words and phrases
+ *
+ * Keywords are compiled into one automaton whose transitions are fully
+ * resolved, so scanning a text is a single pass with one table lookup per
+ * byte regardless of how many keywords there are. ASCII letters are
+ * folded to lower case as they are read, so the text is never copied.
+ *
+ * A match counts only at word boundaries: "bad" does not match "badge" or
+ * "sinbad". A keyword ending in '*' is a prefix: "disappoint*" matches
+ * "disappointing" and "disappointed" but still has to start a word.
+ * Letters, digits, '_' and all non-ASCII bytes are word characters, as is
+ * an apostrophe between two letters ("don't"); a quoted 'bad' still matches.
+ */
+class KeywordMatcher {
+public:
+    /**
+     * @brief Add a keyword; call build() before scanning again
+     * @param keyword Word or phrase, optionally ending in '*'
+     * @param category Caller-defined value reported with each match
+     * @return Keyword index, or -1 if the keyword is empty
+     */
+    int addKeyword(const std::string& keyword, int category) {
+        bool prefix = !keyword.empty() && keyword.back() == '*';
+        std::string text = prefix ? keyword.substr(0, keyword.size() - 1) : keyword;
+        if (text.empty()) {
+            return -1;
+        }
+        for (char& c : text) {
+            c = static_cast<char>(fold(static_cast<unsigned char>(c)));
+        }
+        keywords.push_back({text, category, prefix});
+        built = false;
+        return static_cast<int>(keywords.size()) - 1;
+    }
+
+    void clear() {
+        keywords.clear();
+        built = false;
+        build();
+    }
+
+    /**
+     * @brief Compile the keywords into the automaton
+     */
+    void build() {
+        // Map each byte that appears in a keyword to its own column; every other byte shares column 0
+        classOf.fill(0);
+        int classes = 1;
+        for (const auto& keyword : keywords) {
+            for (unsigned char c : keyword.text) {
+                if (classOf[c] == 0) {
+                    classOf[c] = static_cast<uint16_t>(classes++);
+                }
+            }
+        }
+        for (int c = 'A'; c <= 'Z'; ++c) {
+            classOf[c] = classOf[c - 'A' + 'a'];
+        }
+        width = classes;
+
+        // Trie of the keywords
+        transitions.assign(width, -1);
+        nodeKeyword.assign(1, -1);
+        for (size_t k = 0; k < keywords.size(); ++k) {
+            int node = 0;
+            for (unsigned char c : keywords[k].text) {
+                int& next = transitions[node * width + classOf[c]];
+                if (next < 0) {
+                    next = static_cast<int>(nodeKeyword.size());
+                    nodeKeyword.push_back(-1);
+                    transitions.resize(transitions.size() + width, -1);
+                }
+                node = transitions[node * width + classOf[c]];
+            }
+            if (nodeKeyword[node] < 0) {
+                nodeKeyword[node] = static_cast<int>(k); // Duplicates keep the first category
+            }
+        }
+
+        // Failure links in breadth-first order, folded into the transition table
+        size_t nodes = nodeKeyword.size();
+        std::vector<int> failure(nodes, 0);
+        nextMatch.assign(nodes, -1);
+        std::queue<int> pending;
+        for (int c = 0; c < width; ++c) {
+            int& next = transitions[c];
+            if (next < 0) {
+                next = 0;
+            } else {
+                pending.push(next);
+            }
+        }
+        while (!pending.empty()) {
+            int node = pending.front();
+            pending.pop();
+            int fallback = failure[node];
+            nextMatch[node] = nodeKeyword[fallback] >= 0 ? fallback : nextMatch[fallback];
+            for (int c = 0; c < width; ++c) {
+                int& next = transitions[node * width + c];
+                if (next < 0) {
+                    next = transitions[fallback * width + c];
+                } else {
+                    failure[next] = transitions[fallback * width + c];
+                    pending.push(next);
+                }
+            }
+        }
+        built = true;
+    }
+
+    /**
+     * @brief Report every whole-word keyword occurrence in a text
+     * @param onMatch Called as onMatch(keywordIndex, category) for each occurrence
+     */
+    template <typename Callback>
+    void scan(std::string_view text, Callback&& onMatch) const {
+        if (!built || keywords.empty()) {
+            return;
+        }
+        int node = 0;
+        for (size_t i = 0; i < text.size(); ++i) {
+            node = transitions[node * width + classOf[static_cast<unsigned char>(text[i])]];
+            for (int hit = nodeKeyword[node] >= 0 ? node : nextMatch[node]; hit > 0; hit = nextMatch[hit]) {
+                const Keyword& keyword = keywords[nodeKeyword[hit]];
+                size_t start = i + 1 - keyword.text.size();
+                bool startsWord = start == 0 || !isWordAt(text, start - 1);
+                bool endsWord = keyword.prefix || i + 1 == text.size() || !isWordAt(text, i + 1);
+                if (startsWord && endsWord) {
+                    onMatch(nodeKeyword[hit], keyword.category);
+                }
+            }
+        }
+    }
+
+    size_t keywordCount() const { return keywords.size(); }
+
+    /**
+     * @brief Keyword text as added, with its '*' if it is a prefix
+     */
+    std::string keywordAt(size_t index) const {
+        return keywords[index].text + (keywords[index].prefix ? "*" : "");
+    }
+
+    int categoryAt(size_t index) const { return keywords[index].category; }
+
+private:
+    struct Keyword {
+        std::string text;   // Lower case
+        int category;
+        bool prefix;
+    };
+
+    static unsigned char fold(unsigned char c) {
+        return c >= 'A' && c <= 'Z' ? static_cast<unsigned char>(c - 'A' + 'a') : c;
+    }
+
+    static bool isLetterByte(unsigned char c) {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c >= 0x80;
+    }
+
+    static bool isWordAt(std::string_view text, size_t i) {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        if (c == '\'') {
+            return i > 0 && i + 1 < text.size() && isLetterByte(static_cast<unsigned char>(text[i - 1])) &&
+                   isLetterByte(static_cast<unsigned char>(text[i + 1]));
+        }
+        return isLetterByte(c) || (c >= '0' && c <= '9') || c == '_';
+    }
+
+    std::vector<Keyword> keywords;
+    std::array<uint16_t, 256> classOf{}; // Wide enough for one class per byte value
+    int width = 1;
+    std::vector<int> transitions = std::vector<int>(1, 0); // node * width + class -> node
+    std::vector<int> nodeKeyword = std::vector<int>(1, -1); // Keyword ending exactly at a node
+    std::vector<int> nextMatch = std::vector<int>(1, -1);   // Nearest shorter suffix that ends a keyword
+    bool built = true;
+};
@@ -6,6 +6,8 @@
 #include <optional>
 #include <chrono>
 #include <ctime>
+#include <cstdint>
+#include <cmath>
 
 namespace Model {
     // Forward declarations
@@ -50,6 +52,59 @@ namespace Model {
         }
     };
 
+    // Fixed-point money amount, held as an integer count of the currency's minor unit
+    struct Money {
+        int64_t minor = 0; // e.g. cents for USD; negative for refunds
+
+        // Number of decimal places of a currency's minor unit (ISO 4217)
+        static int minorDigits(const std::string& currency) {
+            if (currency == "JPY" || currency == "KRW" || currency == "VND" || currency == "ISK") return 0;
+            if (currency == "BHD" || currency == "KWD" || currency == "OMR" || currency == "JOD" || currency == "TND") return 3;
+            return 2;
+        }
+
+        static int64_t minorScale(const std::string& currency) {
+            int64_t scale = 1;
+            for (int i = minorDigits(currency); i > 0; --i) scale *= 10;
+            return scale;
+        }
+
+        // Convert a major-unit amount (e.g. 12.34 USD), rounding half away from zero
+        static Money fromMajor(double major, const std::string& currency) {
+            return Money{static_cast<int64_t>(std::llround(major * static_cast<double>(minorScale(currency))))};
+        }
+
+        // Major-unit value for display and legacy double APIs
+        double toMajor(const std::string& currency) const {
+            return static_cast<double>(minor) / static_cast<double>(minorScale(currency));
+        }
+
+        // Exact decimal text, e.g. "-12.50"
+        std::string toString(const std::string& currency) const {
+            int digits = minorDigits(currency);
+            int64_t scale = minorScale(currency);
+            uint64_t magnitude = minor < 0 ? 0 - static_cast<uint64_t>(minor) : static_cast<uint64_t>(minor);
+            std::string text = (minor < 0 ? "-" : "") + std::to_string(magnitude / scale);
+            if (digits > 0) {
+                std::string fraction = std::to_string(magnitude % scale);
+                text += "." + std::string(digits - fraction.size(), '0') + fraction;
+            }
+            return text;
+        }
+
+        Money operator-() const { return Money{-minor}; }
+        Money operator+(Money other) const { return Money{minor + other.minor}; }
+        Money operator-(Money other) const { return Money{minor - other.minor}; }
+        Money& operator+=(Money other) { minor += other.minor; return *this; }
+        Money& operator-=(Money other) { minor -= other.minor; return *this; }
+        bool operator==(Money other) const { return minor == other.minor; }
+        bool operator!=(Money other) const { return minor != other.minor; }
+        bool operator<(Money other) const { return minor < other.minor; }
+        bool operator>(Money other) const { return minor > other.minor; }
+        bool operator<=(Money other) const { return minor <= other.minor; }
+        bool operator>=(Money other) const { return minor >= other.minor; }
+    };
+
     // Enum for event status
     enum class EventStatus {
         SCHEDULED,
@@ -219,6 +274,8 @@ namespace Model {
         int rating;               // typically 1-5 or 1-10
         std::string comments;
         DateTime submitted_at;
+        int attendee_id = 0;      // Persisted owner ID (weak_ptr below is not saved)
+        int concert_id = 0;       // Persisted concert ID
         std::weak_ptr<Attendee> attendee; // To avoid circular references
     };
 
@@ -238,12 +295,13 @@ namespace Model {
     // Payment struct for transaction records
     struct Payment {
         int payment_id;
-        double amount;
+        Money amount;               // Fixed-point, in minor units of currency
         std::string currency;
         std::string payment_method; // e.g., "Credit Card", "PayPal", etc.
         std::string transaction_id; // External payment processor ID
         PaymentStatus status;
         DateTime payment_date_time;
+        int attendee_id = 0;        // Persisted payer ID (weak_ptr below is not saved)
         std::weak_ptr<Attendee> attendee; // To avoid circular references
     };
 
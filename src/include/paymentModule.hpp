@@ -10,11 +10,230 @@
 #include <chrono>
 #include <random>
 #include <iomanip>
+#include <unordered_map>
+#include <tuple>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <future>
+#include <thread>
+#include <condition_variable>
+#include <cstdio>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
 #include "models.hpp"
 #include "baseModule.hpp"
+#include "workerPool.hpp"
+#include "changeFeed.hpp"
+#include "reportCache.hpp"
 
 namespace PaymentManager {
 
+    /**
+     * @brief Charge request handed to a payment gateway
+     */
+    struct GatewayRequest {
+        std::string idempotency_key; // Repeats of a key must not charge twice
+        std::string transaction_id;
+        Model::Money amount;
+        std::string currency;
+        std::string payment_method;
+    };
+
+    /**
+     * @brief Gateway verdict, applied through PaymentModule::handleTransactionCallback
+     */
+    struct GatewayResponse {
+        std::string status;  // "completed" or "failed"
+        std::string message; // Raw gateway response for the audit trail
+    };
+
+    /**
+     * @brief Pluggable payment gateway
+     *
+     * charge() may block on the network; it is only called from the payment
+     * worker pool, never while the module lock is held.
+     */
+    class PaymentGateway {
+    public:
+        virtual ~PaymentGateway() = default;
+        virtual GatewayResponse charge(const GatewayRequest& request) = 0;
+    };
+
+    /**
+     * @brief Local gateway stand-in with configurable latency and failure rate
+     *
+     * Remembers the verdict for each idempotency key, so a retried request gets
+     * the original answer without being charged again.
+     */
+    class SimulatedGateway : public PaymentGateway {
+    public:
+        /**
+         * @param latencyMs Simulated round-trip time per charge
+         * @param failureRate Probability (0..1) that a charge is declined
+         * @param seed Seed for the decline decisions
+         */
+        SimulatedGateway(int latencyMs = 0, double failureRate = 0.0, unsigned int seed = 42)
+            : latency(latencyMs), failureRate(failureRate), rng(seed) {}
+
+        GatewayResponse charge(const GatewayRequest& request) override {
+            {
+                std::lock_guard<std::mutex> lock(gatewayMutex);
+                auto seen = verdicts.find(request.idempotency_key);
+                if (seen != verdicts.end()) {
+                    return seen->second;
+                }
+            }
+
+            if (latency > 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(latency));
+            }
+
+            std::lock_guard<std::mutex> lock(gatewayMutex);
+            bool declined = std::uniform_real_distribution<double>(0.0, 1.0)(rng) < failureRate;
+            GatewayResponse response = declined
+                ? GatewayResponse{"failed", "DECLINED " + request.transaction_id}
+                : GatewayResponse{"completed", "APPROVED " + request.transaction_id};
+            auto inserted = verdicts.emplace(request.idempotency_key, response);
+            if (inserted.second) {
+                ++charges;
+            }
+            return inserted.first->second; // A concurrent retry may have answered first
+        }
+
+        /**
+         * @brief Number of distinct charges made (retries excluded)
+         */
+        size_t getChargeCount() const {
+            std::lock_guard<std::mutex> lock(gatewayMutex);
+            return charges;
+        }
+
+    private:
+        int latency;
+        double failureRate;
+        std::mt19937 rng;
+        mutable std::mutex gatewayMutex;
+        std::unordered_map<std::string, GatewayResponse> verdicts;
+        size_t charges = 0;
+    };
+
+    /**
+     * @brief Date-versioned exchange rates against a base currency
+     *
+     * Rate file format, one rate per line ('#' starts a comment):
+     *     2024-06-01 EUR 0.9210
+     * meaning one unit of the base currency buys 0.9210 EUR from 2024-06-01 on.
+     * Built-in rates cover the supported currencies until a file overrides them.
+     */
+    class CurrencyRateTable {
+    public:
+        explicit CurrencyRateTable(const std::string& base = "USD") : baseCurrency(base) {
+            setRate("1970-01-01", "EUR", 0.92);
+            setRate("1970-01-01", "GBP", 0.79);
+            setRate("1970-01-01", "CAD", 1.36);
+            setRate("1970-01-01", "AUD", 1.52);
+        }
+
+        /**
+         * @brief Load (and merge) rates from a rate file
+         * @param path Path to the rate file
+         * @return true if the file was read, false if it could not be opened
+         */
+        bool loadFromFile(const std::string& path) {
+            std::ifstream file(path);
+            if (!file.is_open()) {
+                return false;
+            }
+            std::string line;
+            while (std::getline(file, line)) {
+                line = line.substr(0, line.find('#'));
+                std::istringstream fields(line);
+                std::string date, currency;
+                double perBase = 0.0;
+                if (fields >> date >> currency >> perBase) {
+                    setRate(date, currency, perBase);
+                }
+            }
+            return true;
+        }
+
+        /**
+         * @brief Set the rate of a currency from a date on
+         * @param effectiveDate First day the rate applies ("YYYY-MM-DD")
+         * @param currency Currency code
+         * @param perBase Units of currency per unit of the base currency
+         */
+        void setRate(const std::string& effectiveDate, const std::string& currency, double perBase) {
+            if (perBase <= 0.0 || currency == baseCurrency) {
+                return;
+            }
+            ratesByCurrency[currency][effectiveDate.substr(0, 10)] = perBase;
+            ++version;
+        }
+
+        /**
+         * @brief Units of currency per unit of the base currency on a date
+         * @return The rate, or 0.0 if the currency has no rate in effect
+         */
+        double getRate(const std::string& currency, const std::string& date) const {
+            if (currency == baseCurrency) {
+                return 1.0;
+            }
+            auto table = ratesByCurrency.find(currency);
+            if (table == ratesByCurrency.end()) {
+                return 0.0;
+            }
+            auto rate = table->second.upper_bound(date.substr(0, 10));
+            if (rate == table->second.begin()) {
+                return 0.0;
+            }
+            return std::prev(rate)->second;
+        }
+
+        /**
+         * @brief Multiplier turning minor units of one currency into minor units of another
+         * @return The factor, or 0.0 if either currency has no rate on that date
+         */
+        double minorUnitFactor(const std::string& from, const std::string& to, const std::string& date) const {
+            double fromRate = getRate(from, date);
+            double toRate = getRate(to, date);
+            if (fromRate == 0.0 || toRate == 0.0) {
+                return 0.0;
+            }
+            return (toRate / fromRate) * static_cast<double>(Model::Money::minorScale(to)) /
+                   static_cast<double>(Model::Money::minorScale(from));
+        }
+
+        /**
+         * @brief Convert an amount at the rates in effect on a date
+         * @return Converted amount (zero if no rate is known)
+         */
+        Model::Money convert(Model::Money amount, const std::string& from, const std::string& to,
+                             const std::string& date) const {
+            if (from == to) {
+                return amount;
+            }
+            return Model::Money{static_cast<int64_t>(std::llround(
+                static_cast<double>(amount.minor) * minorUnitFactor(from, to, date)))};
+        }
+
+        const std::string& getBaseCurrency() const { return baseCurrency; }
+
+        /**
+         * @brief Change counter, bumped whenever a rate is set
+         */
+        uint64_t getVersion() const { return version; }
+
+    private:
+        std::string baseCurrency;
+        std::map<std::string, std::map<std::string, double>> ratesByCurrency; // Currency -> effective date -> rate
+        uint64_t version = 0;
+    };
+
     /**
      * @brief Payment Module for handling all payment-related operations
      * 
@@ -38,80 +257,168 @@ namespace PaymentManager {
          * @brief Destructor
          */
         ~PaymentModule() {
-            saveEntities();
+            gatewayPool.reset(); // Let queued gateway calls finish first
+            // Every change is already in the snapshot or the log; no save needed
+            if (logFile) {
+                std::fclose(logFile);
+            }
         }
 
         // Core Payment Operations
         
         /**
-         * @brief Process a new payment transaction
+         * @brief Process a new payment transaction and wait for the gateway's verdict
          * @param attendee_id ID of the attendee making the payment
          * @param amount Payment amount
          * @param currency Currency code (e.g., "USD", "EUR")
          * @param payment_method Payment method (e.g., "Credit Card", "PayPal")
-         * @return Transaction ID if successful, empty string if failed
+         * @return Transaction ID if the payment completed, empty string if failed
          */
         std::string processPayment(int attendee_id, double amount, 
                                  const std::string& currency, 
                                  const std::string& payment_method) {
-            // Validate payment data
-            if (!validatePaymentData(amount, currency)) {
+            PaymentSubmission submission = submitPayment(attendee_id, amount, currency, payment_method);
+            if (submission.transaction_id.empty() ||
+                submission.outcome.get() != Model::PaymentStatus::COMPLETED) {
                 return "";
             }
+            return submission.transaction_id;
+        }
+
+        /**
+         * @brief Handle to a payment travelling through the gateway pipeline
+         */
+        struct PaymentSubmission {
+            std::string transaction_id;                         // Empty if the request was rejected
+            std::shared_future<Model::PaymentStatus> outcome;   // COMPLETED or FAILED once the gateway answers
+        };
+
+        /**
+         * @brief Queue a payment for the gateway without waiting for it
+         *
+         * A PENDING record is created at once; a worker then charges the gateway
+         * and applies its verdict through handleTransactionCallback.
+         * @param attendee_id ID of the attendee making the payment
+         * @param amount Payment amount
+         * @param currency Currency code
+         * @param payment_method Payment method
+         * @param idempotency_key Client key for retries; a repeated key returns the
+         *        original submission instead of charging again ("" for none)
+         * @return Submission handle; transaction_id is empty if validation failed
+         *         or the PENDING record could not be made durable
+         */
+        PaymentSubmission submitPayment(int attendee_id, double amount,
+                                        const std::string& currency,
+                                        const std::string& payment_method,
+                                        const std::string& idempotency_key = "") {
+            std::unique_lock<std::recursive_mutex> lock(paymentMutex);
+            if (!idempotency_key.empty()) {
+                auto seen = submissions.find(idempotency_key);
+                if (seen != submissions.end()) {
+                    return seen->second;
+                }
+            }
 
-            // Generate transaction ID
             std::string transaction_id = generateTransactionId();
-            
-            // Create payment
-            int payment_id = createPayment(attendee_id, amount, currency, payment_method, transaction_id);
-            if (payment_id == -1) {
-                return "";
+            auto payment = addPayment(attendee_id, amount, currency, payment_method, transaction_id);
+            if (!payment) {
+                return PaymentSubmission();
             }
+            uint64_t ticket = logUpsert(*payment);
 
-            // For simulation, we'll mark the payment as completed
-            updatePaymentStatus(payment_id, Model::PaymentStatus::COMPLETED);
-            
-            return transaction_id;
+            auto verdict = std::make_shared<std::promise<Model::PaymentStatus>>();
+            PaymentSubmission submission{transaction_id, verdict->get_future().share()};
+            if (!idempotency_key.empty()) {
+                submissions.emplace(idempotency_key, submission);
+            }
+            lock.unlock();
+
+            // The PENDING record is on disk before the gateway is charged or the caller hears back
+            if (!awaitDurable(ticket)) {
+                lock.lock();
+                removePayment(payment);
+                if (!idempotency_key.empty()) {
+                    submissions.erase(idempotency_key);
+                }
+                verdict->set_value(Model::PaymentStatus::FAILED);
+                return PaymentSubmission();
+            }
+            lock.lock();
+
+            GatewayRequest request;
+            request.idempotency_key = idempotency_key.empty() ? transaction_id : idempotency_key;
+            request.transaction_id = transaction_id;
+            request.amount = payment->amount;
+            request.currency = payment->currency;
+            request.payment_method = payment->payment_method;
+
+            std::shared_ptr<PaymentGateway> target = ensureGateway();
+            gatewayPool->submit([this, target, request, verdict]() {
+                GatewayResponse response = target->charge(request);
+                Model::PaymentStatus status = Model::PaymentStatus::FAILED;
+                handleTransactionCallback(request.transaction_id, response.status, response.message);
+                auto settled = getPaymentByTransactionId(request.transaction_id);
+                if (settled) {
+                    std::lock_guard<std::recursive_mutex> lock(paymentMutex);
+                    status = settled->status;
+                }
+                verdict->set_value(status);
+            });
+            return submission;
+        }
+
+        /**
+         * @brief Replace the payment gateway
+         *
+         * Waits for in-flight gateway calls before switching.
+         * @param newGateway Gateway to charge through
+         * @param workers Number of concurrent gateway calls
+         */
+        void setGateway(std::shared_ptr<PaymentGateway> newGateway, size_t workers = 4) {
+            std::unique_ptr<WorkerPool> draining;
+            {
+                std::lock_guard<std::recursive_mutex> lock(paymentMutex);
+                draining = std::move(gatewayPool);
+                gateway = std::move(newGateway);
+                gatewayWorkers = workers == 0 ? 1 : workers;
+            }
+            draining.reset(); // Runs queued calls on the old gateway; needs paymentMutex free
         }
 
         /**
          * @brief Create a new payment record
          * @param attendee_id ID of the attendee making the payment
-         * @param amount Payment amount
+         * @param amount Payment amount in major units (rounded to the currency's minor unit)
          * @param currency Currency code
          * @param payment_method Payment method
          * @param transaction_id External transaction ID
-         * @return Payment ID if successful, -1 if failed
+         * @return Payment ID if successful, -1 if invalid or not made durable
          */
         int createPayment(int attendee_id, double amount, const std::string& currency,
                         const std::string& payment_method, const std::string& transaction_id) {
-            if (!validatePaymentData(amount, currency)) {
+            std::unique_lock<std::recursive_mutex> lock(paymentMutex);
+            auto payment = addPayment(attendee_id, amount, currency, payment_method, transaction_id);
+            if (!payment) {
                 return -1;
             }
-
-            auto payment = std::make_shared<Model::Payment>();
-            payment->payment_id = generateNewId();
-            payment->amount = amount;
-            payment->currency = currency;
-            payment->payment_method = payment_method;
-            payment->transaction_id = transaction_id;
-            payment->status = Model::PaymentStatus::PENDING;
-            payment->payment_date_time = Model::DateTime::now();
-            // Note: attendee reference will be set by calling code if needed
-
-            entities.push_back(payment);
-            saveEntities();
-            
-            logPaymentTransaction(*payment, "CREATED");
-            return payment->payment_id;
+            uint64_t ticket = logUpsert(*payment);
+            int payment_id = payment->payment_id;
+            lock.unlock();
+            if (!awaitDurable(ticket)) {
+                lock.lock();
+                removePayment(payment);
+                return -1;
+            }
+            return payment_id;
         }
 
         /**
          * @brief Create a payment record
          * @param payment Payment object to create
-         * @return Payment ID if successful, -1 if failed
+         * @return Payment ID if successful, -1 if invalid or not made durable
          */
         int createPayment(const Model::Payment& payment) {
+            std::unique_lock<std::recursive_mutex> lock(paymentMutex);
             if (!validatePaymentData(payment.amount, payment.currency)) {
                 return -1;
             }
@@ -121,10 +428,19 @@ namespace PaymentManager {
             newPayment->payment_date_time = Model::DateTime::now();
 
             entities.push_back(newPayment);
-            saveEntities();
+            indexPayment(newPayment);
+            rollPayment(*newPayment, 1);
+            uint64_t ticket = logUpsert(*newPayment);
             
             logPaymentTransaction(*newPayment, "CREATED");
-            return newPayment->payment_id;
+            int payment_id = newPayment->payment_id;
+            lock.unlock();
+            if (!awaitDurable(ticket)) {
+                lock.lock();
+                removePayment(newPayment);
+                return -1;
+            }
+            return payment_id;
         }
 
         /**
@@ -134,35 +450,40 @@ namespace PaymentManager {
          * @return true if successful, false otherwise
          */
         bool updatePaymentStatus(int payment_id, Model::PaymentStatus status) {
+            std::unique_lock<std::recursive_mutex> lock(paymentMutex);
             auto payment = getPaymentById(payment_id);
             if (!payment) {
                 return false;
             }
 
-            payment->status = status;
-            payment->payment_date_time = Model::DateTime::now();
-            saveEntities();
+            setPaymentStatus(payment, status);
+            uint64_t ticket = logUpsert(*payment);
             
             logPaymentTransaction(*payment, "STATUS_UPDATED");
-            return true;
+            lock.unlock();
+            return awaitDurable(ticket);
         }
 
         /**
          * @brief Process a refund for a payment
          * @param payment_id Original payment ID
-         * @param refund_amount Amount to refund (0 for full refund)
+         * @param refund_amount Amount to refund in major units (0 for full refund)
          * @param reason Reason for refund
-         * @return Refund transaction ID if successful, empty string if failed
+         * @return Refund transaction ID if successful, empty string if invalid or
+         *         not made durable (the refund is then undone)
          */
         std::string processRefund(int payment_id, double refund_amount = 0.0, 
                                 const std::string& reason = "") {
+            std::unique_lock<std::recursive_mutex> lock(paymentMutex);
             auto originalPayment = getPaymentById(payment_id);
             if (!originalPayment || originalPayment->status != Model::PaymentStatus::COMPLETED) {
                 return "";
             }
 
-            double refund = (refund_amount > 0) ? refund_amount : originalPayment->amount;
-            if (refund > originalPayment->amount) {
+            Model::Money refund = (refund_amount > 0)
+                ? Model::Money::fromMajor(refund_amount, originalPayment->currency)
+                : originalPayment->amount;
+            if (refund.minor <= 0 || refund > originalPayment->amount) {
                 return "";
             }
 
@@ -175,18 +496,32 @@ namespace PaymentManager {
             refundPayment->transaction_id = generateTransactionId();
             refundPayment->status = Model::PaymentStatus::REFUNDED;
             refundPayment->payment_date_time = Model::DateTime::now();
+            refundPayment->attendee_id = originalPayment->attendee_id;
 
             entities.push_back(refundPayment);
+            indexPayment(refundPayment);
+            rollPayment(*refundPayment, 1);
+            uint64_t ticket = logUpsert(*refundPayment);
             
             // Update original payment status if full refund
-            if (refund == originalPayment->amount) {
-                originalPayment->status = Model::PaymentStatus::REFUNDED;
-                originalPayment->payment_date_time = Model::DateTime::now();
+            bool fullRefund = refund == originalPayment->amount;
+            if (fullRefund) {
+                setPaymentStatus(originalPayment, Model::PaymentStatus::REFUNDED);
+                ticket = logUpsert(*originalPayment);
             }
 
-            saveEntities();
             logPaymentTransaction(*refundPayment, "REFUNDED");
-            return refundPayment->transaction_id;
+            std::string refund_transaction_id = refundPayment->transaction_id;
+            lock.unlock();
+            if (!awaitDurable(ticket)) {
+                lock.lock();
+                removePayment(refundPayment);
+                if (fullRefund) {
+                    setPaymentStatus(originalPayment, Model::PaymentStatus::COMPLETED);
+                }
+                return "";
+            }
+            return refund_transaction_id;
         }
 
         // Query Operations
@@ -197,26 +532,31 @@ namespace PaymentManager {
          * @return Shared pointer to payment, nullptr if not found
          */
         std::shared_ptr<Model::Payment> getPaymentById(int payment_id) {
-            auto it = std::find_if(entities.begin(), entities.end(),
-                [payment_id](const std::shared_ptr<Model::Payment>& payment) {
-                    return payment->payment_id == payment_id;
-                });
-            return (it != entities.end()) ? *it : nullptr;
+            std::lock_guard<std::recursive_mutex> lock(paymentMutex);
+            auto it = paymentsById.find(payment_id);
+            return (it != paymentsById.end()) ? it->second : nullptr;
+        }
+
+        /**
+         * @brief Get payment by gateway transaction ID
+         * @param transaction_id Transaction ID to look up
+         * @return Shared pointer to payment, nullptr if not found
+         */
+        std::shared_ptr<Model::Payment> getPaymentByTransactionId(const std::string& transaction_id) {
+            std::lock_guard<std::recursive_mutex> lock(paymentMutex);
+            auto it = paymentsByTransaction.find(transaction_id);
+            return (it != paymentsByTransaction.end()) ? it->second : nullptr;
         }
 
         /**
-         * @brief Get all payments for a specific attendee
+         * @brief Get all payments for a specific attendee (including refund records)
          * @param attendee_id Attendee ID
-         * @return Vector of payments for the attendee
+         * @return Vector of payments for the attendee, in creation order
          */
         std::vector<std::shared_ptr<Model::Payment>> getPaymentsByAttendee(int attendee_id) {
-            std::vector<std::shared_ptr<Model::Payment>> result;
-            std::copy_if(entities.begin(), entities.end(), std::back_inserter(result),
-                [attendee_id](const std::shared_ptr<Model::Payment>& payment) {
-                    auto attendee = payment->attendee.lock();
-                    return attendee && attendee->id == attendee_id;
-                });
-            return result;
+            std::lock_guard<std::recursive_mutex> lock(paymentMutex);
+            auto it = paymentsByAttendee.find(attendee_id);
+            return (it != paymentsByAttendee.end()) ? it->second : std::vector<std::shared_ptr<Model::Payment>>();
         }
 
         /**
@@ -225,11 +565,15 @@ namespace PaymentManager {
          * @return Vector of payments with the specified status
          */
         std::vector<std::shared_ptr<Model::Payment>> getPaymentsByStatus(Model::PaymentStatus status) {
+            std::lock_guard<std::recursive_mutex> lock(paymentMutex);
             std::vector<std::shared_ptr<Model::Payment>> result;
-            std::copy_if(entities.begin(), entities.end(), std::back_inserter(result),
-                [status](const std::shared_ptr<Model::Payment>& payment) {
-                    return payment->status == status;
-                });
+            auto it = paymentsByStatus.find(status);
+            if (it != paymentsByStatus.end()) {
+                result.reserve(it->second.size());
+                for (const auto& entry : it->second) {
+                    result.push_back(entry.second);
+                }
+            }
             return result;
         }
 
@@ -241,6 +585,7 @@ namespace PaymentManager {
          */
         std::vector<std::shared_ptr<Model::Payment>> getPaymentsByDateRange(
             const std::string& start_date, const std::string& end_date) {
+            std::lock_guard<std::recursive_mutex> lock(paymentMutex);
             std::vector<std::shared_ptr<Model::Payment>> result;
             std::copy_if(entities.begin(), entities.end(), std::back_inserter(result),
                 [&start_date, &end_date](const std::shared_ptr<Model::Payment>& payment) {
@@ -253,19 +598,53 @@ namespace PaymentManager {
         /**
          * @brief Get recent payments (last N payments)
          * @param limit Number of recent payments to retrieve (default: 30)
-         * @return Vector of recent payments
+         * @return Vector of recent payments, newest first
          */
         std::vector<std::shared_ptr<Model::Payment>> getRecentPayments(int limit = 30) {
-            std::vector<std::shared_ptr<Model::Payment>> sorted_payments = entities;
-            std::sort(sorted_payments.begin(), sorted_payments.end(),
-                [](const std::shared_ptr<Model::Payment>& a, const std::shared_ptr<Model::Payment>& b) {
-                    return a->payment_date_time.iso8601String > b->payment_date_time.iso8601String;
-                });
-            
-            if (sorted_payments.size() > static_cast<size_t>(limit)) {
-                sorted_payments.resize(limit);
+            std::lock_guard<std::recursive_mutex> lock(paymentMutex);
+            std::vector<std::shared_ptr<Model::Payment>> result;
+            if (limit <= 0) {
+                return result;
+            }
+            result.reserve(std::min(static_cast<size_t>(limit), paymentsByTime.size()));
+            for (auto it = paymentsByTime.rbegin(); 
+                 it != paymentsByTime.rend() && result.size() < static_cast<size_t>(limit); ++it) {
+                result.push_back(it->second);
+            }
+            return result;
+        }
+
+        /**
+         * @brief Position in the newest-first payment listing
+         */
+        struct PaymentCursor {
+            std::string timestamp; // Empty: start from the newest payment
+            int payment_id = 0;
+        };
+
+        /**
+         * @brief Get the next page of payments, newest first
+         * @param cursor Position after the previous page; advanced to the last payment returned
+         * @param limit Maximum number of payments to return
+         * @param status Only return payments with this status (all if not set)
+         * @return Payments of the page; fewer than limit when the listing is exhausted
+         */
+        std::vector<std::shared_ptr<Model::Payment>> getRecentPaymentsPage(
+            PaymentCursor& cursor, size_t limit,
+            std::optional<Model::PaymentStatus> status = std::nullopt) {
+            std::lock_guard<std::recursive_mutex> lock(paymentMutex);
+            std::vector<std::shared_ptr<Model::Payment>> page;
+            auto it = cursor.timestamp.empty() ? paymentsByTime.end()
+                                               : paymentsByTime.lower_bound({cursor.timestamp, cursor.payment_id});
+            while (it != paymentsByTime.begin() && page.size() < limit) {
+                --it;
+                if (!status || it->second->status == *status) {
+                    page.push_back(it->second);
+                }
+                cursor.timestamp = it->first.first;
+                cursor.payment_id = it->first.second;
             }
-            return sorted_payments;
+            return page;
         }
 
         // Transaction Management
@@ -289,54 +668,218 @@ namespace PaymentManager {
         bool handleTransactionCallback(const std::string& transaction_id,
                                      const std::string& status,
                                      const std::string& gateway_response) {
-            auto it = std::find_if(entities.begin(), entities.end(),
-                [&transaction_id](const std::shared_ptr<Model::Payment>& payment) {
-                    return payment->transaction_id == transaction_id;
-                });
-            
-            if (it == entities.end()) {
+            std::unique_lock<std::recursive_mutex> lock(paymentMutex);
+            auto payment = getPaymentByTransactionId(transaction_id);
+            if (!payment) {
                 return false;
             }
 
-            auto payment = *it;
-            payment->payment_date_time = Model::DateTime::now();
-
             if (status == "completed") {
-                payment->status = Model::PaymentStatus::COMPLETED;
+                setPaymentStatus(payment, Model::PaymentStatus::COMPLETED);
             } else if (status == "failed") {
-                payment->status = Model::PaymentStatus::FAILED;
+                setPaymentStatus(payment, Model::PaymentStatus::FAILED);
+            } else {
+                setPaymentStatus(payment, payment->status);
             }
+            uint64_t ticket = logUpsert(*payment);
 
-            saveEntities();
             logPaymentTransaction(*payment, "CALLBACK_PROCESSED");
-            return true;
+            lock.unlock();
+            return awaitDurable(ticket);
         }
 
         // Analytics and Reporting
 
+        /**
+         * @brief Exact total of payment amounts, scanned from the columnar amount array
+         * @param status Only sum payments with this status (all if not set)
+         * @param currency Only sum payments in this currency (all if empty; amounts are then added as-is)
+         * @param sign 1 for positive amounts only, -1 for refund records only, 0 for both
+         * @return Sum in minor units
+         */
+        Model::Money sumAmounts(std::optional<Model::PaymentStatus> status = std::nullopt,
+                                const std::string& currency = "", int sign = 0) const {
+            std::lock_guard<std::recursive_mutex> lock(paymentMutex);
+            uint16_t currencyKey = 0;
+            if (!currency.empty()) {
+                auto it = std::find(currencyDictionary.begin(), currencyDictionary.end(), currency);
+                if (it == currencyDictionary.end()) {
+                    return Model::Money();
+                }
+                currencyKey = static_cast<uint16_t>(it - currencyDictionary.begin());
+            }
+            const bool anyStatus = !status;
+            const bool anyCurrency = currency.empty();
+            const uint8_t statusKey = status ? static_cast<uint8_t>(*status) : 0;
+            const bool positive = sign >= 0;
+            const bool negative = sign <= 0;
+
+            const size_t n = amountColumn.size();
+            const int64_t* amounts = amountColumn.data();
+            const uint8_t* statuses = statusColumn.data();
+            const uint16_t* currencies = currencyColumn.data();
+            int64_t total = 0;
+            // Branch-free masked sum over plain arrays so the compiler can vectorize it
+            for (size_t i = 0; i < n; ++i) {
+                bool match = (statuses[i] != DELETED_SLOT) &
+                             (anyStatus | (statuses[i] == statusKey)) &
+                             (anyCurrency | (currencies[i] == currencyKey)) &
+                             ((positive & (amounts[i] > 0)) | (negative & (amounts[i] < 0)));
+                total += amounts[i] & -static_cast<int64_t>(match);
+            }
+            return Model::Money{total};
+        }
+
+        /**
+         * @brief Visit every payment record under the module lock
+         * @param visitor Called once per payment, in creation order
+         */
+        void visitPayments(const std::function<void(const Model::Payment&)>& visitor) const {
+            std::lock_guard<std::recursive_mutex> lock(paymentMutex);
+            for (const auto& payment : entities) {
+                visitor(*payment);
+            }
+        }
+
+        /**
+         * @brief Get the currencies that appear in payment records
+         * @return Currency codes in first-seen order
+         */
+        std::vector<std::string> getCurrencies() const {
+            std::lock_guard<std::recursive_mutex> lock(paymentMutex);
+            return currencyDictionary;
+        }
+
         /**
          * @brief Calculate total revenue for a date range
          * @param start_date Start date (ISO 8601 format)
          * @param end_date End date (ISO 8601 format)
-         * @param currency Currency to filter by (empty for all)
-         * @return Total revenue amount
+         * @param currency Currency to filter by (empty for all, converted to the base currency)
+         * @return Total revenue amount in major units
          */
         double calculateRevenue(const std::string& start_date, 
                               const std::string& end_date,
                               const std::string& currency = "") {
-            double total = 0.0;
-            for (const auto& payment : entities) {
-                if (payment->status == Model::PaymentStatus::COMPLETED &&
-                    payment->amount > 0 && // Exclude refunds
-                    payment->payment_date_time.iso8601String >= start_date &&
-                    payment->payment_date_time.iso8601String <= end_date &&
-                    (currency.empty() || payment->currency == currency)) {
-                    total += payment->amount;
+            std::lock_guard<std::recursive_mutex> lock(paymentMutex);
+            if (currency.empty()) {
+                const std::string& base = rates.getBaseCurrency();
+                return calculateConsolidatedRevenue(start_date, end_date, base).toMajor(base);
+            }
+            Model::Money total;
+            for (const auto& entry : rollupRange(start_date, end_date)) {
+                const RollupKey& key = entry.first;
+                if (key.status == Model::PaymentStatus::COMPLETED &&
+                    !key.refund && // Exclude refunds
+                    key.currency == currency) {
+                    total += entry.second.amount;
+                }
+            }
+            return total.toMajor(currency);
+        }
+
+        /**
+         * @brief Completed revenue of a date range in one currency
+         *
+         * Each day's rollups are converted at that day's rates, one conversion
+         * per currency and day rather than per payment.
+         * @param start_date Start date (ISO 8601 format)
+         * @param end_date End date (ISO 8601 format)
+         * @param target Currency to report in
+         * @return Revenue in minor units of target
+         */
+        Model::Money calculateConsolidatedRevenue(const std::string& start_date,
+                                                  const std::string& end_date,
+                                                  const std::string& target) {
+            std::lock_guard<std::recursive_mutex> lock(paymentMutex);
+            // Sum per (day, currency) exactly, then convert each sum once
+            std::map<std::pair<std::string, std::string>, Model::Money> dailyTotals;
+            visitRollupRange(start_date, end_date, [&dailyTotals](const std::string& day, const RollupBucket& bucket) {
+                for (const auto& entry : bucket) {
+                    if (entry.first.status == Model::PaymentStatus::COMPLETED && !entry.first.refund) {
+                        dailyTotals[{day, entry.first.currency}] += entry.second.amount;
+                    }
                 }
+            });
+            Model::Money total;
+            for (const auto& entry : dailyTotals) {
+                total += rates.convert(entry.second, entry.first.second, target, entry.first.first);
+            }
+            return total;
+        }
+
+        /**
+         * @brief Whole-table total in one currency, from the columnar amounts
+         *
+         * Runs one vectorized masked sum per currency and converts each sum
+         * at the rates in effect on as_of_date.
+         * @param status Only sum payments with this status (all if not set)
+         * @param target Currency to report in
+         * @param as_of_date Rate date ("YYYY-MM-DD"; empty for today)
+         * @param sign 1 for positive amounts only, -1 for refund records only, 0 for both
+         * @return Total in minor units of target
+         */
+        Model::Money sumAmountsConverted(std::optional<Model::PaymentStatus> status,
+                                         const std::string& target,
+                                         const std::string& as_of_date = "", int sign = 0) const {
+            std::lock_guard<std::recursive_mutex> lock(paymentMutex);
+            std::string date = as_of_date.empty() ? Model::DateTime::now().iso8601String.substr(0, 10) : as_of_date;
+            Model::Money total;
+            for (const auto& currency : currencyDictionary) {
+                total += rates.convert(sumAmounts(status, currency, sign), currency, target, date);
             }
             return total;
         }
 
+        /**
+         * @brief Load exchange rates from a rate file (see CurrencyRateTable)
+         * @param path Path to the rate file
+         * @return true if the file was read
+         */
+        bool loadRateTable(const std::string& path) {
+            std::lock_guard<std::recursive_mutex> lock(paymentMutex);
+            ++rateRevision;
+            reportCache.clear();
+            return rates.loadFromFile(path);
+        }
+
+        /**
+         * @brief Set an exchange rate from a date on
+         * @param effective_date First day the rate applies ("YYYY-MM-DD")
+         * @param currency Currency code
+         * @param per_base Units of currency per unit of the base currency
+         */
+        void setExchangeRate(const std::string& effective_date, const std::string& currency, double per_base) {
+            std::lock_guard<std::recursive_mutex> lock(paymentMutex);
+            ++rateRevision;
+            reportCache.clear(); // Converted totals of every period may change
+            rates.setRate(effective_date, currency, per_base);
+        }
+
+        /**
+         * @brief Counter bumped whenever the rate table changes, for callers caching converted totals
+         */
+        uint64_t getRateRevision() const {
+            std::lock_guard<std::recursive_mutex> lock(paymentMutex);
+            return rateRevision;
+        }
+
+        /**
+         * @brief Convert an amount at the rates in effect on a date
+         */
+        Model::Money convertAmount(Model::Money amount, const std::string& from,
+                                   const std::string& to, const std::string& date) const {
+            std::lock_guard<std::recursive_mutex> lock(paymentMutex);
+            return rates.convert(amount, from, to, date);
+        }
+
+        /**
+         * @brief Currency that mixed-currency totals are reported in
+         */
+        std::string getBaseCurrency() const {
+            std::lock_guard<std::recursive_mutex> lock(paymentMutex);
+            return rates.getBaseCurrency();
+        }
+
         /**
          * @brief Get payment statistics
          * @return Payment statistics struct
@@ -352,40 +895,49 @@ namespace PaymentManager {
             std::string most_used_payment_method;
         };
         PaymentStats getPaymentStatistics() {
+            std::lock_guard<std::recursive_mutex> lock(paymentMutex);
             PaymentStats stats = {};
             std::map<std::string, int> methodCount;
-            double totalAmount = 0.0;
+            Model::Money totalAmount;
+            Model::Money totalRevenue;
             int validPayments = 0;
+            const std::string& base = rates.getBaseCurrency();
+            std::string today = Model::DateTime::now().iso8601String.substr(0, 10);
 
-            for (const auto& payment : entities) {
-                stats.total_payments++;
+            // All-time rollup cells: one per currency/method/status, not per payment
+            for (const auto& entry : rollupTotals) {
+                const RollupKey& key = entry.first;
+                const RollupCell& cell = entry.second;
+                stats.total_payments += cell.count;
                 
-                switch (payment->status) {
+                switch (key.status) {
                     case Model::PaymentStatus::COMPLETED:
-                        stats.completed_payments++;
-                        if (payment->amount > 0) {
-                            stats.total_revenue += payment->amount;
+                        stats.completed_payments += cell.count;
+                        if (!key.refund) {
+                            totalRevenue += rates.convert(cell.amount, key.currency, base, today);
                         }
                         break;
                     case Model::PaymentStatus::PENDING:
-                        stats.pending_payments++;
+                        stats.pending_payments += cell.count;
                         break;
                     case Model::PaymentStatus::FAILED:
-                        stats.failed_payments++;
+                        stats.failed_payments += cell.count;
                         break;
                     case Model::PaymentStatus::REFUNDED:
-                        stats.refunded_payments++;
+                        stats.refunded_payments += cell.count;
                         break;
                 }
 
-                if (payment->amount > 0) {
-                    totalAmount += payment->amount;
-                    validPayments++;
-                    methodCount[payment->payment_method]++;
+                if (!key.refund) {
+                    totalAmount += rates.convert(cell.amount, key.currency, base, today);
+                    validPayments += cell.count;
+                    methodCount[key.payment_method] += cell.count;
                 }
             }
 
-            stats.average_payment_amount = validPayments > 0 ? totalAmount / validPayments : 0.0;
+            // Amounts in the base currency at today's rates
+            stats.total_revenue = totalRevenue.toMajor(base);
+            stats.average_payment_amount = validPayments > 0 ? totalAmount.toMajor(base) / validPayments : 0.0;
             
             // Find most used payment method
             int maxCount = 0;
@@ -411,29 +963,39 @@ namespace PaymentManager {
         }
         std::string generatePaymentReport(const std::string& start_date, 
                                         const std::string& end_date) {
-            auto payments = getPaymentsByDateRange(start_date, end_date);
+            std::lock_guard<std::recursive_mutex> lock(paymentMutex);
+            std::string key = ReportCache<std::string>::makeKey("payment", {start_date, end_date});
+            std::string cached;
+            uint64_t version = 0;
+            if (reportCache.lookup(key, cached, version)) {
+                return cached;
+            }
+            RollupBucket cells = rollupRange(start_date, end_date);
             std::ostringstream report;
             
             report << "Payment Report (" << numericDate(start_date) << " to " << numericDate(end_date) << ")\n";
             report << "=====================================\n\n";
             
-            double totalRevenue = calculateRevenue(start_date, end_date);
-            report << "Total Revenue: $" << std::fixed << std::setprecision(2) << totalRevenue << "\n";
-            report << "Total Transactions: " << payments.size() << "\n\n";
-            
-            std::map<std::string, double> currencyTotals;
+            int transactionCount = 0;
+            std::map<std::string, Model::Money> currencyTotals;
             std::map<std::string, int> methodCounts;
             
-            for (const auto& payment : payments) {
-                if (payment->status == Model::PaymentStatus::COMPLETED && payment->amount > 0) {
-                    currencyTotals[payment->currency] += payment->amount;
-                    methodCounts[payment->payment_method]++;
+            for (const auto& entry : cells) {
+                transactionCount += entry.second.count;
+                if (entry.first.status == Model::PaymentStatus::COMPLETED && !entry.first.refund) {
+                    currencyTotals[entry.first.currency] += entry.second.amount;
+                    methodCounts[entry.first.payment_method] += entry.second.count;
                 }
             }
             
+            const std::string& base = rates.getBaseCurrency();
+            Model::Money totalRevenue = calculateConsolidatedRevenue(start_date, end_date, base);
+            report << "Total Revenue: " << totalRevenue.toString(base) << " " << base << " (at daily rates)\n";
+            report << "Total Transactions: " << transactionCount << "\n\n";
+            
             report << "Revenue by Currency:\n";
             for (const auto& pair : currencyTotals) {
-                report << "  " << pair.first << ": " << std::fixed << std::setprecision(2) << pair.second << "\n";
+                report << "  " << pair.first << ": " << pair.second.toString(pair.first) << "\n";
             }
             
             report << "\nPayment Methods:\n";
@@ -441,93 +1003,923 @@ namespace PaymentManager {
                 report << "  " << pair.first << ": " << pair.second << " transactions\n";
             }
             
-            return report.str();
+            std::string result = report.str();
+            reportCache.store(key, start_date, end_date, 1, result, version);
+            return result;
         }
 
-    protected:
-        // BaseModule implementation
-        int getEntityId(const std::shared_ptr<Model::Payment>& entity) const override {
-            return entity->payment_id;
+        /**
+         * @brief Hit/miss counters of the payment report cache
+         *
+         * Cached reports are dropped when a payment stamped inside their
+         * period is added, changed or deleted, or when the rates change.
+         */
+        ReportCacheStats getReportCacheStats() const {
+            return reportCache.getStats();
         }
-        
-        void loadEntities() override {
-            entities.clear();
-            std::ifstream file(dataFilePath, std::ios::binary);
-            if (!file.is_open()) {
-                return; // File doesn't exist yet, start with empty collection
+
+        /**
+         * @brief Delete a payment record and drop it from the lookup indexes
+         * @param payment_id Payment ID to delete
+         * @return true if successful, false otherwise
+         */
+        bool deleteEntity(int payment_id) override {
+            std::unique_lock<std::recursive_mutex> lock(paymentMutex);
+            auto payment = getPaymentById(payment_id);
+            if (!payment) {
+                return false;
             }
+            removePayment(payment);
+            std::string record(1, 'D');
+            appendRaw(record, payment_id);
+            uint64_t ticket = appendLog(record);
+            lock.unlock();
+            return awaitDurable(ticket);
+        }
 
-            size_t count;
-            file.read(reinterpret_cast<char*>(&count), sizeof(count));
-            
-            for (size_t i = 0; i < count; ++i) {
-                auto payment = std::make_shared<Model::Payment>();
-                
-                // Read payment data
-                file.read(reinterpret_cast<char*>(&payment->payment_id), sizeof(payment->payment_id));
-                file.read(reinterpret_cast<char*>(&payment->amount), sizeof(payment->amount));
-                file.read(reinterpret_cast<char*>(&payment->status), sizeof(payment->status));
-                
-                // Read strings
-                size_t len;
-                file.read(reinterpret_cast<char*>(&len), sizeof(len));
-                payment->currency.resize(len);
-                file.read(&payment->currency[0], len);
-                
-                file.read(reinterpret_cast<char*>(&len), sizeof(len));
-                payment->payment_method.resize(len);
-                file.read(&payment->payment_method[0], len);
-                
-                file.read(reinterpret_cast<char*>(&len), sizeof(len));
-                payment->transaction_id.resize(len);
-                file.read(&payment->transaction_id[0], len);
-                
-                file.read(reinterpret_cast<char*>(&len), sizeof(len));
-                payment->payment_date_time.iso8601String.resize(len);
-                file.read(&payment->payment_date_time.iso8601String[0], len);
-                
+        /**
+         * @brief Group commit counters
+         */
+        struct CommitStats {
+            uint64_t records = 0;      // Log records made durable
+            uint64_t batches = 0;      // fsync'd log writes
+            uint64_t checkpoints = 0;  // Full snapshot rewrites
+            uint64_t logRecords = 0;   // Records in the current log
+            uint64_t failedCommits = 0; // Batches neither written nor covered by a checkpoint
+        };
+
+        /**
+         * @brief Get the group commit counters
+         * @return Counters since the module was opened
+         */
+        CommitStats getCommitStats() {
+            std::lock_guard<std::mutex> lock(commitMutex);
+            CommitStats stats = commitStats;
+            stats.logRecords = logRecords;
+            return stats;
+        }
+
+        /**
+         * @brief Set how long a commit leader holds a batch open under concurrent writes
+         * @param window Batch window (0 commits as soon as the previous fsync finishes)
+         */
+        void setGroupCommitWindow(std::chrono::microseconds window) {
+            std::lock_guard<std::mutex> lock(commitMutex);
+            commitWindow = window;
+        }
+
+        /**
+         * @brief Payment change notifications
+         *
+         * Published wherever the rollups change, so listeners see the same
+         * deltas: the old image (-1) and the new one (+1) of each updated
+         * payment. Listeners run with the payment lock held.
+         */
+        ChangeFeed<Model::Payment>& getChangeFeed() {
+            return changeFeed;
+        }
+
+    protected:
+        // BaseModule implementation
+        int getEntityId(const std::shared_ptr<Model::Payment>& entity) const override {
+            return entity->payment_id;
+        }
+        
+        void loadEntities() override {
+            if (logFile) {
+                std::fclose(logFile);
+                logFile = nullptr;
+            }
+            entities.clear();
+            paymentsById.clear();
+            paymentsByTransaction.clear();
+            paymentsByAttendee.clear();
+            paymentsByStatus.clear();
+            paymentsByTime.clear();
+            amountColumn.clear();
+            statusColumn.clear();
+            currencyColumn.clear();
+            currencyDictionary.clear();
+            columnSlot.clear();
+            clearRollups();
+            revision = 0;
+            std::ifstream file(dataFilePath, std::ios::binary);
+            if (!file.is_open()) {
+                return; // File doesn't exist yet, start with empty collection
+            }
+
+            // Version 1 adds attendee_id; legacy files load with attendee_id = 0.
+            // Version 2 adds the save revision that ties the rollup file to this one.
+            // Version 3 stores amounts in minor units; older double amounts are rounded.
+            uint32_t version = readFormatVersion(file);
+            if (version >= 2) {
+                readBinary(file, revision);
+            }
+
+            size_t count;
+            file.read(reinterpret_cast<char*>(&count), sizeof(count));
+            
+            for (size_t i = 0; i < count; ++i) {
+                auto payment = std::make_shared<Model::Payment>();
+                if (!readPaymentRecord(file, version, *payment)) {
+                    break;
+                }
                 entities.push_back(payment);
+                indexPayment(payment);
             }
             file.close();
+
+            // Rollups from an older or interrupted save are rebuilt from the payments
+            if (!loadRollups()) {
+                clearRollups();
+                for (const auto& payment : entities) {
+                    rollPayment(*payment, 1);
+                }
+            }
+
+            // Changes committed after the snapshot live in the log. Keep appending
+            // to it unless it ends in a torn record, which a checkpoint discards.
+            size_t replayed = 0;
+            bool clean = true;
+            if (replayLog(replayed, clean)) {
+                logRecords = replayed;
+                if (!clean) {
+                    saveEntities();
+                } else {
+                    logFile = std::fopen(logPath().c_str(), "ab");
+                }
+            }
         }
         
+        /**
+         * @brief Checkpoint: write a full snapshot and start an empty commit log
+         *
+         * Log records still waiting for a group commit are covered by the
+         * snapshot, so their writers are released as durable.
+         */
         bool saveEntities() override {
-            std::ofstream file(dataFilePath, std::ios::binary);
-            if (!file.is_open()) {
+            std::lock_guard<std::recursive_mutex> lock(paymentMutex);
+            std::unique_lock<std::mutex> commitLock(commitMutex);
+            commitDone.wait(commitLock, [this]() { return !committing; });
+
+            std::string image;
+            appendRaw(image, FORMAT_MAGIC);
+            appendRaw(image, PAYMENT_FORMAT_VERSION);
+            appendRaw(image, revision + 1);
+            appendRaw(image, entities.size());
+            for (const auto& payment : entities) {
+                appendPaymentRecord(image, *payment);
+            }
+            if (!writeDurably(dataFilePath, image)) {
                 return false;
             }
+            ++revision;
+            saveRollups(); // Rebuilt from the payments if this one is lost
 
-            size_t count = entities.size();
-            file.write(reinterpret_cast<const char*>(&count), sizeof(count));
-            
-            for (const auto& payment : entities) {
-                file.write(reinterpret_cast<const char*>(&payment->payment_id), sizeof(payment->payment_id));
-                file.write(reinterpret_cast<const char*>(&payment->amount), sizeof(payment->amount));
-                file.write(reinterpret_cast<const char*>(&payment->status), sizeof(payment->status));
-                
-                // Write strings
-                size_t len = payment->currency.size();
-                file.write(reinterpret_cast<const char*>(&len), sizeof(len));
-                file.write(payment->currency.c_str(), len);
-                
-                len = payment->payment_method.size();
-                file.write(reinterpret_cast<const char*>(&len), sizeof(len));
-                file.write(payment->payment_method.c_str(), len);
-                
-                len = payment->transaction_id.size();
-                file.write(reinterpret_cast<const char*>(&len), sizeof(len));
-                file.write(payment->transaction_id.c_str(), len);
-                
-                len = payment->payment_date_time.iso8601String.size();
-                file.write(reinterpret_cast<const char*>(&len), sizeof(len));
-                file.write(payment->payment_date_time.iso8601String.c_str(), len);
+            // The old log belongs to the previous revision, so a crash between
+            // the two renames simply ignores it on the next load
+            if (logFile) {
+                std::fclose(logFile);
+                logFile = nullptr;
             }
-            
-            file.close();
-            return true;
+            logBroken = false;
+            std::string header;
+            appendRaw(header, FORMAT_MAGIC);
+            appendRaw(header, LOG_FORMAT_VERSION);
+            appendRaw(header, revision);
+            bool ok = writeDurably(logPath(), header);
+            if (ok) {
+                logFile = std::fopen(logPath().c_str(), "ab");
+            }
+
+            pendingLog.clear();
+            durableSeq = appendedSeq;
+            logRecords = 0;
+            ++commitStats.checkpoints;
+            commitDone.notify_all();
+            return ok && logFile != nullptr;
         }
 
     private:
+        static constexpr uint32_t PAYMENT_FORMAT_VERSION = 3;
+
+        // Guards all payment state; gateway calls run without it
+        mutable std::recursive_mutex paymentMutex;
+
+        // Listeners for payment changes
+        ChangeFeed<Model::Payment> changeFeed;
+
+        // Payment reports by period, invalidated from rollPayment
+        ReportCache<std::string> reportCache;
+        uint64_t rateRevision = 0;
+
+        // Gateway pipeline, started on first submission
+        std::shared_ptr<PaymentGateway> gateway;
+        size_t gatewayWorkers = 4;
+        std::unique_ptr<WorkerPool> gatewayPool;
+
+        // Exchange rates for mixed-currency totals
+        CurrencyRateTable rates;
+
+        // Client idempotency key -> submission (kept for the lifetime of the module)
+        std::unordered_map<std::string, PaymentSubmission> submissions;
+
+        // Commit log: records appended after the last checkpoint, fsync'd in batches
+        static constexpr uint32_t LOG_FORMAT_VERSION = 1;
+        static constexpr uint64_t CHECKPOINT_RECORDS = 4096;
+        static constexpr size_t MAX_FIELD_BYTES = 1 << 16; // Guards against a torn length
+        std::mutex commitMutex;                   // Guards everything below
+        std::condition_variable commitDone;
+        std::string pendingLog;                   // Encoded records not yet written
+        uint64_t appendedSeq = 0;                 // Last record sequence handed out
+        uint64_t durableSeq = 0;                  // Records up to here are on disk
+        uint64_t failedThrough = 0;               // Last record of the most recent failed commit
+        bool logBroken = false;                   // A batch write failed; checkpoint before appending again
+        bool committing = false;                  // A leader is writing a batch
+        int waitingWriters = 0;
+        std::chrono::microseconds commitWindow{500};
+        FILE* logFile = nullptr;
+        uint64_t logRecords = 0;
+        CommitStats commitStats;
+
+        std::string logPath() const {
+            return dataFilePath + ".log";
+        }
+
+        template<typename T>
+        static void appendRaw(std::string& out, const T& value) {
+            out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        static void appendText(std::string& out, const std::string& text) {
+            appendRaw(out, text.size());
+            out.append(text);
+        }
+
+        /**
+         * @brief Encode one payment in the current record layout
+         */
+        static void appendPaymentRecord(std::string& out, const Model::Payment& payment) {
+            appendRaw(out, payment.payment_id);
+            appendRaw(out, payment.amount.minor);
+            appendRaw(out, payment.status);
+            appendText(out, payment.currency);
+            appendText(out, payment.payment_method);
+            appendText(out, payment.transaction_id);
+            appendText(out, payment.payment_date_time.iso8601String);
+            appendRaw(out, payment.attendee_id);
+        }
+
+        /**
+         * @brief Decode one payment record written with the given format version
+         * @return false if the record is truncated
+         */
+        bool readPaymentRecord(std::ifstream& file, uint32_t version, Model::Payment& payment) {
+            auto readText = [&file](std::string& text) {
+                size_t len = 0;
+                file.read(reinterpret_cast<char*>(&len), sizeof(len));
+                if (!file || len > MAX_FIELD_BYTES) {
+                    file.setstate(std::ios::failbit);
+                    return;
+                }
+                text.resize(len);
+                file.read(&text[0], len);
+            };
+
+            readBinary(file, payment.payment_id);
+            double legacyAmount = 0.0;
+            if (version >= 3) {
+                readBinary(file, payment.amount.minor);
+            } else {
+                readBinary(file, legacyAmount);
+            }
+            readBinary(file, payment.status);
+            readText(payment.currency);
+            if (version < 3) {
+                payment.amount = Model::Money::fromMajor(legacyAmount, payment.currency);
+            }
+            readText(payment.payment_method);
+            readText(payment.transaction_id);
+            readText(payment.payment_date_time.iso8601String);
+            if (version >= 1) {
+                readBinary(file, payment.attendee_id);
+            }
+            return static_cast<bool>(file);
+        }
+
+        /**
+         * @brief Flush a stream and force it to stable storage
+         */
+        static bool syncFile(FILE* file) {
+            if (!file || std::fflush(file) != 0) {
+                return false;
+            }
+#ifdef _WIN32
+            return _commit(_fileno(file)) == 0;
+#else
+            return fsync(fileno(file)) == 0;
+#endif
+        }
+
+        /**
+         * @brief Write bytes to a temporary, sync it and rename it over path
+         */
+        static bool writeDurably(const std::string& path, const std::string& bytes) {
+            std::string tempPath = path + ".tmp";
+            FILE* out = std::fopen(tempPath.c_str(), "wb");
+            if (!out) {
+                return false;
+            }
+            bool ok = std::fwrite(bytes.data(), 1, bytes.size(), out) == bytes.size();
+            ok = syncFile(out) && ok;
+            std::fclose(out);
+            if (!ok) {
+                return false;
+            }
+            if (std::rename(tempPath.c_str(), path.c_str()) == 0) {
+                return true;
+            }
+            std::remove(path.c_str()); // rename does not overwrite on Windows
+            return std::rename(tempPath.c_str(), path.c_str()) == 0;
+        }
+
+        /**
+         * @brief Queue a payment upsert for the next group commit (caller holds paymentMutex)
+         * @return Sequence number to pass to awaitDurable
+         */
+        uint64_t logUpsert(const Model::Payment& payment) {
+            std::string record(1, 'U');
+            appendPaymentRecord(record, payment);
+            return appendLog(record);
+        }
+
+        /**
+         * @brief Queue an encoded log record (caller holds paymentMutex)
+         * @return Sequence number to pass to awaitDurable
+         */
+        uint64_t appendLog(const std::string& record) {
+            bool needCheckpoint;
+            {
+                std::lock_guard<std::mutex> lock(commitMutex);
+                needCheckpoint = !logFile || logBroken;
+            }
+            if (needCheckpoint) {
+                saveEntities(); // No usable log for this snapshot: start one from a checkpoint
+            }
+            std::lock_guard<std::mutex> lock(commitMutex);
+            pendingLog += record;
+            return ++appendedSeq;
+        }
+
+        /**
+         * @brief Block until a queued record is on disk, committing a batch if no one else is
+         *
+         * The first writer to find no commit in flight becomes the leader: it
+         * takes every record queued so far, writes and fsyncs them in one go,
+         * and wakes the writers it covered. Writers that arrive while a commit
+         * is in flight wait for it and then lead the next batch together. With
+         * several writers waiting the leader also holds the batch open for
+         * commitWindow so stragglers share its fsync.
+         *
+         * If the write or fsync fails, durableSeq stays put and the batch is
+         * queued again. The log may now end in part of that batch, so nothing
+         * more is appended to it; the leader checkpoints instead. Writers the
+         * batch covered get false only if that checkpoint fails too.
+         *
+         * @param ticket Sequence number from logUpsert/appendLog
+         * @return true if the record was synced (or folded into a checkpoint)
+         */
+        bool awaitDurable(uint64_t ticket) {
+            std::unique_lock<std::mutex> lock(commitMutex);
+            ++waitingWriters;
+            uint64_t failuresSeen = commitStats.failedCommits;
+            while (durableSeq < ticket) {
+                if (commitStats.failedCommits != failuresSeen && failedThrough >= ticket) {
+                    break; // A commit covering this record failed and could not be checkpointed
+                }
+                if (committing) {
+                    commitDone.wait(lock);
+                    continue;
+                }
+                committing = true;
+                if (waitingWriters > 1 && commitWindow.count() > 0) {
+                    lock.unlock();
+                    std::this_thread::sleep_for(commitWindow);
+                    lock.lock();
+                }
+                std::string batch;
+                batch.swap(pendingLog);
+                uint64_t batchStart = durableSeq + 1;
+                uint64_t batchEnd = appendedSeq;
+                FILE* target = logBroken ? nullptr : logFile;
+                lock.unlock();
+
+                bool ok = target && std::fwrite(batch.data(), 1, batch.size(), target) == batch.size();
+                ok = syncFile(target) && ok;
+
+                lock.lock();
+                committing = false;
+                if (ok) {
+                    durableSeq = batchEnd;
+                    ++commitStats.batches;
+                    commitStats.records += batchEnd - batchStart + 1;
+                    logRecords += batchEnd - batchStart + 1;
+                    commitDone.notify_all();
+                    continue;
+                }
+                pendingLog.insert(0, batch);
+                logBroken = true;
+                commitDone.notify_all();
+                lock.unlock();
+                {
+                    std::lock_guard<std::recursive_mutex> relock(paymentMutex);
+                    saveEntities(); // Covers the batch if the snapshot can be written
+                }
+                lock.lock();
+                if (durableSeq < batchEnd) {
+                    failedThrough = batchEnd;
+                    ++commitStats.failedCommits;
+                    commitDone.notify_all();
+                }
+            }
+            --waitingWriters;
+            bool durable = durableSeq >= ticket;
+            bool compact = logRecords >= CHECKPOINT_RECORDS;
+            lock.unlock();
+
+            // Compact once the log outgrows the snapshot it would replace
+            if (compact) {
+                std::lock_guard<std::recursive_mutex> relock(paymentMutex);
+                uint64_t records = getCommitStats().logRecords;
+                if (records >= CHECKPOINT_RECORDS && records > 2 * entities.size()) {
+                    saveEntities();
+                }
+            }
+            return durable;
+        }
+
+        /**
+         * @brief Apply the commit log written since the loaded snapshot
+         * @param replayed Set to the number of records applied
+         * @param clean Set to false if the log ends in a torn record
+         * @return true if a log for this snapshot revision exists
+         */
+        bool replayLog(size_t& replayed, bool& clean) {
+            std::ifstream file(logPath(), std::ios::binary);
+            if (!file.is_open() || readFormatVersion(file) != LOG_FORMAT_VERSION) {
+                return false;
+            }
+            uint64_t logRevision = 0;
+            readBinary(file, logRevision);
+            if (!file || logRevision != revision) {
+                return false; // Written for an older snapshot that already covers it
+            }
+
+            char op = 0;
+            while (file.read(&op, 1)) {
+                if (op == 'U') {
+                    Model::Payment record;
+                    if (!readPaymentRecord(file, PAYMENT_FORMAT_VERSION, record)) {
+                        clean = false;
+                        break;
+                    }
+                    auto existing = getPaymentById(record.payment_id);
+                    if (existing) {
+                        unindexPayment(existing);
+                        rollPayment(*existing, -1);
+                        *existing = record;
+                        indexPayment(existing);
+                        rollPayment(*existing, 1);
+                    } else {
+                        auto payment = std::make_shared<Model::Payment>(record);
+                        entities.push_back(payment);
+                        indexPayment(payment);
+                        rollPayment(*payment, 1);
+                    }
+                } else if (op == 'D') {
+                    int payment_id = 0;
+                    readBinary(file, payment_id);
+                    if (!file) {
+                        clean = false;
+                        break;
+                    }
+                    auto existing = getPaymentById(payment_id);
+                    if (existing) {
+                        removePayment(existing);
+                    }
+                } else {
+                    clean = false;
+                    break;
+                }
+                ++replayed;
+            }
+            return true;
+        }
+
+        /**
+         * @brief Start the gateway pool (and the default simulated gateway) on first use
+         * @return The gateway to charge through
+         */
+        std::shared_ptr<PaymentGateway> ensureGateway() {
+            if (!gateway) {
+                gateway = std::make_shared<SimulatedGateway>();
+            }
+            if (!gatewayPool) {
+                gatewayPool.reset(new WorkerPool(gatewayWorkers));
+            }
+            return gateway;
+        }
+        static constexpr uint32_t ROLLUP_FORMAT_VERSION = 2;
+
+        /**
+         * @brief Rollup dimensions: one cell per currency, method, status and sign
+         */
+        struct RollupKey {
+            std::string currency;
+            std::string payment_method;
+            Model::PaymentStatus status;
+            bool refund; // Refund records carry negative amounts
+
+            bool operator<(const RollupKey& other) const {
+                return std::tie(currency, payment_method, status, refund) <
+                       std::tie(other.currency, other.payment_method, other.status, other.refund);
+            }
+        };
+
+        /**
+         * @brief Payment count and amount total of one rollup cell
+         */
+        struct RollupCell {
+            int count = 0;
+            Model::Money amount;
+        };
+
+        using RollupBucket = std::map<RollupKey, RollupCell>;
+
+        // Hour ("YYYY-MM-DDThh") -> rollup cells, persisted next to the payment file
+        std::map<std::string, RollupBucket> hourlyRollups;
+
+        // Day ("YYYY-MM-DD") -> rollup cells, derived from the hourly buckets
+        std::map<std::string, RollupBucket> dailyRollups;
+
+        // All-time rollup cells for statistics
+        RollupBucket rollupTotals;
+
+        // Save counter written to both the payment file and the rollup file
+        uint64_t revision = 0;
+
+        // Payment ID -> payment
+        std::unordered_map<int, std::shared_ptr<Model::Payment>> paymentsById;
+
+        // Transaction ID -> payment (first record wins if a gateway ID repeats)
+        std::unordered_map<std::string, std::shared_ptr<Model::Payment>> paymentsByTransaction;
+
+        // Attendee ID -> payments (and refund records) in creation order
+        std::unordered_map<int, std::vector<std::shared_ptr<Model::Payment>>> paymentsByAttendee;
+
+        // Status -> payments keyed by payment ID (creation order)
+        std::unordered_map<Model::PaymentStatus, std::map<int, std::shared_ptr<Model::Payment>>> paymentsByStatus;
+
+        // (timestamp, payment ID) -> payment, oldest first; restamped on status change
+        std::map<std::pair<std::string, int>, std::shared_ptr<Model::Payment>> paymentsByTime;
+
+        // Columnar copies of the summed fields, one slot per indexed payment.
+        // Deleted payments leave a DELETED_SLOT status until the next load.
+        static constexpr uint8_t DELETED_SLOT = 0xFF;
+        std::vector<int64_t> amountColumn;           // Minor units
+        std::vector<uint8_t> statusColumn;           // Model::PaymentStatus
+        std::vector<uint16_t> currencyColumn;        // Index into currencyDictionary
+        std::vector<std::string> currencyDictionary;
+        std::unordered_map<int, size_t> columnSlot;  // Payment ID -> slot
+
+        /**
+         * @brief Add a payment to the lookup indexes
+         * @param payment Payment to index
+         */
+        void indexPayment(const std::shared_ptr<Model::Payment>& payment) {
+            paymentsById[payment->payment_id] = payment;
+            paymentsByTransaction.emplace(payment->transaction_id, payment);
+            paymentsByAttendee[payment->attendee_id].push_back(payment);
+            paymentsByStatus[payment->status][payment->payment_id] = payment;
+            paymentsByTime[{payment->payment_date_time.iso8601String, payment->payment_id}] = payment;
+
+            auto currency = std::find(currencyDictionary.begin(), currencyDictionary.end(), payment->currency);
+            if (currency == currencyDictionary.end()) {
+                currency = currencyDictionary.insert(currency, payment->currency);
+            }
+            columnSlot[payment->payment_id] = amountColumn.size();
+            amountColumn.push_back(payment->amount.minor);
+            statusColumn.push_back(static_cast<uint8_t>(payment->status));
+            currencyColumn.push_back(static_cast<uint16_t>(currency - currencyDictionary.begin()));
+        }
+
+        /**
+         * @brief Remove a payment from the lookup indexes
+         * @param payment Payment to remove
+         */
+        void unindexPayment(const std::shared_ptr<Model::Payment>& payment) {
+            paymentsById.erase(payment->payment_id);
+
+            auto txn = paymentsByTransaction.find(payment->transaction_id);
+            if (txn != paymentsByTransaction.end() && txn->second == payment) {
+                paymentsByTransaction.erase(txn);
+                // Fall back to another record carrying the same gateway ID, if any
+                for (const auto& other : entities) {
+                    if (other != payment && other->transaction_id == payment->transaction_id) {
+                        paymentsByTransaction.emplace(other->transaction_id, other);
+                        break;
+                    }
+                }
+            }
+
+            auto it = paymentsByAttendee.find(payment->attendee_id);
+            if (it != paymentsByAttendee.end()) {
+                auto& bucket = it->second;
+                bucket.erase(std::remove(bucket.begin(), bucket.end(), payment), bucket.end());
+                if (bucket.empty()) {
+                    paymentsByAttendee.erase(it);
+                }
+            }
+
+            auto status = paymentsByStatus.find(payment->status);
+            if (status != paymentsByStatus.end()) {
+                status->second.erase(payment->payment_id);
+            }
+
+            paymentsByTime.erase({payment->payment_date_time.iso8601String, payment->payment_id});
+
+            auto slot = columnSlot.find(payment->payment_id);
+            if (slot != columnSlot.end()) {
+                statusColumn[slot->second] = DELETED_SLOT;
+                columnSlot.erase(slot);
+            }
+        }
+
+        /**
+         * @brief Validate, create and index a PENDING payment (caller holds paymentMutex)
+         * @return The new payment, or nullptr if the data is invalid
+         */
+        std::shared_ptr<Model::Payment> addPayment(int attendee_id, double amount, const std::string& currency,
+                                                   const std::string& payment_method, const std::string& transaction_id) {
+            Model::Money money = Model::Money::fromMajor(amount, currency);
+            if (!validatePaymentData(money, currency)) {
+                return nullptr;
+            }
+
+            auto payment = std::make_shared<Model::Payment>();
+            payment->payment_id = generateNewId();
+            payment->amount = money;
+            payment->currency = currency;
+            payment->payment_method = payment_method;
+            payment->transaction_id = transaction_id;
+            payment->status = Model::PaymentStatus::PENDING;
+            payment->payment_date_time = Model::DateTime::now();
+            payment->attendee_id = attendee_id;
+            // Note: attendee weak_ptr will be set by calling code if needed
+
+            entities.push_back(payment);
+            indexPayment(payment);
+            rollPayment(*payment, 1);
+            
+            logPaymentTransaction(*payment, "CREATED");
+            return payment;
+        }
+
+        /**
+         * @brief Drop a payment from memory, its indexes and the rollups (caller holds paymentMutex)
+         */
+        void removePayment(const std::shared_ptr<Model::Payment>& payment) {
+            unindexPayment(payment);
+            rollPayment(*payment, -1);
+            entities.erase(std::remove(entities.begin(), entities.end(), payment), entities.end());
+        }
+
+        /**
+         * @brief Change a payment's status, stamp it with the current time and
+         *        move it between status, time and rollup buckets
+         * @param payment Payment to update
+         * @param status New status
+         */
+        void setPaymentStatus(const std::shared_ptr<Model::Payment>& payment, Model::PaymentStatus status) {
+            rollPayment(*payment, -1);
+            if (payment->status != status) {
+                auto bucket = paymentsByStatus.find(payment->status);
+                if (bucket != paymentsByStatus.end()) {
+                    bucket->second.erase(payment->payment_id);
+                }
+                payment->status = status;
+                paymentsByStatus[status][payment->payment_id] = payment;
+                auto slot = columnSlot.find(payment->payment_id);
+                if (slot != columnSlot.end()) {
+                    statusColumn[slot->second] = static_cast<uint8_t>(status);
+                }
+            }
+            paymentsByTime.erase({payment->payment_date_time.iso8601String, payment->payment_id});
+            payment->payment_date_time = Model::DateTime::now();
+            paymentsByTime[{payment->payment_date_time.iso8601String, payment->payment_id}] = payment;
+            rollPayment(*payment, 1);
+        }
+
+        /**
+         * @brief Add a payment to (direction 1) or remove it from (direction -1) the
+         *        rollups, drop cached reports covering it and pass the delta to
+         *        change listeners
+         * @param payment Payment to apply
+         * @param direction 1 or -1
+         */
+        void rollPayment(const Model::Payment& payment, int direction) {
+            RollupKey key{payment.currency, payment.payment_method, payment.status, payment.amount.minor < 0};
+            addRollup(payment.payment_date_time.iso8601String.substr(0, 13), key,
+                      direction, Model::Money{direction * payment.amount.minor});
+            reportCache.invalidate(1, payment.payment_date_time.iso8601String);
+            changeFeed.publish(payment, direction);
+        }
+
+        /**
+         * @brief Apply a count/amount delta to an hour and its day and the all-time totals
+         * @param hour Hour bucket ("YYYY-MM-DDThh")
+         * @param key Rollup cell
+         * @param count Payment count delta
+         * @param amount Amount delta
+         */
+        void addRollup(const std::string& hour, const RollupKey& key, int count, Model::Money amount) {
+            std::string day = hour.substr(0, 10);
+            applyToBucket(hourlyRollups[hour], key, count, amount);
+            if (hourlyRollups[hour].empty()) {
+                hourlyRollups.erase(hour);
+            }
+            applyToBucket(dailyRollups[day], key, count, amount);
+            if (dailyRollups[day].empty()) {
+                dailyRollups.erase(day);
+            }
+            applyToBucket(rollupTotals, key, count, amount);
+        }
+
+        static void applyToBucket(RollupBucket& bucket, const RollupKey& key, int count, Model::Money amount) {
+            RollupCell& cell = bucket[key];
+            cell.count += count;
+            cell.amount += amount;
+            if (cell.count <= 0) {
+                bucket.erase(key);
+            }
+        }
+
+        void clearRollups() {
+            hourlyRollups.clear();
+            dailyRollups.clear();
+            rollupTotals.clear();
+        }
+
+        /**
+         * @brief How much of the period [first, last] lies within [start, end]
+         * @return 0 for none, 1 for part, 2 for all of it
+         */
+        static int coverage(const std::string& first, const std::string& last,
+                            const std::string& start, const std::string& end) {
+            if (last < start || first > end) return 0;
+            return (first >= start && last <= end) ? 2 : 1;
+        }
+
+        /**
+         * @brief Visit the rollup cells of all payments stamped within [start_date, end_date]
+         *
+         * Whole days come from the daily rollups and whole hours from the hourly ones;
+         * payments are only scanned for an hour that a bound cuts in the middle.
+         * @param start_date Start date (ISO 8601 format)
+         * @param end_date End date (ISO 8601 format)
+         * @param visit Called with the day ("YYYY-MM-DD") and the cells of each covered bucket
+         */
+        void visitRollupRange(const std::string& start_date, const std::string& end_date,
+                              const std::function<void(const std::string&, const RollupBucket&)>& visit) const {
+            std::string lastDay = end_date.substr(0, 10);
+            for (auto day = dailyRollups.lower_bound(start_date.substr(0, 10));
+                 day != dailyRollups.end() && day->first <= lastDay; ++day) {
+                int dayCoverage = coverage(day->first + "T00:00:00Z", day->first + "T23:59:59Z", start_date, end_date);
+                if (dayCoverage == 2) {
+                    visit(day->first, day->second);
+                    continue;
+                }
+                if (dayCoverage == 0) {
+                    continue;
+                }
+                for (auto hour = hourlyRollups.lower_bound(day->first);
+                     hour != hourlyRollups.end() && hour->first.compare(0, 10, day->first) == 0; ++hour) {
+                    int hourCoverage = coverage(hour->first + ":00:00Z", hour->first + ":59:59Z", start_date, end_date);
+                    if (hourCoverage == 2) {
+                        visit(day->first, hour->second);
+                    } else if (hourCoverage == 1) {
+                        RollupBucket partial;
+                        for (const auto& payment : entities) {
+                            const std::string& stamp = payment->payment_date_time.iso8601String;
+                            if (stamp.compare(0, 13, hour->first) == 0 && stamp >= start_date && stamp <= end_date) {
+                                RollupKey key{payment->currency, payment->payment_method, payment->status, payment->amount.minor < 0};
+                                partial[key].count += 1;
+                                partial[key].amount += payment->amount;
+                            }
+                        }
+                        visit(day->first, partial);
+                    }
+                }
+            }
+        }
+
+        /**
+         * @brief Aggregate the rollup cells of all payments stamped within [start_date, end_date]
+         * @param start_date Start date (ISO 8601 format)
+         * @param end_date End date (ISO 8601 format)
+         * @return Rollup cells summed over the range
+         */
+        RollupBucket rollupRange(const std::string& start_date, const std::string& end_date) const {
+            RollupBucket result;
+            visitRollupRange(start_date, end_date, [&result](const std::string&, const RollupBucket& bucket) {
+                for (const auto& entry : bucket) {
+                    result[entry.first].count += entry.second.count;
+                    result[entry.first].amount += entry.second.amount;
+                }
+            });
+            return result;
+        }
+
+        /**
+         * @brief Write the hourly rollups to "<payment file>.rollup"
+         * @return true if successful, false otherwise
+         */
+        bool saveRollups() {
+            std::ofstream file(dataFilePath + ".rollup", std::ios::binary);
+            if (!file.is_open()) {
+                return false;
+            }
+
+            writeFormatHeader(file, ROLLUP_FORMAT_VERSION);
+            writeBinary(file, revision);
+            size_t bucketCount = hourlyRollups.size();
+            writeBinary(file, bucketCount);
+            for (const auto& hour : hourlyRollups) {
+                writeString(file, hour.first);
+                size_t cellCount = hour.second.size();
+                writeBinary(file, cellCount);
+                for (const auto& entry : hour.second) {
+                    writeString(file, entry.first.currency);
+                    writeString(file, entry.first.payment_method);
+                    writeBinary(file, entry.first.status);
+                    uint8_t refund = entry.first.refund ? 1 : 0;
+                    writeBinary(file, refund);
+                    writeBinary(file, entry.second.count);
+                    writeBinary(file, entry.second.amount.minor);
+                }
+            }
+            return static_cast<bool>(file);
+        }
+
+        /**
+         * @brief Load the hourly rollups saved with this revision of the payment file
+         * @return true if the rollups were loaded and agree with the payments
+         */
+        bool loadRollups() {
+            if (revision == 0) {
+                return false; // Payment file predates rollups
+            }
+            std::ifstream file(dataFilePath + ".rollup", std::ios::binary);
+            if (!file.is_open() || readFormatVersion(file) != ROLLUP_FORMAT_VERSION) {
+                return false;
+            }
+
+            uint64_t savedRevision = 0;
+            readBinary(file, savedRevision);
+            if (!file || savedRevision != revision) {
+                return false; // Stale: the payment file was saved after the rollups
+            }
+
+            size_t bucketCount = 0;
+            readBinary(file, bucketCount);
+            for (size_t i = 0; i < bucketCount && file; ++i) {
+                std::string hour = readString(file);
+                size_t cellCount = 0;
+                readBinary(file, cellCount);
+                for (size_t j = 0; j < cellCount && file; ++j) {
+                    RollupKey key;
+                    key.currency = readString(file);
+                    key.payment_method = readString(file);
+                    readBinary(file, key.status);
+                    uint8_t refund = 0;
+                    readBinary(file, refund);
+                    key.refund = refund != 0;
+                    RollupCell cell;
+                    readBinary(file, cell.count);
+                    readBinary(file, cell.amount.minor);
+                    if (file) {
+                        addRollup(hour, key, cell.count, cell.amount);
+                    }
+                }
+            }
+
+            size_t rolledUp = 0;
+            for (const auto& entry : rollupTotals) {
+                rolledUp += entry.second.count;
+            }
+            return file && rolledUp == entities.size();
+        }
+
         /**
          * @brief Generate a unique transaction ID
          * @return Unique transaction ID
@@ -549,8 +1941,8 @@ namespace PaymentManager {
          * @param currency Currency code
          * @return true if valid, false otherwise
          */
-        bool validatePaymentData(double amount, const std::string& currency) {
-            if (amount <= 0.0) return false;
+        bool validatePaymentData(Model::Money amount, const std::string& currency) {
+            if (amount.minor <= 0) return false;
             if (currency.empty() || currency.length() != 3) return false;
             
             // Basic currency validation
@@ -568,7 +1960,7 @@ namespace PaymentManager {
             // For now, we'll just output to console in debug builds
             #ifdef DEBUG
             std::cout << "[PAYMENT AUDIT] " << action << " - Payment ID: " << payment.payment_id 
-                      << ", Amount: " << payment.amount << " " << payment.currency 
+                      << ", Amount: " << payment.amount.toString(payment.currency) << " " << payment.currency 
                       << ", Status: " << static_cast<int>(payment.status) << std::endl;
             #endif
         }
@@ -0,0 +1,530 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <thread>
+#include <limits>
+#include <cstdint>
+#include <cstdlib>
+#include <cctype>
+#include "columnarSnapshot.hpp"
+
+namespace QueryEngine {
+
+    /**
+     * @brief Value type of a column view
+     */
+    enum class ColumnType {
+        INT64,      // IDs, counts, ratings
+        DOUBLE,     // Prices and amounts in major units
+        STRING,     // Codes into the column's dictionary
+        TIMESTAMP   // Packed local time YYYYMMDDhhmmss (see Columnar::packTimestamp), 0 if unknown
+    };
+
+    using Columnar::Bucket;
+    using Columnar::GroupBy;
+
+    /**
+     * @brief Rows per batch; filters and aggregates run one column over a whole batch at a time
+     */
+    constexpr uint32_t BATCH_ROWS = 1024;
+
+    /**
+     * @brief In-memory table of typed columns, filled row by row from module entities
+     */
+    class Table {
+    public:
+        struct Column {
+            std::string name;
+            ColumnType type;
+            std::vector<int64_t> ints;      // INT64, STRING and TIMESTAMP columns
+            std::vector<double> reals;      // DOUBLE columns
+            std::vector<std::string> dictionary;
+            std::unordered_map<std::string, int64_t> codes;
+        };
+
+        Table() = default;
+        Table(const std::string& name, const std::vector<std::pair<std::string, ColumnType>>& definition) : name(name) {
+            for (const auto& entry : definition) {
+                columns.push_back({entry.first, entry.second, {}, {}, {}, {}});
+            }
+        }
+
+        void appendInt(size_t column, int64_t value) {
+            columns[column].ints.push_back(value);
+        }
+
+        void appendDouble(size_t column, double value) {
+            columns[column].reals.push_back(value);
+        }
+
+        void appendString(size_t column, const std::string& value) {
+            Column& target = columns[column];
+            auto inserted = target.codes.emplace(value, static_cast<int64_t>(target.dictionary.size()));
+            if (inserted.second) {
+                target.dictionary.push_back(value);
+            }
+            target.ints.push_back(inserted.first->second);
+        }
+
+        void appendTimestamp(size_t column, const std::string& iso) {
+            columns[column].ints.push_back(Columnar::packTimestamp(iso));
+        }
+
+        uint64_t rowCount() const {
+            if (columns.empty()) return 0;
+            return columns[0].type == ColumnType::DOUBLE ? columns[0].reals.size() : columns[0].ints.size();
+        }
+
+        const Column* column(const std::string& columnName) const {
+            for (const auto& entry : columns) {
+                if (entry.name == columnName) return &entry;
+            }
+            return nullptr;
+        }
+
+        const std::string& getName() const { return name; }
+        const std::vector<Column>& getColumns() const { return columns; }
+
+    private:
+        std::string name;
+        std::vector<Column> columns;
+    };
+
+    enum class Aggregate { COUNT, SUM, AVG, MIN, MAX };
+
+    struct AggregateSpec {
+        Aggregate function = Aggregate::COUNT;
+        std::string column; // Empty for COUNT
+    };
+
+    /**
+     * @brief Row predicate; value is text and is read according to the column type
+     *
+     * Text columns support = and != only. Timestamps take "2030", "2030-06",
+     * "2030-06-15" and so on, covering whole periods ("<= 2030-06" includes June).
+     */
+    struct Filter {
+        enum Op { EQ, NE, LT, LE, GT, GE };
+        std::string column;
+        Op op = EQ;
+        std::string value;
+    };
+
+    /**
+     * @brief Filtered aggregates grouped by up to three columns
+     */
+    struct Query {
+        std::string table;
+        std::vector<GroupBy> groupBy;
+        std::vector<AggregateSpec> aggregates; // COUNT is always reported
+        std::vector<Filter> filters;
+    };
+
+    struct Result {
+        bool ok = false;
+        std::string error;
+        std::vector<std::string> keyNames;
+        std::vector<std::string> valueNames; // One per non-COUNT aggregate, e.g. "avg(rating)"
+        struct Row {
+            std::vector<std::string> keys;
+            std::vector<int64_t> rawKeys;
+            int64_t count = 0;
+            std::vector<double> values;
+        };
+        std::vector<Row> rows; // Ordered by key
+        uint64_t rowsScanned = 0;
+        uint64_t rowsMatched = 0;
+        uint64_t batches = 0;
+        unsigned threads = 0;
+        double seconds = 0.0;
+    };
+
+    inline const char* aggregateName(Aggregate function) {
+        switch (function) {
+            case Aggregate::SUM: return "sum";
+            case Aggregate::AVG: return "avg";
+            case Aggregate::MIN: return "min";
+            case Aggregate::MAX: return "max";
+            default: return "count";
+        }
+    }
+
+    namespace detail {
+        using Key = Columnar::GroupKey;
+
+        struct BoundFilter {
+            const Table::Column* column;
+            Filter::Op op;
+            int64_t value;       // INT64, STRING and TIMESTAMP columns
+            double real;         // DOUBLE columns
+        };
+
+        struct BoundAggregate {
+            Aggregate function;
+            const Table::Column* column;
+        };
+
+        /**
+         * @brief Per-group aggregate state; one instance per worker, merged at the end
+         */
+        struct Groups {
+            std::unordered_map<Key, uint32_t, Columnar::GroupKeyHash> index;
+            std::vector<Key> keys;
+            std::vector<int64_t> counts;
+            std::vector<double> sums;   // group * aggregates + aggregate
+            std::vector<double> mins;
+            std::vector<double> maxs;
+            size_t width = 0;
+
+            uint32_t find(const Key& key) {
+                auto inserted = index.emplace(key, static_cast<uint32_t>(keys.size()));
+                if (inserted.second) {
+                    keys.push_back(key);
+                    counts.push_back(0);
+                    sums.resize(sums.size() + width, 0.0);
+                    mins.resize(mins.size() + width, std::numeric_limits<double>::infinity());
+                    maxs.resize(maxs.size() + width, -std::numeric_limits<double>::infinity());
+                }
+                return inserted.first->second;
+            }
+        };
+
+        /**
+         * @brief Filter and aggregate one batch of rows into a worker's groups
+         */
+        inline uint32_t runBatch(uint64_t start, uint32_t count, const std::vector<BoundFilter>& filters,
+                                 const std::vector<const Table::Column*>& keys, const std::vector<GroupBy>& groupBy,
+                                 const std::vector<BoundAggregate>& aggregates, Groups& groups) {
+            uint32_t selection[BATCH_ROWS];
+            uint32_t slot[BATCH_ROWS];
+            double values[BATCH_ROWS];
+            for (uint32_t i = 0; i < count; ++i) {
+                selection[i] = i;
+            }
+            uint32_t selected = count;
+            for (const auto& filter : filters) {
+                if (filter.column->type == ColumnType::DOUBLE) {
+                    selected = Columnar::narrowSelection(filter.column->reals.data() + start, filter.op, filter.real, selection, selected);
+                } else {
+                    selected = Columnar::narrowSelection(filter.column->ints.data() + start, filter.op, filter.value, selection, selected);
+                }
+            }
+
+            // Group slot per selected row; neighbouring rows usually share one, so skip the hash lookup then
+            Key previous = {};
+            uint32_t current = 0;
+            bool haveCurrent = false;
+            for (uint32_t i = 0; i < selected; ++i) {
+                Key key = {0, 0, 0};
+                for (size_t k = 0; k < keys.size(); ++k) {
+                    key[k] = Columnar::applyBucket(keys[k]->ints[start + selection[i]], groupBy[k].bucket);
+                }
+                if (!haveCurrent || key != previous) {
+                    current = groups.find(key);
+                    previous = key;
+                    haveCurrent = true;
+                }
+                slot[i] = current;
+                ++groups.counts[current];
+            }
+
+            // Each aggregate is one pass: gather its column, then fold into the slots
+            for (size_t a = 0; a < aggregates.size(); ++a) {
+                const Table::Column* column = aggregates[a].column;
+                if (!column) {
+                    continue;
+                }
+                if (column->type == ColumnType::DOUBLE) {
+                    const double* data = column->reals.data() + start;
+                    for (uint32_t i = 0; i < selected; ++i) values[i] = data[selection[i]];
+                } else {
+                    const int64_t* data = column->ints.data() + start;
+                    for (uint32_t i = 0; i < selected; ++i) values[i] = static_cast<double>(data[selection[i]]);
+                }
+                size_t width = groups.width;
+                switch (aggregates[a].function) {
+                    case Aggregate::SUM:
+                    case Aggregate::AVG:
+                        for (uint32_t i = 0; i < selected; ++i) groups.sums[slot[i] * width + a] += values[i];
+                        break;
+                    case Aggregate::MIN:
+                        for (uint32_t i = 0; i < selected; ++i) {
+                            double& low = groups.mins[slot[i] * width + a];
+                            low = std::min(low, values[i]);
+                        }
+                        break;
+                    case Aggregate::MAX:
+                        for (uint32_t i = 0; i < selected; ++i) {
+                            double& high = groups.maxs[slot[i] * width + a];
+                            high = std::max(high, values[i]);
+                        }
+                        break;
+                    default:
+                        break;
+                }
+            }
+            return selected;
+        }
+
+        inline bool parseInteger(const std::string& text, int64_t& value) {
+            char* end = nullptr;
+            value = std::strtoll(text.c_str(), &end, 10);
+            return !text.empty() && *end == '\0';
+        }
+    }
+
+    /**
+     * @brief Run a query over a table
+     *
+     * Rows are processed in batches of BATCH_ROWS. Within a batch each filter
+     * narrows a selection vector in one pass over its column, then group slots
+     * are assigned and every aggregate folds its column into them. Worker
+     * threads claim batches from a shared counter and keep private group
+     * tables, which are merged once the scan is done.
+     *
+     * @param threads Worker threads; 0 uses one per hardware thread
+     */
+    inline Result execute(const Table& table, const Query& query, unsigned threads = 0) {
+        auto started = std::chrono::steady_clock::now();
+        Result result;
+        if (query.groupBy.size() > 3) {
+            result.error = "at most three group-by columns";
+            return result;
+        }
+
+        std::vector<detail::BoundFilter> filters;
+        for (const auto& filter : query.filters) {
+            const Table::Column* column = table.column(filter.column);
+            if (!column) {
+                result.error = "unknown column " + filter.column;
+                return result;
+            }
+            detail::BoundFilter bound = {column, filter.op, 0, 0.0};
+            bool valid = true;
+            switch (column->type) {
+                case ColumnType::STRING: {
+                    if (filter.op != Filter::EQ && filter.op != Filter::NE) {
+                        result.error = "only = and != apply to text column " + filter.column;
+                        return result;
+                    }
+                    auto code = column->codes.find(filter.value);
+                    bound.value = code == column->codes.end() ? -1 : code->second;
+                    break;
+                }
+                case ColumnType::TIMESTAMP:
+                    // "< 2030-06" starts at June; "> 2030-06" starts after it
+                    bound.value = Columnar::packTimestamp(filter.value, filter.op == Filter::LE || filter.op == Filter::GT);
+                    valid = bound.value != 0;
+                    break;
+                case ColumnType::DOUBLE: {
+                    char* end = nullptr;
+                    bound.real = std::strtod(filter.value.c_str(), &end);
+                    valid = !filter.value.empty() && *end == '\0';
+                    break;
+                }
+                default:
+                    valid = detail::parseInteger(filter.value, bound.value);
+            }
+            if (!valid) {
+                result.error = "bad value for " + filter.column + ": " + filter.value;
+                return result;
+            }
+            filters.push_back(bound);
+        }
+
+        std::vector<const Table::Column*> keys;
+        std::vector<Columnar::KeyFormat> keyFormats;
+        for (const auto& group : query.groupBy) {
+            const Table::Column* column = table.column(group.column);
+            if (!column) {
+                result.error = "unknown column " + group.column;
+                return result;
+            }
+            if (column->type == ColumnType::DOUBLE) {
+                result.error = "cannot group by decimal column " + group.column;
+                return result;
+            }
+            if (group.bucket != Bucket::NONE && column->type != ColumnType::TIMESTAMP) {
+                result.error = "calendar buckets need a timestamp column, not " + group.column;
+                return result;
+            }
+            keys.push_back(column);
+            keyFormats.push_back({column->type == ColumnType::STRING ? Columnar::KeyFormat::TEXT :
+                                  column->type == ColumnType::TIMESTAMP ? Columnar::KeyFormat::TIME : Columnar::KeyFormat::NUMBER,
+                                  &column->dictionary, group.bucket});
+            result.keyNames.push_back(group.column);
+        }
+
+        std::vector<detail::BoundAggregate> aggregates;
+        for (const auto& spec : query.aggregates) {
+            if (spec.function == Aggregate::COUNT) {
+                continue;
+            }
+            const Table::Column* column = table.column(spec.column);
+            if (!column) {
+                result.error = "unknown column " + spec.column;
+                return result;
+            }
+            if (column->type != ColumnType::INT64 && column->type != ColumnType::DOUBLE) {
+                result.error = std::string(aggregateName(spec.function)) + " needs a numeric column, not " + spec.column;
+                return result;
+            }
+            aggregates.push_back({spec.function, column});
+            result.valueNames.push_back(std::string(aggregateName(spec.function)) + "(" + spec.column + ")");
+        }
+
+        uint64_t rows = table.rowCount();
+        uint64_t batches = (rows + BATCH_ROWS - 1) / BATCH_ROWS;
+        unsigned workers = threads > 0 ? threads : std::max(1u, std::thread::hardware_concurrency());
+        workers = static_cast<unsigned>(std::max<uint64_t>(1, std::min<uint64_t>(workers, batches)));
+
+        std::vector<detail::Groups> partials(workers);
+        std::vector<uint64_t> matched(workers, 0);
+        std::atomic<uint64_t> nextBatch(0);
+        auto scan = [&](unsigned worker) {
+            detail::Groups& groups = partials[worker];
+            groups.width = aggregates.size();
+            for (uint64_t batch = nextBatch++; batch < batches; batch = nextBatch++) {
+                uint64_t start = batch * BATCH_ROWS;
+                uint32_t count = static_cast<uint32_t>(std::min<uint64_t>(BATCH_ROWS, rows - start));
+                matched[worker] += detail::runBatch(start, count, filters, keys, query.groupBy, aggregates, groups);
+            }
+        };
+        std::vector<std::future<void>> running;
+        for (unsigned worker = 1; worker < workers; ++worker) {
+            running.push_back(std::async(std::launch::async, scan, worker));
+        }
+        scan(0);
+        for (auto& worker : running) {
+            worker.get();
+        }
+
+        // Fold the workers' groups into the first
+        detail::Groups& merged = partials[0];
+        size_t width = aggregates.size();
+        for (unsigned worker = 1; worker < workers; ++worker) {
+            detail::Groups& partial = partials[worker];
+            for (size_t g = 0; g < partial.keys.size(); ++g) {
+                uint32_t target = merged.find(partial.keys[g]);
+                merged.counts[target] += partial.counts[g];
+                for (size_t a = 0; a < width; ++a) {
+                    merged.sums[target * width + a] += partial.sums[g * width + a];
+                    merged.mins[target * width + a] = std::min(merged.mins[target * width + a], partial.mins[g * width + a]);
+                    merged.maxs[target * width + a] = std::max(merged.maxs[target * width + a], partial.maxs[g * width + a]);
+                }
+            }
+            matched[0] += matched[worker];
+        }
+
+        for (size_t g = 0; g < merged.keys.size(); ++g) {
+            Result::Row row;
+            row.count = merged.counts[g];
+            Columnar::setGroupKeys(row, merged.keys[g], keyFormats);
+            for (size_t a = 0; a < width; ++a) {
+                switch (aggregates[a].function) {
+                    case Aggregate::SUM: row.values.push_back(merged.sums[g * width + a]); break;
+                    case Aggregate::AVG: row.values.push_back(merged.sums[g * width + a] / static_cast<double>(row.count)); break;
+                    case Aggregate::MIN: row.values.push_back(merged.mins[g * width + a]); break;
+                    default: row.values.push_back(merged.maxs[g * width + a]);
+                }
+            }
+            result.rows.push_back(std::move(row));
+        }
+        Columnar::sortGroupRows(result.rows, keyFormats);
+        result.rowsScanned = rows;
+        result.rowsMatched = matched[0];
+        result.batches = batches;
+        result.threads = workers;
+        result.ok = true;
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+        return result;
+    }
+
+    /**
+     * @brief Parse a query written as space-separated terms
+     *
+     *   <table> [count] [sum=<column>] [avg=<column>] [min=<column>] [max=<column>]
+     *           [by=<column>[:day|:month|:year],...] [where=<column><op><value>]...
+     *
+     * where <op> is one of = != < <= > >=. A term may be double-quoted to
+     * include spaces, e.g. "where=name=Summer Jam". For example:
+     *   tickets by=concert_id,status where=status!=AVAILABLE
+     *
+     * @return false with error set if the text is malformed
+     */
+    inline bool parseQuery(const std::string& text, Query& query, std::string& error) {
+        std::vector<std::string> terms;
+        for (size_t pos = 0; pos < text.size();) {
+            if (std::isspace(static_cast<unsigned char>(text[pos]))) {
+                ++pos;
+                continue;
+            }
+            std::string term;
+            bool quoted = false;
+            for (; pos < text.size() && (quoted || !std::isspace(static_cast<unsigned char>(text[pos]))); ++pos) {
+                if (text[pos] == '"') {
+                    quoted = !quoted;
+                } else {
+                    term += text[pos];
+                }
+            }
+            terms.push_back(term);
+        }
+        if (terms.empty()) {
+            error = "missing table name";
+            return false;
+        }
+
+        query = Query();
+        query.table = terms[0];
+        static const std::vector<std::pair<std::string, Aggregate>> functions = {
+            {"sum=", Aggregate::SUM}, {"avg=", Aggregate::AVG}, {"min=", Aggregate::MIN}, {"max=", Aggregate::MAX}};
+        static const std::vector<std::pair<std::string, Filter::Op>> ops = {
+            {"!=", Filter::NE}, {">=", Filter::GE}, {"<=", Filter::LE}, {"=", Filter::EQ}, {">", Filter::GT}, {"<", Filter::LT}};
+        for (size_t t = 1; t < terms.size(); ++t) {
+            const std::string& term = terms[t];
+            bool matched = false;
+            if (term == "count") {
+                matched = true;
+            }
+            for (const auto& function : functions) {
+                if (!matched && term.rfind(function.first, 0) == 0 && term.size() > function.first.size()) {
+                    query.aggregates.push_back({function.second, term.substr(function.first.size())});
+                    matched = true;
+                }
+            }
+            if (!matched && term.rfind("by=", 0) == 0) {
+                if (!Columnar::parseGroupBy(term.substr(3), query.groupBy, error)) {
+                    return false;
+                }
+                matched = true;
+            }
+            if (!matched && term.rfind("where=", 0) == 0) {
+                std::string predicate = term.substr(6);
+                size_t at = std::string::npos;
+                for (const auto& op : ops) {
+                    at = predicate.find(op.first);
+                    if (at != std::string::npos && at > 0) {
+                        query.filters.push_back({predicate.substr(0, at), op.second, predicate.substr(at + op.first.size())});
+                        break;
+                    }
+                }
+                if (at == std::string::npos || at == 0) {
+                    error = "bad filter: " + predicate;
+                    return false;
+                }
+                matched = true;
+            }
+            if (!matched) {
+                error = "unrecognised term: " + term;
+                return false;
+            }
+        }
+        return true;
+    }
+}
@@ -0,0 +1,227 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include "models.hpp"
+#include "ticketModule.hpp"
+#include "paymentModule.hpp"
+
+namespace Reconciliation {
+
+    /**
+     * @brief Kinds of ticket/payment disagreement
+     */
+    enum class MismatchType {
+        ATTENDEE_UNPAID,      // Sold or checked-in ticket whose attendee has no completed payment at all
+        ORPHAN_PAYMENT,       // Attendee holds no live ticket but kept money paid in a currency
+        REFUND_WITHOUT_VOID,  // More refunds than cancelled tickets for the attendee
+        DOUBLE_REFUND         // Refunds exceed what the attendee paid in a currency
+    };
+
+    inline std::string mismatchTypeToString(MismatchType type) {
+        switch (type) {
+            case MismatchType::ATTENDEE_UNPAID: return "ATTENDEE_UNPAID";
+            case MismatchType::ORPHAN_PAYMENT: return "ORPHAN_PAYMENT";
+            case MismatchType::REFUND_WITHOUT_VOID: return "REFUND_WITHOUT_VOID";
+            case MismatchType::DOUBLE_REFUND: return "DOUBLE_REFUND";
+            default: return "UNKNOWN";
+        }
+    }
+
+    /**
+     * @brief Join fields of one ticket
+     */
+    struct TicketRow {
+        int attendee_id;
+        int concert_id;
+        int ticket_id;
+        Model::TicketStatus status;
+    };
+
+    /**
+     * @brief Join fields of one payment (refund records carry negative amounts)
+     */
+    struct PaymentRow {
+        int attendee_id;
+        int payment_id;
+        int64_t minor;
+        uint16_t currency; // Index into the currency list passed to reconcile
+        Model::PaymentStatus status;
+    };
+
+    /**
+     * @brief One reported disagreement
+     */
+    struct Mismatch {
+        MismatchType type;
+        int attendee_id;
+        int concert_id;  // -1 for payment-side mismatches (payments carry no concert)
+        int record_id;   // Ticket ID for ATTENDEE_UNPAID, payment ID otherwise
+        std::string detail;
+    };
+
+    /**
+     * @brief Ticket counts for one concert
+     */
+    struct ConcertSummary {
+        int sold = 0;     // SOLD or CHECKED_IN
+        int voided = 0;   // CANCELLED
+        int unpaid = 0;   // Live tickets reported as ATTENDEE_UNPAID
+    };
+
+    struct ReconciliationResult {
+        std::vector<Mismatch> mismatches;
+        std::map<int, ConcertSummary> concerts;
+        size_t tickets = 0;
+        size_t payments = 0;
+        size_t attendees = 0;
+        double seconds = 0.0;
+    };
+
+    /**
+     * @brief Reconcile tickets against payments in one merge-join pass
+     *
+     * Payments only record the attendee, so the join key is the attendee ID:
+     * both inputs are sorted by it and each attendee's tickets are compared
+     * with that attendee's payments as the two cursors advance together.
+     * Cost is two sorts plus one linear pass; the only per-row lookup is the
+     * ticket's concert in the per-concert summary map.
+     *
+     * The payment check is attendee-level. Payments carry neither a ticket
+     * nor a price, so they cannot be allocated to individual tickets: one
+     * completed payment of any amount clears all of the attendee's live
+     * tickets, and ATTENDEE_UNPAID only flags attendees with none at all.
+     *
+     * @param tickets Ticket rows (sorted in place)
+     * @param payments Payment rows (sorted in place)
+     * @param currencies Currency codes referenced by PaymentRow::currency
+     * @return Mismatches in attendee order plus per-concert counts
+     */
+    inline ReconciliationResult reconcile(std::vector<TicketRow>& tickets, std::vector<PaymentRow>& payments,
+                                          const std::vector<std::string>& currencies) {
+        auto start = std::chrono::steady_clock::now();
+        ReconciliationResult result;
+        result.tickets = tickets.size();
+        result.payments = payments.size();
+
+        std::sort(tickets.begin(), tickets.end(), [](const TicketRow& a, const TicketRow& b) {
+            return a.attendee_id != b.attendee_id ? a.attendee_id < b.attendee_id : a.ticket_id < b.ticket_id;
+        });
+        std::sort(payments.begin(), payments.end(), [](const PaymentRow& a, const PaymentRow& b) {
+            return a.attendee_id != b.attendee_id ? a.attendee_id < b.attendee_id : a.payment_id < b.payment_id;
+        });
+
+        std::vector<int64_t> paid(currencies.size()), refunded(currencies.size());
+        std::vector<int> lastPayment(currencies.size()), lastRefund(currencies.size());
+        size_t t = 0, p = 0;
+        while (t < tickets.size() || p < payments.size()) {
+            // Next attendee present on either side
+            int attendee;
+            if (p == payments.size() || (t < tickets.size() && tickets[t].attendee_id <= payments[p].attendee_id)) {
+                attendee = tickets[t].attendee_id;
+            } else {
+                attendee = payments[p].attendee_id;
+            }
+            size_t ticketEnd = t, paymentEnd = p;
+            while (ticketEnd < tickets.size() && tickets[ticketEnd].attendee_id == attendee) ++ticketEnd;
+            while (paymentEnd < payments.size() && payments[paymentEnd].attendee_id == attendee) ++paymentEnd;
+            ++result.attendees;
+
+            int live = 0, voided = 0;
+            for (size_t i = t; i < ticketEnd; ++i) {
+                ConcertSummary& concert = result.concerts[tickets[i].concert_id];
+                if (tickets[i].status == Model::TicketStatus::SOLD || tickets[i].status == Model::TicketStatus::CHECKED_IN) {
+                    ++live;
+                    ++concert.sold;
+                } else if (tickets[i].status == Model::TicketStatus::CANCELLED) {
+                    ++voided;
+                    ++concert.voided;
+                }
+            }
+
+            int completed = 0, refunds = 0;
+            std::fill(paid.begin(), paid.end(), 0);
+            std::fill(refunded.begin(), refunded.end(), 0);
+            for (size_t i = p; i < paymentEnd; ++i) {
+                const PaymentRow& row = payments[i];
+                if (row.minor < 0) {
+                    ++refunds;
+                    refunded[row.currency] -= row.minor;
+                    lastRefund[row.currency] = row.payment_id;
+                    if (refunds > voided) {
+                        result.mismatches.push_back({MismatchType::REFUND_WITHOUT_VOID, attendee, -1, row.payment_id,
+                            "refund " + std::to_string(refunds) + " but " + std::to_string(voided) + " cancelled ticket(s)"});
+                    }
+                } else if (row.status == Model::PaymentStatus::COMPLETED || row.status == Model::PaymentStatus::REFUNDED) {
+                    paid[row.currency] += row.minor;
+                    lastPayment[row.currency] = row.payment_id;
+                    if (row.status == Model::PaymentStatus::COMPLETED) {
+                        ++completed;
+                    }
+                }
+            }
+
+            if (live > 0 && completed == 0) {
+                for (size_t i = t; i < ticketEnd; ++i) {
+                    if (tickets[i].status == Model::TicketStatus::SOLD || tickets[i].status == Model::TicketStatus::CHECKED_IN) {
+                        ++result.concerts[tickets[i].concert_id].unpaid;
+                        result.mismatches.push_back({MismatchType::ATTENDEE_UNPAID, attendee, tickets[i].concert_id,
+                            tickets[i].ticket_id, "no completed payment from attendee"});
+                    }
+                }
+            }
+            for (size_t c = 0; c < currencies.size(); ++c) {
+                if (refunded[c] > paid[c]) {
+                    result.mismatches.push_back({MismatchType::DOUBLE_REFUND, attendee, -1, lastRefund[c],
+                        "refunded " + Model::Money{refunded[c]}.toString(currencies[c]) + " of " +
+                        Model::Money{paid[c]}.toString(currencies[c]) + " " + currencies[c] + " paid"});
+                } else if (live == 0 && paid[c] > refunded[c]) {
+                    result.mismatches.push_back({MismatchType::ORPHAN_PAYMENT, attendee, -1, lastPayment[c],
+                        "kept " + Model::Money{paid[c] - refunded[c]}.toString(currencies[c]) + " " + currencies[c] +
+                        " with no live ticket"});
+                }
+            }
+
+            t = ticketEnd;
+            p = paymentEnd;
+        }
+
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return result;
+    }
+
+    /**
+     * @brief Reconcile the tickets and payments held by the two modules
+     *
+     * Unsold inventory (attendee 0) and tickets with unreadable QR codes are
+     * skipped; they cannot be owed a payment.
+     */
+    inline ReconciliationResult reconcile(TicketManager::TicketModule& ticketModule,
+                                          PaymentManager::PaymentModule& paymentModule) {
+        std::vector<TicketRow> tickets;
+        tickets.reserve(ticketModule.getAll().size());
+        for (const auto& ticket : ticketModule.getAll()) {
+            int attendee_id = TicketManager::TicketModule::extractAttendeeId(ticket->qr_code);
+            if (attendee_id <= 0) {
+                continue;
+            }
+            tickets.push_back({attendee_id, TicketManager::TicketModule::extractConcertId(ticket->qr_code),
+                               ticket->ticket_id, ticket->status});
+        }
+
+        std::vector<PaymentRow> payments;
+        std::vector<std::string> currencies;
+        paymentModule.visitPayments([&payments, &currencies](const Model::Payment& payment) {
+            auto code = std::find(currencies.begin(), currencies.end(), payment.currency);
+            if (code == currencies.end()) {
+                code = currencies.insert(code, payment.currency);
+            }
+            payments.push_back({payment.attendee_id, payment.payment_id, payment.amount.minor,
+                                static_cast<uint16_t>(code - currencies.begin()), payment.status});
+        });
+        return reconcile(tickets, payments, currencies);
+    }
+}
@@ -0,0 +1,173 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <mutex>
+#include <cstdint>
+
+/**
+ * @brief Hit, miss and invalidation counters of a report cache
+ */
+struct ReportCacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t invalidations = 0;  // Entries dropped because a covered record changed
+    uint64_t evictions = 0;      // Entries dropped to stay within capacity
+    size_t entries = 0;
+};
+
+/**
+ * @brief Results of date-range reports, dropped when a write lands in their range
+ *
+ * Each entry remembers the period it covers and which data sources it was
+ * built from. Owners call invalidate() with the timestamp of every changed
+ * record (both its old and new image), and only entries whose period
+ * contains that timestamp and that read that source are removed; reports
+ * over other periods stay cached.
+ *
+ * A result computed while a write was in flight could already be stale, so
+ * lookup() hands out a version and store() discards the result if any
+ * invalidation happened since.
+ *
+ * @tparam Value Cached result type
+ */
+template <typename Value>
+class ReportCache {
+public:
+    using Stats = ReportCacheStats;
+
+    /**
+     * @param capacity Maximum entries; the oldest is evicted beyond that
+     */
+    explicit ReportCache(size_t capacity = 256) : capacity(capacity == 0 ? 1 : capacity) {}
+
+    ReportCache(const ReportCache&) = delete;
+    ReportCache& operator=(const ReportCache&) = delete;
+
+    /**
+     * @brief Build a cache key from a report type and its parameters
+     */
+    static std::string makeKey(const std::string& report, const std::vector<std::string>& parameters) {
+        std::string key = report;
+        for (const auto& parameter : parameters) {
+            key += '\x1f'; // Unit separator; never part of a date or format name
+            key += parameter;
+        }
+        return key;
+    }
+
+    /**
+     * @brief Look up a result
+     * @param key Key from makeKey
+     * @param value Receives the cached result on a hit
+     * @param version Receives the version to pass to store() on a miss
+     * @return true on a hit
+     */
+    bool lookup(const std::string& key, Value& value, uint64_t& version) {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        version = writeVersion;
+        auto it = entries.find(key);
+        if (it == entries.end()) {
+            ++stats.misses;
+            return false;
+        }
+        ++stats.hits;
+        value = it->second.value;
+        return true;
+    }
+
+    /**
+     * @brief Cache a result computed after a missed lookup
+     * @param key Key from makeKey
+     * @param start_date Start of the covered period ("" for unbounded)
+     * @param end_date End of the covered period ("" for unbounded)
+     * @param sources Bit set of the data sources the result was built from
+     * @param value Result
+     * @param version Version returned by the missed lookup
+     * @return false if a write arrived in the meantime and the result was discarded
+     */
+    bool store(const std::string& key, const std::string& start_date, const std::string& end_date,
+               unsigned sources, const Value& value, uint64_t version) {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        if (version != writeVersion) {
+            return false;
+        }
+        auto it = entries.find(key);
+        if (it != entries.end()) {
+            insertionOrder.erase(it->second.sequence);
+            entries.erase(it);
+        }
+        while (entries.size() >= capacity && !insertionOrder.empty()) {
+            entries.erase(insertionOrder.begin()->second);
+            insertionOrder.erase(insertionOrder.begin());
+            ++stats.evictions;
+        }
+        Entry entry{value, start_date, end_date, sources, ++lastSequence};
+        insertionOrder[entry.sequence] = key;
+        entries.emplace(key, std::move(entry));
+        return true;
+    }
+
+    /**
+     * @brief Drop every entry built from a source whose period contains a timestamp
+     * @param source Bit of the source that changed
+     * @param timestamp ISO 8601 timestamp of the changed record
+     * @return Number of entries dropped
+     */
+    size_t invalidate(unsigned source, const std::string& timestamp) {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        ++writeVersion;
+        size_t dropped = 0;
+        for (auto it = entries.begin(); it != entries.end();) {
+            const Entry& entry = it->second;
+            if ((entry.sources & source) &&
+                (entry.start_date.empty() || timestamp.compare(0, entry.start_date.size(), entry.start_date) >= 0) &&
+                (entry.end_date.empty() || timestamp.compare(0, entry.end_date.size(), entry.end_date) <= 0)) {
+                insertionOrder.erase(entry.sequence);
+                it = entries.erase(it);
+                ++dropped;
+            } else {
+                ++it;
+            }
+        }
+        stats.invalidations += dropped;
+        return dropped;
+    }
+
+    /**
+     * @brief Drop every entry (e.g. after a change that affects all periods)
+     */
+    void clear() {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        ++writeVersion;
+        stats.invalidations += entries.size();
+        entries.clear();
+        insertionOrder.clear();
+    }
+
+    Stats getStats() const {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        Stats current = stats;
+        current.entries = entries.size();
+        return current;
+    }
+
+private:
+    struct Entry {
+        Value value;
+        std::string start_date;
+        std::string end_date;
+        unsigned sources;
+        uint64_t sequence;
+    };
+
+    mutable std::mutex cacheMutex;
+    std::unordered_map<std::string, Entry> entries;
+    std::map<uint64_t, std::string> insertionOrder; // Sequence -> key, oldest first
+    uint64_t lastSequence = 0;
+    uint64_t writeVersion = 0;
+    size_t capacity;
+    Stats stats;
+};
@@ -0,0 +1,316 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <ostream>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <charconv>
+#include "models.hpp"
+
+namespace ReportExport {
+
+    /**
+     * @brief Append a string as a quoted JSON string literal
+     *
+     * Quotes, backslashes and control characters are escaped; other bytes,
+     * including UTF-8 sequences, are copied through unchanged.
+     *
+     * @tparam Out Any type with append(const char*, size_t), e.g. std::string
+     */
+    template <typename Out>
+    void appendJsonString(Out& out, std::string_view text) {
+        static const char hex[] = "0123456789abcdef";
+        out.append("\"", 1);
+        size_t copied = 0;
+        for (size_t i = 0; i < text.size(); ++i) {
+            unsigned char c = static_cast<unsigned char>(text[i]);
+            if (c >= 0x20 && c != '"' && c != '\\') {
+                continue;
+            }
+            out.append(text.data() + copied, i - copied);
+            copied = i + 1;
+            switch (c) {
+                case '"': out.append("\\\"", 2); break;
+                case '\\': out.append("\\\\", 2); break;
+                case '\n': out.append("\\n", 2); break;
+                case '\r': out.append("\\r", 2); break;
+                case '\t': out.append("\\t", 2); break;
+                case '\b': out.append("\\b", 2); break;
+                case '\f': out.append("\\f", 2); break;
+                default: {
+                    char escaped[6] = {'\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xF]};
+                    out.append(escaped, 6);
+                }
+            }
+        }
+        out.append(text.data() + copied, text.size() - copied);
+        out.append("\"", 1);
+    }
+
+    /**
+     * @brief Append a string as one CSV field (RFC 4180)
+     *
+     * The field is quoted only if it contains a comma, quote or line break;
+     * embedded quotes are doubled.
+     */
+    template <typename Out>
+    void appendCsvField(Out& out, std::string_view text) {
+        if (text.find_first_of(",\"\r\n") == std::string_view::npos) {
+            out.append(text.data(), text.size());
+            return;
+        }
+        out.append("\"", 1);
+        size_t copied = 0;
+        for (size_t quote = text.find('"'); quote != std::string_view::npos; quote = text.find('"', quote + 1)) {
+            out.append(text.data() + copied, quote + 1 - copied);
+            out.append("\"", 1);
+            copied = quote + 1;
+        }
+        out.append(text.data() + copied, text.size() - copied);
+        out.append("\"", 1);
+    }
+
+    /**
+     * @brief Fixed-size write buffer in front of a file or stream
+     *
+     * Writers append into one 64 KiB buffer that is handed to the sink
+     * whenever it fills, so memory use does not grow with the export size.
+     * Numbers are formatted with std::to_chars rather than iostreams.
+     */
+    class OutputBuffer {
+    public:
+        explicit OutputBuffer(std::FILE* file) : file(file), stream(nullptr), buffer(BUFFER_SIZE) {}
+        explicit OutputBuffer(std::ostream& stream) : file(nullptr), stream(&stream), buffer(BUFFER_SIZE) {}
+
+        OutputBuffer(const OutputBuffer&) = delete;
+        OutputBuffer& operator=(const OutputBuffer&) = delete;
+
+        ~OutputBuffer() {
+            flush();
+        }
+
+        void append(const char* data, size_t size) {
+            if (used + size > buffer.size()) {
+                flush();
+                if (size > buffer.size()) {
+                    writeToSink(data, size);
+                    return;
+                }
+            }
+            std::memcpy(buffer.data() + used, data, size);
+            used += size;
+        }
+
+        void append(std::string_view text) {
+            append(text.data(), text.size());
+        }
+
+        void appendInt(int64_t value) {
+            char digits[24];
+            auto result = std::to_chars(digits, digits + sizeof(digits), value);
+            append(digits, static_cast<size_t>(result.ptr - digits));
+        }
+
+        void appendDouble(double value) {
+            char digits[32];
+            auto result = std::to_chars(digits, digits + sizeof(digits), value);
+            append(digits, static_cast<size_t>(result.ptr - digits));
+        }
+
+        /**
+         * @brief Append an exact decimal amount, e.g. 1234 minor USD -> "12.34"
+         */
+        void appendMoney(Model::Money amount, const std::string& currency) {
+            int64_t scale = Model::Money::minorScale(currency);
+            int digits = Model::Money::minorDigits(currency);
+            uint64_t magnitude = amount.minor < 0 ? 0 - static_cast<uint64_t>(amount.minor) : static_cast<uint64_t>(amount.minor);
+            if (amount.minor < 0) {
+                append("-", 1);
+            }
+            appendInt(static_cast<int64_t>(magnitude / static_cast<uint64_t>(scale)));
+            if (digits > 0) {
+                char fraction[20];
+                uint64_t remainder = magnitude % static_cast<uint64_t>(scale);
+                fraction[0] = '.';
+                for (int i = digits; i > 0; --i) {
+                    fraction[i] = static_cast<char>('0' + remainder % 10);
+                    remainder /= 10;
+                }
+                append(fraction, static_cast<size_t>(digits) + 1);
+            }
+        }
+
+        /**
+         * @brief Hand buffered bytes to the sink
+         * @return false if the sink has failed
+         */
+        bool flush() {
+            if (used > 0) {
+                writeToSink(buffer.data(), used);
+                used = 0;
+            }
+            return ok;
+        }
+
+        bool good() const { return ok; }
+        uint64_t bytesWritten() const { return written + used; }
+
+    private:
+        static constexpr size_t BUFFER_SIZE = 1 << 16;
+
+        void writeToSink(const char* data, size_t size) {
+            if (!ok) {
+                return;
+            }
+            if (file) {
+                ok = std::fwrite(data, 1, size, file) == size;
+            } else {
+                ok = static_cast<bool>(stream->write(data, static_cast<std::streamsize>(size)));
+            }
+            written += size;
+        }
+
+        std::FILE* file;
+        std::ostream* stream;
+        std::vector<char> buffer;
+        size_t used = 0;
+        uint64_t written = 0;
+        bool ok = true;
+    };
+
+    /**
+     * @brief Row-at-a-time export writer
+     *
+     * Columns are fixed at construction; each row supplies one value per
+     * column, in order, between beginRow() and endRow().
+     */
+    class RowWriter {
+    public:
+        virtual ~RowWriter() = default;
+
+        virtual void beginRow() = 0;
+        virtual void text(std::string_view value) = 0;
+        virtual void integer(int64_t value) = 0;
+        virtual void number(double value) = 0;
+        virtual void money(Model::Money amount, const std::string& currency) = 0;
+        virtual void endRow() = 0;
+
+        /**
+         * @brief Write any trailer and flush
+         * @return false if the output could not be written
+         */
+        virtual bool finish() = 0;
+
+        uint64_t rowCount() const { return rows; }
+
+    protected:
+        uint64_t rows = 0;
+    };
+
+    /**
+     * @brief CSV with a header line, one record per line
+     */
+    class CsvWriter : public RowWriter {
+    public:
+        CsvWriter(OutputBuffer& out, const std::vector<std::string>& columns) : out(out) {
+            for (size_t i = 0; i < columns.size(); ++i) {
+                if (i > 0) out.append(",", 1);
+                appendCsvField(out, columns[i]);
+            }
+            out.append("\n", 1);
+        }
+
+        void beginRow() override { first = true; }
+        void text(std::string_view value) override { separator(); appendCsvField(out, value); }
+        void integer(int64_t value) override { separator(); out.appendInt(value); }
+        void number(double value) override { separator(); out.appendDouble(value); }
+        void money(Model::Money amount, const std::string& currency) override { separator(); out.appendMoney(amount, currency); }
+        void endRow() override { out.append("\n", 1); ++rows; }
+        bool finish() override { return out.flush(); }
+
+    private:
+        void separator() {
+            if (!first) out.append(",", 1);
+            first = false;
+        }
+
+        OutputBuffer& out;
+        bool first = true;
+    };
+
+    /**
+     * @brief JSON array with one object per row, keyed by column name
+     */
+    class JsonWriter : public RowWriter {
+    public:
+        JsonWriter(OutputBuffer& out, const std::vector<std::string>& columns) : out(out) {
+            // Encode each "name": prefix once instead of per row
+            for (const auto& column : columns) {
+                std::string key;
+                appendJsonString(key, column);
+                key += ':';
+                keys.push_back(std::move(key));
+            }
+            out.append("[", 1);
+        }
+
+        void beginRow() override {
+            out.append(rows == 0 ? "\n{" : ",\n{", rows == 0 ? 2 : 3);
+            column = 0;
+        }
+        void text(std::string_view value) override { key(); appendJsonString(out, value); }
+        void integer(int64_t value) override { key(); out.appendInt(value); }
+        void number(double value) override { key(); out.appendDouble(value); }
+        void money(Model::Money amount, const std::string& currency) override { key(); out.appendMoney(amount, currency); }
+        void endRow() override { out.append("}", 1); ++rows; }
+        bool finish() override {
+            out.append(rows == 0 ? "]\n" : "\n]\n", rows == 0 ? 2 : 3);
+            return out.flush();
+        }
+
+    private:
+        void key() {
+            if (column > 0) out.append(",", 1);
+            if (column < keys.size()) out.append(keys[column]);
+            ++column;
+        }
+
+        OutputBuffer& out;
+        std::vector<std::string> keys;
+        size_t column = 0;
+    };
+
+    inline std::string ticketStatusName(Model::TicketStatus status) {
+        switch (status) {
+            case Model::TicketStatus::AVAILABLE: return "AVAILABLE";
+            case Model::TicketStatus::SOLD: return "SOLD";
+            case Model::TicketStatus::CHECKED_IN: return "CHECKED_IN";
+            case Model::TicketStatus::CANCELLED: return "CANCELLED";
+            case Model::TicketStatus::EXPIRED: return "EXPIRED";
+            default: return "UNKNOWN";
+        }
+    }
+
+    inline std::string paymentStatusName(Model::PaymentStatus status) {
+        switch (status) {
+            case Model::PaymentStatus::PENDING: return "PENDING";
+            case Model::PaymentStatus::COMPLETED: return "COMPLETED";
+            case Model::PaymentStatus::FAILED: return "FAILED";
+            case Model::PaymentStatus::REFUNDED: return "REFUNDED";
+            default: return "UNKNOWN";
+        }
+    }
+
+    inline std::string eventStatusName(Model::EventStatus status) {
+        switch (status) {
+            case Model::EventStatus::SCHEDULED: return "SCHEDULED";
+            case Model::EventStatus::CANCELLED: return "CANCELLED";
+            case Model::EventStatus::POSTPONED: return "POSTPONED";
+            case Model::EventStatus::COMPLETED: return "COMPLETED";
+            case Model::EventStatus::SOLDOUT: return "SOLDOUT";
+            default: return "UNKNOWN";
+        }
+    }
+}
@@ -11,8 +11,23 @@
 #include <random>
 #include <iomanip>
 #include <numeric>
+#include <cstdio>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <unordered_map>
+#include <atomic>
 #include "models.hpp"
 #include "baseModule.hpp"
+#include "attendeeModule.hpp"
+#include "crewModule.hpp"
+#include "reportCache.hpp"
+#include "reportExport.hpp"
+#include "reportScheduler.hpp"
+#include "columnarSnapshot.hpp"
+#include "timeBuckets.hpp"
+#include "queryEngine.hpp"
+#include "sketches.hpp"
 
 namespace ReportManager {
 
@@ -40,15 +55,121 @@ namespace ReportManager {
          * @brief Constructor
          * @param filePath Path to the reports data file
          */
-        ReportModule(const std::string& filePath = "data/reports.dat") : BaseModule<Model::ConcertReport, int>(filePath) {
+        ReportModule(const std::string& filePath = "data/reports.dat")
+            : BaseModule<Model::ConcertReport, int>(filePath), scheduler(filePath + ".schedules") {
             loadEntities();
+            loadSketches();
         }
 
         /**
          * @brief Destructor
          */
         ~ReportModule() {
+            scheduler.stop();
+            unsubscribeLive();
             saveEntities();
+            saveAnalyticsSketches();
+        }
+
+        /**
+         * @brief Live modules the analytics are computed from
+         *
+         * Any source may be left null; its figures then read as zero.
+         */
+        struct DataSources {
+            ConcertModule* concerts = nullptr;
+            TicketManager::TicketModule* tickets = nullptr;
+            PaymentManager::PaymentModule* payments = nullptr;
+            AttendeeModule* attendees = nullptr;
+            FeedbackModule* feedback = nullptr;
+            CrewModule* crews = nullptr;
+        };
+
+        /**
+         * @brief Attach the modules that metrics and reports read from
+         *
+         * Also seeds the live dashboard with one scan of the ticket, payment and
+         * feedback modules and subscribes to their change feeds; from then on
+         * each change is applied to the dashboard as it happens. Attach before
+         * the modules take concurrent writes, and attach an empty set before
+         * destroying a source that this module outlives.
+         * @param dataSources Module pointers (must outlive the attachment)
+         */
+        void attachDataSources(const DataSources& dataSources) {
+            unsubscribeLive();
+            sources = dataSources;
+            summaryCache.clear();
+            statementCache.clear();
+            cachedRateRevision = sources.payments ? sources.payments->getRateRevision() : 0;
+
+            ReportTiming timing;
+            Snapshot seeded = collectSnapshot("", "", SCAN_TICKETS | SCAN_PAYMENTS | SCAN_FEEDBACK, timing);
+            bool stale;
+            {
+                std::lock_guard<std::mutex> lock(liveMutex);
+                live = std::move(seeded);
+                // Persisted sketches are reused unless the sources no longer match them
+                stale = sketches.tickets_sold != live.tickets_sold || sketches.transactions != live.transactions ||
+                        sketches.ratings.count() != live.all_feedback.count;
+            }
+            if (stale) {
+                rebuildAnalyticsSketches();
+            }
+            if (sources.tickets) {
+                ticketSubscription = sources.tickets->getChangeFeed().subscribe(
+                    [this](const Model::Ticket& ticket, int direction) {
+                        SketchConcert concert = sketchConcert(TicketManager::TicketModule::extractConcertId(ticket.qr_code));
+                        std::lock_guard<std::mutex> lock(liveMutex);
+                        applyTicket(live, ticket, direction);
+                        sketchTicket(sketches, ticket, direction, concert);
+                    });
+            }
+            if (sources.payments) {
+                paymentSubscription = sources.payments->getChangeFeed().subscribe(
+                    [this](const Model::Payment& payment, int direction) {
+                        invalidateCaches(SCAN_PAYMENTS, payment.payment_date_time.iso8601String);
+                        std::lock_guard<std::mutex> lock(liveMutex);
+                        applyPayment(live, payment, direction);
+                        sketchPayment(sketches, payment, direction);
+                    });
+            }
+            if (sources.feedback) {
+                feedbackSubscription = sources.feedback->getChangeFeed().subscribe(
+                    [this](const Model::Feedback& feedback, int direction) {
+                        std::lock_guard<std::mutex> lock(liveMutex);
+                        applyFeedback(live, feedback, direction);
+                        sketchFeedback(sketches, feedback, direction);
+                    });
+            }
+            if (sources.crews) {
+                crewSubscription = sources.crews->getChangeFeed().subscribe(
+                    [this](const Model::Crew& crew, int) {
+                        if (crew.check_in_time) {
+                            invalidateCaches(SCAN_CREWS, crew.check_in_time->iso8601String);
+                        }
+                    });
+            }
+        }
+
+        // Crew pay per hour when a payroll report is not given a rate
+        static constexpr double DEFAULT_HOURLY_RATE = 25.0;
+
+        /**
+         * @brief Cost of the most recent run of a report
+         */
+        struct ReportTiming {
+            double total_ms = 0.0;                  // Wall time, including the merge
+            std::map<std::string, double> scan_ms;  // Module -> its pass (passes run in parallel)
+            Model::DateTime computed_at;
+        };
+
+        /**
+         * @brief Get the compute time of the latest run of each report
+         * @return Map of report name ("summary", "concert", "sales", "payroll", "dashboard") -> timing
+         */
+        std::map<std::string, ReportTiming> getReportTimings() const {
+            std::lock_guard<std::mutex> lock(timingMutex);
+            return reportTimings;
         }
 
         // Core Report Operations
@@ -112,18 +233,12 @@ namespace ReportManager {
                 return "";
             }
 
-            std::ostringstream report;
-            report << "Sales Analytics Report\n";
-            report << "Period: " << numericDate(start_date) << " to " << numericDate(end_date) << "\n";
-            report << "Format: " << format << "\n\n";
-            
-            // Simulate sales data
-            report << "Total Sales: $50,000\n";
-            report << "Number of Transactions: 125\n";
-            report << "Average Transaction Value: $400\n";
-            report << "Top Selling Concert: Summer Music Festival\n";
-            
-            return formatReportOutput(report.str(), format);
+            auto started = std::chrono::steady_clock::now();
+            ReportTiming timing;
+            Snapshot snapshot = collectSnapshot(start_date, end_date, SCAN_CONCERTS | SCAN_TICKETS | SCAN_PAYMENTS, timing);
+            std::string report = renderSalesAnalyticsReport(snapshot, start_date, end_date, format);
+            recordTiming("sales", timing, started);
+            return report;
         }
 
         /**
@@ -135,22 +250,18 @@ namespace ReportManager {
          */
         std::string generatePayrollReport(const std::string& start_date,
                                         const std::string& end_date,
-                                        const std::string& format = "JSON") {
+                                        const std::string& format = "JSON",
+                                        double hourly_rate = DEFAULT_HOURLY_RATE) {
             if (!validateDateRange(start_date, end_date)) {
                 return "";
             }
 
-            std::ostringstream report;
-            report << "Payroll Report\n";
-            report << "Period: " << numericDate(start_date) << " to " << numericDate(end_date) << "\n\n";
-            
-            // Simulate payroll data
-            report << "Total Payroll: $15,000\n";
-            report << "Number of Staff: 25\n";
-            report << "Average Pay: $600\n";
-            report << "Departments: Sound, Lighting, Security, Management\n";
-            
-            return formatReportOutput(report.str(), format);
+            auto started = std::chrono::steady_clock::now();
+            ReportTiming timing;
+            Snapshot snapshot = collectSnapshot(start_date, end_date, SCAN_CREWS, timing);
+            std::string report = renderPayrollReport(snapshot, start_date, end_date, format, hourly_rate);
+            recordTiming("payroll", timing, started);
+            return report;
         }
 
         // Analytics and Metrics
@@ -174,22 +285,11 @@ namespace ReportManager {
             std::string top_performing_venue;
         };
         SummaryMetrics calculateSummaryMetrics() {
-            SummaryMetrics metrics = {};
-            
-            // Simulate data for demonstration
-            metrics.total_concerts = 25;
-            metrics.active_concerts = 8;
-            metrics.completed_concerts = 15;
-            metrics.cancelled_concerts = 2;
-            metrics.total_attendees = 12500;
-            metrics.total_tickets_sold = 15000;
-            metrics.total_revenue = 750000.0;
-            metrics.average_ticket_price = 50.0;
-            metrics.overall_satisfaction_score = 4.2;
-            metrics.nps_score = 75.0;
-            metrics.most_popular_concert = "Summer Music Festival";
-            metrics.top_performing_venue = "Grand Concert Hall";
-            
+            auto started = std::chrono::steady_clock::now();
+            ReportTiming timing;
+            Snapshot snapshot = collectSnapshot("", "", SCAN_ALL & ~SCAN_CREWS, timing);
+            SummaryMetrics metrics = summarize(snapshot);
+            recordTiming("summary", timing, started);
             return metrics;
         }
 
@@ -214,83 +314,74 @@ namespace ReportManager {
             Model::DateTime last_updated;
         };
         ConcertMetrics getConcertMetrics(int concert_id) {
-            ConcertMetrics metrics = {};
-            metrics.concert_id = concert_id;
-            metrics.concert_name = "Concert #" + std::to_string(concert_id);
-            metrics.total_registrations = 500;
-            metrics.tickets_sold = 450;
-            metrics.tickets_available = 50;
-            metrics.sales_volume = 22500.0;
-            metrics.capacity_utilization = 90.0;
-            metrics.attendee_engagement_score = calculateEngagementScore(concert_id);
-            metrics.nps_score = 80.0;
-            metrics.total_feedback_count = 125;
-            metrics.average_rating = 4.3;
-            metrics.top_payment_method = "Credit Card";
-            metrics.last_updated = Model::DateTime::now();
-            
+            auto started = std::chrono::steady_clock::now();
+            ReportTiming timing;
+            Snapshot snapshot = collectSnapshot("", "", SCAN_CONCERTS | SCAN_TICKETS | SCAN_FEEDBACK, timing);
+            ConcertMetrics metrics = concertMetrics(snapshot, concert_id);
+            auto tickets = snapshot.tickets.find(concert_id);
+            if (tickets != snapshot.tickets.end()) {
+                metrics.top_payment_method = topPaymentMethod(tickets->second.holders);
+            }
+            recordTiming("concert", timing, started);
             return metrics;
         }
 
         /**
          * @brief Get revenue breakdown by time period
+         *
+         * Net payments (gross less refunds, converted to the base currency at
+         * each day's rate) are summed per day and rolled up into periods.
+         * Every period overlapping the range is present, zero if idle.
+         *
          * @param start_date Start date (ISO 8601 format)
-         * @param end_date End date (ISO 8601 format)
-         * @param period_type Period type ("daily", "weekly", "monthly")
-         * @return Map of period -> revenue amount
+         * @param end_date End date (ISO 8601 format, inclusive)
+         * @param period_type Period type ("daily", "weekly" for ISO weeks, "monthly")
+         * @return Map of period ("2030-01-15", "2030-W03", "2030-01") -> revenue amount
          */
         std::map<std::string, double> getRevenueBreakdown(const std::string& start_date,
                                                         const std::string& end_date,
                                                         const std::string& period_type = "daily") {
             std::map<std::string, double> breakdown;
-            
-            if (!validateDateRange(start_date, end_date)) {
+            TimeBuckets::Period period;
+            int64_t first_day, last_day;
+            if (!validateDateRange(start_date, end_date) || !TimeBuckets::parsePeriod(period_type, period) ||
+                !dayRange(start_date, end_date, first_day, last_day)) {
                 return breakdown;
             }
             
-            // Simulate revenue data based on period type
-            if (period_type == "daily") {
-                breakdown["2024-01-01"] = 5000.0;
-                breakdown["2024-01-02"] = 7500.0;
-                breakdown["2024-01-03"] = 3200.0;
-                breakdown["2024-01-04"] = 8900.0;
-                breakdown["2024-01-05"] = 6400.0;
-            } else if (period_type == "weekly") {
-                breakdown["2024-W01"] = 25000.0;
-                breakdown["2024-W02"] = 32000.0;
-                breakdown["2024-W03"] = 28500.0;
-                breakdown["2024-W04"] = 35000.0;
-            } else if (period_type == "monthly") {
-                breakdown["2024-01"] = 125000.0;
-                breakdown["2024-02"] = 98000.0;
-                breakdown["2024-03"] = 142000.0;
+            ReportTiming timing;
+            Snapshot snapshot = collectSnapshot(start_date, end_date, SCAN_PAYMENTS, timing);
+            for (const auto& total : TimeBuckets::rollUp(snapshot.daily_revenue, first_day, last_day, period)) {
+                breakdown[total.first] = total.second.toMajor(snapshot.base_currency);
             }
-            
             return breakdown;
         }
 
         /**
          * @brief Get attendance trends over time
+         *
+         * Counts checked-in tickets, dated by their last status change, per
+         * period. Every period overlapping the range is present, zero if idle.
+         *
          * @param start_date Start date (ISO 8601 format)
-         * @param end_date End date (ISO 8601 format)
-         * @return Map of date -> attendance count
+         * @param end_date End date (ISO 8601 format, inclusive)
+         * @param period_type Period type ("daily", "weekly" for ISO weeks, "monthly")
+         * @return Map of period -> attendance count
          */
         std::map<std::string, int> getAttendanceTrends(const std::string& start_date,
-                                                     const std::string& end_date) {
+                                                     const std::string& end_date,
+                                                     const std::string& period_type = "daily") {
             std::map<std::string, int> trends;
-            
-            if (!validateDateRange(start_date, end_date)) {
+            TimeBuckets::Period period;
+            int64_t first_day, last_day;
+            if (!validateDateRange(start_date, end_date) || !TimeBuckets::parsePeriod(period_type, period) ||
+                !dayRange(start_date, end_date, first_day, last_day)) {
                 return trends;
             }
             
-            // Simulate attendance data
-            trends["2024-01-01"] = 250;
-            trends["2024-01-02"] = 380;
-            trends["2024-01-03"] = 190;
-            trends["2024-01-04"] = 425;
-            trends["2024-01-05"] = 320;
-            
-            return trends;
+            ReportTiming timing;
+            Snapshot snapshot = collectSnapshot(start_date, end_date, SCAN_TICKETS, timing);
+            return TimeBuckets::rollUp(snapshot.daily_check_ins, first_day, last_day, period);
         }
 
         // Financial Reports
@@ -302,20 +393,21 @@ namespace ReportManager {
          * @return Financial summary struct
          */
         struct FinancialSummary {
-            double total_revenue;
-            double gross_profit;
-            double net_profit;
-            double operating_expenses;
-            double venue_costs;
-            double performer_fees;
-            double marketing_costs;
-            double staff_costs;
-            double payment_processing_fees;
-            double refunds_issued;
+            std::string base_currency;  // Currency of every amount below unless noted
+            Model::Money total_revenue;
+            Model::Money gross_profit;
+            Model::Money net_profit;
+            Model::Money operating_expenses;
+            Model::Money venue_costs;
+            Model::Money performer_fees;
+            Model::Money marketing_costs;
+            Model::Money staff_costs;
+            Model::Money payment_processing_fees;
+            Model::Money refunds_issued;
             int total_transactions;
-            double average_transaction_value;
-            std::map<std::string, double> revenue_by_currency;
-            std::map<std::string, double> revenue_by_payment_method;
+            Model::Money average_transaction_value;
+            std::map<std::string, Model::Money> revenue_by_currency;  // Net, in each currency
+            std::map<std::string, Model::Money> revenue_by_payment_method;
         };
         FinancialSummary generateFinancialSummary(const std::string& start_date,
                                                 const std::string& end_date) {
@@ -325,29 +417,16 @@ namespace ReportManager {
                 return summary;
             }
             
-            // Simulate financial data
-            summary.total_revenue = 150000.0;
-            summary.operating_expenses = 45000.0;
-            summary.venue_costs = 20000.0;
-            summary.performer_fees = 35000.0;
-            summary.marketing_costs = 8000.0;
-            summary.staff_costs = 15000.0;
-            summary.payment_processing_fees = 3000.0;
-            summary.refunds_issued = 2500.0;
-            summary.gross_profit = summary.total_revenue - summary.operating_expenses;
-            summary.net_profit = summary.gross_profit - summary.venue_costs - summary.performer_fees 
-                               - summary.marketing_costs - summary.staff_costs - summary.payment_processing_fees;
-            summary.total_transactions = 1250;
-            summary.average_transaction_value = summary.total_revenue / summary.total_transactions;
-            
-            summary.revenue_by_currency["USD"] = 120000.0;
-            summary.revenue_by_currency["EUR"] = 20000.0;
-            summary.revenue_by_currency["GBP"] = 10000.0;
-            
-            summary.revenue_by_payment_method["Credit Card"] = 90000.0;
-            summary.revenue_by_payment_method["PayPal"] = 35000.0;
-            summary.revenue_by_payment_method["Bank Transfer"] = 25000.0;
+            std::string key = ReportCache<FinancialSummary>::makeKey("financial", {start_date, end_date});
+            uint64_t version = 0;
+            syncRateRevision();
+            if (summaryCache.lookup(key, summary, version)) {
+                return summary;
+            }
             
+            ReportTiming timing;
+            summary = summarizeFinances(collectSnapshot(start_date, end_date, SCAN_PAYMENTS | SCAN_CREWS, timing));
+            summaryCache.store(key, start_date, end_date, SCAN_PAYMENTS | SCAN_CREWS, summary, version);
             return summary;
         }
 
@@ -361,98 +440,504 @@ namespace ReportManager {
         std::string generateProfitLossStatement(const std::string& start_date,
                                               const std::string& end_date,
                                               const std::string& format = "JSON") {
-            FinancialSummary summary = generateFinancialSummary(start_date, end_date);
-            
-            std::ostringstream pnl;
-            pnl << "PROFIT & LOSS STATEMENT\n";
-            pnl << "Period: " << numericDate(start_date) << " to " << numericDate(end_date) << "\n\n";
-            pnl << "REVENUE\n";
-            pnl << "Total Revenue: $" << std::fixed << std::setprecision(2) << summary.total_revenue << "\n\n";
-            pnl << "EXPENSES\n";
-            pnl << "Venue Costs: $" << summary.venue_costs << "\n";
-            pnl << "Performer Fees: $" << summary.performer_fees << "\n";
-            pnl << "Marketing Costs: $" << summary.marketing_costs << "\n";
-            pnl << "Staff Costs: $" << summary.staff_costs << "\n";
-            pnl << "Payment Processing: $" << summary.payment_processing_fees << "\n";
-            pnl << "Refunds Issued: $" << summary.refunds_issued << "\n";
-            pnl << "Total Expenses: $" << (summary.venue_costs + summary.performer_fees + 
-                                         summary.marketing_costs + summary.staff_costs + 
-                                         summary.payment_processing_fees + summary.refunds_issued) << "\n\n";
-            pnl << "NET PROFIT: $" << summary.net_profit << "\n";
-            
-            return formatReportOutput(pnl.str(), format);
+            std::string key = ReportCache<std::string>::makeKey("profit_loss", {start_date, end_date, format});
+            std::string cached;
+            uint64_t version = 0;
+            syncRateRevision();
+            if (statementCache.lookup(key, cached, version)) {
+                return cached;
+            }
+            std::string statement = renderProfitLossStatement(generateFinancialSummary(start_date, end_date),
+                                                              start_date, end_date, format);
+            statementCache.store(key, start_date, end_date, SCAN_PAYMENTS | SCAN_CREWS, statement, version);
+            return statement;
+        }
+
+        /**
+         * @brief Hit/miss counters of the cached financial reports
+         *
+         * Entries are dropped when a payment or crew shift inside their period
+         * changes, or when the exchange rates change.
+         * @return Map of report ("financial_summary", "profit_loss") -> counters
+         */
+        std::map<std::string, ReportCacheStats> getCacheStats() const {
+            return {{"financial_summary", summaryCache.getStats()}, {"profit_loss", statementCache.getStats()}};
         }
 
         // Export and Visualization
 
         /**
          * @brief Export data for external visualization tools
-         * @param report_type Type of report to export
+         *
+         * CSV and JSON carry one row per period ("period" plus "revenue" or
+         * "attendance"), ready for charting; other formats wrap the series
+         * as text.
+         *
+         * @param report_type Type of report to export ("revenue" or "attendance")
          * @param start_date Start date (ISO 8601 format)
          * @param end_date End date (ISO 8601 format)
          * @param format Export format ("JSON", "CSV", "XML")
+         * @param period_type Period type ("daily", "weekly", "monthly")
          * @return Exported data as string
          */
         std::string exportDataForVisualization(const std::string& report_type,
                                              const std::string& start_date,
                                              const std::string& end_date,
-                                             const std::string& format = "JSON") {
-            std::ostringstream export_data;
+                                             const std::string& format = "JSON",
+                                             const std::string& period_type = "daily") {
+            std::map<std::string, double> series;
+            std::string value_name;
+            if (report_type == "revenue") {
+                series = getRevenueBreakdown(start_date, end_date, period_type);
+                value_name = "revenue";
+            } else if (report_type == "attendance") {
+                for (const auto& pair : getAttendanceTrends(start_date, end_date, period_type)) {
+                    series.emplace_hint(series.end(), pair.first, pair.second);
+                }
+                value_name = "attendance";
+            }
+            
+            if (!value_name.empty() && (format == "CSV" || format == "JSON")) {
+                std::ostringstream stream;
+                ReportExport::OutputBuffer out(stream);
+                std::vector<std::string> columns = {"period", value_name};
+                std::unique_ptr<ReportExport::RowWriter> writer;
+                if (format == "CSV") {
+                    writer = std::make_unique<ReportExport::CsvWriter>(out, columns);
+                } else {
+                    writer = std::make_unique<ReportExport::JsonWriter>(out, columns);
+                }
+                for (const auto& pair : series) {
+                    writer->beginRow();
+                    writer->text(pair.first);
+                    writer->number(pair.second);
+                    writer->endRow();
+                }
+                writer->finish();
+                return stream.str();
+            }
             
+            std::ostringstream export_data;
             if (report_type == "revenue") {
-                auto breakdown = getRevenueBreakdown(start_date, end_date);
                 export_data << "Revenue Data Export\n";
-                for (const auto& pair : breakdown) {
-                    export_data << pair.first << "," << pair.second << "\n";
-                }
             } else if (report_type == "attendance") {
-                auto trends = getAttendanceTrends(start_date, end_date);
                 export_data << "Attendance Data Export\n";
-                for (const auto& pair : trends) {
-                    export_data << pair.first << "," << pair.second << "\n";
-                }
+            }
+            for (const auto& pair : series) {
+                export_data << pair.first << "," << pair.second << "\n";
             }
             
             return formatReportOutput(export_data.str(), format);
         }
+        /**
+         * @brief Stream every record of a dataset to a file
+         *
+         * Rows are written through a fixed-size buffer as the module is
+         * scanned, so memory use does not depend on the number of records.
+         * Payments are read under the payment lock for the whole export.
+         *
+         * @param dataset "concerts", "tickets" or "payments"
+         * @param format "CSV" or "JSON"
+         * @param file_path Output file, replaced if it exists
+         * @return Number of rows written, or -1 on failure
+         */
+        long long exportDataset(const std::string& dataset, const std::string& format, const std::string& file_path) {
+            if (!canExport(dataset, format)) {
+                return -1;
+            }
+            std::FILE* file = std::fopen(file_path.c_str(), "wb");
+            if (!file) {
+                return -1;
+            }
+            long long rows;
+            {
+                ReportExport::OutputBuffer out(file);
+                rows = exportDataset(dataset, format, out);
+            }
+            if (std::fclose(file) != 0) {
+                rows = -1;
+            }
+            if (rows < 0) {
+                std::remove(file_path.c_str());
+            }
+            logReportGeneration("export_" + dataset, format + " -> " + file_path);
+            return rows;
+        }
+
+        /**
+         * @brief Stream every record of a dataset to an output stream
+         * @return Number of rows written, or -1 on failure
+         */
+        long long exportDataset(const std::string& dataset, const std::string& format, std::ostream& stream) {
+            if (!canExport(dataset, format)) {
+                return -1;
+            }
+            ReportExport::OutputBuffer out(stream);
+            return exportDataset(dataset, format, out);
+        }
+
+        /**
+         * @brief Write ticket, payment and feedback history to a columnar snapshot
+         *
+         * The snapshot is a self-contained file for offline analysis with
+         * snapshotQuery. Payments record only the payer, so each payment's
+         * concert_id is taken from the payer's ticket created closest to the
+         * payment time (-1 if the payer holds no ticket). Amounts are stored
+         * in minor units of their currency.
+         *
+         * @param file_path Output file, replaced if it exists
+         * @return Total rows written, or -1 on failure
+         */
+        long long exportColumnarSnapshot(const std::string& file_path) {
+            if (!sources.tickets && !sources.payments && !sources.feedback) {
+                return -1;
+            }
+            using Columnar::ColumnType;
+            Columnar::TableBuilder tickets("tickets", {{"ticket_id", ColumnType::INT64}, {"concert_id", ColumnType::INT64},
+                                                      {"attendee_id", ColumnType::INT64}, {"status", ColumnType::STRING},
+                                                      {"created_at", ColumnType::TIMESTAMP}});
+            Columnar::TableBuilder payments("payments", {{"payment_id", ColumnType::INT64}, {"concert_id", ColumnType::INT64},
+                                                        {"attendee_id", ColumnType::INT64}, {"amount_minor", ColumnType::INT64},
+                                                        {"currency", ColumnType::STRING}, {"payment_method", ColumnType::STRING},
+                                                        {"status", ColumnType::STRING}, {"paid_at", ColumnType::TIMESTAMP}});
+            Columnar::TableBuilder feedback("feedback", {{"concert_id", ColumnType::INT64}, {"attendee_id", ColumnType::INT64},
+                                                        {"rating", ColumnType::INT64}, {"submitted_at", ColumnType::TIMESTAMP}});
+
+            // Each attendee's tickets by creation time, for attributing payments
+            std::unordered_map<int, std::vector<std::pair<long long, int>>> ticketTimes;
+            if (sources.tickets) {
+                for (const auto& ticket : sources.tickets->getAll()) {
+                    int concert_id = TicketManager::TicketModule::extractConcertId(ticket->qr_code);
+                    int attendee_id = TicketManager::TicketModule::extractAttendeeId(ticket->qr_code);
+                    tickets.appendInt(0, ticket->ticket_id);
+                    tickets.appendInt(1, concert_id);
+                    tickets.appendInt(2, attendee_id);
+                    tickets.appendString(3, ReportExport::ticketStatusName(ticket->status));
+                    tickets.appendTimestamp(4, ticket->created_at.iso8601String);
+                    if (attendee_id > 0) {
+                        ticketTimes[attendee_id].emplace_back(toEpochSeconds(ticket->created_at.iso8601String), concert_id);
+                    }
+                }
+                for (auto& entry : ticketTimes) {
+                    std::sort(entry.second.begin(), entry.second.end());
+                }
+            }
+
+            if (sources.payments) {
+                sources.payments->visitPayments([&](const Model::Payment& payment) {
+                    int concert_id = -1;
+                    auto owned = ticketTimes.find(payment.attendee_id);
+                    if (owned != ticketTimes.end()) {
+                        const auto& times = owned->second;
+                        long long paid = toEpochSeconds(payment.payment_date_time.iso8601String);
+                        auto after = std::lower_bound(times.begin(), times.end(), std::make_pair(paid, std::numeric_limits<int>::min()));
+                        if (after == times.end() || (after != times.begin() && paid - std::prev(after)->first <= after->first - paid)) {
+                            --after;
+                        }
+                        concert_id = after->second;
+                    }
+                    payments.appendInt(0, payment.payment_id);
+                    payments.appendInt(1, concert_id);
+                    payments.appendInt(2, payment.attendee_id);
+                    payments.appendInt(3, payment.amount.minor);
+                    payments.appendString(4, payment.currency);
+                    payments.appendString(5, payment.payment_method);
+                    payments.appendString(6, ReportExport::paymentStatusName(payment.status));
+                    payments.appendTimestamp(7, payment.payment_date_time.iso8601String);
+                });
+            }
+
+            if (sources.feedback) {
+                for (const auto& entry : sources.feedback->getAll()) {
+                    feedback.appendInt(0, entry->concert_id);
+                    feedback.appendInt(1, entry->attendee_id);
+                    feedback.appendInt(2, entry->rating);
+                    feedback.appendTimestamp(3, entry->submitted_at.iso8601String);
+                }
+            }
+
+            if (!Columnar::writeSnapshot(file_path, {&tickets, &payments, &feedback})) {
+                std::remove(file_path.c_str());
+                return -1;
+            }
+            logReportGeneration("columnar_snapshot", file_path);
+            return static_cast<long long>(tickets.rowCount() + payments.rowCount() + feedback.rowCount());
+        }
+
+        /**
+         * @brief Columns of each table that runQuery can read
+         *
+         * Every table is a typed column view built from one attached module
+         * when a query runs. Payment amounts are in major units of each
+         * payment's own currency, so sum them per currency.
+         */
+        static const std::map<std::string, std::vector<std::pair<std::string, QueryEngine::ColumnType>>>& getQuerySchema() {
+            using QueryEngine::ColumnType;
+            static const std::map<std::string, std::vector<std::pair<std::string, ColumnType>>> schema = {
+                {"concerts", {{"concert_id", ColumnType::INT64}, {"name", ColumnType::STRING}, {"status", ColumnType::STRING},
+                              {"venue", ColumnType::STRING}, {"starts_at", ColumnType::TIMESTAMP},
+                              {"base_price", ColumnType::DOUBLE}, {"tickets_sold", ColumnType::INT64},
+                              {"capacity", ColumnType::INT64}}},
+                {"tickets", {{"ticket_id", ColumnType::INT64}, {"concert_id", ColumnType::INT64},
+                             {"attendee_id", ColumnType::INT64}, {"status", ColumnType::STRING},
+                             {"created_at", ColumnType::TIMESTAMP}, {"updated_at", ColumnType::TIMESTAMP}}},
+                {"payments", {{"payment_id", ColumnType::INT64}, {"attendee_id", ColumnType::INT64},
+                              {"amount", ColumnType::DOUBLE}, {"currency", ColumnType::STRING},
+                              {"method", ColumnType::STRING}, {"status", ColumnType::STRING},
+                              {"paid_at", ColumnType::TIMESTAMP}}},
+                {"attendees", {{"attendee_id", ColumnType::INT64}, {"type", ColumnType::STRING},
+                               {"staff", ColumnType::INT64}, {"registered_at", ColumnType::TIMESTAMP}}},
+                {"feedback", {{"concert_id", ColumnType::INT64}, {"attendee_id", ColumnType::INT64},
+                              {"rating", ColumnType::INT64}, {"submitted_at", ColumnType::TIMESTAMP}}},
+                {"crews", {{"crew_id", ColumnType::INT64}, {"name", ColumnType::STRING}, {"tasks", ColumnType::INT64},
+                           {"checked_in_at", ColumnType::TIMESTAMP}, {"checked_out_at", ColumnType::TIMESTAMP}}}};
+            return schema;
+        }
+
+        /**
+         * @brief Run an ad-hoc aggregation over one module's data
+         *
+         * For example, tickets by concert by status:
+         *   query.table = "tickets"; query.groupBy = {{"concert_id"}, {"status"}};
+         *
+         * @param threads Scan threads; 0 uses one per hardware thread
+         * @return Result with ok == false and error set if the table's module is
+         *         not attached or the query names unknown columns
+         */
+        QueryEngine::Result runQuery(const QueryEngine::Query& query, unsigned threads = 0) {
+            auto started = std::chrono::steady_clock::now();
+            QueryEngine::Table table;
+            if (!buildQueryTable(query.table, table)) {
+                QueryEngine::Result result;
+                result.error = getQuerySchema().count(query.table) ? "no module attached for " + query.table
+                                                                  : "unknown table " + query.table;
+                return result;
+            }
+            QueryEngine::Result result = QueryEngine::execute(table, query, threads);
+            recordTiming("ad_hoc_query", ReportTiming(), started);
+            return result;
+        }
+
+        /**
+         * @brief Run an ad-hoc aggregation written as text (see QueryEngine::parseQuery)
+         */
+        QueryEngine::Result runQuery(const std::string& text, unsigned threads = 0) {
+            QueryEngine::Query query;
+            QueryEngine::Result result;
+            if (!QueryEngine::parseQuery(text, query, result.error)) {
+                return result;
+            }
+            return runQuery(query, threads);
+        }
+
+        /**
+         * @brief Estimated number of distinct attendees holding sold tickets
+         *
+         * Read from HyperLogLog sketches kept current by change events, so the
+         * cost does not depend on the history size (about 1.6% error).
+         * Sketches only grow: attendees whose tickets are later cancelled are
+         * still counted until the sketches are rebuilt.
+         *
+         * @param concert_id Concert to count, or 0 for all concerts
+         */
+        uint64_t estimateDistinctAttendees(int concert_id = 0) {
+            std::lock_guard<std::mutex> lock(liveMutex);
+            if (concert_id == 0) {
+                return sketches.all_attendees.estimate();
+            }
+            auto sketch = sketches.attendees_by_concert.find(concert_id);
+            return sketch != sketches.attendees_by_concert.end() ? sketch->second.estimate() : 0;
+        }
+
+        /**
+         * @brief Estimated distinct attendees across the concerts at a venue
+         */
+        uint64_t estimateDistinctAttendeesByVenue(const std::string& venue_name) {
+            std::lock_guard<std::mutex> lock(liveMutex);
+            auto sketch = sketches.attendees_by_venue.find(venue_name);
+            return sketch != sketches.attendees_by_venue.end() ? sketch->second.estimate() : 0;
+        }
+
+        /**
+         * @brief Estimated distinct attendees of concerts starting in a month
+         * @param month Month as "YYYY-MM"
+         */
+        uint64_t estimateDistinctAttendeesByMonth(const std::string& month) {
+            std::lock_guard<std::mutex> lock(liveMutex);
+            auto sketch = sketches.attendees_by_month.find(month);
+            return sketch != sketches.attendees_by_month.end() ? sketch->second.estimate() : 0;
+        }
+
+        /**
+         * @brief Approximate quantile of the base price of sold tickets
+         * @param q Quantile in [0, 1], e.g. 0.5 for the median
+         * @return Price within 1% of the true quantile, or -1 if no tickets are sold
+         */
+        double getTicketPriceQuantile(double q) {
+            std::lock_guard<std::mutex> lock(liveMutex);
+            return sketches.ticket_prices.quantile(q);
+        }
+
+        /**
+         * @brief Approximate quantile of completed payment amounts in one currency
+         * @return Amount in major units, or -1 if there are no payments in the currency
+         */
+        double getPaymentAmountQuantile(const std::string& currency, double q) {
+            std::lock_guard<std::mutex> lock(liveMutex);
+            auto sketch = sketches.payment_amounts.find(currency);
+            return sketch != sketches.payment_amounts.end() ? sketch->second.quantile(q) : -1.0;
+        }
+
+        /**
+         * @brief Approximate quantile of feedback ratings
+         * @return Rating, or -1 if there is no feedback
+         */
+        double getRatingQuantile(double q) {
+            std::lock_guard<std::mutex> lock(liveMutex);
+            return sketches.ratings.quantile(q);
+        }
+
+        /**
+         * @brief Rebuild the analytics sketches with one pass over the attached modules
+         *
+         * Needed only to drop attendees of cancelled tickets from the distinct
+         * counts; attaching sources rebuilds automatically when the persisted
+         * sketches do not match them.
+         */
+        void rebuildAnalyticsSketches() {
+            AnalyticsSketches rebuilt;
+            if (sources.tickets) {
+                std::unordered_map<int, double> counted;
+                {
+                    std::lock_guard<std::mutex> lock(liveMutex);
+                    counted = sketches.sold_prices;
+                }
+                std::unordered_map<int, SketchConcert> concerts;
+                for (const auto& ticket : sources.tickets->getAll()) {
+                    int concert_id = TicketManager::TicketModule::extractConcertId(ticket->qr_code);
+                    auto concert = concerts.find(concert_id);
+                    if (concert == concerts.end()) {
+                        concert = concerts.emplace(concert_id, sketchConcert(concert_id)).first;
+                    }
+                    auto price = counted.find(ticket->ticket_id);
+                    if (price != counted.end()) {
+                        rebuilt.sold_prices.insert(*price); // Tickets already counted keep their sale price
+                    }
+                    sketchTicket(rebuilt, *ticket, 1, concert->second);
+                }
+            }
+            if (sources.payments) {
+                sources.payments->visitPayments([&rebuilt](const Model::Payment& payment) {
+                    sketchPayment(rebuilt, payment, 1);
+                });
+            }
+            if (sources.feedback) {
+                for (const auto& entry : sources.feedback->getAll()) {
+                    sketchFeedback(rebuilt, *entry, 1);
+                }
+            }
+            std::lock_guard<std::mutex> lock(liveMutex);
+            sketches = std::move(rebuilt);
+        }
+
+        /**
+         * @brief Write the analytics sketches next to the reports file
+         * @return false if the file could not be written
+         */
+        bool saveAnalyticsSketches() {
+            std::ofstream file(dataFilePath + ".sketches", std::ios::binary | std::ios::trunc);
+            if (!file.is_open()) {
+                return false;
+            }
+            std::lock_guard<std::mutex> lock(liveMutex);
+            file.write(SKETCH_MAGIC, sizeof(SKETCH_MAGIC));
+            file.write(reinterpret_cast<const char*>(&sketches.tickets_sold), sizeof(sketches.tickets_sold));
+            file.write(reinterpret_cast<const char*>(&sketches.transactions), sizeof(sketches.transactions));
+            sketches.all_attendees.write(file);
+            writeSketchMap(file, sketches.attendees_by_concert);
+            writeSketchMap(file, sketches.attendees_by_venue);
+            writeSketchMap(file, sketches.attendees_by_month);
+            sketches.ticket_prices.write(file);
+            writeSoldPrices(file, sketches.sold_prices);
+            writeSketchMap(file, sketches.payment_amounts);
+            sketches.ratings.write(file);
+            return static_cast<bool>(file);
+        }
 
         /**
          * @brief Generate dashboard data for real-time monitoring
+         *
+         * Ticket, payment and feedback figures come from the live aggregates
+         * that change events keep current, so the cost of a read depends on
+         * the number of concerts, not on sales volume. Concert rows and the
+         * attendee count are re-read from their modules. The recent concerts
+         * leave top_payment_method empty; getConcertMetrics fills it.
          * @return Dashboard data struct
          */
         struct DashboardData {
             SummaryMetrics summary;
             std::vector<ConcertMetrics> recent_concerts;
-            std::map<std::string, double> daily_revenue_trend;
+            std::map<std::string, double> daily_revenue_trend;  // In the base currency
             std::map<std::string, int> daily_ticket_sales;
+            std::map<std::string, int> daily_check_ins;
             std::vector<std::string> recent_alerts;
+            int total_capacity = 0;  // Seats across all concerts
+            uint64_t distinct_attendees = 0;    // Estimated, see estimateDistinctAttendees
+            double median_ticket_price = -1.0;  // -1 when nothing is sold
+            double p90_ticket_price = -1.0;
+            double median_rating = -1.0;        // -1 without feedback
             Model::DateTime last_updated;
         };
         DashboardData generateDashboardData() {
+            auto started = std::chrono::steady_clock::now();
             DashboardData dashboard;
-            dashboard.summary = calculateSummaryMetrics();
-            
-            // Add recent concerts metrics
-            for (int i = 1; i <= 5; ++i) {
-                dashboard.recent_concerts.push_back(getConcertMetrics(i));
+            bool highRefunds = false;
+            {
+                std::lock_guard<std::mutex> lock(liveMutex);
+                refreshConcertRows(live);
+                live.total_attendees = sources.attendees ? static_cast<int>(sources.attendees->getAllAttendees().size()) : 0;
+                dashboard.summary = summarize(live);
+                
+                // Five most recent concerts by start date
+                std::vector<std::pair<std::string, int>> byStart;
+                for (const auto& concert : live.concerts) {
+                    byStart.emplace_back(concert.second.start, concert.first);
+                    dashboard.total_capacity += concert.second.capacity;
+                }
+                std::sort(byStart.rbegin(), byStart.rend());
+                for (size_t i = 0; i < byStart.size() && i < 5; ++i) {
+                    dashboard.recent_concerts.push_back(concertMetrics(live, byStart[i].second));
+                }
+                
+                // The seven calendar days ending today, quiet days included
+                int64_t today = TimeBuckets::dayOf(TimeBuckets::parseIso8601(Model::DateTime::now().iso8601String));
+                for (const auto& day : TimeBuckets::rollUp(live.daily_revenue, today - 6, today, TimeBuckets::Period::DAY)) {
+                    dashboard.daily_revenue_trend[day.first] = day.second.toMajor(live.base_currency);
+                }
+                dashboard.daily_ticket_sales = TimeBuckets::rollUp(live.daily_ticket_sales, today - 6, today, TimeBuckets::Period::DAY);
+                dashboard.daily_check_ins = TimeBuckets::rollUp(live.daily_check_ins, today - 6, today, TimeBuckets::Period::DAY);
+                
+                highRefunds = live.gross.minor > 0 && live.refunds.minor * 10 > live.gross.minor;
+                
+                dashboard.distinct_attendees = sketches.all_attendees.estimate();
+                dashboard.median_ticket_price = sketches.ticket_prices.quantile(0.5);
+                dashboard.p90_ticket_price = sketches.ticket_prices.quantile(0.9);
+                dashboard.median_rating = sketches.ratings.quantile(0.5);
             }
             
-            // Simulate revenue trends
-            dashboard.daily_revenue_trend["2024-01-01"] = 5000.0;
-            dashboard.daily_revenue_trend["2024-01-02"] = 7500.0;
-            dashboard.daily_revenue_trend["2024-01-03"] = 3200.0;
-            
-            // Simulate ticket sales
-            dashboard.daily_ticket_sales["2024-01-01"] = 125;
-            dashboard.daily_ticket_sales["2024-01-02"] = 180;
-            dashboard.daily_ticket_sales["2024-01-03"] = 95;
-            
-            // Recent alerts
-            dashboard.recent_alerts.push_back("High demand for Summer Festival");
-            dashboard.recent_alerts.push_back("Low ticket sales for Jazz Night");
-            dashboard.recent_alerts.push_back("Payment processing delay detected");
+            for (const auto& concert : dashboard.recent_concerts) {
+                if (concert.capacity_utilization >= 90.0) {
+                    dashboard.recent_alerts.push_back("High demand for " + concert.concert_name);
+                } else if (concert.tickets_sold > 0 && concert.capacity_utilization < 20.0) {
+                    dashboard.recent_alerts.push_back("Low ticket sales for " + concert.concert_name);
+                }
+            }
+            if (highRefunds) {
+                dashboard.recent_alerts.push_back("Refunds above 10% of sales");
+            }
             
             dashboard.last_updated = Model::DateTime::now();
+            recordTiming("dashboard", ReportTiming(), started);
             return dashboard;
         }
 
@@ -524,21 +1009,92 @@ namespace ReportManager {
 
         /**
          * @brief Schedule automatic report generation
-         * @param report_type Type of report to schedule
-         * @param frequency Frequency ("daily", "weekly", "monthly")
+         * @param report_type Type of report to schedule ("sales", "payroll", "profit_loss", "payment")
+         * @param frequency "hourly", "daily", "weekly", "monthly" or a five-field cron expression
          * @param recipients Email recipients for the report
          * @return Schedule ID if successful, empty string if failed
          */
         std::string scheduleAutomaticReport(const std::string& report_type,
                                           const std::string& frequency,
-                                          const std::vector<std::string>& recipients);
+                                          const std::vector<std::string>& recipients) {
+            const auto& types = getSchedulableReportTypes();
+            if (std::find(types.begin(), types.end(), report_type) == types.end()) {
+                return "";
+            }
+            return scheduler.schedule(report_type, frequency, recipients);
+        }
 
         /**
          * @brief Cancel scheduled report
          * @param schedule_id Schedule ID to cancel
          * @return true if successful, false otherwise
          */
-        bool cancelScheduledReport(const std::string& schedule_id);
+        bool cancelScheduledReport(const std::string& schedule_id) {
+            return scheduler.cancel(schedule_id);
+        }
+
+        /**
+         * @brief Start watching the report schedules
+         *
+         * Call after attachDataSources. Due reports start in
+         * runDueScheduledReports, which the thread that owns the attached
+         * modules calls from its own loop: the modules have no locks of their
+         * own, so their aggregates are collected there, and a background
+         * worker formats the report and writes it to the output directory.
+         * Each run covers the period since the schedule's previous run.
+         *
+         * @param output_directory Directory for the generated reports
+         * @return false if already started
+         */
+        bool startScheduledReports(const std::string& output_directory = "data/reports") {
+            return scheduler.start([this](const ReportScheduling::ScheduledReport& schedule,
+                                          const std::string& start_date, const std::string& end_date) {
+                return captureScheduledReport(schedule, start_date, end_date);
+            }, output_directory);
+        }
+
+        /**
+         * @brief Stop watching the report schedules, letting reports being written finish
+         */
+        void stopScheduledReports() {
+            scheduler.stop();
+        }
+
+        /**
+         * @brief Queue a scheduled report for the next runDueScheduledReports
+         * @return false if the schedule is unknown or the scheduler is not started
+         */
+        bool runScheduledReportNow(const std::string& schedule_id) {
+            return scheduler.runNow(schedule_id);
+        }
+
+        std::vector<ReportScheduling::ScheduledReport> getScheduledReports() const {
+            return scheduler.getSchedules();
+        }
+
+        /**
+         * @brief Collect every scheduled report that is due and queue it for writing
+         *
+         * Must be called from the thread that changes the attached modules.
+         *
+         * @return Number of reports started
+         */
+        size_t runDueScheduledReports() {
+            return scheduler.runDue();
+        }
+
+        /**
+         * @brief Wait for started scheduled reports to be written
+         * @return false on timeout
+         */
+        bool waitForScheduledReports(std::chrono::milliseconds timeout) {
+            return scheduler.waitUntilIdle(timeout);
+        }
+
+        static const std::vector<std::string>& getSchedulableReportTypes() {
+            static const std::vector<std::string> types = {"sales", "payroll", "profit_loss", "payment"};
+            return types;
+        }
 
     protected:
         // BaseModule implementation
@@ -621,31 +1177,1172 @@ namespace ReportManager {
         }
 
     private:
+        // Modules the analytics read from
+        DataSources sources;
+
+        // Latest compute time per report
+        mutable std::mutex timingMutex;
+        std::map<std::string, ReportTiming> reportTimings;
+
         /**
-         * @brief Calculate engagement score based on various metrics
-         * @param concert_id Concert ID
-         * @return Engagement score (0.0 to 10.0)
+         * @brief Module passes a report needs
          */
-        double calculateEngagementScore(int concert_id) {
-            // Simulate engagement calculation
-            return 7.5 + (concert_id % 3) * 0.5; // Returns 7.5, 8.0, or 8.5
-        }
+        enum ScanSet : unsigned {
+            SCAN_CONCERTS = 1u << 0,
+            SCAN_TICKETS = 1u << 1,
+            SCAN_PAYMENTS = 1u << 2,
+            SCAN_ATTENDEES = 1u << 3,
+            SCAN_FEEDBACK = 1u << 4,
+            SCAN_CREWS = 1u << 5,
+            SCAN_ALL = (1u << 6) - 1
+        };
+
+        struct ConcertRow {
+            std::string name;
+            std::string venue_name;
+            std::string start;
+            Model::EventStatus status = Model::EventStatus::SCHEDULED;
+            int capacity = 0;
+            double base_price = 0.0;
+        };
+
+        struct TicketCounts {
+            int sold = 0;                    // SOLD or CHECKED_IN
+            int checked_in = 0;
+            int available = 0;
+            int cancelled = 0;
+            std::unordered_map<int, int> holders; // Attendee ID -> sold tickets held
+        };
+
+        struct FeedbackCounts {
+            int count = 0;
+            long long rating_sum = 0;
+            int promoters = 0;   // Rated 5 of 5
+            int detractors = 0;  // Rated 3 of 5 or lower
+        };
 
         /**
-         * @brief Calculate Net Promoter Score from feedback
-         * @param feedback_scores Vector of feedback ratings
-         * @return NPS score (-100 to +100)
+         * @brief Payments of one day in one currency, exact and in the base currency
          */
-        double calculateNPS(const std::vector<int>& feedback_scores) {
-            if (feedback_scores.empty()) return 0.0;
-            
-            int promoters = 0, detractors = 0;
-            for (int score : feedback_scores) {
-                if (score >= 9) promoters++;
-                else if (score <= 6) detractors++;
+        struct PaymentDay {
+            Model::Money gross;
+            Model::Money refunds;
+            Model::Money gross_base;
+            Model::Money refunds_base;
+        };
+
+        /**
+         * @brief Payments of one method in one currency
+         */
+        struct PaymentMethodTotal {
+            Model::Money amount;
+            Model::Money amount_base;
+        };
+
+        /**
+         * @brief Aggregates from one pass over each attached module
+         *
+         * Every pass writes only its own members, so the passes can fill a
+         * single snapshot concurrently. The ticket, payment and feedback
+         * members are sums of per-entity deltas, so a change event can be
+         * applied to them directly.
+         */
+        struct Snapshot {
+            // Concert pass
+            std::map<int, ConcertRow> concerts;
+            int active_concerts = 0;
+            int completed_concerts = 0;
+            int cancelled_concerts = 0;
+            // Ticket pass, keyed by concert ID
+            std::map<int, TicketCounts> tickets;
+            std::map<std::string, int> daily_ticket_sales;
+            std::map<std::string, int> daily_check_ins;   // Checked-in tickets only
+            int tickets_sold = 0;
+            // Payment pass, in the base currency unless noted
+            std::string base_currency = "USD";
+            Model::Money gross;
+            Model::Money refunds;
+            Model::Money revenue;                                // gross - refunds
+            int transactions = 0;
+            std::map<std::pair<std::string, std::string>, PaymentDay> payment_days;            // (day, currency)
+            std::map<std::pair<std::string, std::string>, PaymentMethodTotal> payment_methods; // (method, currency)
+            std::map<std::string, Model::Money> daily_revenue;
+            std::map<std::string, Model::Money> revenue_by_currency;  // Net, in each currency
+            std::map<std::string, Model::Money> revenue_by_method;
+            // Attendee pass
+            int total_attendees = 0;
+            // Feedback pass, keyed by concert ID
+            std::map<int, FeedbackCounts> feedback;
+            FeedbackCounts all_feedback;
+            // Crew pass
+            int staff = 0;
+            double staff_hours = 0.0;
+            int tasks = 0;
+        };
+
+        // Dashboard aggregates, kept current by the sources' change feeds
+        // (taken after a source's own lock, never before it)
+        std::mutex liveMutex;
+        Snapshot live;
+        int ticketSubscription = 0;
+        int paymentSubscription = 0;
+        int feedbackSubscription = 0;
+        int crewSubscription = 0;
+
+        /**
+         * @brief Mergeable approximate aggregates, maintained with the live dashboard
+         */
+        struct AnalyticsSketches {
+            Sketches::HyperLogLog all_attendees;
+            std::map<int, Sketches::HyperLogLog> attendees_by_concert;
+            std::map<std::string, Sketches::HyperLogLog> attendees_by_venue;
+            std::map<std::string, Sketches::HyperLogLog> attendees_by_month;   // Concert start month
+            Sketches::QuantileSketch ticket_prices;                           // Base price per sold ticket, at sale
+            std::unordered_map<int, double> sold_prices;                      // Ticket ID -> price it was counted at
+            std::map<std::string, Sketches::QuantileSketch> payment_amounts;  // Major units, by currency
+            Sketches::QuantileSketch ratings;
+            // Sold tickets and counted payments the sketches cover, to detect stale files
+            int64_t tickets_sold = 0;
+            int64_t transactions = 0;
+        };
+
+        /**
+         * @brief What the sketches need to know about a ticket's concert
+         */
+        struct SketchConcert {
+            bool known = false;
+            std::string venue;
+            std::string month;
+            double price = 0.0;
+        };
+
+        static constexpr char SKETCH_MAGIC[8] = {'M', 'U', 'S', 'E', 'S', 'K', 'T', '2'};
+
+        AnalyticsSketches sketches; // Guarded by liveMutex
+
+        // Financial reports by period and format
+        ReportCache<FinancialSummary> summaryCache;
+        ReportCache<std::string> statementCache;
+        std::atomic<uint64_t> cachedRateRevision{0};
+
+        // Recurring reports, persisted next to the reports file
+        ReportScheduling::ReportScheduler scheduler;
+
+        /**
+         * @brief Stop listening to the current sources' change feeds
+         */
+        void unsubscribeLive() {
+            if (ticketSubscription && sources.tickets) {
+                sources.tickets->getChangeFeed().unsubscribe(ticketSubscription);
             }
-            
-            return ((double)(promoters - detractors) / feedback_scores.size()) * 100.0;
+            if (paymentSubscription && sources.payments) {
+                sources.payments->getChangeFeed().unsubscribe(paymentSubscription);
+            }
+            if (feedbackSubscription && sources.feedback) {
+                sources.feedback->getChangeFeed().unsubscribe(feedbackSubscription);
+            }
+            if (crewSubscription && sources.crews) {
+                sources.crews->getChangeFeed().unsubscribe(crewSubscription);
+            }
+            ticketSubscription = paymentSubscription = feedbackSubscription = crewSubscription = 0;
+        }
+
+        /**
+         * @brief Drop cached reports whose period covers a changed record
+         */
+        void invalidateCaches(unsigned source, const std::string& timestamp) {
+            summaryCache.invalidate(source, timestamp);
+            statementCache.invalidate(source, timestamp);
+        }
+
+        /**
+         * @brief Drop all cached reports if the exchange rates changed since they were built
+         */
+        void syncRateRevision() {
+            uint64_t revision = sources.payments ? sources.payments->getRateRevision() : 0;
+            if (cachedRateRevision.exchange(revision) != revision) {
+                summaryCache.clear();
+                statementCache.clear();
+            }
+        }
+
+        /**
+         * @brief Re-read the concert rows and status counts (caller holds liveMutex)
+         */
+        void refreshConcertRows(Snapshot& snapshot) {
+            snapshot.concerts.clear();
+            snapshot.active_concerts = snapshot.completed_concerts = snapshot.cancelled_concerts = 0;
+            if (sources.concerts) {
+                scanConcerts(snapshot);
+            }
+        }
+
+        /**
+         * @brief Run the requested module passes in parallel and collect their aggregates
+         * @param start_date Inclusive lower bound on activity dates ("" for none)
+         * @param end_date Inclusive upper bound on activity dates ("" for none)
+         * @param scans ScanSet bits of the passes to run; unattached modules are skipped
+         * @param timing Receives the time spent in each pass
+         * @return Aggregates of every pass that ran
+         */
+        Snapshot collectSnapshot(const std::string& start_date, const std::string& end_date,
+                                 unsigned scans, ReportTiming& timing) {
+            Snapshot snapshot;
+            std::vector<std::pair<std::string, std::function<void()>>> passes;
+            if ((scans & SCAN_CONCERTS) && sources.concerts) {
+                passes.emplace_back("concerts", [&]() { scanConcerts(snapshot); });
+            }
+            if ((scans & SCAN_TICKETS) && sources.tickets) {
+                passes.emplace_back("tickets", [&]() { scanTickets(snapshot, start_date, end_date); });
+            }
+            if ((scans & SCAN_PAYMENTS) && sources.payments) {
+                passes.emplace_back("payments", [&]() { scanPayments(snapshot, start_date, end_date); });
+            }
+            if ((scans & SCAN_ATTENDEES) && sources.attendees) {
+                passes.emplace_back("attendees", [&]() { scanAttendees(snapshot); });
+            }
+            if ((scans & SCAN_FEEDBACK) && sources.feedback) {
+                passes.emplace_back("feedback", [&]() { scanFeedback(snapshot, start_date, end_date); });
+            }
+            if ((scans & SCAN_CREWS) && sources.crews) {
+                passes.emplace_back("crews", [&]() { scanCrews(snapshot, start_date, end_date); });
+            }
+
+            std::vector<std::future<double>> running;
+            for (auto& pass : passes) {
+                running.push_back(std::async(std::launch::async, [&pass]() {
+                    auto begin = std::chrono::steady_clock::now();
+                    pass.second();
+                    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+                }));
+            }
+            for (size_t i = 0; i < passes.size(); ++i) {
+                timing.scan_ms[passes[i].first] = running[i].get();
+            }
+            return snapshot;
+        }
+
+        /**
+         * @brief Fill the column view of one query table from its module
+         * @return false if the table is unknown or its module is not attached
+         */
+        bool buildQueryTable(const std::string& name, QueryEngine::Table& table) {
+            auto definition = getQuerySchema().find(name);
+            if (definition == getQuerySchema().end()) {
+                return false;
+            }
+            table = QueryEngine::Table(name, definition->second);
+            if (name == "concerts" && sources.concerts) {
+                for (const auto& concert : sources.concerts->getAllConcerts()) {
+                    int sold = concert->ticketInfo ? concert->ticketInfo->quantity_sold : 0;
+                    int capacity = concert->venue ? concert->venue->capacity : 0;
+                    if (capacity == 0 && concert->ticketInfo) {
+                        capacity = concert->ticketInfo->quantity_available + sold;
+                    }
+                    table.appendInt(0, concert->id);
+                    table.appendString(1, concert->name);
+                    table.appendString(2, ReportExport::eventStatusName(concert->event_status));
+                    table.appendString(3, concert->venue ? concert->venue->name : "");
+                    table.appendTimestamp(4, concert->start_date_time.iso8601String);
+                    table.appendDouble(5, concert->ticketInfo ? concert->ticketInfo->base_price : 0.0);
+                    table.appendInt(6, sold);
+                    table.appendInt(7, capacity);
+                }
+            } else if (name == "tickets" && sources.tickets) {
+                for (const auto& ticket : sources.tickets->getAll()) {
+                    table.appendInt(0, ticket->ticket_id);
+                    table.appendInt(1, TicketManager::TicketModule::extractConcertId(ticket->qr_code));
+                    table.appendInt(2, TicketManager::TicketModule::extractAttendeeId(ticket->qr_code));
+                    table.appendString(3, ReportExport::ticketStatusName(ticket->status));
+                    table.appendTimestamp(4, ticket->created_at.iso8601String);
+                    table.appendTimestamp(5, ticket->updated_at.iso8601String);
+                }
+            } else if (name == "payments" && sources.payments) {
+                sources.payments->visitPayments([&table](const Model::Payment& payment) {
+                    table.appendInt(0, payment.payment_id);
+                    table.appendInt(1, payment.attendee_id);
+                    table.appendDouble(2, payment.amount.toMajor(payment.currency));
+                    table.appendString(3, payment.currency);
+                    table.appendString(4, payment.payment_method);
+                    table.appendString(5, ReportExport::paymentStatusName(payment.status));
+                    table.appendTimestamp(6, payment.payment_date_time.iso8601String);
+                });
+            } else if (name == "attendees" && sources.attendees) {
+                for (const auto& attendee : sources.attendees->getAllAttendees()) {
+                    table.appendInt(0, attendee->id);
+                    table.appendString(1, attendee->attendee_type == Model::AttendeeType::VIP ? "VIP" : "REGULAR");
+                    table.appendInt(2, attendee->staff_privileges ? 1 : 0);
+                    table.appendTimestamp(3, attendee->registration_date.iso8601String);
+                }
+            } else if (name == "feedback" && sources.feedback) {
+                for (const auto& entry : sources.feedback->getAll()) {
+                    table.appendInt(0, entry->concert_id);
+                    table.appendInt(1, entry->attendee_id);
+                    table.appendInt(2, entry->rating);
+                    table.appendTimestamp(3, entry->submitted_at.iso8601String);
+                }
+            } else if (name == "crews" && sources.crews) {
+                for (const auto& crew : sources.crews->getAllCrew()) {
+                    table.appendInt(0, crew->id);
+                    table.appendString(1, crew->name);
+                    table.appendInt(2, static_cast<int64_t>(crew->tasks.size()));
+                    table.appendTimestamp(3, crew->check_in_time ? crew->check_in_time->iso8601String : "");
+                    table.appendTimestamp(4, crew->check_out_time ? crew->check_out_time->iso8601String : "");
+                }
+            } else {
+                return false;
+            }
+            return true;
+        }
+
+        SketchConcert sketchConcert(int concert_id) {
+            SketchConcert info;
+            auto concert = sources.concerts ? sources.concerts->getConcertById(concert_id) : nullptr;
+            if (concert) {
+                info.known = true;
+                info.venue = concert->venue ? concert->venue->name : "";
+                info.month = concert->start_date_time.iso8601String.substr(0, 7);
+                info.price = concert->ticketInfo ? concert->ticketInfo->base_price : 0.0;
+            }
+            return info;
+        }
+
+        /**
+         * @brief Add a ticket image to (direction 1) or take it from (direction -1) the sketches
+         *
+         * A ticket is priced at its concert's base price when first counted
+         * and keeps that price through later status changes, so retracting it
+         * takes back what was added even if the concert has been repriced.
+         * Distinct-attendee sketches cannot forget, so only additions reach them.
+         */
+        static void sketchTicket(AnalyticsSketches& target, const Model::Ticket& ticket, int direction,
+                                 const SketchConcert& concert) {
+            if (ticket.status != Model::TicketStatus::SOLD && ticket.status != Model::TicketStatus::CHECKED_IN) {
+                if (direction > 0) {
+                    target.sold_prices.erase(ticket.ticket_id); // Cancelled; a resale is priced afresh
+                }
+                return;
+            }
+            target.tickets_sold += direction;
+            auto priced = target.sold_prices.find(ticket.ticket_id);
+            if (direction < 0) {
+                // The entry stays for the new image of the same change
+                if (priced != target.sold_prices.end()) {
+                    target.ticket_prices.remove(priced->second);
+                }
+            } else if (priced != target.sold_prices.end()) {
+                target.ticket_prices.add(priced->second);
+            } else if (concert.known && target.ticket_prices.add(concert.price)) {
+                target.sold_prices[ticket.ticket_id] = concert.price;
+            }
+            int attendee_id = TicketManager::TicketModule::extractAttendeeId(ticket.qr_code);
+            if (direction <= 0 || attendee_id <= 0) {
+                return;
+            }
+            uint64_t key = static_cast<uint64_t>(attendee_id);
+            target.all_attendees.add(key);
+            target.attendees_by_concert[TicketManager::TicketModule::extractConcertId(ticket.qr_code)].add(key);
+            if (!concert.venue.empty()) {
+                target.attendees_by_venue[concert.venue].add(key);
+            }
+            if (concert.month.size() == 7) {
+                target.attendees_by_month[concert.month].add(key);
+            }
+        }
+
+        /**
+         * @brief Count payments that reach revenue (completed or later refunded), by currency
+         */
+        static void sketchPayment(AnalyticsSketches& target, const Model::Payment& payment, int direction) {
+            if (payment.amount.minor < 0 || (payment.status != Model::PaymentStatus::COMPLETED &&
+                                             payment.status != Model::PaymentStatus::REFUNDED)) {
+                return;
+            }
+            target.transactions += direction;
+            double amount = payment.amount.toMajor(payment.currency);
+            if (direction > 0) {
+                target.payment_amounts[payment.currency].add(amount);
+            } else {
+                target.payment_amounts[payment.currency].remove(amount);
+            }
+        }
+
+        static void sketchFeedback(AnalyticsSketches& target, const Model::Feedback& feedback, int direction) {
+            if (direction > 0) {
+                target.ratings.add(feedback.rating);
+            } else {
+                target.ratings.remove(feedback.rating);
+            }
+        }
+
+        template <typename Key, typename Sketch>
+        static void writeSketchMap(std::ofstream& file, const std::map<Key, Sketch>& sketchMap) {
+            uint64_t count = sketchMap.size();
+            file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+            for (const auto& entry : sketchMap) {
+                writeSketchKey(file, entry.first);
+                entry.second.write(file);
+            }
+        }
+
+        template <typename Key, typename Sketch>
+        static bool readSketchMap(std::ifstream& file, std::map<Key, Sketch>& sketchMap) {
+            uint64_t count = 0;
+            if (!file.read(reinterpret_cast<char*>(&count), sizeof(count))) {
+                return false;
+            }
+            for (uint64_t i = 0; i < count; ++i) {
+                Key key;
+                if (!readSketchKey(file, key) || !sketchMap[key].read(file)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        static void writeSoldPrices(std::ofstream& file, const std::unordered_map<int, double>& prices) {
+            uint64_t count = prices.size();
+            file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+            for (const auto& entry : prices) {
+                file.write(reinterpret_cast<const char*>(&entry.first), sizeof(entry.first));
+                file.write(reinterpret_cast<const char*>(&entry.second), sizeof(entry.second));
+            }
+        }
+
+        static bool readSoldPrices(std::ifstream& file, std::unordered_map<int, double>& prices) {
+            uint64_t count = 0;
+            if (!file.read(reinterpret_cast<char*>(&count), sizeof(count))) {
+                return false;
+            }
+            for (uint64_t i = 0; i < count; ++i) {
+                int ticket_id = 0;
+                double price = 0.0;
+                if (!file.read(reinterpret_cast<char*>(&ticket_id), sizeof(ticket_id)) ||
+                    !file.read(reinterpret_cast<char*>(&price), sizeof(price))) {
+                    return false;
+                }
+                prices[ticket_id] = price;
+            }
+            return true;
+        }
+
+        static void writeSketchKey(std::ofstream& file, int key) {
+            file.write(reinterpret_cast<const char*>(&key), sizeof(key));
+        }
+
+        static void writeSketchKey(std::ofstream& file, const std::string& key) {
+            uint32_t length = static_cast<uint32_t>(key.size());
+            file.write(reinterpret_cast<const char*>(&length), sizeof(length));
+            file.write(key.data(), length);
+        }
+
+        static bool readSketchKey(std::ifstream& file, int& key) {
+            return static_cast<bool>(file.read(reinterpret_cast<char*>(&key), sizeof(key)));
+        }
+
+        static bool readSketchKey(std::ifstream& file, std::string& key) {
+            uint32_t length = 0;
+            if (!file.read(reinterpret_cast<char*>(&length), sizeof(length)) || length > 4096) {
+                return false;
+            }
+            key.resize(length);
+            return static_cast<bool>(file.read(&key[0], length));
+        }
+
+        /**
+         * @brief Load sketches saved by saveAnalyticsSketches; a missing or damaged file leaves them empty
+         */
+        void loadSketches() {
+            std::ifstream file(dataFilePath + ".sketches", std::ios::binary);
+            if (!file.is_open()) {
+                return;
+            }
+            AnalyticsSketches loaded;
+            char magic[sizeof(SKETCH_MAGIC)];
+            bool ok = file.read(magic, sizeof(magic)) && std::memcmp(magic, SKETCH_MAGIC, sizeof(magic)) == 0 &&
+                      file.read(reinterpret_cast<char*>(&loaded.tickets_sold), sizeof(loaded.tickets_sold)) &&
+                      file.read(reinterpret_cast<char*>(&loaded.transactions), sizeof(loaded.transactions)) &&
+                      loaded.all_attendees.read(file) && readSketchMap(file, loaded.attendees_by_concert) &&
+                      readSketchMap(file, loaded.attendees_by_venue) && readSketchMap(file, loaded.attendees_by_month) &&
+                      loaded.ticket_prices.read(file) && readSoldPrices(file, loaded.sold_prices) &&
+                      readSketchMap(file, loaded.payment_amounts) &&
+                      loaded.ratings.read(file);
+            if (!ok) {
+                #ifdef DEBUG
+                std::cerr << "Ignoring damaged sketch file " << dataFilePath << ".sketches" << std::endl;
+                #endif
+                return;
+            }
+            std::lock_guard<std::mutex> lock(liveMutex);
+            sketches = std::move(loaded);
+        }
+
+        void scanConcerts(Snapshot& snapshot) {
+            for (const auto& concert : sources.concerts->getAllConcerts()) {
+                ConcertRow& row = snapshot.concerts[concert->id];
+                row.name = concert->name;
+                row.start = concert->start_date_time.iso8601String;
+                row.status = concert->event_status;
+                if (concert->venue) {
+                    row.venue_name = concert->venue->name;
+                    row.capacity = concert->venue->capacity;
+                }
+                if (concert->ticketInfo) {
+                    row.base_price = concert->ticketInfo->base_price;
+                    if (row.capacity == 0) {
+                        row.capacity = concert->ticketInfo->quantity_available + concert->ticketInfo->quantity_sold;
+                    }
+                }
+                switch (concert->event_status) {
+                    case Model::EventStatus::COMPLETED: snapshot.completed_concerts++; break;
+                    case Model::EventStatus::CANCELLED: snapshot.cancelled_concerts++; break;
+                    default: snapshot.active_concerts++; break;
+                }
+            }
+        }
+
+        void scanTickets(Snapshot& snapshot, const std::string& start_date, const std::string& end_date) {
+            for (const auto& ticket : sources.tickets->getAll()) {
+                applyTicket(snapshot, *ticket, 1, start_date, end_date);
+            }
+        }
+
+        /**
+         * @brief Add a ticket image to (direction 1) or retract it from (direction -1) the ticket aggregates
+         */
+        static void applyTicket(Snapshot& snapshot, const Model::Ticket& ticket, int direction,
+                                const std::string& start_date = "", const std::string& end_date = "") {
+            TicketCounts& counts = snapshot.tickets[TicketManager::TicketModule::extractConcertId(ticket.qr_code)];
+            switch (ticket.status) {
+                case Model::TicketStatus::AVAILABLE:
+                    counts.available += direction;
+                    break;
+                case Model::TicketStatus::CANCELLED:
+                    counts.cancelled += direction;
+                    break;
+                case Model::TicketStatus::SOLD:
+                case Model::TicketStatus::CHECKED_IN: {
+                    // Sales are dated by the ticket's last status change
+                    const std::string& when = ticket.updated_at.iso8601String;
+                    if (!inRange(when, start_date, end_date)) {
+                        break;
+                    }
+                    counts.sold += direction;
+                    if (ticket.status == Model::TicketStatus::CHECKED_IN) {
+                        counts.checked_in += direction;
+                    }
+                    int attendee_id = TicketManager::TicketModule::extractAttendeeId(ticket.qr_code);
+                    if (attendee_id > 0 && (counts.holders[attendee_id] += direction) == 0) {
+                        counts.holders.erase(attendee_id);
+                    }
+                    std::string day = when.substr(0, 10);
+                    if ((snapshot.daily_ticket_sales[day] += direction) == 0) {
+                        snapshot.daily_ticket_sales.erase(day);
+                    }
+                    if (ticket.status == Model::TicketStatus::CHECKED_IN &&
+                        (snapshot.daily_check_ins[day] += direction) == 0) {
+                        snapshot.daily_check_ins.erase(day);
+                    }
+                    snapshot.tickets_sold += direction;
+                    break;
+                }
+                default:
+                    break;
+            }
+        }
+
+        void scanPayments(Snapshot& snapshot, const std::string& start_date, const std::string& end_date) {
+            PaymentManager::PaymentModule& payments = *sources.payments;
+            snapshot.base_currency = payments.getBaseCurrency();
+
+            // Exact sums per day and currency; each bucket is converted once, at its day's rate
+            payments.visitPayments([&](const Model::Payment& payment) {
+                if (inRange(payment.payment_date_time.iso8601String, start_date, end_date)) {
+                    bucketPayment(snapshot, payment, 1);
+                }
+            });
+            const std::string today = Model::DateTime::now().iso8601String.substr(0, 10);
+            for (auto it = snapshot.payment_days.begin(); it != snapshot.payment_days.end();) {
+                auto key = (it++)->first; // The call may erase an emptied bucket
+                convertPaymentDay(snapshot, key);
+            }
+            for (auto it = snapshot.payment_methods.begin(); it != snapshot.payment_methods.end();) {
+                auto key = (it++)->first;
+                convertPaymentMethod(snapshot, key, today);
+            }
+        }
+
+        /**
+         * @brief Apply one payment delta and re-convert only the buckets it touched
+         */
+        void applyPayment(Snapshot& snapshot, const Model::Payment& payment, int direction) {
+            if (!bucketPayment(snapshot, payment, direction)) {
+                return;
+            }
+            convertPaymentDay(snapshot, {payment.payment_date_time.iso8601String.substr(0, 10), payment.currency});
+            if (payment.amount.minor >= 0) {
+                convertPaymentMethod(snapshot, {payment.payment_method, payment.currency},
+                                     Model::DateTime::now().iso8601String.substr(0, 10));
+            }
+        }
+
+        /**
+         * @brief Add a payment's exact amount to (direction 1) or take it from (direction -1) its buckets
+         * @return false if the payment does not count towards revenue
+         */
+        static bool bucketPayment(Snapshot& snapshot, const Model::Payment& payment, int direction) {
+            std::pair<std::string, std::string> day{payment.payment_date_time.iso8601String.substr(0, 10), payment.currency};
+            Model::Money amount{direction * payment.amount.minor};
+            if (payment.amount.minor < 0) {
+                snapshot.payment_days[day].refunds -= amount;
+            } else if (payment.status == Model::PaymentStatus::COMPLETED ||
+                       payment.status == Model::PaymentStatus::REFUNDED) {
+                snapshot.payment_days[day].gross += amount;
+                snapshot.payment_methods[{payment.payment_method, payment.currency}].amount += amount;
+                snapshot.transactions += direction;
+            } else {
+                return false;
+            }
+            snapshot.revenue_by_currency[payment.currency] += amount;
+            return true;
+        }
+
+        /**
+         * @brief Convert one day's bucket at that day's rate and update the totals it feeds
+         */
+        void convertPaymentDay(Snapshot& snapshot, const std::pair<std::string, std::string>& key) {
+            auto entry = snapshot.payment_days.find(key);
+            if (entry == snapshot.payment_days.end()) {
+                return;
+            }
+            const std::string day = key.first;
+            const std::string currency = key.second;
+            PaymentDay& bucket = entry->second;
+            Model::Money gross = sources.payments->convertAmount(bucket.gross, currency, snapshot.base_currency, day);
+            Model::Money refunds = sources.payments->convertAmount(bucket.refunds, currency, snapshot.base_currency, day);
+            snapshot.gross += gross - bucket.gross_base;
+            snapshot.refunds += refunds - bucket.refunds_base;
+            snapshot.revenue = snapshot.gross - snapshot.refunds;
+            bucket.gross_base = gross;
+            bucket.refunds_base = refunds;
+            if (bucket.gross.minor == 0 && bucket.refunds.minor == 0) {
+                snapshot.payment_days.erase(entry);
+            }
+
+            // The day's total is re-summed over its currencies' converted buckets
+            Model::Money dayNet;
+            bool dayActive = false;
+            for (auto it = snapshot.payment_days.lower_bound({day, ""});
+                 it != snapshot.payment_days.end() && it->first.first == day; ++it) {
+                dayNet += it->second.gross_base - it->second.refunds_base;
+                dayActive = true;
+            }
+            if (dayActive) {
+                snapshot.daily_revenue[day] = dayNet;
+            } else {
+                snapshot.daily_revenue.erase(day);
+            }
+        }
+
+        /**
+         * @brief Convert one method's bucket at the given date's rate
+         */
+        void convertPaymentMethod(Snapshot& snapshot, const std::pair<std::string, std::string>& key,
+                                  const std::string& date) {
+            auto entry = snapshot.payment_methods.find(key);
+            if (entry == snapshot.payment_methods.end()) {
+                return;
+            }
+            const std::string method = key.first;
+            PaymentMethodTotal& bucket = entry->second;
+            bucket.amount_base = sources.payments->convertAmount(bucket.amount, key.second, snapshot.base_currency, date);
+            if (bucket.amount.minor == 0) {
+                snapshot.payment_methods.erase(entry);
+            }
+
+            Model::Money total;
+            bool active = false;
+            for (auto it = snapshot.payment_methods.lower_bound({method, ""});
+                 it != snapshot.payment_methods.end() && it->first.first == method; ++it) {
+                total += it->second.amount_base;
+                active = true;
+            }
+            if (active) {
+                snapshot.revenue_by_method[method] = total;
+            } else {
+                snapshot.revenue_by_method.erase(method);
+            }
+        }
+
+        void scanAttendees(Snapshot& snapshot) {
+            snapshot.total_attendees = static_cast<int>(sources.attendees->getAllAttendees().size());
+        }
+
+        void scanFeedback(Snapshot& snapshot, const std::string& start_date, const std::string& end_date) {
+            for (const auto& feedback : sources.feedback->getAll()) {
+                if (inRange(feedback->submitted_at.iso8601String, start_date, end_date)) {
+                    applyFeedback(snapshot, *feedback, 1);
+                }
+            }
+        }
+
+        /**
+         * @brief Add feedback to (direction 1) or retract it from (direction -1) the feedback aggregates
+         */
+        static void applyFeedback(Snapshot& snapshot, const Model::Feedback& feedback, int direction) {
+            for (FeedbackCounts* counts : {&snapshot.feedback[feedback.concert_id], &snapshot.all_feedback}) {
+                counts->count += direction;
+                counts->rating_sum += direction * feedback.rating;
+                if (feedback.rating >= 5) {
+                    counts->promoters += direction;
+                } else if (feedback.rating <= 3) {
+                    counts->detractors += direction;
+                }
+            }
+        }
+
+        void scanCrews(Snapshot& snapshot, const std::string& start_date, const std::string& end_date) {
+            for (const auto& crew : sources.crews->getAllCrew()) {
+                if (!crew->check_in_time || !inRange(crew->check_in_time->iso8601String, start_date, end_date)) {
+                    continue;
+                }
+                snapshot.staff++;
+                snapshot.tasks += static_cast<int>(crew->tasks.size());
+                if (crew->check_out_time) {
+                    long long in = toEpochSeconds(crew->check_in_time->iso8601String);
+                    long long out = toEpochSeconds(crew->check_out_time->iso8601String);
+                    if (in >= 0 && out > in) {
+                        snapshot.staff_hours += (out - in) / 3600.0;
+                    }
+                }
+            }
+        }
+
+        /**
+         * @brief Build summary metrics from a snapshot
+         */
+        SummaryMetrics summarize(const Snapshot& snapshot) const {
+            SummaryMetrics metrics = {};
+            metrics.total_concerts = static_cast<int>(snapshot.concerts.size());
+            metrics.active_concerts = snapshot.active_concerts;
+            metrics.completed_concerts = snapshot.completed_concerts;
+            metrics.cancelled_concerts = snapshot.cancelled_concerts;
+            metrics.total_attendees = snapshot.total_attendees;
+            metrics.total_tickets_sold = snapshot.tickets_sold;
+            metrics.total_revenue = snapshot.revenue.toMajor(snapshot.base_currency);
+            metrics.average_ticket_price = averageOf(snapshot.revenue, snapshot.tickets_sold).toMajor(snapshot.base_currency);
+            metrics.overall_satisfaction_score = snapshot.all_feedback.count > 0
+                ? static_cast<double>(snapshot.all_feedback.rating_sum) / snapshot.all_feedback.count : 0.0;
+            metrics.nps_score = calculateNPS(snapshot.all_feedback);
+
+            int top = topSellingConcert(snapshot);
+            metrics.most_popular_concert = top == -1 ? "" : concertName(snapshot, top);
+
+            // Venue whose concerts sold the most tickets
+            std::map<std::string, int> venueSales;
+            for (const auto& counts : snapshot.tickets) {
+                auto concert = snapshot.concerts.find(counts.first);
+                if (concert != snapshot.concerts.end() && !concert->second.venue_name.empty()) {
+                    venueSales[concert->second.venue_name] += counts.second.sold;
+                }
+            }
+            int bestSales = 0;
+            for (const auto& venue : venueSales) {
+                if (venue.second > bestSales) {
+                    bestSales = venue.second;
+                    metrics.top_performing_venue = venue.first;
+                }
+            }
+            return metrics;
+        }
+
+        /**
+         * @brief Build one concert's metrics from a snapshot (top_payment_method is left to the caller)
+         */
+        ConcertMetrics concertMetrics(const Snapshot& snapshot, int concert_id) {
+            static const ConcertRow noConcert;
+            static const TicketCounts noTickets;
+            static const FeedbackCounts noFeedback;
+            auto concertIt = snapshot.concerts.find(concert_id);
+            auto ticketIt = snapshot.tickets.find(concert_id);
+            auto feedbackIt = snapshot.feedback.find(concert_id);
+            const ConcertRow& concert = concertIt != snapshot.concerts.end() ? concertIt->second : noConcert;
+            const TicketCounts& tickets = ticketIt != snapshot.tickets.end() ? ticketIt->second : noTickets;
+            const FeedbackCounts& feedback = feedbackIt != snapshot.feedback.end() ? feedbackIt->second : noFeedback;
+
+            ConcertMetrics metrics = {};
+            metrics.concert_id = concert_id;
+            metrics.concert_name = concertName(snapshot, concert_id);
+            metrics.total_registrations = static_cast<int>(tickets.holders.size());
+            metrics.tickets_sold = tickets.sold;
+            metrics.tickets_available = tickets.available;
+            metrics.sales_volume = tickets.sold * concert.base_price; // List price; payments carry no concert
+            int capacity = concert.capacity > 0 ? concert.capacity : tickets.sold + tickets.available;
+            metrics.capacity_utilization = capacity > 0 ? 100.0 * tickets.sold / capacity : 0.0;
+            metrics.attendee_engagement_score = calculateEngagementScore(tickets, feedback);
+            metrics.nps_score = calculateNPS(feedback);
+            metrics.total_feedback_count = feedback.count;
+            metrics.average_rating = feedback.count > 0 ? static_cast<double>(feedback.rating_sum) / feedback.count : 0.0;
+            metrics.last_updated = Model::DateTime::now();
+            return metrics;
+        }
+
+        /**
+         * @brief Most used payment method among a set of attendees (indexed lookups, no scan)
+         */
+        std::string topPaymentMethod(const std::unordered_map<int, int>& holders) {
+            if (!sources.payments) {
+                return "";
+            }
+            std::map<std::string, int> methods;
+            for (const auto& holder : holders) {
+                for (const auto& payment : sources.payments->getPaymentsByAttendee(holder.first)) {
+                    if (payment->amount.minor > 0 && payment->status != Model::PaymentStatus::FAILED) {
+                        methods[payment->payment_method]++;
+                    }
+                }
+            }
+            std::string top;
+            int best = 0;
+            for (const auto& method : methods) {
+                if (method.second > best) {
+                    best = method.second;
+                    top = method.first;
+                }
+            }
+            return top;
+        }
+
+        /**
+         * @brief Format a sales report from collected aggregates (reads no module state)
+         */
+        static std::string renderSalesAnalyticsReport(const Snapshot& snapshot, const std::string& start_date,
+                                                      const std::string& end_date, const std::string& format) {
+            const std::string& base = snapshot.base_currency;
+
+            std::ostringstream report;
+            report << std::fixed << std::setprecision(2);
+            report << "Sales Analytics Report\n";
+            report << "Period: " << numericDate(start_date) << " to " << numericDate(end_date) << "\n";
+            report << "Format: " << format << "\n\n";
+            
+            report << "Total Sales: " << snapshot.revenue.toString(base) << " " << base << "\n";
+            report << "Number of Transactions: " << snapshot.transactions << "\n";
+            report << "Average Transaction Value: "
+                   << averageOf(snapshot.gross, snapshot.transactions).toString(base) << " " << base << "\n";
+            report << "Refunds Issued: " << snapshot.refunds.toString(base) << " " << base << "\n";
+            report << "Tickets Sold: " << snapshot.tickets_sold << "\n";
+            int topConcert = topSellingConcert(snapshot);
+            report << "Top Selling Concert: "
+                   << (topConcert == -1 ? "None" : concertName(snapshot, topConcert) + " (" +
+                       std::to_string(snapshot.tickets.at(topConcert).sold) + " tickets)") << "\n";
+            for (const auto& currency : snapshot.revenue_by_currency) {
+                report << "Sales in " << currency.first << ": " << currency.second.toString(currency.first) << "\n";
+            }
+            return formatReportOutput(report.str(), format);
+        }
+
+        /**
+         * @brief Format a payroll report from collected aggregates (reads no module state)
+         */
+        static std::string renderPayrollReport(const Snapshot& snapshot, const std::string& start_date,
+                                               const std::string& end_date, const std::string& format,
+                                               double hourly_rate) {
+            double payroll = snapshot.staff_hours * hourly_rate;
+
+            std::ostringstream report;
+            report << std::fixed << std::setprecision(2);
+            report << "Payroll Report\n";
+            report << "Period: " << numericDate(start_date) << " to " << numericDate(end_date) << "\n\n";
+            
+            report << "Total Payroll: $" << payroll << "\n";
+            report << "Number of Staff: " << snapshot.staff << "\n";
+            report << "Hours Worked: " << snapshot.staff_hours << " at $" << hourly_rate << "/hour\n";
+            report << "Average Pay: $" << (snapshot.staff > 0 ? payroll / snapshot.staff : 0.0) << "\n";
+            report << "Tasks Assigned: " << snapshot.tasks << "\n";
+            return formatReportOutput(report.str(), format);
+        }
+
+        /**
+         * @brief Financial summary of collected payment and crew aggregates
+         */
+        static FinancialSummary summarizeFinances(const Snapshot& snapshot) {
+            FinancialSummary summary = {};
+            summary.base_currency = snapshot.base_currency;
+            summary.total_revenue = snapshot.gross;
+            summary.refunds_issued = snapshot.refunds;
+            summary.total_transactions = snapshot.transactions;
+            summary.average_transaction_value = averageOf(snapshot.gross, snapshot.transactions);
+            summary.revenue_by_currency = snapshot.revenue_by_currency;
+            summary.revenue_by_payment_method = snapshot.revenue_by_method;
+            
+            // Only staff hours are recorded; venue, performer, marketing and
+            // processing costs have no source yet and stay at zero
+            summary.staff_costs = Model::Money::fromMajor(snapshot.staff_hours * DEFAULT_HOURLY_RATE, summary.base_currency);
+            summary.operating_expenses = summary.venue_costs + summary.performer_fees + summary.marketing_costs +
+                                         summary.staff_costs + summary.payment_processing_fees;
+            summary.gross_profit = summary.total_revenue - summary.refunds_issued;
+            summary.net_profit = summary.gross_profit - summary.operating_expenses;
+            return summary;
+        }
+
+        /**
+         * @brief Format a P&L statement from a financial summary (reads no module state)
+         */
+        static std::string renderProfitLossStatement(const FinancialSummary& summary, const std::string& start_date,
+                                                     const std::string& end_date, const std::string& format) {
+            const std::string& base = summary.base_currency;
+            
+            std::ostringstream pnl;
+            pnl << "PROFIT & LOSS STATEMENT\n";
+            pnl << "Period: " << numericDate(start_date) << " to " << numericDate(end_date) << "\n\n";
+            pnl << "REVENUE\n";
+            pnl << "Total Revenue: $" << summary.total_revenue.toString(base) << "\n\n";
+            pnl << "EXPENSES\n";
+            pnl << "Venue Costs: $" << summary.venue_costs.toString(base) << "\n";
+            pnl << "Performer Fees: $" << summary.performer_fees.toString(base) << "\n";
+            pnl << "Marketing Costs: $" << summary.marketing_costs.toString(base) << "\n";
+            pnl << "Staff Costs: $" << summary.staff_costs.toString(base) << "\n";
+            pnl << "Payment Processing: $" << summary.payment_processing_fees.toString(base) << "\n";
+            pnl << "Refunds Issued: $" << summary.refunds_issued.toString(base) << "\n";
+            pnl << "Total Expenses: $" << (summary.operating_expenses + summary.refunds_issued).toString(base) << "\n\n";
+            pnl << "NET PROFIT: $" << summary.net_profit.toString(base) << "\n";
+            return formatReportOutput(pnl.str(), format);
+        }
+
+        /**
+         * @brief Concert with the most tickets sold in the snapshot
+         * @return Concert ID, or -1 if nothing sold
+         */
+        static int topSellingConcert(const Snapshot& snapshot) {
+            int top = -1, best = 0;
+            for (const auto& counts : snapshot.tickets) {
+                if (counts.first > 0 && counts.second.sold > best) {
+                    best = counts.second.sold;
+                    top = counts.first;
+                }
+            }
+            return top;
+        }
+
+        static std::string concertName(const Snapshot& snapshot, int concert_id) {
+            auto concert = snapshot.concerts.find(concert_id);
+            return concert != snapshot.concerts.end() ? concert->second.name : "Concert #" + std::to_string(concert_id);
+        }
+
+        /**
+         * @brief Check a timestamp against bounds given as dates or full timestamps
+         *
+         * The timestamp is cut to each bound's length first, so an end date of
+         * "2024-01-31" includes the whole of that day.
+         */
+        static bool inRange(const std::string& timestamp, const std::string& start_date, const std::string& end_date) {
+            return (start_date.empty() || timestamp.compare(0, start_date.size(), start_date) >= 0) &&
+                   (end_date.empty() || timestamp.compare(0, end_date.size(), end_date) <= 0);
+        }
+
+        /**
+         * @brief Day numbers of an inclusive date range
+         * @return false if either bound is not an ISO 8601 date or timestamp
+         */
+        static bool dayRange(const std::string& start_date, const std::string& end_date,
+                             int64_t& first_day, int64_t& last_day) {
+            int64_t start = TimeBuckets::parseIso8601(start_date);
+            int64_t end = TimeBuckets::parseIso8601(end_date);
+            if (start == TimeBuckets::INVALID || end == TimeBuckets::INVALID) {
+                return false;
+            }
+            first_day = TimeBuckets::dayOf(start);
+            last_day = TimeBuckets::dayOf(end);
+            return true;
+        }
+
+        /**
+         * @brief Seconds since 1970-01-01 for an ISO 8601 timestamp, or -1 if malformed
+         */
+        static long long toEpochSeconds(const std::string& iso) {
+            int64_t seconds = TimeBuckets::parseIso8601(iso);
+            return seconds == TimeBuckets::INVALID ? -1 : static_cast<long long>(seconds);
+        }
+
+        /**
+         * @brief Store a report's compute time
+         */
+        void recordTiming(const std::string& report, ReportTiming timing,
+                          std::chrono::steady_clock::time_point started) {
+            timing.total_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+            timing.computed_at = Model::DateTime::now();
+            std::lock_guard<std::mutex> lock(timingMutex);
+            reportTimings[report] = timing;
+        }
+
+        /**
+         * @brief Calculate engagement score from ticket and feedback counts
+         *
+         * Up to 7 points for the share of sold tickets checked in and up to 3
+         * for the share of sales that left feedback.
+         *
+         * @return Engagement score (0.0 to 10.0)
+         */
+        static double calculateEngagementScore(const TicketCounts& tickets, const FeedbackCounts& feedback) {
+            if (tickets.sold == 0) {
+                return 0.0;
+            }
+            double checkInRate = static_cast<double>(tickets.checked_in) / tickets.sold;
+            double responseRate = std::min(1.0, static_cast<double>(feedback.count) / tickets.sold);
+            return 7.0 * checkInRate + 3.0 * responseRate;
+        }
+
+        /**
+         * @brief Net Promoter Score from 1-5 ratings (5 promotes, 3 or lower detracts)
+         * @return NPS score (-100 to +100)
+         */
+        static double calculateNPS(const FeedbackCounts& feedback) {
+            if (feedback.count == 0) return 0.0;
+            return static_cast<double>(feedback.promoters - feedback.detractors) / feedback.count * 100.0;
+        }
+
+        /**
+         * @brief Mean of a total over a count, rounded half away from zero to the minor unit
+         * @return Zero when the count is not positive
+         */
+        static Model::Money averageOf(Model::Money total, int count) {
+            if (count <= 0) return Model::Money{};
+            int64_t half = total.minor < 0 ? -(count / 2) : count / 2;
+            return Model::Money{(total.minor + half) / count};
+        }
+
+        /**
+         * @brief Collect a scheduled report's aggregates and return the step that formats them
+         *
+         * Runs on the thread that owns the attached modules. The returned
+         * step only reads its own copy of the aggregates (or the payment
+         * module, which locks itself), so the scheduler runs it on its worker.
+         *
+         * @return Render step, or an empty function if the report cannot run
+         */
+        ReportScheduling::ReportScheduler::Render captureScheduledReport(const ReportScheduling::ScheduledReport& schedule,
+                                                                         const std::string& start_date,
+                                                                         const std::string& end_date) {
+            if (!validateDateRange(start_date, end_date)) {
+                return {};
+            }
+            std::function<std::string()> body;
+            ReportTiming timing;
+            if (schedule.report_type == "sales") {
+                auto snapshot = std::make_shared<Snapshot>(
+                    collectSnapshot(start_date, end_date, SCAN_CONCERTS | SCAN_TICKETS | SCAN_PAYMENTS, timing));
+                body = [snapshot, start_date, end_date]() {
+                    return renderSalesAnalyticsReport(*snapshot, start_date, end_date, "TEXT");
+                };
+            } else if (schedule.report_type == "payroll") {
+                auto snapshot = std::make_shared<Snapshot>(collectSnapshot(start_date, end_date, SCAN_CREWS, timing));
+                body = [snapshot, start_date, end_date]() {
+                    return renderPayrollReport(*snapshot, start_date, end_date, "TEXT", DEFAULT_HOURLY_RATE);
+                };
+            } else if (schedule.report_type == "profit_loss") {
+                FinancialSummary summary = generateFinancialSummary(start_date, end_date);
+                body = [summary, start_date, end_date]() {
+                    return renderProfitLossStatement(summary, start_date, end_date, "TEXT");
+                };
+            } else if (schedule.report_type == "payment" && sources.payments) {
+                PaymentManager::PaymentModule* payments = sources.payments;
+                body = [payments, start_date, end_date]() { return payments->generatePaymentReport(start_date, end_date); };
+            }
+            if (!body) {
+                return {};
+            }
+            
+            return [schedule, start_date, end_date, body]() -> std::string {
+                std::string text = body();
+                if (text.empty()) {
+                    return "";
+                }
+                std::ostringstream report;
+                report << "Scheduled Report " << schedule.id << " (" << schedule.report_type << ", " << schedule.frequency << ")\n";
+                report << "Period: " << start_date << " to " << end_date << "\n";
+                if (!schedule.recipients.empty()) {
+                    report << "Recipients: ";
+                    for (size_t i = 0; i < schedule.recipients.size(); ++i) {
+                        report << (i > 0 ? ", " : "") << schedule.recipients[i];
+                    }
+                    report << "\n";
+                }
+                report << "\n" << text << "\n";
+                return report.str();
+            };
+        }
+
+        static const std::vector<std::string>& exportColumns(const std::string& dataset) {
+            static const std::vector<std::string> concerts = {"concert_id", "name", "start_date_time", "end_date_time",
+                                                              "status", "base_price", "quantity_available", "quantity_sold"};
+            static const std::vector<std::string> tickets = {"ticket_id", "concert_id", "attendee_id", "status",
+                                                             "created_at", "updated_at"};
+            static const std::vector<std::string> payments = {"payment_id", "attendee_id", "amount", "currency",
+                                                              "payment_method", "transaction_id", "status", "payment_date_time"};
+            return dataset == "concerts" ? concerts : dataset == "tickets" ? tickets : payments;
+        }
+
+        bool canExport(const std::string& dataset, const std::string& format) const {
+            if (format != "CSV" && format != "JSON") {
+                return false;
+            }
+            return (dataset == "concerts" && sources.concerts) || (dataset == "tickets" && sources.tickets) ||
+                   (dataset == "payments" && sources.payments);
+        }
+
+        long long exportDataset(const std::string& dataset, const std::string& format, ReportExport::OutputBuffer& out) {
+            std::unique_ptr<ReportExport::RowWriter> writer;
+            if (format == "CSV") {
+                writer = std::make_unique<ReportExport::CsvWriter>(out, exportColumns(dataset));
+            } else {
+                writer = std::make_unique<ReportExport::JsonWriter>(out, exportColumns(dataset));
+            }
+            ReportExport::RowWriter& rows = *writer;
+            
+            if (dataset == "concerts") {
+                for (const auto& concert : sources.concerts->getAllConcerts()) {
+                    rows.beginRow();
+                    rows.integer(concert->id);
+                    rows.text(concert->name);
+                    rows.text(concert->start_date_time.iso8601String);
+                    rows.text(concert->end_date_time.iso8601String);
+                    rows.text(ReportExport::eventStatusName(concert->event_status));
+                    rows.number(concert->ticketInfo ? concert->ticketInfo->base_price : 0.0);
+                    rows.integer(concert->ticketInfo ? concert->ticketInfo->quantity_available : 0);
+                    rows.integer(concert->ticketInfo ? concert->ticketInfo->quantity_sold : 0);
+                    rows.endRow();
+                }
+            } else if (dataset == "tickets") {
+                for (const auto& ticket : sources.tickets->getAll()) {
+                    rows.beginRow();
+                    rows.integer(ticket->ticket_id);
+                    rows.integer(TicketManager::TicketModule::extractConcertId(ticket->qr_code));
+                    rows.integer(TicketManager::TicketModule::extractAttendeeId(ticket->qr_code));
+                    rows.text(ReportExport::ticketStatusName(ticket->status));
+                    rows.text(ticket->created_at.iso8601String);
+                    rows.text(ticket->updated_at.iso8601String);
+                    rows.endRow();
+                }
+            } else {
+                sources.payments->visitPayments([&rows](const Model::Payment& payment) {
+                    rows.beginRow();
+                    rows.integer(payment.payment_id);
+                    rows.integer(payment.attendee_id);
+                    rows.money(payment.amount, payment.currency);
+                    rows.text(payment.currency);
+                    rows.text(payment.payment_method);
+                    rows.text(payment.transaction_id);
+                    rows.text(ReportExport::paymentStatusName(payment.status));
+                    rows.text(payment.payment_date_time.iso8601String);
+                    rows.endRow();
+                });
+            }
+            
+            if (!rows.finish()) {
+                return -1;
+            }
+            return static_cast<long long>(rows.rowCount());
         }
 
         /**
@@ -654,11 +2351,13 @@ namespace ReportManager {
          * @param format Output format
          * @return Formatted report string
          */
-        std::string formatReportOutput(const std::string& data, const std::string& format) {
+        static std::string formatReportOutput(const std::string& data, const std::string& format) {
             if (format == "HTML") {
                 return generateHTMLReport("Report", data);
             } else if (format == "JSON") {
-                return "{\"report\": \"" + data + "\"}";
+                std::string json = "{\"report\": ";
+                ReportExport::appendJsonString(json, data);
+                return json + "}";
             } else if (format == "CSV") {
                 // Convert to CSV format (simplified)
                 std::string csv = data;
@@ -684,7 +2383,7 @@ namespace ReportManager {
          * @param content Report content
          * @return HTML formatted report
          */
-        std::string generateHTMLReport(const std::string& title, const std::string& content) {
+        static std::string generateHTMLReport(const std::string& title, const std::string& content) {
             std::ostringstream html;
             html << "<!DOCTYPE html><html><head><title>" << title << "</title></head>";
             html << "<body><h1>" << title << "</h1><pre>" << content << "</pre></body></html>";
@@ -0,0 +1,599 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <map>
+#include <queue>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <ctime>
+#include <cstdio>
+#include <cstdint>
+#include <bitset>
+#include <cctype>
+#include <iostream>
+#include "workerPool.hpp"
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+namespace ReportScheduling {
+
+    /**
+     * @brief Format a time the way Model::DateTime::now() does (local time)
+     */
+    inline std::string formatLocalTime(std::time_t when) {
+        std::tm local;
+        #ifdef _WIN32
+            localtime_s(&local, &when);
+        #else
+            localtime_r(&when, &local);
+        #endif
+        char buffer[30];
+        std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%SZ", &local);
+        return buffer;
+    }
+
+    /**
+     * @brief Five-field cron expression: minute hour day-of-month month day-of-week
+     *
+     * Each field accepts "*", numbers, ranges ("1-5"), lists ("1,15") and
+     * steps ("0-30/10", or "*" followed by "/15"). Day of week is 0-7 with
+     * both 0 and 7 for Sunday. As in cron, when both day fields are
+     * restricted a day matches if either does. The aliases hourly, daily,
+     * weekly and monthly are accepted. Times are local.
+     */
+    class CronExpression {
+    public:
+        /**
+         * @brief Parse an expression or alias
+         * @return false if the expression is malformed
+         */
+        static bool parse(const std::string& text, CronExpression& cron) {
+            std::string expression = text;
+            if (text == "hourly") expression = "0 * * * *";
+            else if (text == "daily") expression = "0 0 * * *";
+            else if (text == "weekly") expression = "0 0 * * 0";
+            else if (text == "monthly") expression = "0 0 1 * *";
+
+            std::istringstream fields(expression);
+            std::string minute, hour, dayOfMonth, month, dayOfWeek, extra;
+            if (!(fields >> minute >> hour >> dayOfMonth >> month >> dayOfWeek) || (fields >> extra)) {
+                return false;
+            }
+            CronExpression parsed;
+            std::bitset<64> days, weekdays;
+            if (!parseField(minute, 0, 59, parsed.minutes) || !parseField(hour, 0, 23, parsed.hours) ||
+                !parseField(dayOfMonth, 1, 31, days) || !parseField(month, 1, 12, parsed.months) ||
+                !parseField(dayOfWeek, 0, 7, weekdays)) {
+                return false;
+            }
+            if (weekdays[7]) {
+                weekdays[0] = true;
+            }
+            parsed.daysOfMonth = days;
+            parsed.daysOfWeek = weekdays;
+            parsed.anyDayOfMonth = dayOfMonth == "*";
+            parsed.anyDayOfWeek = dayOfWeek == "*";
+            parsed.text = text;
+            cron = parsed;
+            return true;
+        }
+
+        /**
+         * @brief First matching minute strictly after a time
+         * @return Time of the next run, or -1 if none within five years
+         */
+        std::time_t next(std::time_t after) const {
+            std::tm local;
+            #ifdef _WIN32
+                localtime_s(&local, &after);
+            #else
+                localtime_r(&after, &local);
+            #endif
+            local.tm_sec = 0;
+            local.tm_min += 1;
+            local.tm_isdst = -1;
+            std::time_t candidate = std::mktime(&local);
+            std::time_t limit = after + 5LL * 366 * 24 * 3600;
+
+            // Skip whole months, days and hours at a time until every field matches
+            while (candidate != -1 && candidate <= limit) {
+                #ifdef _WIN32
+                    localtime_s(&local, &candidate);
+                #else
+                    localtime_r(&candidate, &local);
+                #endif
+                local.tm_isdst = -1;
+                if (!months[local.tm_mon + 1]) {
+                    local.tm_mon += 1;
+                    local.tm_mday = 1;
+                    local.tm_hour = 0;
+                    local.tm_min = 0;
+                } else if (!dayMatches(local)) {
+                    local.tm_mday += 1;
+                    local.tm_hour = 0;
+                    local.tm_min = 0;
+                } else if (!hours[local.tm_hour]) {
+                    local.tm_hour += 1;
+                    local.tm_min = 0;
+                } else if (!minutes[local.tm_min]) {
+                    local.tm_min += 1;
+                } else {
+                    return candidate;
+                }
+                std::time_t advanced = std::mktime(&local);
+                // Around a DST change mktime can land on or before the old candidate
+                candidate = advanced > candidate ? advanced : candidate + 60;
+            }
+            return -1;
+        }
+
+        const std::string& getText() const { return text; }
+
+    private:
+        std::bitset<64> minutes, hours, daysOfMonth, months, daysOfWeek;
+        bool anyDayOfMonth = true;
+        bool anyDayOfWeek = true;
+        std::string text;
+
+        bool dayMatches(const std::tm& local) const {
+            bool dom = daysOfMonth[local.tm_mday];
+            bool dow = daysOfWeek[local.tm_wday];
+            if (anyDayOfMonth) return dow;
+            if (anyDayOfWeek) return dom;
+            return dom || dow;
+        }
+
+        static bool parseNumber(const std::string& text, int& value) {
+            if (text.empty() || text.size() > 2 || !std::all_of(text.begin(), text.end(), ::isdigit)) {
+                return false;
+            }
+            value = std::stoi(text);
+            return true;
+        }
+
+        static bool parseField(const std::string& field, int low, int high, std::bitset<64>& bits) {
+            std::stringstream items(field);
+            std::string item;
+            while (std::getline(items, item, ',')) {
+                int step = 1;
+                size_t slash = item.find('/');
+                if (slash != std::string::npos) {
+                    if (!parseNumber(item.substr(slash + 1), step) || step == 0) {
+                        return false;
+                    }
+                    item = item.substr(0, slash);
+                }
+                int first = low, last = high;
+                size_t dash = item.find('-');
+                if (item == "*") {
+                    // Full range
+                } else if (dash != std::string::npos) {
+                    if (!parseNumber(item.substr(0, dash), first) || !parseNumber(item.substr(dash + 1), last)) {
+                        return false;
+                    }
+                } else {
+                    if (!parseNumber(item, first)) {
+                        return false;
+                    }
+                    last = slash == std::string::npos ? first : high;
+                }
+                if (first < low || last > high || first > last) {
+                    return false;
+                }
+                for (int value = first; value <= last; value += step) {
+                    bits[value] = true;
+                }
+            }
+            return bits.any();
+        }
+    };
+
+    /**
+     * @brief One recurring report
+     */
+    struct ScheduledReport {
+        std::string id;
+        std::string report_type;
+        std::string frequency;          // Cron expression or alias as given
+        std::vector<std::string> recipients;
+        int64_t created = 0;            // Epoch seconds
+        int64_t next_run = -1;          // -1 if the expression never matches again
+        int64_t last_run = 0;           // 0 before the first run
+        uint32_t runs = 0;
+        uint32_t failures = 0;
+        uint32_t coalesced = 0;         // Occurrences skipped because a run was still going
+        std::string last_output;        // Path of the last report written
+        bool running = false;           // Not persisted
+    };
+
+    /**
+     * @brief Runs recurring reports in two steps: capture on the owner, render on a worker
+     *
+     * Next-run times sit in a min-heap. The thread that owns the report data
+     * calls runDue() from its own loop; for every schedule whose time has
+     * come, the runner is called there to copy out what the report needs
+     * while nothing else is changing the data. The render step it returns
+     * runs on a background worker, which also writes the output file, so the
+     * owner only pays for the capture. An occurrence that comes due while the
+     * same schedule is still rendering is coalesced into that run, as are
+     * occurrences missed between two calls or while the program was down.
+     * Schedules are saved to a binary file after every change and reloaded
+     * on construction.
+     *
+     * The runner receives the schedule and the period since its previous run
+     * and returns the render step (empty on failure); the render step returns
+     * the report text ("" on failure). start, stop and runDue belong to the
+     * owning thread.
+     */
+    class ReportScheduler {
+    public:
+        using Render = std::function<std::string()>;
+        using Runner = std::function<Render(const ScheduledReport&, const std::string& period_start,
+                                            const std::string& period_end)>;
+
+        explicit ReportScheduler(const std::string& filePath) : filePath(filePath) {
+            loadSchedules();
+        }
+
+        ~ReportScheduler() {
+            stop();
+        }
+
+        ReportScheduler(const ReportScheduler&) = delete;
+        ReportScheduler& operator=(const ReportScheduler&) = delete;
+
+        /**
+         * @brief Start watching the schedules and the render worker; runs start in runDue()
+         * @param reportRunner Captures a run's inputs and returns its render step
+         * @param directory Directory the reports are written to (created if missing)
+         * @return false if already started
+         */
+        bool start(Runner reportRunner, const std::string& directory) {
+            std::lock_guard<std::mutex> lock(scheduleMutex);
+            if (started) {
+                return false;
+            }
+            runner = std::move(reportRunner);
+            outputDirectory = directory;
+            #ifdef _WIN32
+                _mkdir(outputDirectory.c_str());
+            #else
+                mkdir(outputDirectory.c_str(), 0755);
+            #endif
+            started = true;
+            pool = std::make_unique<WorkerPool>(1);
+            for (const auto& entry : schedules) {
+                pushScheduled(entry.second);
+            }
+            return true;
+        }
+
+        /**
+         * @brief Stop watching; queued runs are dropped, renders in progress finish
+         */
+        void stop() {
+            {
+                std::lock_guard<std::mutex> lock(scheduleMutex);
+                if (!started) {
+                    return;
+                }
+                started = false;
+                heap = {};
+            }
+            pool.reset(); // Drains and joins the worker
+        }
+
+        /**
+         * @brief Add a recurring report
+         * @param report_type Report to run (interpreted by the runner)
+         * @param frequency Cron expression or hourly/daily/weekly/monthly
+         * @param recipients Recipients recorded with the report
+         * @return Schedule ID, or "" if the frequency is invalid
+         */
+        std::string schedule(const std::string& report_type, const std::string& frequency,
+                             const std::vector<std::string>& recipients) {
+            CronExpression cron;
+            if (report_type.empty() || !CronExpression::parse(frequency, cron)) {
+                return "";
+            }
+            std::lock_guard<std::mutex> lock(scheduleMutex);
+            Entry entry;
+            entry.cron = cron;
+            entry.info.id = "SCH-" + std::to_string(++lastId);
+            entry.info.report_type = report_type;
+            entry.info.frequency = frequency;
+            entry.info.recipients = recipients;
+            entry.info.created = static_cast<int64_t>(std::time(nullptr));
+            entry.info.next_run = cron.next(static_cast<std::time_t>(entry.info.created));
+            auto& stored = schedules[entry.info.id] = entry;
+            if (started) {
+                pushScheduled(stored);
+            }
+            saveSchedules();
+            return stored.info.id;
+        }
+
+        /**
+         * @brief Remove a schedule; a render in progress still completes
+         * @return false if the ID is unknown
+         */
+        bool cancel(const std::string& id) {
+            std::lock_guard<std::mutex> lock(scheduleMutex);
+            if (schedules.erase(id) == 0) {
+                return false;
+            }
+            saveSchedules();
+            return true;
+        }
+
+        /**
+         * @brief Queue a run outside the recurrence for the next runDue()
+         * @return false if the ID is unknown or the scheduler is not started
+         */
+        bool runNow(const std::string& id) {
+            std::lock_guard<std::mutex> lock(scheduleMutex);
+            auto it = schedules.find(id);
+            if (it == schedules.end() || !started) {
+                return false;
+            }
+            heap.push({static_cast<int64_t>(std::time(nullptr)), id, it->second.generation, true});
+            return true;
+        }
+
+        /**
+         * @brief Capture every schedule that is due and hand its render step to the worker
+         * @return Number of runs started
+         */
+        size_t runDue() {
+            std::vector<ScheduledReport> due;
+            bool changed = false;
+            int64_t now = static_cast<int64_t>(std::time(nullptr));
+            {
+                std::lock_guard<std::mutex> lock(scheduleMutex);
+                if (!started) {
+                    return 0;
+                }
+                while (!heap.empty() && heap.top().when <= now) {
+                    Due next = heap.top();
+                    heap.pop();
+                    auto it = schedules.find(next.id);
+                    if (it == schedules.end() || (!next.manual && next.generation != it->second.generation)) {
+                        continue;
+                    }
+                    changed = true;
+                    Entry& entry = it->second;
+                    if (!next.manual) {
+                        // Later occurrences that were already missed collapse into this run
+                        ++entry.generation;
+                        entry.info.next_run = entry.cron.next(static_cast<std::time_t>(std::max(now, next.when)));
+                        pushScheduled(entry);
+                    }
+                    if (entry.info.running) {
+                        ++entry.info.coalesced;
+                        continue;
+                    }
+                    entry.info.running = true;
+                    ++activeRuns;
+                    due.push_back(entry.info);
+                }
+                if (changed) {
+                    saveSchedules();
+                }
+            }
+            for (const auto& report : due) {
+                std::string period_start = formatLocalTime(static_cast<std::time_t>(report.last_run > 0 ? report.last_run : report.created));
+                std::string period_end = formatLocalTime(static_cast<std::time_t>(now));
+                Render render;
+                try {
+                    render = runner(report, period_start, period_end);
+                } catch (const std::exception& e) {
+                    #ifdef DEBUG
+                    std::cout << "[REPORT SCHEDULER] " << report.id << " capture threw: " << e.what() << std::endl;
+                    #endif
+                }
+                if (!render) {
+                    finish(report, now, "", period_end);
+                    continue;
+                }
+                pool->submit([this, report, now, period_end, render]() {
+                    std::string content;
+                    try {
+                        content = render();
+                    } catch (const std::exception& e) {
+                        #ifdef DEBUG
+                        std::cout << "[REPORT SCHEDULER] " << report.id << " threw: " << e.what() << std::endl;
+                        #endif
+                    }
+                    finish(report, now, content, period_end);
+                });
+            }
+            return due.size();
+        }
+
+        /**
+         * @brief Wait until no started run is still rendering
+         * @return false on timeout
+         */
+        bool waitUntilIdle(std::chrono::milliseconds timeout) {
+            std::unique_lock<std::mutex> lock(scheduleMutex);
+            return idle.wait_for(lock, timeout, [this]() { return activeRuns == 0; });
+        }
+
+        std::vector<ScheduledReport> getSchedules() const {
+            std::lock_guard<std::mutex> lock(scheduleMutex);
+            std::vector<ScheduledReport> result;
+            for (const auto& entry : schedules) {
+                result.push_back(entry.second.info);
+            }
+            return result;
+        }
+
+        bool isRunning() const {
+            std::lock_guard<std::mutex> lock(scheduleMutex);
+            return started;
+        }
+
+    private:
+        struct Entry {
+            ScheduledReport info;
+            CronExpression cron;
+            uint64_t generation = 0; // Bumped whenever next_run is replaced
+        };
+
+        struct Due {
+            int64_t when;
+            std::string id;
+            uint64_t generation;
+            bool manual;
+            bool operator>(const Due& other) const { return when > other.when; }
+        };
+
+        std::string filePath;
+        std::string outputDirectory;
+        Runner runner;
+        std::map<std::string, Entry> schedules;
+        std::priority_queue<Due, std::vector<Due>, std::greater<Due>> heap;
+        unsigned long lastId = 0;
+        size_t activeRuns = 0;
+        bool started = false;
+        mutable std::mutex scheduleMutex;
+        std::condition_variable idle;
+        std::unique_ptr<WorkerPool> pool;
+
+        void pushScheduled(const Entry& entry) {
+            if (entry.info.next_run >= 0) {
+                heap.push({entry.info.next_run, entry.info.id, entry.generation, false});
+            }
+        }
+
+        /**
+         * @brief Write a run's report and record its outcome (worker, or owner on capture failure)
+         */
+        void finish(const ScheduledReport& report, int64_t now, const std::string& content,
+                    const std::string& period_end) {
+            std::string path;
+            if (!content.empty()) {
+                std::string stamp = period_end;
+                std::replace(stamp.begin(), stamp.end(), ':', '-');
+                path = outputDirectory + "/" + report.report_type + "_" + report.id + "_" + stamp + ".txt";
+                std::ofstream file(path, std::ios::binary | std::ios::trunc);
+                file << content;
+                if (!file.good()) {
+                    path.clear();
+                }
+            }
+
+            std::lock_guard<std::mutex> lock(scheduleMutex);
+            auto it = schedules.find(report.id);
+            if (it != schedules.end()) {
+                ScheduledReport& info = it->second.info;
+                info.running = false;
+                info.last_run = now;
+                if (path.empty()) {
+                    ++info.failures;
+                } else {
+                    ++info.runs;
+                    info.last_output = path;
+                }
+                saveSchedules();
+            }
+            --activeRuns;
+            idle.notify_all();
+            #ifdef DEBUG
+            std::cout << "[REPORT SCHEDULER] " << report.id << " " << report.report_type
+                      << (path.empty() ? " failed" : " -> " + path) << std::endl;
+            #endif
+        }
+
+        static void writeString(std::ofstream& file, const std::string& value) {
+            size_t len = value.size();
+            file.write(reinterpret_cast<const char*>(&len), sizeof(len));
+            file.write(value.data(), len);
+        }
+
+        static bool readString(std::ifstream& file, std::string& value) {
+            size_t len = 0;
+            if (!file.read(reinterpret_cast<char*>(&len), sizeof(len)) || len > (1u << 20)) {
+                return false;
+            }
+            value.resize(len);
+            return len == 0 || static_cast<bool>(file.read(&value[0], len));
+        }
+
+        void saveSchedules() const {
+            std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+            if (!file.is_open()) {
+                return;
+            }
+            size_t count = schedules.size();
+            file.write(reinterpret_cast<const char*>(&lastId), sizeof(lastId));
+            file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+            for (const auto& pair : schedules) {
+                const ScheduledReport& info = pair.second.info;
+                writeString(file, info.id);
+                writeString(file, info.report_type);
+                writeString(file, info.frequency);
+                size_t recipients = info.recipients.size();
+                file.write(reinterpret_cast<const char*>(&recipients), sizeof(recipients));
+                for (const auto& recipient : info.recipients) {
+                    writeString(file, recipient);
+                }
+                file.write(reinterpret_cast<const char*>(&info.created), sizeof(info.created));
+                file.write(reinterpret_cast<const char*>(&info.next_run), sizeof(info.next_run));
+                file.write(reinterpret_cast<const char*>(&info.last_run), sizeof(info.last_run));
+                file.write(reinterpret_cast<const char*>(&info.runs), sizeof(info.runs));
+                file.write(reinterpret_cast<const char*>(&info.failures), sizeof(info.failures));
+                file.write(reinterpret_cast<const char*>(&info.coalesced), sizeof(info.coalesced));
+                writeString(file, info.last_output);
+            }
+        }
+
+        void loadSchedules() {
+            std::ifstream file(filePath, std::ios::binary);
+            if (!file.is_open()) {
+                return;
+            }
+            size_t count = 0;
+            if (!file.read(reinterpret_cast<char*>(&lastId), sizeof(lastId)) ||
+                !file.read(reinterpret_cast<char*>(&count), sizeof(count))) {
+                lastId = 0;
+                return;
+            }
+            for (size_t i = 0; i < count; ++i) {
+                Entry entry;
+                ScheduledReport& info = entry.info;
+                size_t recipients = 0;
+                if (!readString(file, info.id) || !readString(file, info.report_type) || !readString(file, info.frequency) ||
+                    !file.read(reinterpret_cast<char*>(&recipients), sizeof(recipients)) || recipients > 4096) {
+                    break;
+                }
+                info.recipients.resize(recipients);
+                bool ok = true;
+                for (auto& recipient : info.recipients) {
+                    ok = ok && readString(file, recipient);
+                }
+                ok = ok && file.read(reinterpret_cast<char*>(&info.created), sizeof(info.created)) &&
+                     file.read(reinterpret_cast<char*>(&info.next_run), sizeof(info.next_run)) &&
+                     file.read(reinterpret_cast<char*>(&info.last_run), sizeof(info.last_run)) &&
+                     file.read(reinterpret_cast<char*>(&info.runs), sizeof(info.runs)) &&
+                     file.read(reinterpret_cast<char*>(&info.failures), sizeof(info.failures)) &&
+                     file.read(reinterpret_cast<char*>(&info.coalesced), sizeof(info.coalesced)) &&
+                     readString(file, info.last_output);
+                if (!ok || !CronExpression::parse(info.frequency, entry.cron)) {
+                    break;
+                }
+                schedules[info.id] = entry;
+            }
+        }
+    };
+}
@@ -0,0 +1,275 @@
+#pragma once
+#include <vector>
+#include <map>
+#include <cmath>
+#include <algorithm>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+
+namespace Sketches {
+
+    /**
+     * @brief Mix an integer key into 64 well-distributed bits (splitmix64 finalizer)
+     */
+    inline uint64_t mix64(uint64_t value) {
+        value += 0x9E3779B97F4A7C15ULL;
+        value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+        return value ^ (value >> 31);
+    }
+
+    /**
+     * @brief HyperLogLog distinct-count estimator
+     *
+     * 2^12 one-byte registers (4 KiB, allocated on the first add) give a
+     * standard error of about 1.6% at any cardinality. Adding a key twice
+     * has no effect, and two sketches merge by taking register maxima, so
+     * per-concert sketches can be combined into any larger group. Keys
+     * cannot be removed.
+     */
+    class HyperLogLog {
+    public:
+        static constexpr int PRECISION = 12;
+        static constexpr size_t REGISTERS = size_t(1) << PRECISION;
+
+        void add(uint64_t key) {
+            if (registers.empty()) {
+                registers.assign(REGISTERS, 0);
+            }
+            uint64_t hash = mix64(key);
+            size_t index = static_cast<size_t>(hash >> (64 - PRECISION));
+            uint64_t rest = hash << PRECISION;
+            uint8_t rank = 1;
+            while (rank <= 64 - PRECISION && !(rest & (uint64_t(1) << 63))) {
+                rest <<= 1;
+                ++rank;
+            }
+            if (rank > registers[index]) {
+                registers[index] = rank;
+            }
+        }
+
+        void merge(const HyperLogLog& other) {
+            if (other.registers.empty()) {
+                return;
+            }
+            if (registers.empty()) {
+                registers = other.registers;
+                return;
+            }
+            for (size_t i = 0; i < REGISTERS; ++i) {
+                if (other.registers[i] > registers[i]) {
+                    registers[i] = other.registers[i];
+                }
+            }
+        }
+
+        /**
+         * @brief Estimated number of distinct keys added
+         */
+        uint64_t estimate() const {
+            if (registers.empty()) {
+                return 0;
+            }
+            const double m = static_cast<double>(REGISTERS);
+            double sum = 0.0;
+            size_t zeros = 0;
+            for (uint8_t value : registers) {
+                sum += std::ldexp(1.0, -value);
+                zeros += value == 0;
+            }
+            double raw = 0.7213 / (1.0 + 1.079 / m) * m * m / sum;
+            // Linear counting is more accurate while many registers are still empty
+            if (raw <= 2.5 * m && zeros > 0) {
+                raw = m * std::log(m / static_cast<double>(zeros));
+            }
+            return static_cast<uint64_t>(raw + 0.5);
+        }
+
+        bool empty() const { return registers.empty(); }
+
+        void write(std::ostream& out) const {
+            uint8_t allocated = registers.empty() ? 0 : 1;
+            out.write(reinterpret_cast<const char*>(&allocated), sizeof(allocated));
+            if (allocated) {
+                out.write(reinterpret_cast<const char*>(registers.data()), static_cast<std::streamsize>(REGISTERS));
+            }
+        }
+
+        bool read(std::istream& in) {
+            uint8_t allocated = 0;
+            if (!in.read(reinterpret_cast<char*>(&allocated), sizeof(allocated)) || allocated > 1) {
+                return false;
+            }
+            registers.clear();
+            if (allocated) {
+                registers.resize(REGISTERS);
+                if (!in.read(reinterpret_cast<char*>(registers.data()), static_cast<std::streamsize>(REGISTERS))) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+    private:
+        std::vector<uint8_t> registers;
+    };
+
+    /**
+     * @brief Relative-error quantile sketch over non-negative values
+     *
+     * Values are counted in logarithmic bins of width 2% (DDSketch), so any
+     * quantile is returned within 1% of a value actually at that rank.
+     * Unlike sampling sketches it supports remove(), which lets change
+     * events retract an entity's old value. Sketches merge by adding bin
+     * counts. At most MAX_BINS bins are kept; beyond that the lowest bins
+     * are folded together, which only affects the smallest quantiles.
+     */
+    class QuantileSketch {
+    public:
+        static constexpr double RELATIVE_ACCURACY = 0.01;
+        static constexpr size_t MAX_BINS = 2048;
+
+        /**
+         * @return false for negative or non-finite values, which are not counted
+         */
+        bool add(double value, int64_t weight = 1) {
+            if (!(value >= 0.0) || !std::isfinite(value)) {
+                return false;
+            }
+            if (value < MIN_VALUE) {
+                zeroCount += weight;
+            } else {
+                bins[binOf(value)] += weight;
+                if (bins.size() > MAX_BINS) {
+                    auto lowest = bins.begin();
+                    int64_t folded = lowest->second;
+                    bins.erase(lowest);
+                    bins.begin()->second += folded;
+                }
+            }
+            total += weight;
+            return true;
+        }
+
+        /**
+         * @brief Take back a value added earlier
+         *
+         * The count drops by at most what the value's bin holds, so the
+         * total always equals the sum of the bins.
+         * @return false if no bin holds the value, in which case nothing changes
+         */
+        bool remove(double value, int64_t weight = 1) {
+            if (!(value >= 0.0) || !std::isfinite(value) || weight <= 0) {
+                return false;
+            }
+            if (value < MIN_VALUE) {
+                if (zeroCount <= 0) {
+                    return false;
+                }
+                int64_t taken = std::min(weight, zeroCount);
+                zeroCount -= taken;
+                total -= taken;
+                return true;
+            }
+            auto bin = bins.find(binOf(value));
+            if (bin == bins.end() && !bins.empty() && binOf(value) < bins.begin()->first) {
+                bin = bins.begin(); // Folded into the lowest bin when the sketch was full
+            }
+            if (bin == bins.end()) {
+                return false;
+            }
+            int64_t taken = std::min(weight, bin->second);
+            total -= taken;
+            if ((bin->second -= taken) <= 0) {
+                bins.erase(bin);
+            }
+            return true;
+        }
+
+        void merge(const QuantileSketch& other) {
+            for (const auto& bin : other.bins) {
+                bins[bin.first] += bin.second;
+            }
+            while (bins.size() > MAX_BINS) {
+                auto lowest = bins.begin();
+                int64_t folded = lowest->second;
+                bins.erase(lowest);
+                bins.begin()->second += folded;
+            }
+            zeroCount += other.zeroCount;
+            total += other.total;
+        }
+
+        /**
+         * @brief Value at quantile q (0 = minimum, 0.5 = median, 1 = maximum)
+         * @return -1 if the sketch is empty
+         */
+        double quantile(double q) const {
+            if (total <= 0) {
+                return -1.0;
+            }
+            q = std::min(1.0, std::max(0.0, q));
+            int64_t rank = static_cast<int64_t>(q * static_cast<double>(total - 1));
+            if (rank < zeroCount) {
+                return 0.0;
+            }
+            int64_t seen = zeroCount;
+            for (const auto& bin : bins) {
+                seen += bin.second;
+                if (seen > rank) {
+                    return 2.0 * std::pow(GAMMA, bin.first) / (GAMMA + 1.0);
+                }
+            }
+            return bins.empty() ? 0.0 : 2.0 * std::pow(GAMMA, bins.rbegin()->first) / (GAMMA + 1.0);
+        }
+
+        int64_t count() const { return total; }
+        size_t binCount() const { return bins.size(); }
+
+        void write(std::ostream& out) const {
+            uint32_t size = static_cast<uint32_t>(bins.size());
+            out.write(reinterpret_cast<const char*>(&zeroCount), sizeof(zeroCount));
+            out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+            for (const auto& bin : bins) {
+                out.write(reinterpret_cast<const char*>(&bin.first), sizeof(bin.first));
+                out.write(reinterpret_cast<const char*>(&bin.second), sizeof(bin.second));
+            }
+        }
+
+        bool read(std::istream& in) {
+            uint32_t size = 0;
+            bins.clear();
+            if (!in.read(reinterpret_cast<char*>(&zeroCount), sizeof(zeroCount)) ||
+                !in.read(reinterpret_cast<char*>(&size), sizeof(size)) || size > MAX_BINS || zeroCount < 0) {
+                return false;
+            }
+            total = zeroCount;
+            for (uint32_t i = 0; i < size; ++i) {
+                int32_t index = 0;
+                int64_t weight = 0;
+                if (!in.read(reinterpret_cast<char*>(&index), sizeof(index)) ||
+                    !in.read(reinterpret_cast<char*>(&weight), sizeof(weight)) || weight <= 0) {
+                    return false;
+                }
+                bins[index] = weight;
+                total += weight;
+            }
+            return true;
+        }
+
+    private:
+        static constexpr double GAMMA = (1.0 + RELATIVE_ACCURACY) / (1.0 - RELATIVE_ACCURACY);
+        static constexpr double MIN_VALUE = 1e-9;
+
+        static int32_t binOf(double value) {
+            static const double logGamma = std::log(GAMMA);
+            return static_cast<int32_t>(std::ceil(std::log(value) / logGamma));
+        }
+
+        std::map<int32_t, int64_t> bins; // Bin i holds values in (GAMMA^(i-1), GAMMA^i]
+        int64_t zeroCount = 0;
+        int64_t total = 0;
+    };
+}
@@ -11,8 +11,10 @@
 #include <random>
 #include <iomanip>
 #include <numeric>
+#include <unordered_map>
 #include "models.hpp"
 #include "baseModule.hpp"
+#include "changeFeed.hpp"
 
 // Forward declarations to avoid circular dependencies
 class AttendeeModule;
@@ -72,7 +74,9 @@ namespace TicketManager {
             ticket->updated_at = Model::DateTime::now();
             
             entities.push_back(ticket);
+            indexTicketOwner(ticket, attendee_id);
             saveEntities();
+            changeFeed.publish(*ticket, 1);
             
             logTicketTransaction(*ticket, "CREATED");
             return ticket->ticket_id;
@@ -90,9 +94,14 @@ namespace TicketManager {
                 return false;
             }
             
+            changeFeed.publish(*ticket, -1);
             ticket->attendee = attendee;
+            // Persist ownership in the QR code so the attendee index survives restarts
+            ticket->qr_code = replaceQRAttendee(ticket->qr_code, attendee->id);
+            indexTicketOwner(ticket, attendee->id);
             ticket->updated_at = Model::DateTime::now();
             saveEntities();
+            changeFeed.publish(*ticket, 1);
             return true;
         }
         
@@ -118,7 +127,9 @@ namespace TicketManager {
             ticket->updated_at = Model::DateTime::now();
             
             entities.push_back(ticket);
+            indexTicketOwner(ticket, attendee_id);
             saveEntities();
+            changeFeed.publish(*ticket, 1);
             
             logTicketTransaction(*ticket, "CREATED");
             return ticket->ticket_id;
@@ -199,6 +210,7 @@ namespace TicketManager {
                 
                 entities.push_back(ticket);
                 ticket_ids.push_back(ticket->ticket_id);
+                changeFeed.publish(*ticket, 1);
                 
                 logTicketTransaction(*ticket, "INVENTORY_CREATED");
             }
@@ -223,19 +235,7 @@ namespace TicketManager {
                     }
                     
                     // **FIX: Parse concert_id from QR code to match specific concert**
-                    std::string qr = ticket->qr_code;
-                    size_t c_pos = qr.find("C");
-                    size_t a_pos = qr.find("A");
-                    
-                    if (c_pos != std::string::npos && a_pos != std::string::npos && c_pos < a_pos) {
-                        try {
-                            int ticket_concert_id = std::stoi(qr.substr(c_pos + 1, a_pos - c_pos - 1));
-                            return ticket_concert_id == concert_id;
-                        } catch (...) {
-                            return false; // Invalid QR format
-                        }
-                    }
-                    return false; // Invalid QR format
+                    return extractConcertId(ticket->qr_code) == concert_id;
                 });
             
             if (it == entities.end()) {
@@ -245,11 +245,14 @@ namespace TicketManager {
             auto ticket = *it;
             
             // Convert to sold ticket
+            changeFeed.publish(*ticket, -1);
             ticket->status = Model::TicketStatus::SOLD;
             ticket->qr_code = generateUniqueQRCode(ticket->ticket_id, concert_id, attendee_id);
             ticket->updated_at = Model::DateTime::now();
+            indexTicketOwner(ticket, attendee_id);
             
             saveEntities();
+            changeFeed.publish(*ticket, 1);
             logTicketTransaction(*ticket, "PURCHASED");
             
             return ticket->ticket_id;
@@ -267,9 +270,11 @@ namespace TicketManager {
                 return false;
             }
 
+            changeFeed.publish(*ticket, -1);
             ticket->status = status;
             ticket->updated_at = Model::DateTime::now();
             saveEntities();
+            changeFeed.publish(*ticket, 1);
             
             logTicketTransaction(*ticket, "STATUS_UPDATED");
             return true;
@@ -287,10 +292,12 @@ namespace TicketManager {
                 return false;
             }
 
+            changeFeed.publish(*ticket, -1);
             ticket->status = Model::TicketStatus::CANCELLED;
             ticket->updated_at = Model::DateTime::now();
             // Note: cancellation_reason field doesn't exist in Model::Ticket
             saveEntities();
+            changeFeed.publish(*ticket, 1);
             
             logTicketTransaction(*ticket, "CANCELLED");
             return true;
@@ -323,9 +330,12 @@ namespace TicketManager {
             int attendee_id = attendee ? attendee->id : 0;
             int concert_id = 0; // Would need to get from concert_ticket if available
             
+            changeFeed.publish(*ticket, -1);
             ticket->qr_code = generateUniqueQRCode(ticket_id, concert_id, attendee_id);
             ticket->updated_at = Model::DateTime::now();
+            indexTicketOwner(ticket, attendee_id);
             saveEntities();
+            changeFeed.publish(*ticket, 1);
             
             std::cout << "✅ DEBUG: Generated new QR code for ticket " << ticket_id << ": '" << ticket->qr_code << "'" << std::endl;
             return ticket->qr_code;
@@ -398,9 +408,11 @@ namespace TicketManager {
             // Allow check-in for SOLD and AVAILABLE tickets
             if (ticket->status == Model::TicketStatus::SOLD || 
                 ticket->status == Model::TicketStatus::AVAILABLE) {
+                changeFeed.publish(*ticket, -1);
                 ticket->status = Model::TicketStatus::CHECKED_IN;
                 ticket->updated_at = Model::DateTime::now();
                 saveEntities();
+                changeFeed.publish(*ticket, 1);
                 
                 logTicketTransaction(*ticket, "CHECKED_IN");
                 std::cout << "✅ DEBUG: Successfully checked in ticket " << ticket_id << "\n";
@@ -436,16 +448,11 @@ namespace TicketManager {
         /**
          * @brief Get all tickets for a specific attendee
          * @param attendee_id Attendee ID
-         * @return Vector of tickets for the attendee
+         * @return Vector of tickets for the attendee (served from the attendee index)
          */
         std::vector<std::shared_ptr<Model::Ticket>> getTicketsByAttendee(int attendee_id) {
-            std::vector<std::shared_ptr<Model::Ticket>> result;
-            std::copy_if(entities.begin(), entities.end(), std::back_inserter(result),
-                [attendee_id](const std::shared_ptr<Model::Ticket>& ticket) {
-                    auto attendee = ticket->attendee.lock();
-                    return attendee && attendee->id == attendee_id;
-                });
-            return result;
+            auto it = ticketsByAttendee.find(attendee_id);
+            return (it != ticketsByAttendee.end()) ? it->second : std::vector<std::shared_ptr<Model::Ticket>>();
         }
 
         /**
@@ -455,12 +462,11 @@ namespace TicketManager {
          */
         std::vector<std::shared_ptr<Model::Ticket>> getActiveTicketsByAttendee(int attendee_id) {
             std::vector<std::shared_ptr<Model::Ticket>> result;
-            std::copy_if(entities.begin(), entities.end(), std::back_inserter(result),
-                [attendee_id](const std::shared_ptr<Model::Ticket>& ticket) {
-                    auto attendee = ticket->attendee.lock();
-                    return attendee && attendee->id == attendee_id && 
-                           (ticket->status == Model::TicketStatus::SOLD || 
-                            ticket->status == Model::TicketStatus::CHECKED_IN);
+            auto owned = getTicketsByAttendee(attendee_id);
+            std::copy_if(owned.begin(), owned.end(), std::back_inserter(result),
+                [](const std::shared_ptr<Model::Ticket>& ticket) {
+                    return ticket->status == Model::TicketStatus::SOLD || 
+                           ticket->status == Model::TicketStatus::CHECKED_IN;
                 });
             return result;
         }
@@ -472,11 +478,10 @@ namespace TicketManager {
          */
         std::vector<std::shared_ptr<Model::Ticket>> getExpiredTicketsByAttendee(int attendee_id) {
             std::vector<std::shared_ptr<Model::Ticket>> result;
-            std::copy_if(entities.begin(), entities.end(), std::back_inserter(result),
-                [attendee_id](const std::shared_ptr<Model::Ticket>& ticket) {
-                    auto attendee = ticket->attendee.lock();
-                    return attendee && attendee->id == attendee_id && 
-                           ticket->status == Model::TicketStatus::EXPIRED;
+            auto owned = getTicketsByAttendee(attendee_id);
+            std::copy_if(owned.begin(), owned.end(), std::back_inserter(result),
+                [](const std::shared_ptr<Model::Ticket>& ticket) {
+                    return ticket->status == Model::TicketStatus::EXPIRED;
                 });
             return result;
         }
@@ -505,20 +510,7 @@ namespace TicketManager {
             std::copy_if(entities.begin(), entities.end(), std::back_inserter(result),
                 [concert_id](const std::shared_ptr<Model::Ticket>& ticket) {
                     // **FIX: Parse concert_id from QR code since Model::Ticket doesn't have concert_id field**
-                    // QR format: TKT[id]C[concert_id]A[attendee_id]X[random]
-                    std::string qr = ticket->qr_code;
-                    size_t c_pos = qr.find("C");
-                    size_t a_pos = qr.find("A");
-                    
-                    if (c_pos != std::string::npos && a_pos != std::string::npos && c_pos < a_pos) {
-                        try {
-                            int ticket_concert_id = std::stoi(qr.substr(c_pos + 1, a_pos - c_pos - 1));
-                            return ticket_concert_id == concert_id;
-                        } catch (...) {
-                            return false; // Invalid QR format
-                        }
-                    }
-                    return false; // Invalid QR format
+                    return extractConcertId(ticket->qr_code) == concert_id;
                 });
             return result;
         }
@@ -723,8 +715,10 @@ namespace TicketManager {
             
             // Note: Direct attendee_id field doesn't exist, would need to update weak_ptr reference
             // Note: transfer_reason field doesn't exist in Model::Ticket
+            changeFeed.publish(*ticket, -1);
             ticket->updated_at = Model::DateTime::now();
             saveEntities();
+            changeFeed.publish(*ticket, 1);
             
             logTicketTransaction(*ticket, "TRANSFERRED");
             return true;
@@ -745,13 +739,25 @@ namespace TicketManager {
             }
             
             // Note: ticket_type and price fields don't exist in Model::Ticket
+            changeFeed.publish(*ticket, -1);
             ticket->updated_at = Model::DateTime::now();
             saveEntities();
+            changeFeed.publish(*ticket, 1);
             
             logTicketTransaction(*ticket, "UPGRADED");
             return true;
         }
         
+        /**
+         * @brief Ticket change notifications
+         *
+         * Every status, owner or timestamp change is published as the old
+         * image (-1) followed by the new one (+1).
+         */
+        ChangeFeed<Model::Ticket>& getChangeFeed() {
+            return changeFeed;
+        }
+
         /**
          * @brief Public method to save entities (PRIORITY 2 FIX)
          * @return true if successful, false otherwise
@@ -760,6 +766,39 @@ namespace TicketManager {
             return saveEntities();
         }
 
+        /**
+         * @brief Delete a ticket and drop it from the attendee index
+         * @param ticket_id Ticket ID to delete
+         * @return true if successful, false otherwise
+         */
+        bool deleteEntity(int ticket_id) override {
+            auto ticket = getTicketById(ticket_id);
+            if (ticket) {
+                changeFeed.publish(*ticket, -1);
+            }
+            unindexTicketOwner(ticket_id);
+            return BaseModule<Model::Ticket, int>::deleteEntity(ticket_id);
+        }
+
+        /**
+         * @brief Extract the concert ID encoded in a ticket QR code
+         * QR format: TKT[id]C[concert_id]A[attendee_id]X[random]
+         * @param qr QR code string
+         * @return Concert ID, or -1 if the QR code is malformed
+         */
+        static int extractConcertId(const std::string& qr) {
+            return extractQRField(qr, 'C', 'A');
+        }
+
+        /**
+         * @brief Extract the attendee ID encoded in a ticket QR code
+         * @param qr QR code string
+         * @return Attendee ID (0 for unsold inventory), or -1 if malformed
+         */
+        static int extractAttendeeId(const std::string& qr) {
+            return extractQRField(qr, 'A', 'X');
+        }
+
     protected:
         // BaseModule implementation
         int getEntityId(const std::shared_ptr<Model::Ticket>& entity) const override {
@@ -768,6 +807,8 @@ namespace TicketManager {
         
         void loadEntities() override {
             entities.clear();
+            ticketsByAttendee.clear();
+            ticketOwner.clear();
             std::ifstream file(dataFilePath, std::ios::binary);
             if (!file.is_open()) {
                 return;
@@ -797,6 +838,7 @@ namespace TicketManager {
                 file.read(&ticket->updated_at.iso8601String[0], len);
                 
                 entities.push_back(ticket);
+                indexTicketOwner(ticket, extractAttendeeId(ticket->qr_code));
                 
                 // **DEBUG: Check status of loaded tickets**
                 if (i < 5) { // Only show first 5 for brevity
@@ -850,6 +892,92 @@ namespace TicketManager {
         };
         std::vector<TicketReservation> reservations;
 
+        // Listeners for ticket changes
+        ChangeFeed<Model::Ticket> changeFeed;
+
+        // Attendee ID -> owned tickets, and ticket ID -> attendee it is filed under
+        std::unordered_map<int, std::vector<std::shared_ptr<Model::Ticket>>> ticketsByAttendee;
+        std::unordered_map<int, int> ticketOwner;
+
+        /**
+         * @brief File a ticket under its owner in the attendee index
+         * @param ticket Ticket to index
+         * @param attendee_id Owner's attendee ID (0 or negative means unowned)
+         */
+        void indexTicketOwner(const std::shared_ptr<Model::Ticket>& ticket, int attendee_id) {
+            auto owner = ticketOwner.find(ticket->ticket_id);
+            if (owner != ticketOwner.end() && owner->second == attendee_id) {
+                return;
+            }
+            unindexTicketOwner(ticket->ticket_id);
+            if (attendee_id <= 0) {
+                return;
+            }
+            ticketsByAttendee[attendee_id].push_back(ticket);
+            ticketOwner[ticket->ticket_id] = attendee_id;
+        }
+
+        /**
+         * @brief Remove a ticket from the attendee index
+         * @param ticket_id Ticket ID to remove
+         */
+        void unindexTicketOwner(int ticket_id) {
+            auto owner = ticketOwner.find(ticket_id);
+            if (owner == ticketOwner.end()) {
+                return;
+            }
+            auto bucket = ticketsByAttendee.find(owner->second);
+            if (bucket != ticketsByAttendee.end()) {
+                auto& tickets = bucket->second;
+                tickets.erase(std::remove_if(tickets.begin(), tickets.end(),
+                    [ticket_id](const std::shared_ptr<Model::Ticket>& ticket) {
+                        return ticket->ticket_id == ticket_id;
+                    }), tickets.end());
+                if (tickets.empty()) {
+                    ticketsByAttendee.erase(bucket);
+                }
+            }
+            ticketOwner.erase(owner);
+        }
+
+        /**
+         * @brief Parse the integer between two marker characters of a QR code
+         * @param qr QR code string
+         * @param begin Marker preceding the field
+         * @param end Marker following the field
+         * @return Parsed value, or -1 if the QR code is malformed
+         */
+        static int extractQRField(const std::string& qr, char begin, char end) {
+            size_t b_pos = qr.find(begin);
+            size_t e_pos = (b_pos == std::string::npos) ? std::string::npos : qr.find(end, b_pos + 1);
+            if (b_pos == std::string::npos || e_pos == std::string::npos || e_pos == b_pos + 1) {
+                return -1;
+            }
+            int value = 0;
+            for (size_t i = b_pos + 1; i < e_pos; ++i) {
+                if (qr[i] < '0' || qr[i] > '9') {
+                    return -1;
+                }
+                value = value * 10 + (qr[i] - '0');
+            }
+            return value;
+        }
+
+        /**
+         * @brief Rewrite the attendee field of a QR code, keeping the rest intact
+         * @param qr Existing QR code
+         * @param attendee_id New owner's attendee ID
+         * @return Updated QR code (unchanged if malformed)
+         */
+        static std::string replaceQRAttendee(const std::string& qr, int attendee_id) {
+            if (extractAttendeeId(qr) < 0) {
+                return qr;
+            }
+            size_t a_pos = qr.find('A');
+            size_t x_pos = qr.find('X', a_pos + 1);
+            return qr.substr(0, a_pos + 1) + std::to_string(attendee_id) + qr.substr(x_pos);
+        }
+
         /**
          * @brief Generate a unique QR code for a ticket
          * @param ticket_id Ticket ID
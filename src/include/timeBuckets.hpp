@@ -0,0 +1,228 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <map>
+#include <cstdio>
+#include <cstdint>
+#include <limits>
+
+namespace TimeBuckets {
+
+    /**
+     * @brief Reporting period a timestamp is bucketed into
+     */
+    enum class Period {
+        DAY,    // "YYYY-MM-DD"
+        WEEK,   // ISO 8601 week, "YYYY-Www" (weeks start on Monday)
+        MONTH   // "YYYY-MM"
+    };
+
+    constexpr int64_t INVALID = std::numeric_limits<int64_t>::min();
+
+    /**
+     * @brief Map "daily"/"weekly"/"monthly" (or "day"/"week"/"month") to a period
+     * @return false for any other name
+     */
+    inline bool parsePeriod(const std::string& name, Period& period) {
+        if (name == "daily" || name == "day") period = Period::DAY;
+        else if (name == "weekly" || name == "week") period = Period::WEEK;
+        else if (name == "monthly" || name == "month") period = Period::MONTH;
+        else return false;
+        return true;
+    }
+
+    /**
+     * @brief Days since 1970-01-01 for a proleptic Gregorian date
+     */
+    inline int64_t daysFromCivil(int64_t year, int month, int day) {
+        year -= month <= 2;
+        int64_t era = (year >= 0 ? year : year - 399) / 400;
+        int64_t yoe = year - era * 400;
+        int64_t doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+        int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+        return era * 146097 + doe - 719468;
+    }
+
+    /**
+     * @brief Inverse of daysFromCivil
+     */
+    inline void civilFromDays(int64_t days, int64_t& year, int& month, int& day) {
+        days += 719468;
+        int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+        int64_t doe = days - era * 146097;
+        int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+        int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+        int64_t mp = (5 * doy + 2) / 153;
+        day = static_cast<int>(doy - (153 * mp + 2) / 5 + 1);
+        month = static_cast<int>(mp < 10 ? mp + 3 : mp - 9);
+        year = yoe + era * 400 + (month <= 2);
+    }
+
+    inline int daysInMonth(int64_t year, int month) {
+        static const int lengths[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+        bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+        return month == 2 && leap ? 29 : lengths[month - 1];
+    }
+
+    /**
+     * @brief Parse an ISO 8601 timestamp into seconds since the epoch
+     *
+     * Accepts "YYYY-MM-DD" optionally followed by "Thh:mm", ":ss", a
+     * fraction, and "Z" or a "+hh:mm"/"-hhmm" offset (applied to the result).
+     * Digits are read directly; there is no locale, stream or regex work.
+     * Timestamps stored by the modules carry local wall-clock time with a
+     * "Z" suffix, so results compare and bucket consistently with them.
+     *
+     * @return Seconds since 1970-01-01T00:00:00, or INVALID if malformed
+     */
+    inline int64_t parseIso8601(std::string_view text) {
+        size_t pos = 0;
+        auto digits = [&text, &pos](int count, int& value) {
+            value = 0;
+            for (int i = 0; i < count; ++i, ++pos) {
+                if (pos >= text.size() || text[pos] < '0' || text[pos] > '9') return false;
+                value = value * 10 + (text[pos] - '0');
+            }
+            return true;
+        };
+        auto literal = [&text, &pos](char c) {
+            if (pos < text.size() && text[pos] == c) {
+                ++pos;
+                return true;
+            }
+            return false;
+        };
+
+        int year, month, day, hour = 0, minute = 0, second = 0;
+        if (!digits(4, year) || !literal('-') || !digits(2, month) || !literal('-') || !digits(2, day) ||
+            month < 1 || month > 12 || day < 1 || day > daysInMonth(year, month)) {
+            return INVALID;
+        }
+        if (literal('T') || literal(' ')) {
+            if (!digits(2, hour) || !literal(':') || !digits(2, minute) || hour > 23 || minute > 59) {
+                return INVALID;
+            }
+            if (literal(':')) {
+                if (!digits(2, second) || second > 60) return INVALID;
+                if (literal('.') || literal(',')) {
+                    while (pos < text.size() && text[pos] >= '0' && text[pos] <= '9') ++pos;
+                }
+            }
+        }
+        int64_t offset = 0;
+        if (pos < text.size() && (text[pos] == '+' || text[pos] == '-')) {
+            int sign = text[pos++] == '-' ? -1 : 1;
+            int offsetHours, offsetMinutes = 0;
+            if (!digits(2, offsetHours)) return INVALID;
+            literal(':');
+            if (pos < text.size() && !digits(2, offsetMinutes)) return INVALID;
+            offset = sign * (offsetHours * 3600 + offsetMinutes * 60);
+        } else {
+            literal('Z');
+        }
+        if (pos != text.size()) {
+            return INVALID;
+        }
+        return daysFromCivil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second - offset;
+    }
+
+    /**
+     * @brief Day number (days since the epoch) containing an epoch second
+     */
+    inline int64_t dayOf(int64_t seconds) {
+        return seconds >= 0 ? seconds / 86400 : (seconds - 86399) / 86400;
+    }
+
+    /**
+     * @brief First day of the bucket containing a day
+     */
+    inline int64_t bucketStart(int64_t day, Period period) {
+        if (period == Period::WEEK) {
+            int64_t weekday = ((day + 3) % 7 + 7) % 7; // 0 = Monday; the epoch was a Thursday
+            return day - weekday;
+        }
+        if (period == Period::MONTH) {
+            int64_t year;
+            int month, dayOfMonth;
+            civilFromDays(day, year, month, dayOfMonth);
+            return day - (dayOfMonth - 1);
+        }
+        return day;
+    }
+
+    /**
+     * @brief First day of the bucket after the one starting on a day
+     */
+    inline int64_t nextBucket(int64_t start, Period period) {
+        if (period == Period::WEEK) return start + 7;
+        if (period == Period::MONTH) {
+            int64_t year;
+            int month, dayOfMonth;
+            civilFromDays(start, year, month, dayOfMonth);
+            return start + daysInMonth(year, month);
+        }
+        return start + 1;
+    }
+
+    /**
+     * @brief Label of the bucket containing a day
+     */
+    inline std::string bucketLabel(int64_t day, Period period) {
+        char label[64];
+        int64_t year;
+        int month, dayOfMonth;
+        if (period == Period::WEEK) {
+            // The ISO week belongs to the year that holds its Thursday
+            int64_t thursday = bucketStart(day, Period::WEEK) + 3;
+            civilFromDays(thursday, year, month, dayOfMonth);
+            int64_t week = (thursday - daysFromCivil(year, 1, 1)) / 7 + 1;
+            std::snprintf(label, sizeof(label), "%04lld-W%02lld", static_cast<long long>(year), static_cast<long long>(week));
+        } else {
+            civilFromDays(day, year, month, dayOfMonth);
+            if (period == Period::MONTH) {
+                std::snprintf(label, sizeof(label), "%04lld-%02d", static_cast<long long>(year), month);
+            } else {
+                std::snprintf(label, sizeof(label), "%04lld-%02d-%02d", static_cast<long long>(year), month, dayOfMonth);
+            }
+        }
+        return label;
+    }
+
+    /**
+     * @brief Roll per-day values up into periods over an inclusive day range
+     *
+     * Every period that overlaps the range gets an entry, zero if nothing
+     * happened in it, so sparse activity still yields a continuous series.
+     * Ranges longer than maxBuckets periods are not zero-filled.
+     *
+     * @param daily Values keyed by "YYYY-MM-DD" (other keys are ignored)
+     * @param firstDay First day of the range (day number)
+     * @param lastDay Last day of the range (day number)
+     */
+    template <typename Value>
+    std::map<std::string, Value> rollUp(const std::map<std::string, Value>& daily, int64_t firstDay, int64_t lastDay,
+                                        Period period, size_t maxBuckets = 20000) {
+        std::map<std::string, Value> buckets;
+        if (lastDay < firstDay) {
+            return buckets;
+        }
+        size_t filled = 0;
+        for (int64_t start = bucketStart(firstDay, period); start <= lastDay && filled < maxBuckets;
+             start = nextBucket(start, period), ++filled) {
+            buckets.emplace_hint(buckets.end(), bucketLabel(start, period), Value());
+        }
+        // Day labels sort in date order, so only the days in range are visited
+        auto end = daily.lower_bound(bucketLabel(lastDay + 1, Period::DAY));
+        for (auto entry = daily.lower_bound(bucketLabel(firstDay, Period::DAY)); entry != end; ++entry) {
+            int64_t seconds = parseIso8601(entry->first);
+            if (seconds == INVALID) {
+                continue;
+            }
+            int64_t day = dayOf(seconds);
+            if (day >= firstDay && day <= lastDay) {
+                buckets[bucketLabel(day, period)] += entry->second;
+            }
+        }
+        return buckets;
+    }
+}
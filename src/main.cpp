@@ -26,6 +26,7 @@
 #include "include/performerModule.hpp"
 #include "include/reportModule.hpp"
 #include "include/attendeeModule.hpp"
+#include "include/reconciliation.hpp"
 #include "include/validationModule.hpp"
 #include "include/uiModule.hpp"
 
@@ -71,6 +72,8 @@ namespace DataPaths {
     const std::string TICKETS_FILE = "data/tickets.dat";
     const std::string FEEDBACK_FILE = "data/feedback.dat";
     const std::string PAYMENTS_FILE = "data/payments.dat";
+    const std::string RATES_FILE = "data/currency_rates.txt";
+    const std::string SENTIMENT_LEXICON_FILE = "data/sentiment_lexicon.txt";
     const std::string SPONSORS_FILE = "data/sponsors.dat";
     const std::string PROMOTIONS_FILE = "data/promotions.dat";
     const std::string REPORTS_FILE = "data/reports.dat";
@@ -96,6 +99,7 @@ struct UserSession {
     int userId;
     std::string username;
     std::string userRole;
+    std::string sessionToken; // Opaque token issued by AuthModule::login
     bool isAuthenticated;
     Model::DateTime loginTime;
     
@@ -194,6 +198,7 @@ bool initializeModules();
 bool initializeDefaultUsers();
 void cleanupModules();
 bool authenticateUser();
+bool isSessionActive();
 void displayAuthMenu();
 bool registerNewUser();
 void logout();
@@ -371,8 +376,13 @@ bool initializeModules() {
         g_concertModule = std::make_unique<ConcertModule>(DataPaths::CONCERTS_FILE);
         g_ticketModule = std::make_unique<TicketManager::TicketModule>(DataPaths::TICKETS_FILE);
         g_paymentModule = std::make_unique<PaymentManager::PaymentModule>(DataPaths::PAYMENTS_FILE);
+        g_paymentModule->loadRateTable(DataPaths::RATES_FILE); // Optional; built-in rates otherwise
         g_feedbackModule = std::make_unique<FeedbackModule>(DataPaths::FEEDBACK_FILE);
+        g_feedbackModule->loadSentimentLexicon(DataPaths::SENTIMENT_LEXICON_FILE); // Optional; built-in keywords otherwise
         g_reportModule = std::make_unique<ReportManager::ReportModule>(DataPaths::REPORTS_FILE);
+        g_reportModule->attachDataSources({g_concertModule.get(), g_ticketModule.get(), g_paymentModule.get(),
+                                           g_attendeeModule.get(), g_feedbackModule.get(), g_crewModule.get()});
+        g_reportModule->startScheduledReports("data/reports"); // Due reports start between menus
         g_commModule = std::make_unique<CommunicationModule>(DataPaths::COMM_FILE);
         
         std::cout << "✅ All modules initialized successfully!\n";
@@ -440,8 +450,16 @@ void cleanupModules() {
     std::cout << "✅ Cleanup completed successfully!\n";
 }
 
+// Scheduled reports collect from the unlocked modules on this thread between menus; a worker writes them
+void runDueScheduledReports() {
+    if (g_reportModule) {
+        g_reportModule->runDueScheduledReports();
+    }
+}
+
 // Authentication system implementation
 void displayAuthMenu() {
+    runDueScheduledReports();
     UIManager::displayAuthMenu();
 }
 
@@ -475,12 +493,17 @@ bool authenticateUser() {
                 UIManager::displayPrompt("Password");
                 std::getline(std::cin, password);
                 
-                bool isAuthenticated = g_authModule->authenticateUser(username, password);
-                if (isAuthenticated) {
+                std::string sessionToken = g_authModule->login(username, password);
+                if (!sessionToken.empty()) {
                     currentSession.username = username;
+                    currentSession.sessionToken = sessionToken;
                     currentSession.isAuthenticated = true;
                     currentSession.loginTime = Model::DateTime::now();
-                    currentSession.userRole = "user"; // All users have same role now
+                    switch (g_authModule->getSessionRole(sessionToken)) {
+                        case 1: currentSession.userRole = "admin"; break;
+                        case 2: currentSession.userRole = "staff"; break;
+                        default: currentSession.userRole = "user"; break;
+                    }
                     // Map user to attendee profile if exists
                     int mappedId = -1;
                     if (g_attendeeModule) {
@@ -494,7 +517,13 @@ bool authenticateUser() {
                     UIManager::displaySuccess("Login successful! Welcome, " + username);
                     return true;
                 } else {
-                    UIManager::displayError("Invalid credentials. Please try again.");
+                    long long retryAfter = g_authModule->getRetryAfterSeconds(username);
+                    if (retryAfter > 0) {
+                        UIManager::displayError("Too many failed attempts. Please try again in " +
+                                                std::to_string(retryAfter) + " second(s).");
+                    } else {
+                        UIManager::displayError("Invalid credentials. Please try again.");
+                    }
                 }
                 break;
             }
@@ -636,10 +665,26 @@ bool registerNewUser() {
 void logout() {
     UIManager::addSmallSpacing();
     std::cout << "Logging out " << currentSession.username << "...\n";
+    if (g_authModule && !currentSession.sessionToken.empty()) {
+        g_authModule->revokeSession(currentSession.sessionToken);
+    }
     currentSession = UserSession(); // Reset session
     UIManager::displaySuccess("Logged out successfully!");
 }
 
+bool isSessionActive() {
+    if (!currentSession.isAuthenticated) {
+        return false;
+    }
+    // Single table lookup - no credential block is decrypted after login
+    if (g_authModule && g_authModule->validateSession(currentSession.sessionToken)) {
+        return true;
+    }
+    UIManager::displayError("Your session has expired. Please log in again.");
+    currentSession = UserSession();
+    return false;
+}
+
 void displayAllAccounts() {
     UIManager::addSmallSpacing();
     UIManager::printSeparator('=');
@@ -652,18 +697,35 @@ void displayAllAccounts() {
         return;
     }
     
-    auto usernames = g_authModule->getAllUsernames();
+    const size_t pageSize = 20;
+    size_t totalAccounts = g_authModule->getUserCountByType(-1);
     
-    if (usernames.empty()) {
+    if (totalAccounts == 0) {
         UIManager::displayInfo("No accounts found.");
         UIManager::displayInfo("Use 'Register New Account' to create your first account.");
     } else {
-        std::cout << "📋 Found " << usernames.size() << " registered account(s):\n\n";
+        std::cout << "📋 Found " << totalAccounts << " registered account(s):\n\n";
         
+        // Page through the sorted index instead of materialising every username
         int count = 1;
-        for (const auto& username : usernames) {
-            std::cout << "  " << count << ". " << username << std::endl;
-            count++;
+        std::string cursor;
+        while (true) {
+            auto usernames = g_authModule->getUsernamesPage(-1, cursor, pageSize);
+            for (const auto& username : usernames) {
+                std::cout << "  " << count << ". " << username << std::endl;
+                count++;
+            }
+            if (usernames.size() < pageSize || static_cast<size_t>(count - 1) >= totalAccounts) {
+                break;
+            }
+            cursor = usernames.back();
+            std::cout << "\n-- Showing " << (count - 1) << " of " << totalAccounts
+                      << ". Press Enter for more, or 0 to stop: ";
+            std::string more;
+            std::getline(std::cin, more);
+            if (more == "0") {
+                break;
+            }
         }
         
         UIManager::addSmallSpacing();
@@ -678,14 +740,17 @@ void displayAllAccounts() {
 }
 
 void displayMainMenu() {
+    runDueScheduledReports();
     UIManager::displayMainMenu();
 }
 
 void displayManagementMenu() {
+    runDueScheduledReports();
     UIManager::displayManagementMenu();
 }
 
 void displayUserMenu() {
+    runDueScheduledReports();
     UIManager::displayUserMenu();
 }
 
@@ -1123,13 +1188,15 @@ void manageTickets() {
                 std::cout << "Validating ticket-concert relationships...\n";
                 int invalidCount = 0;
                 
-                // This would implement comprehensive validation
-                auto allTickets = g_ticketModule->getAll();
-                for (const auto& ticket : allTickets) {
-                    // Need to fix ticket field access - check actual Model::Ticket structure
-                    std::cout << "⚠️ Ticket validation requires access to actual ticket fields.\n";
-                    // This would need proper implementation based on actual Ticket model
-                    break;
+                for (const auto& ticket : g_ticketModule->getAll()) {
+                    int concertId = TicketManager::TicketModule::extractConcertId(ticket->qr_code);
+                    if (concertId < 0 || !g_concertModule->getConcertById(concertId)) {
+                        if (invalidCount < 20) {
+                            std::cout << "⚠️ Ticket " << ticket->ticket_id << " refers to unknown concert "
+                                      << concertId << " (QR: " << ticket->qr_code << ")\n";
+                        }
+                        invalidCount++;
+                    }
                 }
                 
                 if (invalidCount == 0) {
@@ -1137,6 +1204,34 @@ void manageTickets() {
                 } else {
                     std::cout << "⚠️ Found " << invalidCount << " invalid relationships.\n";
                 }
+                
+                // Tickets against payments, joined per attendee
+                std::cout << "\nReconciling tickets against payments...\n";
+                auto reconciliation = Reconciliation::reconcile(*g_ticketModule, *g_paymentModule);
+                std::cout << "Checked " << reconciliation.tickets << " tickets and " << reconciliation.payments
+                          << " payments for " << reconciliation.attendees << " attendees in "
+                          << std::fixed << std::setprecision(3) << reconciliation.seconds << "s\n";
+                for (const auto& entry : reconciliation.concerts) {
+                    auto concert = g_concertModule->getConcertById(entry.first);
+                    std::cout << (concert ? concert->name : "Unknown concert") << " (ID: " << entry.first << ") - Sold: "
+                              << entry.second.sold << ", Cancelled: " << entry.second.voided
+                              << ", Holder unpaid: " << entry.second.unpaid << "\n";
+                }
+                
+                const size_t shown = std::min<size_t>(reconciliation.mismatches.size(), 20);
+                for (size_t i = 0; i < shown; ++i) {
+                    const auto& mismatch = reconciliation.mismatches[i];
+                    std::cout << "⚠️ " << Reconciliation::mismatchTypeToString(mismatch.type)
+                              << " attendee " << mismatch.attendee_id
+                              << (mismatch.type == Reconciliation::MismatchType::ATTENDEE_UNPAID ? " ticket " : " payment ")
+                              << mismatch.record_id << ": " << mismatch.detail << "\n";
+                }
+                if (reconciliation.mismatches.empty()) {
+                    std::cout << "✅ Every ticket holder has paid and every refund voided a ticket.\n";
+                } else {
+                    std::cout << "⚠️ Found " << reconciliation.mismatches.size() << " mismatches"
+                              << (shown < reconciliation.mismatches.size() ? " (first 20 shown)" : "") << ".\n";
+                }
                 break;
             }
             case 5: { // QR Code Management
@@ -1957,6 +2052,35 @@ void managePerformersAndCrew() {
     }
 }
 
+// Revenue totals per currency, summed exactly in minor units over all payments
+void displayRevenueReport() {
+    auto stats = g_paymentModule->getPaymentStatistics();
+    if (stats.total_payments == 0) {
+        std::cout << "No payment data available for revenue report.\n";
+        return;
+    }
+    
+    std::cout << "\n--- Revenue Report ---\n";
+    std::cout << "Total Transactions: " << stats.total_payments << std::endl;
+    std::cout << "Completed Transactions: " << stats.completed_payments << std::endl;
+    for (const auto& currency : g_paymentModule->getCurrencies()) {
+        Model::Money gross = g_paymentModule->sumAmounts(std::nullopt, currency, 1);
+        Model::Money net = g_paymentModule->sumAmounts(Model::PaymentStatus::COMPLETED, currency);
+        Model::Money refunded = -g_paymentModule->sumAmounts(std::nullopt, currency, -1);
+        if (gross.minor == 0 && refunded.minor == 0) {
+            continue;
+        }
+        std::cout << "[" << currency << "] Gross: " << gross.toString(currency)
+                  << " | Net (completed): " << net.toString(currency)
+                  << " | Refunded: " << refunded.toString(currency) << std::endl;
+    }
+    std::string base = g_paymentModule->getBaseCurrency();
+    Model::Money consolidated = g_paymentModule->sumAmountsConverted(Model::PaymentStatus::COMPLETED, base);
+    std::cout << "Consolidated Net Revenue: " << consolidated.toString(base) << " " << base
+              << " (at today's rates)" << std::endl;
+    std::cout << "Average Payment: " << std::fixed << std::setprecision(2) << stats.average_payment_amount << std::endl;
+}
+
 void monitorPayments() {
     while (true) {
         std::cout << "\n--- Payment & Financial Monitoring ---\n";
@@ -1980,36 +2104,14 @@ void monitorPayments() {
         
         switch (choice) {
             case 1: { // View Payment Statistics
-                auto payments = g_paymentModule->getRecentPayments(1000); // Get recent payments
+                auto stats = g_paymentModule->getPaymentStatistics(); // Read from the rollups
                 std::cout << "\n--- Payment Statistics ---\n";
-                std::cout << "Total Payments: " << payments.size() << std::endl;
-                
-                int completed = 0, pending = 0, failed = 0, refunded = 0;
-                double totalRevenue = 0.0;
-                
-                for (const auto& payment : payments) {
-                    switch (payment->status) {
-                        case Model::PaymentStatus::COMPLETED:
-                            completed++;
-                            totalRevenue += payment->amount;
-                            break;
-                        case Model::PaymentStatus::PENDING:
-                            pending++;
-                            break;
-                        case Model::PaymentStatus::FAILED:
-                            failed++;
-                            break;
-                        case Model::PaymentStatus::REFUNDED:
-                            refunded++;
-                            break;
-                    }
-                }
-                
-                std::cout << "Completed: " << completed << std::endl;
-                std::cout << "Pending: " << pending << std::endl;
-                std::cout << "Failed: " << failed << std::endl;
-                std::cout << "Refunded: " << refunded << std::endl;
-                std::cout << "Total Revenue: $" << std::fixed << std::setprecision(2) << totalRevenue << std::endl;
+                std::cout << "Total Payments: " << stats.total_payments << std::endl;
+                std::cout << "Completed: " << stats.completed_payments << std::endl;
+                std::cout << "Pending: " << stats.pending_payments << std::endl;
+                std::cout << "Failed: " << stats.failed_payments << std::endl;
+                std::cout << "Refunded: " << stats.refunded_payments << std::endl;
+                std::cout << "Total Revenue: $" << std::fixed << std::setprecision(2) << stats.total_revenue << std::endl;
                 break;
             }
             case 2: { // Process Refund
@@ -2044,22 +2146,7 @@ void monitorPayments() {
                 break;
             }
             case 3: { // View Transaction History
-                auto payments = g_paymentModule->getRecentPayments(1000); // Get recent payments
-
-                // Filter to COMPLETED only and sort by payment_id ascending
-                std::vector<std::shared_ptr<Model::Payment>> completed;
-                completed.reserve(payments.size());
-                for (const auto& p : payments) {
-                    if (p && p->status == Model::PaymentStatus::COMPLETED) {
-                        completed.push_back(p);
-                    }
-                }
-                std::sort(completed.begin(), completed.end(),
-                    [](const std::shared_ptr<Model::Payment>& a, const std::shared_ptr<Model::Payment>& b) {
-                        return a->payment_id < b->payment_id;
-                    });
-
-                std::cout << "\n--- Transaction History (COMPLETED only) ---\n";
+                std::cout << "\n--- Transaction History (COMPLETED only, newest first) ---\n";
                 std::cout << std::setw(8) << "ID" << " | " 
                           << std::setw(15) << "Transaction ID" << " | "
                           << std::setw(10) << "Amount" << " | "
@@ -2067,15 +2154,32 @@ void monitorPayments() {
                           << std::setw(15) << "Method" << std::endl;
                 std::cout << std::string(70, '-') << std::endl;
                 
-                for (const auto& payment : completed) {
-                    std::cout << std::setw(8) << payment->payment_id << " | " 
-                              << std::setw(15) << payment->transaction_id << " | "
-                              << std::setw(10) << std::fixed << std::setprecision(2) << payment->amount << " | "
-                              << std::setw(12) << "COMPLETED"
-                              << " | " << std::setw(15) << payment->payment_method << std::endl;
+                // Page through the time index instead of copying every payment
+                const size_t pageSize = 20;
+                PaymentManager::PaymentModule::PaymentCursor cursor;
+                size_t shown = 0;
+                while (true) {
+                    auto page = g_paymentModule->getRecentPaymentsPage(cursor, pageSize, Model::PaymentStatus::COMPLETED);
+                    for (const auto& payment : page) {
+                        std::cout << std::setw(8) << payment->payment_id << " | " 
+                                  << std::setw(15) << payment->transaction_id << " | "
+                                  << std::setw(10) << payment->amount.toString(payment->currency) << " | "
+                                  << std::setw(12) << "COMPLETED"
+                                  << " | " << std::setw(15) << payment->payment_method << std::endl;
+                    }
+                    shown += page.size();
+                    if (page.size() < pageSize) {
+                        break;
+                    }
+                    std::cout << "\n-- Showing " << shown << ". Press Enter for more, or 0 to stop: ";
+                    std::string more;
+                    std::getline(std::cin, more);
+                    if (more == "0") {
+                        break;
+                    }
                 }
                 
-                if (completed.empty()) {
+                if (shown == 0) {
                     std::cout << "No completed transactions found.\n";
                 }
                 break;
@@ -2126,35 +2230,7 @@ void monitorPayments() {
                 break;
             }
             case 5: { // Revenue Analysis
-                auto payments = g_paymentModule->getRecentPayments(1000); // Get recent payments
-                if (payments.empty()) {
-                    std::cout << "No payment data available for revenue report.\n";
-                    break;
-                }
-                
-                double totalRevenue = 0, completedRevenue = 0, refundedAmount = 0;
-                int totalTransactions = 0, completedTransactions = 0;
-                
-                for (const auto& payment : payments) {
-                    totalTransactions++;
-                    totalRevenue += payment->amount;
-                    
-                    if (payment->status == Model::PaymentStatus::COMPLETED) {
-                        completedTransactions++;
-                        completedRevenue += payment->amount;
-                    } else if (payment->status == Model::PaymentStatus::REFUNDED) {
-                        refundedAmount += payment->amount;
-                    }
-                }
-                
-                std::cout << "\n--- Revenue Report ---\n";
-                std::cout << "Total Transactions: " << totalTransactions << std::endl;
-                std::cout << "Completed Transactions: " << completedTransactions << std::endl;
-                std::cout << "Gross Revenue: $" << std::fixed << std::setprecision(2) << totalRevenue << std::endl;
-                std::cout << "Net Revenue: $" << std::fixed << std::setprecision(2) << completedRevenue << std::endl;
-                std::cout << "Refunded Amount: $" << std::fixed << std::setprecision(2) << refundedAmount << std::endl;
-                std::cout << "Average Transaction: $" << std::fixed << std::setprecision(2) 
-                          << (completedTransactions > 0 ? completedRevenue / completedTransactions : 0) << std::endl;
+                displayRevenueReport();
                 break;
             }
             case 6: { // Failed Payments
@@ -2167,7 +2243,7 @@ void monitorPayments() {
                 
                 for (const auto& payment : payments) {
                     std::cout << "Payment ID: " << payment->payment_id 
-                              << " | Amount: $" << std::fixed << std::setprecision(2) << payment->amount
+                              << " | Amount: " << payment->amount.toString(payment->currency) << " " << payment->currency
                               << " | Method: " << payment->payment_method 
                               << " | Date: " << formatTimestampDisplay(payment->payment_date_time.iso8601String) << std::endl;
                 }
@@ -2313,10 +2389,11 @@ void manageFeedbackAndComm() {
         std::cout << "1. View All Feedback\n";
         std::cout << "2. Check Critical/Urgent Feedback\n";
         std::cout << "3. Communication Logs\n";
+        std::cout << "4. Reload Sentiment Lexicon\n";
         std::cout << "0. Back to Management Portal\n";
         
         std::string choiceStr;
-        std::cout << "Enter choice (0-3): ";
+        std::cout << "Enter choice (0-4): ";
         std::getline(std::cin, choiceStr);
         
         if (!isValidInteger(choiceStr)) {
@@ -2371,6 +2448,16 @@ void manageFeedbackAndComm() {
                 manageCommunicationLogs();
                 break;
             }
+            case 4: { // Reload Sentiment Lexicon
+                if (g_feedbackModule->loadSentimentLexicon(DataPaths::SENTIMENT_LEXICON_FILE)) {
+                    std::cout << "✅ Sentiment keywords reloaded from " << DataPaths::SENTIMENT_LEXICON_FILE
+                              << "; existing feedback re-classified.\n";
+                } else {
+                    std::cout << "❌ Could not load " << DataPaths::SENTIMENT_LEXICON_FILE
+                              << " (missing, empty or unknown category). Current keywords kept.\n";
+                }
+                break;
+            }
             case 0: // Back
                 return;
             default:
@@ -2384,6 +2471,7 @@ void manageFeedbackAndComm() {
 
 void generateReports() {
     while (true) {
+        runDueScheduledReports();
         std::cout << "\n--- Reports & Analytics ---\n";
         std::cout << "1. Concert Attendance Report\n";
         std::cout << "2. Revenue Report\n";
@@ -2392,10 +2480,11 @@ void generateReports() {
         std::cout << "5. Ticket Sales Analysis\n";
         std::cout << "6. System Usage Report\n";
         std::cout << "7. Export Reports\n";
+        std::cout << "8. Scheduled Reports\n";
         std::cout << "0. Back to Management Portal\n";
         
         std::string choiceStr;
-        std::cout << "Enter choice (0-7): ";
+        std::cout << "Enter choice (0-8): ";
         std::getline(std::cin, choiceStr);
         
         if (!isValidInteger(choiceStr)) {
@@ -2449,35 +2538,7 @@ void generateReports() {
                 break;
             }
             case 2: { // Revenue Report
-                auto payments = g_paymentModule->getRecentPayments(1000); // Get recent payments
-                if (payments.empty()) {
-                    std::cout << "No payment data available for revenue report.\n";
-                    break;
-                }
-                
-                double totalRevenue = 0, completedRevenue = 0, refundedAmount = 0;
-                int totalTransactions = 0, completedTransactions = 0;
-                
-                for (const auto& payment : payments) {
-                    totalTransactions++;
-                    totalRevenue += payment->amount;
-                    
-                    if (payment->status == Model::PaymentStatus::COMPLETED) {
-                        completedTransactions++;
-                        completedRevenue += payment->amount;
-                    } else if (payment->status == Model::PaymentStatus::REFUNDED) {
-                        refundedAmount += payment->amount;
-                    }
-                }
-                
-                std::cout << "\n--- Revenue Report ---\n";
-                std::cout << "Total Transactions: " << totalTransactions << std::endl;
-                std::cout << "Completed Transactions: " << completedTransactions << std::endl;
-                std::cout << "Gross Revenue: $" << std::fixed << std::setprecision(2) << totalRevenue << std::endl;
-                std::cout << "Net Revenue: $" << std::fixed << std::setprecision(2) << completedRevenue << std::endl;
-                std::cout << "Refunded Amount: $" << std::fixed << std::setprecision(2) << refundedAmount << std::endl;
-                std::cout << "Average Transaction: $" << std::fixed << std::setprecision(2) 
-                          << (completedTransactions > 0 ? completedRevenue / completedTransactions : 0) << std::endl;
+                displayRevenueReport();
                 break;
             }
             case 3: { // Venue Utilization Report
@@ -2583,6 +2644,25 @@ void generateReports() {
                 size_t totalRecords = concerts.size() + venues.size() + performers.size() + 
                                      attendees.size() + tickets.size() + payments.size();
                 std::cout << "Total Records: " << totalRecords << std::endl;
+                
+                auto summary = g_reportModule->calculateSummaryMetrics();
+                std::cout << "\n--- Summary Metrics ---\n";
+                std::cout << "Active Concerts: " << summary.active_concerts << std::endl;
+                std::cout << "Tickets Sold: " << summary.total_tickets_sold << std::endl;
+                std::cout << "Net Revenue: " << std::fixed << std::setprecision(2) << summary.total_revenue << std::endl;
+                std::cout << "Satisfaction: " << summary.overall_satisfaction_score << " / 5, NPS " << summary.nps_score << std::endl;
+                std::cout << "Most Popular Concert: " << summary.most_popular_concert << std::endl;
+                
+                std::cout << "\n--- Report Compute Time ---\n";
+                for (const auto& timing : g_reportModule->getReportTimings()) {
+                    std::cout << std::setw(10) << timing.first << ": " << std::setprecision(3) << timing.second.total_ms << " ms (";
+                    bool first = true;
+                    for (const auto& scan : timing.second.scan_ms) {
+                        std::cout << (first ? "" : ", ") << scan.first << " " << scan.second << " ms";
+                        first = false;
+                    }
+                    std::cout << ")" << std::endl;
+                }
                 break;
             }
             case 7: { // Export Reports
@@ -2591,26 +2671,152 @@ void generateReports() {
                 std::cout << "1. Export Concert Data\n";
                 std::cout << "2. Export Financial Data\n";
                 std::cout << "3. Export All Data\n";
-                std::cout << "4. Back\n";
+                std::cout << "4. Export Analytics Snapshot (for snapshotQuery)\n";
+                std::cout << "5. Back\n";
+                
+                std::string exportStr;
+                std::cout << "Enter choice (1-5): ";
+                std::getline(std::cin, exportStr);
+                if (!isValidInteger(exportStr)) {
+                    std::cout << "❌ Invalid input. Please enter a valid integer only.\n";
+                    break;
+                }
+                int exportChoice = std::stoi(exportStr);
+                if (exportChoice == 5) {
+                    break;
+                }
                 
-                int exportChoice;
-                std::cout << "Enter choice (1-4): ";
-                std::cin >> exportChoice;
+                const std::string exportsDir = "data/exports";
+                #ifdef _WIN32
+                    _mkdir("data");
+                    _mkdir(exportsDir.c_str());
+                #else
+                    mkdir("data", 0755);
+                    mkdir(exportsDir.c_str(), 0755);
+                #endif
+                std::string timestamp = Model::DateTime::now().iso8601String;
+                std::replace(timestamp.begin(), timestamp.end(), ':', '-');
+                
+                if (exportChoice == 4) {
+                    std::string path = exportsDir + "/analytics_" + timestamp + ".mcol";
+                    auto started = std::chrono::steady_clock::now();
+                    long long rows = g_reportModule->exportColumnarSnapshot(path);
+                    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+                    if (rows < 0) {
+                        std::cout << "❌ Failed to write snapshot " << path << std::endl;
+                    } else {
+                        std::cout << "✅ Wrote " << rows << " rows to " << path << " in " << std::fixed << std::setprecision(2)
+                                  << seconds << "s\n";
+                        std::cout << "Query it offline with: snapshotQuery " << path << " revenue\n";
+                    }
+                    break;
+                }
                 
+                std::vector<std::string> datasets;
                 switch (exportChoice) {
-                    case 1:
-                        std::cout << "✅ Concert data export initiated (feature placeholder)\n";
-                        break;
-                    case 2:
-                        std::cout << "✅ Financial data export initiated (feature placeholder)\n";
-                        break;
-                    case 3:
-                        std::cout << "✅ Full system export initiated (feature placeholder)\n";
-                        break;
-                    case 4:
-                        break;
+                    case 1: datasets = {"concerts", "tickets"}; break;
+                    case 2: datasets = {"payments"}; break;
+                    case 3: datasets = {"concerts", "tickets", "payments"}; break;
                     default:
                         std::cout << "❌ Invalid choice.\n";
+                        break;
+                }
+                if (datasets.empty()) {
+                    break;
+                }
+                
+                std::string format;
+                std::cout << "Format (JSON/CSV): ";
+                std::getline(std::cin, format);
+                std::transform(format.begin(), format.end(), format.begin(), ::toupper);
+                if (format != "JSON" && format != "CSV") {
+                    std::cout << "❌ Unsupported format.\n";
+                    break;
+                }
+                
+                std::string extension = format == "CSV" ? ".csv" : ".json";
+                
+                for (const auto& dataset : datasets) {
+                    std::string path = exportsDir + "/" + dataset + "_" + timestamp + extension;
+                    auto started = std::chrono::steady_clock::now();
+                    long long rows = g_reportModule->exportDataset(dataset, format, path);
+                    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+                    if (rows < 0) {
+                        std::cout << "❌ Failed to export " << dataset << " to " << path << std::endl;
+                    } else {
+                        std::cout << "✅ Exported " << rows << " " << dataset << " rows to " << path
+                                  << " in " << std::fixed << std::setprecision(2) << seconds << "s" << std::endl;
+                    }
+                }
+                break;
+            }
+            case 8: { // Scheduled Reports
+                auto schedules = g_reportModule->getScheduledReports();
+                std::cout << "\n--- Scheduled Reports ---\n";
+                if (schedules.empty()) {
+                    std::cout << "No reports scheduled.\n";
+                } else {
+                    std::cout << std::left << std::setw(8) << "ID" << std::setw(13) << "Report" << std::setw(16) << "Frequency"
+                              << std::setw(22) << "Next Run" << std::setw(22) << "Last Run" << "Runs/Failed/Coalesced\n";
+                    for (const auto& schedule : schedules) {
+                        std::cout << std::setw(8) << schedule.id << std::setw(13) << schedule.report_type
+                                  << std::setw(16) << schedule.frequency
+                                  << std::setw(22) << (schedule.next_run < 0 ? "never" : ReportScheduling::formatLocalTime(schedule.next_run))
+                                  << std::setw(22) << (schedule.last_run == 0 ? "-" : ReportScheduling::formatLocalTime(schedule.last_run))
+                                  << schedule.runs << "/" << schedule.failures << "/" << schedule.coalesced
+                                  << (schedule.running ? " (running)" : "") << "\n";
+                    }
+                    std::cout << std::right;
+                }
+                std::cout << "\n1. Add Schedule\n";
+                std::cout << "2. Cancel Schedule\n";
+                std::cout << "3. Run Now\n";
+                std::cout << "4. Back\n";
+                
+                std::string actionStr;
+                std::cout << "Enter choice (1-4): ";
+                std::getline(std::cin, actionStr);
+                if (!isValidInteger(actionStr)) {
+                    std::cout << "❌ Invalid input. Please enter a valid integer only.\n";
+                    break;
+                }
+                int action = std::stoi(actionStr);
+                if (action == 1) {
+                    std::string reportType, frequency, recipientList;
+                    std::cout << "Report type (sales, payroll, profit_loss, payment): ";
+                    std::getline(std::cin, reportType);
+                    std::cout << "Frequency (hourly, daily, weekly, monthly or cron \"m h dom mon dow\"): ";
+                    std::getline(std::cin, frequency);
+                    std::cout << "Recipients (comma-separated, optional): ";
+                    std::getline(std::cin, recipientList);
+                    std::vector<std::string> recipients;
+                    std::stringstream recipientStream(recipientList);
+                    std::string recipient;
+                    while (std::getline(recipientStream, recipient, ',')) {
+                        recipient.erase(0, recipient.find_first_not_of(' '));
+                        recipient.erase(recipient.find_last_not_of(' ') + 1);
+                        if (!recipient.empty()) {
+                            recipients.push_back(recipient);
+                        }
+                    }
+                    std::string id = g_reportModule->scheduleAutomaticReport(reportType, frequency, recipients);
+                    if (id.empty()) {
+                        std::cout << "❌ Unknown report type or invalid frequency.\n";
+                    } else {
+                        std::cout << "✅ Scheduled " << reportType << " report " << id << ". Reports are written to data/reports/\n";
+                    }
+                } else if (action == 2 || action == 3) {
+                    std::string id;
+                    std::cout << "Schedule ID: ";
+                    std::getline(std::cin, id);
+                    if (action == 2) {
+                        std::cout << (g_reportModule->cancelScheduledReport(id) ? "✅ Schedule cancelled.\n" : "❌ Schedule not found.\n");
+                    } else {
+                        std::cout << (g_reportModule->runScheduledReportNow(id) ? "✅ Report queued; it starts when this menu is shown again.\n"
+                                                                                : "❌ Schedule not found.\n");
+                    }
+                } else if (action != 4) {
+                    std::cout << "❌ Invalid choice.\n";
                 }
                 break;
             }
@@ -2724,19 +2930,16 @@ void showAnalyticsDashboard() {
     writeOutput("Generated: " + formatTimestampDisplay(timestamp) + "\n");
     writeOutput(std::string(100, '=') + "\n");
 
-    // Ticket Sales Overview
-    double totalSales = 0.0;
-    int totalTicketsSold = 0;
-    int totalAttendees = 0;
+    // Ticket Sales Overview, read from the live dashboard aggregates
+    auto dashboard = g_reportModule->generateDashboardData();
+    double totalSales = dashboard.summary.total_revenue;
+    int totalTicketsSold = dashboard.summary.total_tickets_sold;
+    int totalAttendees = dashboard.summary.total_attendees;
     double avgEngagementScore = 0.0;
-    int totalReports = 0;
+    int totalReports = static_cast<int>(dashboard.recent_concerts.size());
 
-    for (const auto& report : g_reportModule->getAll()) {
-        totalSales += report->sales_volume;
-        totalTicketsSold += report->tickets_sold;
-        totalAttendees += report->total_registrations;
-        avgEngagementScore += report->attendee_engagement_score;
-        totalReports++;
+    for (const auto& concert : dashboard.recent_concerts) {
+        avgEngagementScore += concert.attendee_engagement_score;
     }
 
     if (totalReports > 0) {
@@ -2752,14 +2955,10 @@ void showAnalyticsDashboard() {
     // Progress bar for ticket sales (assuming 1000 as max capacity)
     int barWidth = 40;
 
-    // Calculate total venue capacity for more accurate sales metrics
-    int totalCapacity = 0;
+    // Seats across all concerts (fallback to 1000 if none are known)
+    int totalCapacity = dashboard.total_capacity;
     auto venues = g_venueModule->getAllVenues();
-    for (const auto& venue : venues) {
-        totalCapacity += venue->capacity;
-    }
     
-    // Use total capacity as max for sales progress (fallback to 1000 if no venues)
     int maxCapacity = totalCapacity > 0 ? totalCapacity : 1000;
     int progress = (totalTicketsSold * barWidth) / maxCapacity;
     int percentage = maxCapacity > 0 ? (totalTicketsSold * 100) / maxCapacity : 0;
@@ -2772,11 +2971,27 @@ void showAnalyticsDashboard() {
     
     std::cout << "] " << percentage << "% (" << totalTicketsSold << "/" << maxCapacity << " total tickets available for sale)" << std::endl;
 
+    // Daily trend over the last week, quiet days shown as zero
+    std::cout << "\nLast 7 days (revenue / tickets sold / check-ins):" << std::endl;
+    for (const auto& day : dashboard.daily_revenue_trend) {
+        std::cout << "  " << day.first << "  $" << std::fixed << std::setprecision(2) << std::setw(10) << day.second
+                  << "  " << std::setw(5) << dashboard.daily_ticket_sales[day.first]
+                  << "  " << std::setw(5) << dashboard.daily_check_ins[day.first] << std::endl;
+    }
+
     // Attendee Engagement
     std::cout << "\n👥 ATTENDEE METRICS" << std::endl;
     std::cout << std::string(50, '-') << std::endl;
     std::cout << "Total Registrations: " << totalAttendees << std::endl;
-    std::cout << "Average Engagement Score: " << std::fixed << std::setprecision(1) << avgEngagementScore << "/10" << std::endl;
+    std::cout << "Distinct Ticket Holders (est.): " << dashboard.distinct_attendees << std::endl;
+    if (dashboard.median_ticket_price >= 0) {
+        std::cout << "Ticket Price (median / p90): $" << std::fixed << std::setprecision(2) << dashboard.median_ticket_price
+                  << " / $" << dashboard.p90_ticket_price << std::endl;
+    }
+    if (dashboard.median_rating >= 0) {
+        std::cout << "Median Rating: " << std::fixed << std::setprecision(1) << dashboard.median_rating << std::endl;
+    }
+    std::cout << "Average Engagement Score: " << std::fixed << std::setprecision(1) << avgEngagementScore << "/10 (recent concerts)" << std::endl;
     
     // Engagement Visualization
     std::cout << "Engagement Level: ";
@@ -2809,17 +3024,7 @@ void showAnalyticsDashboard() {
     std::cout << "\n💭 FEEDBACK OVERVIEW" << std::endl;
     std::cout << std::string(50, '-') << std::endl;
     
-    double avgNPS = 0.0;
-    int totalNPS = 0;
-    for (const auto& report : g_reportModule->getAll()) {
-        if (report->nps_score > 0) {
-            avgNPS += report->nps_score;
-            totalNPS++;
-        }
-    }
-    if (totalNPS > 0) {
-        avgNPS /= totalNPS;
-    }
+    double avgNPS = dashboard.summary.nps_score;
     
     std::cout << "Net Promoter Score: " << std::fixed << std::setprecision(1) << avgNPS << std::endl;
     std::cout << "NPS Category: ";
@@ -2874,7 +3079,10 @@ void showAnalyticsDashboard() {
     reportFile << "Total Registrations: " << totalAttendees << "\n";
     reportFile << "Average Engagement Score: " << avgEngagementScore << "/10\n";
     reportFile << "Net Promoter Score: " << avgNPS << "\n";
-    reportFile << "Total Reports Analyzed: " << totalReports << "\n";
+    reportFile << "Recent Concerts Analyzed: " << totalReports << "\n";
+    for (const auto& alert : dashboard.recent_alerts) {
+        reportFile << "Alert: " << alert << "\n";
+    }
     
     reportFile.close();
     
@@ -2920,10 +3128,16 @@ void systemAdministration() {
         DataPaths::TICKETS_FILE,
         DataPaths::FEEDBACK_FILE,
         DataPaths::PAYMENTS_FILE,
+        DataPaths::PAYMENTS_FILE + ".rollup", // revenue rollups kept next to payments.dat
+        DataPaths::PAYMENTS_FILE + ".log",    // payment changes since the last checkpoint
+        DataPaths::RATES_FILE,
+        DataPaths::SENTIMENT_LEXICON_FILE,
         DataPaths::SPONSORS_FILE,
         DataPaths::PROMOTIONS_FILE,
         DataPaths::REPORTS_FILE,
+        DataPaths::REPORTS_FILE + ".sketches", // analytics sketches saved with the reports
         DataPaths::AUTH_FILE,
+        DataPaths::AUTH_FILE + ".journal", // credential map journal kept next to auth.dat
         DataPaths::COMM_FILE,
         std::string("data/chat_data.bin")
     };
@@ -2932,8 +3146,11 @@ void systemAdministration() {
         std::cout << "\n--- System Administration ---\n";
         std::cout << "1. System Health Check\n";
         std::cout << "2. Data Backup & Restore\n";
+        std::cout << "3. Login Throttle Statistics\n";
+        std::cout << "4. Report Cache Statistics\n";
+        std::cout << "5. Ad-hoc Data Query\n";
         std::cout << "0. Back to Management Portal\n";
-        std::cout << "Enter choice (0-2): ";
+        std::cout << "Enter choice (0-5): ";
 
         std::string choiceStr;
         std::getline(std::cin, choiceStr);
@@ -3027,10 +3244,100 @@ void systemAdministration() {
                 }
                 break;
             }
+            case 3: {
+                if (!g_authModule) { std::cout << "❌ Authentication module not initialized.\n"; break; }
+                auto stats = g_authModule->getThrottleStats();
+                auto policy = g_authModule->getThrottlePolicy();
+                std::cout << "\n--- Login Throttle Statistics ---\n";
+                std::cout << "Throttling: " << (policy.enabled ? "ENABLED" : "DISABLED") << "\n";
+                std::cout << "Attempts admitted:          " << stats.allowed << "\n";
+                std::cout << "Rejected (global limit):    " << stats.rejectedGlobal << "\n";
+                std::cout << "Rejected (per-user limit):  " << stats.rejectedUser << "\n";
+                std::cout << "Rejected (locked out):      " << stats.rejectedLockout << "\n";
+                std::cout << "Rejected (table full):      " << stats.rejectedTableFull << "\n";
+                std::cout << "Lockouts started:           " << stats.lockouts << "\n";
+                std::cout << "Tracked usernames:          " << stats.trackedUsernames << " / " << stats.tableSlots << "\n";
+                std::cout << "Table evictions:            " << stats.evictions << "\n";
+                std::cout << "Limits: " << policy.userBurst << " burst + " << policy.userRatePerSecond
+                          << "/s per user, " << policy.globalBurst << " burst + " << policy.globalRatePerSecond
+                          << "/s global, lockout after " << policy.lockoutThreshold << " failures\n";
+                std::cout << "Press Enter to continue...";
+                std::cin.get();
+                break;
+            }
+            case 4: {
+                auto caches = g_reportModule->getCacheStats();
+                caches["payment_report"] = g_paymentModule->getReportCacheStats();
+                std::cout << "\n--- Report Cache Statistics ---\n";
+                std::cout << std::left << std::setw(20) << "Report" << std::right << std::setw(8) << "Hits"
+                          << std::setw(8) << "Misses" << std::setw(10) << "Hit rate" << std::setw(14) << "Invalidated"
+                          << std::setw(9) << "Evicted" << std::setw(9) << "Cached" << "\n";
+                for (const auto& cache : caches) {
+                    const ReportCacheStats& stats = cache.second;
+                    uint64_t lookups = stats.hits + stats.misses;
+                    std::cout << std::left << std::setw(20) << cache.first << std::right << std::setw(8) << stats.hits
+                              << std::setw(8) << stats.misses << std::setw(9) << std::fixed << std::setprecision(1)
+                              << (lookups > 0 ? 100.0 * stats.hits / lookups : 0.0) << "%"
+                              << std::setw(14) << stats.invalidations << std::setw(9) << stats.evictions
+                              << std::setw(9) << stats.entries << "\n";
+                }
+                std::cout << "Entries are dropped when a payment or crew shift inside their period changes.\n";
+                std::cout << "Press Enter to continue...";
+                std::cin.get();
+                break;
+            }
+            case 5: {
+                static const char* typeNames[] = {"int", "decimal", "text", "timestamp"};
+                std::cout << "\n--- Ad-hoc Data Query ---\n";
+                for (const auto& table : ReportManager::ReportModule::getQuerySchema()) {
+                    std::cout << table.first << ":";
+                    for (const auto& column : table.second) {
+                        std::cout << " " << column.first << "(" << typeNames[static_cast<int>(column.second)] << ")";
+                    }
+                    std::cout << "\n";
+                }
+                std::cout << "\nSyntax: <table> [count] [sum|avg|min|max=<column>] [by=<column>[:day|:month|:year],...] "
+                          << "[where=<column><op><value>]...  (op: = != < <= > >=)\n";
+                std::cout << "Example: tickets by=concert_id,status where=status!=AVAILABLE\n";
+                std::cout << "Enter query (blank to go back): ";
+                std::string text;
+                std::getline(std::cin, text);
+                if (text.find_first_not_of(" \t") == std::string::npos) break;
+                
+                auto result = g_reportModule->runQuery(text);
+                if (!result.ok) {
+                    std::cout << "❌ " << result.error << "\n";
+                    break;
+                }
+                for (const auto& name : result.keyNames) {
+                    std::cout << std::left << std::setw(20) << name;
+                }
+                std::cout << std::right << std::setw(10) << "count";
+                for (const auto& name : result.valueNames) {
+                    std::cout << std::setw(20) << name;
+                }
+                std::cout << "\n" << std::string(20 * (result.keyNames.size() + result.valueNames.size()) + 10, '-') << "\n";
+                for (const auto& row : result.rows) {
+                    for (const auto& key : row.keys) {
+                        std::cout << std::left << std::setw(20) << key;
+                    }
+                    std::cout << std::right << std::setw(10) << row.count;
+                    for (double value : row.values) {
+                        std::cout << std::setw(20) << std::fixed << std::setprecision(2) << value;
+                    }
+                    std::cout << "\n";
+                }
+                std::cout << result.rows.size() << " groups from " << result.rowsMatched << " of " << result.rowsScanned
+                          << " rows (" << result.batches << " batches, " << result.threads << " threads, "
+                          << std::fixed << std::setprecision(3) << result.seconds * 1000.0 << " ms)\n";
+                std::cout << "Press Enter to continue...";
+                std::cin.get();
+                break;
+            }
             case 0:
                 return;
             default:
-                std::cout << "❌ Invalid choice. Please select 0-2.\n";
+                std::cout << "❌ Invalid choice. Please select 0-5.\n";
         }
     }
 }
@@ -3461,7 +3768,7 @@ void purchaseTickets() {
                 double amount = basePrice * multiplier * static_cast<double>(quantity);
 
                 // 7) Process payment
-                if (!currentSession.isAuthenticated) {
+                if (!isSessionActive()) {
                     std::cout << "❌ You must be logged in to purchase.\n";
                     break;
                 }
@@ -4102,7 +4409,7 @@ void manageProfile() {
                     // In a real system, we'd filter by current user's attendee ID
                     // For demo purposes, show recent payments
                     std::cout << "💳 Payment ID: " << payment->payment_id << std::endl;
-                    std::cout << "   Amount: $" << std::fixed << std::setprecision(2) << payment->amount << std::endl;
+                    std::cout << "   Amount: " << payment->amount.toString(payment->currency) << " " << payment->currency << std::endl;
                     std::cout << "   Date: " << payment->payment_date_time.iso8601String << std::endl;
                     std::cout << "   Method: " << payment->payment_method << std::endl;
                     std::cout << "   Status: ";
@@ -4304,7 +4611,7 @@ int main() {
         }
         
         // Main application loop after successful authentication
-        while (currentSession.isAuthenticated) {
+        while (isSessionActive()) {
             displayMainMenu();
             
             std::string choiceStr;
@@ -0,0 +1,188 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include "include/models.hpp"
+#include "include/columnarSnapshot.hpp"
+
+// Offline queries over an analytics snapshot written by ReportModule::exportColumnarSnapshot
+// Usage:
+//   snapshotQuery <snapshot> info
+//   snapshotQuery <snapshot> revenue [from] [to]
+//   snapshotQuery <snapshot> query <table> [sum=<column>] [by=<column>[:day|:month|:year],...] [where=<column><op><value>]...
+// where <op> is one of = != >= <=, e.g.
+//   snapshotQuery data/exports/analytics.mcol query tickets by=concert_id,status where=created_at>=2030-01
+
+void displaySeparator(char symbol = '-', int length = 70) {
+    std::cout << std::string(length, symbol) << std::endl;
+}
+
+void printUsage() {
+    std::cout << "Usage:\n"
+              << "  snapshotQuery <snapshot> info\n"
+              << "  snapshotQuery <snapshot> revenue [from] [to]\n"
+              << "  snapshotQuery <snapshot> query <table> [sum=<column>] [by=<column>[:day|:month|:year],...] "
+              << "[where=<column><op><value>]...\n";
+}
+
+const char* typeName(Columnar::ColumnType type) {
+    switch (type) {
+        case Columnar::ColumnType::INT64: return "int64";
+        case Columnar::ColumnType::STRING: return "string";
+        case Columnar::ColumnType::TIMESTAMP: return "timestamp";
+        default: return "unknown";
+    }
+}
+
+// Parse "column<op>value" against the table's column types
+bool parseFilter(const Columnar::Snapshot::Table& table, const std::string& text, Columnar::Filter& filter) {
+    static const std::vector<std::pair<std::string, Columnar::Filter::Op>> ops = {
+        {"!=", Columnar::Filter::NE}, {">=", Columnar::Filter::GE}, {"<=", Columnar::Filter::LE}, {"=", Columnar::Filter::EQ}};
+    for (const auto& op : ops) {
+        size_t at = text.find(op.first);
+        if (at == std::string::npos || at == 0) {
+            continue;
+        }
+        filter.column = text.substr(0, at);
+        filter.op = op.second;
+        std::string value = text.substr(at + op.first.size());
+        const Columnar::Snapshot::Column* column = table.column(filter.column);
+        if (!column) {
+            return false;
+        }
+        if (column->type == Columnar::ColumnType::STRING) {
+            filter.text = value;
+        } else if (column->type == Columnar::ColumnType::TIMESTAMP) {
+            filter.value = Columnar::packTimestamp(value, op.second == Columnar::Filter::LE);
+            if (filter.value == 0) {
+                return false;
+            }
+        } else {
+            char* end = nullptr;
+            filter.value = std::strtoll(value.c_str(), &end, 10);
+            if (value.empty() || *end != '\0') {
+                return false;
+            }
+        }
+        return true;
+    }
+    return false;
+}
+
+void printResult(const Columnar::QueryResult& result, const std::string& sumLabel, int currencyKey = -1) {
+    for (const auto& name : result.keyNames) {
+        std::cout << std::left << std::setw(16) << name;
+    }
+    std::cout << std::right << std::setw(12) << "count";
+    if (!sumLabel.empty()) {
+        std::cout << std::setw(18) << sumLabel;
+    }
+    std::cout << std::endl;
+    displaySeparator();
+    for (const auto& row : result.rows) {
+        for (const auto& key : row.keys) {
+            std::cout << std::left << std::setw(16) << key;
+        }
+        std::cout << std::right << std::setw(12) << row.count;
+        if (!sumLabel.empty()) {
+            if (currencyKey >= 0) {
+                // Amounts are minor units of the row's currency
+                const std::string& currency = row.keys[static_cast<size_t>(currencyKey)];
+                std::cout << std::setw(18) << Model::Money{row.sum}.toString(currency);
+            } else {
+                std::cout << std::setw(18) << row.sum;
+            }
+        }
+        std::cout << std::endl;
+    }
+    displaySeparator();
+    std::cout << result.rows.size() << " groups from " << result.rowsMatched << " rows; " << result.blocksScanned
+              << " blocks scanned, " << result.blocksSkipped << " skipped; " << std::fixed << std::setprecision(3)
+              << result.seconds * 1000.0 << " ms" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        printUsage();
+        return 1;
+    }
+    Columnar::Snapshot snapshot;
+    if (!snapshot.open(argv[1])) {
+        std::cerr << "Cannot open snapshot: " << argv[1] << std::endl;
+        return 1;
+    }
+    std::string command = argv[2];
+
+    if (command == "info") {
+        for (const auto& table : snapshot.getTables()) {
+            std::cout << table.name << " (" << table.rows << " rows, " << table.blockRows << " rows per block)" << std::endl;
+            for (const auto& column : table.columns) {
+                std::cout << "  " << std::left << std::setw(16) << column.name << std::setw(10) << typeName(column.type);
+                if (column.type == Columnar::ColumnType::STRING) {
+                    std::cout << column.dictionary.size() << " distinct";
+                }
+                std::cout << std::endl;
+            }
+        }
+        return 0;
+    }
+
+    Columnar::Query query;
+    std::string sumLabel;
+    int currencyKey = -1;
+    if (command == "revenue") {
+        // Net takings by concert by month, per currency; refunds are negative records
+        query.table = "payments";
+        query.groupBy = {{"concert_id", Columnar::Bucket::NONE}, {"paid_at", Columnar::Bucket::MONTH},
+                         {"currency", Columnar::Bucket::NONE}};
+        query.sumColumn = "amount_minor";
+        query.filters.push_back({"status", Columnar::Filter::NE, 0, "PENDING"});
+        query.filters.push_back({"status", Columnar::Filter::NE, 0, "FAILED"});
+        if (argc > 3) query.filters.push_back({"paid_at", Columnar::Filter::GE, Columnar::packTimestamp(argv[3]), ""});
+        if (argc > 4) query.filters.push_back({"paid_at", Columnar::Filter::LE, Columnar::packTimestamp(argv[4], true), ""});
+        sumLabel = "net revenue";
+        currencyKey = 2;
+    } else if (command == "query" && argc > 3) {
+        query.table = argv[3];
+        const Columnar::Snapshot::Table* table = snapshot.table(query.table);
+        if (!table) {
+            std::cerr << "Unknown table: " << query.table << std::endl;
+            return 1;
+        }
+        for (int i = 4; i < argc; ++i) {
+            std::string argument = argv[i];
+            if (argument.rfind("sum=", 0) == 0) {
+                query.sumColumn = argument.substr(4);
+                sumLabel = "sum(" + query.sumColumn + ")";
+            } else if (argument.rfind("by=", 0) == 0) {
+                std::string error;
+                if (!Columnar::parseGroupBy(argument.substr(3), query.groupBy, error)) {
+                    std::cerr << "Bad group-by: " << argument << std::endl;
+                    return 1;
+                }
+            } else if (argument.rfind("where=", 0) == 0) {
+                Columnar::Filter filter;
+                if (!parseFilter(*table, argument.substr(6), filter)) {
+                    std::cerr << "Bad filter: " << argument << std::endl;
+                    return 1;
+                }
+                query.filters.push_back(filter);
+            } else {
+                printUsage();
+                return 1;
+            }
+        }
+    } else {
+        printUsage();
+        return 1;
+    }
+
+    Columnar::QueryResult result = Columnar::runQuery(snapshot, query);
+    if (!result.ok) {
+        std::cerr << "Query failed: " << result.error << std::endl;
+        return 1;
+    }
+    printResult(result, sumLabel, currencyKey);
+    return 0;
+}
@@ -3,6 +3,7 @@
 #include <string>
 #include <iomanip>
 #include <vector>
+#include <cstdio>
 #include "../include/models.hpp"
 #include "../include/attendeeModule.hpp"
 
@@ -295,6 +296,82 @@ void testDeleteOperations(AttendeeModule& module, std::vector<std::shared_ptr<Mo
     std::cout << "Delete result: " << (nonExistentDelete ? "Succeeded (unexpected)" : "Failed (expected)") << std::endl;
 }
 
+// Test the joined attendee overview (profile + tickets + payments + refunds + feedback)
+void testAttendeeOverview(AttendeeModule& module, const std::vector<std::shared_ptr<Model::Attendee>>& testAttendees) {
+    displayHeader("ATTENDEE OVERVIEW TEST");
+    
+    if (testAttendees.empty()) {
+        std::cout << "No test attendees available for overview testing." << std::endl;
+        return;
+    }
+    
+    const char* files[] = {"test_overview_tickets.dat", "test_overview_payments.dat",
+                           "test_overview_payments.dat.rollup", "test_overview_payments.dat.log",
+                           "test_overview_feedback.dat"};
+    for (const char* file : files) {
+        std::remove(file);
+    }
+    
+    int attendeeId = testAttendees[0]->getId();
+    int ticketId = 0, paymentId = 0;
+    {
+        TicketManager::TicketModule tickets("test_overview_tickets.dat");
+        PaymentManager::PaymentModule payments("test_overview_payments.dat");
+        FeedbackModule feedback("test_overview_feedback.dat");
+        
+        ticketId = tickets.createTicket(attendeeId, 7, "Regular");
+        paymentId = payments.createPayment(attendeeId, 80.0, "USD", "Credit Card", "TXN_OVERVIEW_1");
+        payments.updatePaymentStatus(paymentId, Model::PaymentStatus::COMPLETED);
+        payments.processRefund(paymentId, 30.0, "Partial refund");
+        feedback.createFeedback(7, attendeeId, 4, "Great show");
+        
+        // Another attendee's history must not leak into the view
+        tickets.createTicket(attendeeId + 1000, 7, "Regular");
+        payments.createPayment(attendeeId + 1000, 10.0, "USD", "Credit Card", "TXN_OVERVIEW_2");
+        
+        auto overview = module.getAttendeeOverview(attendeeId, tickets, payments, feedback);
+        std::cout << "Profile: " << (overview.profile ? overview.profile->name : "[missing]") << std::endl;
+        std::cout << "Tickets: " << overview.tickets.size() << " (expected 1)" << std::endl;
+        for (const auto& line : overview.tickets) {
+            std::cout << "  Ticket " << line.ticket->ticket_id << " -> " << line.concert_name << std::endl;
+        }
+        std::cout << "Payments: " << overview.payments.size() << " (expected 1)" << std::endl;
+        std::cout << "Refunds: " << overview.refunds.size() << " (expected 1)" << std::endl;
+        std::cout << "Feedback: " << overview.feedbacks.size() << " (expected 1)" << std::endl;
+        
+        bool passed = overview.profile && overview.tickets.size() == 1 &&
+                      overview.tickets[0].ticket->ticket_id == ticketId &&
+                      overview.tickets[0].concert_id == 7 &&
+                      overview.payments.size() == 1 && overview.refunds.size() == 1 &&
+                      overview.feedbacks.size() == 1;
+        std::cout << "Overview join: " << (passed ? "PASS" : "FAIL") << std::endl;
+        
+        auto missing = module.getAttendeeOverview(9999, tickets, payments, feedback);
+        std::cout << "Unknown attendee returns empty view: " << (!missing.profile ? "PASS" : "FAIL") << std::endl;
+    }
+    
+    // The per-attendee indexes are rebuilt from the files after a restart
+    {
+        AttendeeModule attendees; // Same default file as the module under test
+        TicketManager::TicketModule tickets("test_overview_tickets.dat");
+        PaymentManager::PaymentModule payments("test_overview_payments.dat");
+        FeedbackModule feedback("test_overview_feedback.dat");
+        
+        auto overview = attendees.getAttendeeOverview(attendeeId, tickets, payments, feedback);
+        bool passed = overview.profile && overview.profile->name == testAttendees[0]->name &&
+                      overview.tickets.size() == 1 && overview.tickets[0].ticket->ticket_id == ticketId &&
+                      overview.tickets[0].concert_id == 7 &&
+                      overview.payments.size() == 1 && overview.payments[0]->payment_id == paymentId &&
+                      overview.refunds.size() == 1 && overview.feedbacks.size() == 1 &&
+                      overview.feedbacks[0]->comments == "Great show";
+        std::cout << "Overview after reload: " << (passed ? "PASS" : "FAIL") << std::endl;
+    }
+    
+    for (const char* file : files) {
+        std::remove(file);
+    }
+}
+
 // Main testing function
 int main() {
     std::cout << "\n\n";
@@ -320,6 +397,10 @@ int main() {
         testUpdateOperations(module, testAttendees);
         std::cout << "\n\n";
         
+        // Test joined OVERVIEW query
+        testAttendeeOverview(module, testAttendees);
+        std::cout << "\n\n";
+        
         // Test DELETE operations
         testDeleteOperations(module, testAttendees);
         
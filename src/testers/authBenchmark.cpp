@@ -0,0 +1,116 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <future>
+#include <cstdlib>
+#include "../include/authModule.hpp"
+
+// Login throughput benchmark: synchronous verification vs. the worker pool
+// Usage: authBenchmark [users=16] [logins=200] [iterations=AuthModule::DEFAULT_KDF_ITERATIONS]
+
+// Utility function to display a separator line
+void displaySeparator(char symbol = '-', int length = 50) {
+    std::cout << std::string(length, symbol) << std::endl;
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char* argv[]) {
+    int userCount = argc > 1 ? std::atoi(argv[1]) : 16;
+    int loginCount = argc > 2 ? std::atoi(argv[2]) : 200;
+    uint32_t iterations = argc > 3 ? static_cast<uint32_t>(std::atoi(argv[3]))
+                                   : AuthModule::DEFAULT_KDF_ITERATIONS;
+    if (userCount <= 0 || loginCount <= 0 || iterations == 0) {
+        std::cerr << "Usage: authBenchmark [users] [logins] [iterations]" << std::endl;
+        return 1;
+    }
+
+    displaySeparator('=');
+    std::cout << "AUTH LOGIN THROUGHPUT BENCHMARK" << std::endl;
+    displaySeparator('=');
+    std::cout << "Users: " << userCount << ", logins: " << loginCount
+              << ", KDF iterations: " << iterations
+              << ", hardware threads: " << std::thread::hardware_concurrency() << std::endl;
+
+    AuthModule auth(4096, "bench_auth.dat");
+    auth.setKdfIterations(iterations);
+    
+    // Measure raw verification throughput; throttling is exercised separately below
+    AuthModule::ThrottlePolicy defaultPolicy = auth.getThrottlePolicy();
+    AuthModule::ThrottlePolicy unthrottled;
+    unthrottled.enabled = false;
+    auth.setThrottlePolicy(unthrottled);
+
+    // Bulk provisioning: parallel hashing, one durable commit
+    std::vector<std::string> usernames;
+    std::vector<std::pair<std::string, std::string>> accounts;
+    for (int i = 0; i < userCount; ++i) {
+        usernames.push_back("bench.user" + std::to_string(i));
+        accounts.emplace_back(usernames.back(), "benchpass" + std::to_string(i));
+    }
+    auto provisionStart = std::chrono::steady_clock::now();
+    size_t provisioned = auth.registerUsers(accounts);
+    double provisionSeconds = secondsSince(provisionStart);
+
+    // Synchronous: one login at a time on the calling thread
+    int syncSuccesses = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < loginCount; ++i) {
+        int u = i % userCount;
+        if (auth.authenticateUser(usernames[u], "benchpass" + std::to_string(u))) {
+            ++syncSuccesses;
+        }
+    }
+    double syncSeconds = secondsSince(start);
+
+    // Asynchronous: all logins submitted to the verification pool
+    int asyncSuccesses = 0;
+    start = std::chrono::steady_clock::now();
+    std::vector<std::future<bool>> pending;
+    pending.reserve(loginCount);
+    for (int i = 0; i < loginCount; ++i) {
+        int u = i % userCount;
+        pending.push_back(auth.authenticateUserAsync(usernames[u], "benchpass" + std::to_string(u)));
+    }
+    for (auto& result : pending) {
+        if (result.get()) {
+            ++asyncSuccesses;
+        }
+    }
+    double asyncSeconds = secondsSince(start);
+
+    displaySeparator();
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "Provisioning: " << provisioned << " new users, "
+              << (provisioned / provisionSeconds) << " users/sec" << std::endl;
+    std::cout << "Synchronous:  " << syncSuccesses << "/" << loginCount << " ok, "
+              << (loginCount / syncSeconds) << " logins/sec" << std::endl;
+    std::cout << "Worker pool:  " << asyncSuccesses << "/" << loginCount << " ok, "
+              << (loginCount / asyncSeconds) << " logins/sec" << std::endl;
+    std::cout << std::setprecision(2) << "Speedup: " << (syncSeconds / asyncSeconds) << "x" << std::endl;
+
+    // Password spray with the default throttle: most attempts never reach the KDF
+    auth.setThrottlePolicy(defaultPolicy);
+    int sprayAttempts = loginCount * 10;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < sprayAttempts; ++i) {
+        auth.authenticateUser(usernames[i % userCount], "guess" + std::to_string(i));
+    }
+    double spraySeconds = secondsSince(start);
+    AuthModule::ThrottleStats stats = auth.getThrottleStats();
+    std::cout << std::setprecision(1) << "Spray:        " << sprayAttempts << " bad attempts in "
+              << spraySeconds << "s, shed " << (stats.rejectedGlobal + stats.rejectedUser + stats.rejectedLockout +
+                                                    stats.rejectedTableFull)
+              << ", lockouts " << stats.lockouts << std::endl;
+    
+    auth.setThrottlePolicy(unthrottled);
+    for (const auto& username : usernames) {
+        auth.deleteUser(username);
+    }
+
+    return (syncSuccesses == loginCount && asyncSuccesses == loginCount) ? 0 : 1;
+}
@@ -1,6 +1,10 @@
 #include <iostream>
 #include <string>
 #include <memory>
+#include <cstring>
+#include <future>
+#include <vector>
+#include <algorithm>
 #include "../include/models.hpp"
 #include "../include/authModule.hpp"
 
@@ -177,6 +181,371 @@ void testCredentialPersistence(AuthModule& auth) {
     std::cout << "John Doe authentication " << (userType >= 0 ? "successful" : "failed") << std::endl;
 }
 
+// Test key derivation, cost upgrade and asynchronous verification
+void testKdfAndAsyncVerification() {
+    displayHeader("KDF COST & ASYNC VERIFICATION TEST");
+    
+    // RFC 7914 section 11 PBKDF2-HMAC-SHA256 vector: P="password", S="salt", c=1
+    const unsigned char expected[32] = {
+        0x12, 0x0f, 0xb6, 0xcf, 0xfc, 0xf8, 0xb3, 0x2c, 0x43, 0xe7, 0x22, 0x52, 0x56, 0xc4, 0xf8, 0x37,
+        0xa8, 0x65, 0x48, 0xc9, 0x2c, 0xcc, 0x35, 0x48, 0x08, 0x05, 0x98, 0x7c, 0xb7, 0x0b, 0xe1, 0x7b
+    };
+    unsigned char derived[32];
+    const unsigned char salt[] = {'s', 'a', 'l', 't'};
+    AuthCrypto::pbkdf2Sha256("password", salt, sizeof(salt), 1, derived, sizeof(derived));
+    bool vectorMatch = std::memcmp(derived, expected, sizeof(expected)) == 0;
+    std::cout << "PBKDF2 known-answer vector: " << (vectorMatch ? "PASS" : "FAIL") << std::endl;
+    
+    AuthModule auth(4096, "test_kdf_auth.dat");
+    auth.deleteUser("kdf.user");
+    
+    // Register at a low cost, then raise the configured cost
+    auth.setKdfIterations(1000);
+    auth.registerUser("kdf.user", "kdfpass");
+    std::cout << "Stored cost after registration: " << auth.getCredentialCost("kdf.user") << std::endl;
+    
+    auth.setKdfIterations(2000);
+    bool loggedIn = auth.authenticateUser("kdf.user", "kdfpass");
+    long long upgradedCost = auth.getCredentialCost("kdf.user");
+    std::cout << "Login after raising cost: " << (loggedIn ? "PASS" : "FAIL") << std::endl;
+    std::cout << "Credential upgraded to new cost: " << (upgradedCost == 2000 ? "PASS" : "FAIL") << std::endl;
+    std::cout << "Login after upgrade: " << (auth.authenticateUser("kdf.user", "kdfpass") ? "PASS" : "FAIL") << std::endl;
+    
+    // Asynchronous verification returns the same answers as the synchronous path
+    std::future<bool> good = auth.authenticateUserAsync("kdf.user", "kdfpass");
+    std::future<bool> bad = auth.authenticateUserAsync("kdf.user", "wrongpass");
+    std::future<bool> missing = auth.authenticateUserAsync("nobody", "kdfpass");
+    bool asyncOk = good.get() && !bad.get() && !missing.get();
+    std::cout << "Async verification results: " << (asyncOk ? "PASS" : "FAIL") << std::endl;
+    
+    auth.deleteUser("kdf.user");
+}
+
+// Test session tokens
+void testSessionTokens() {
+    displayHeader("SESSION TOKEN TEST");
+    
+    AuthModule auth(4096, "test_session_auth.dat");
+    auth.setKdfIterations(1000);
+    auth.registerUser("session.user", "sessionpass");
+    
+    std::string badToken = auth.login("session.user", "wrongpass");
+    std::cout << "Login with wrong password yields no token: " << (badToken.empty() ? "PASS" : "FAIL") << std::endl;
+    
+    std::string token = auth.login("session.user", "sessionpass");
+    std::cout << "Login issues token: " << (!token.empty() ? "PASS" : "FAIL") << std::endl;
+    std::cout << "Token validates: " << (auth.validateSession(token) ? "PASS" : "FAIL") << std::endl;
+    std::cout << "Session role is REGULAR: " << (auth.getSessionRole(token) == 0 ? "PASS" : "FAIL") << std::endl;
+    std::cout << "Session username: " << (auth.getSessionUsername(token) == "session.user" ? "PASS" : "FAIL") << std::endl;
+    std::cout << "Unknown token rejected: " << (!auth.validateSession("not-a-token") ? "PASS" : "FAIL") << std::endl;
+    
+    std::string second = auth.login("session.user", "sessionpass");
+    std::cout << "Tokens are unique: " << (second != token ? "PASS" : "FAIL") << std::endl;
+    
+    bool revoked = auth.revokeSession(token);
+    std::cout << "Revoked token rejected: " << (revoked && !auth.validateSession(token) ? "PASS" : "FAIL") << std::endl;
+    std::cout << "Other session unaffected: " << (auth.validateSession(second) ? "PASS" : "FAIL") << std::endl;
+    
+    auth.deleteUser("session.user");
+    std::cout << "Deleting user ends its sessions: " << (!auth.validateSession(second) ? "PASS" : "FAIL") << std::endl;
+    
+    // Short-lived session expires on its own
+    auth.registerUser("session.user", "sessionpass");
+    auth.setSessionTimeout(1);
+    std::string shortLived = auth.login("session.user", "sessionpass");
+    std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+    std::cout << "Expired token rejected: " << (!auth.validateSession(shortLived) ? "PASS" : "FAIL") << std::endl;
+    std::cout << "Active sessions: " << auth.getActiveSessionCount() << std::endl;
+    auth.deleteUser("session.user");
+}
+
+// Test that deleted blocks are reused without clobbering live users
+void testBlockReuse() {
+    displayHeader("CREDENTIAL BLOCK REUSE TEST");
+    
+    AuthModule auth(4096, "test_reuse_auth.dat");
+    auth.setKdfIterations(1000);
+    const char* names[] = {"reuse.a", "reuse.b", "reuse.c"};
+    for (const char* name : names) {
+        auth.deleteUser(name);
+        auth.registerUser(name, std::string(name) + "-pw");
+    }
+    
+    // Deleting the middle user frees its block; the next registration must take
+    // that block instead of overwriting the last user's block
+    auth.deleteUser("reuse.b");
+    auth.registerUser("reuse.d", "reuse.d-pw");
+    
+    bool allValid = auth.authenticateUser("reuse.a", "reuse.a-pw") &&
+                    auth.authenticateUser("reuse.c", "reuse.c-pw") &&
+                    auth.authenticateUser("reuse.d", "reuse.d-pw") &&
+                    !auth.authenticateUser("reuse.b", "reuse.b-pw");
+    std::cout << "Live users intact after delete + register: " << (allValid ? "PASS" : "FAIL") << std::endl;
+    
+    // Growing past the first slab keeps earlier blocks in place
+    for (int i = 0; i < 300; ++i) {
+        auth.registerUser("reuse.bulk" + std::to_string(i), "bulkpass");
+    }
+    bool afterGrowth = auth.authenticateUser("reuse.a", "reuse.a-pw") &&
+                       auth.authenticateUser("reuse.bulk299", "bulkpass");
+    std::cout << "Users intact after slab growth: " << (afterGrowth ? "PASS" : "FAIL") << std::endl;
+    
+    // Reload from disk and check the same accounts
+    AuthModule reloaded(4096, "test_reuse_auth.dat");
+    bool afterReload = reloaded.authenticateUser("reuse.c", "reuse.c-pw") &&
+                       reloaded.authenticateUser("reuse.d", "reuse.d-pw") &&
+                       reloaded.getUserCount() == auth.getUserCount();
+    std::cout << "Users intact after reload: " << (afterReload ? "PASS" : "FAIL") << std::endl;
+    
+    for (int i = 0; i < 300; ++i) {
+        auth.deleteUser("reuse.bulk" + std::to_string(i));
+    }
+    for (const char* name : {"reuse.a", "reuse.c", "reuse.d"}) {
+        auth.deleteUser(name);
+    }
+}
+
+// Test incremental persistence and bulk provisioning
+void testIncrementalPersistence() {
+    displayHeader("INCREMENTAL PERSISTENCE TEST");
+    
+    const std::string path = "test_incremental_auth.dat";
+    std::vector<std::pair<std::string, std::string>> accounts;
+    for (int i = 0; i < 50; ++i) {
+        accounts.emplace_back("bulk.user" + std::to_string(i), "bulkpass" + std::to_string(i));
+    }
+    accounts.emplace_back("bulk.user0", "duplicate");
+    
+    {
+        AuthModule auth(4096, path);
+        auth.setKdfIterations(1000);
+        for (const auto& account : accounts) {
+            auth.deleteUser(account.first);
+        }
+        size_t registered = auth.registerUsers(accounts);
+        std::cout << "Bulk registration (duplicates skipped): " << (registered == 50 ? "PASS" : "FAIL") << std::endl;
+        
+        for (int i = 0; i < 10; ++i) {
+            auth.deleteUser("bulk.user" + std::to_string(i));
+        }
+        auth.changePassword("bulk.user10", "bulkpass10", "changed10");
+    }
+    
+    // A fresh instance sees every change without any full save having happened
+    AuthModule reopened(4096, path);
+    bool countOk = reopened.getUserCount() == 40;
+    bool deletedGone = !reopened.userExists("bulk.user0") && !reopened.userExists("bulk.user9");
+    bool changedOk = reopened.authenticateUser("bulk.user10", "changed10") &&
+                     !reopened.authenticateUser("bulk.user10", "bulkpass10");
+    bool untouchedOk = reopened.authenticateUser("bulk.user49", "bulkpass49");
+    std::cout << "User count after reopen: " << (countOk ? "PASS" : "FAIL") << std::endl;
+    std::cout << "Deletions persisted: " << (deletedGone ? "PASS" : "FAIL") << std::endl;
+    std::cout << "Password change persisted: " << (changedOk ? "PASS" : "FAIL") << std::endl;
+    std::cout << "Bulk-registered user persisted: " << (untouchedOk ? "PASS" : "FAIL") << std::endl;
+    
+    for (const auto& account : accounts) {
+        reopened.deleteUser(account.first);
+    }
+}
+
+// Test that only usernames that fit a credential block are stored
+void testUsernameLimits() {
+    displayHeader("USERNAME LIMITS TEST");
+    
+    const std::string path = "test_names_auth.dat";
+    std::remove(path.c_str());
+    std::remove((path + ".journal").c_str());
+    const std::string longest(63, 'n');
+    const std::string tooLong(64, 'n');
+    
+    {
+        AuthModule auth(4096, path);
+        auth.setKdfIterations(1000);
+        std::cout << "63-character name accepted: " << (auth.registerUser(longest, "pw") ? "PASS" : "FAIL") << std::endl;
+        std::cout << "64-character name rejected: " << (!auth.registerUser(tooLong, "pw") ? "PASS" : "FAIL") << std::endl;
+        std::cout << "Empty name rejected: " << (!auth.registerUser("", "pw") ? "PASS" : "FAIL") << std::endl;
+        size_t bulk = auth.registerUsers({{tooLong + "x", "pw"}, {"names.short", "pw"}});
+        std::cout << "Bulk skips long names: " << (bulk == 1 ? "PASS" : "FAIL") << std::endl;
+    }
+    
+    AuthModule reloaded(4096, path);
+    bool intact = reloaded.getUserCount() == 2 && reloaded.authenticateUser(longest, "pw") &&
+                  reloaded.authenticateUser("names.short", "pw");
+    std::cout << "Stored names survive reload: " << (intact ? "PASS" : "FAIL") << std::endl;
+}
+
+// Test that one bad journal record does not hide the records after it
+void testJournalReplay() {
+    displayHeader("JOURNAL REPLAY TEST");
+    
+    const std::string path = "test_replay_auth.dat";
+    std::remove(path.c_str());
+    std::remove((path + ".journal").c_str());
+    {
+        AuthModule auth(4096, path);
+        auth.setKdfIterations(1000);
+        auth.registerUser("replay.a", "pw-a");
+    }
+    
+    // Complete records an older build could write: an over-long name and an unknown op
+    FILE* journal = std::fopen((path + ".journal").c_str(), "ab");
+    const std::string longName(70, 'L');
+    size_t offset = 0, length = longName.size();
+    for (char op : {'P', 'X'}) {
+        std::fwrite(&op, 1, 1, journal);
+        std::fwrite(&offset, sizeof(offset), 1, journal);
+        std::fwrite(&length, sizeof(length), 1, journal);
+        std::fwrite(longName.data(), 1, length, journal);
+    }
+    std::fclose(journal);
+    
+    {
+        AuthModule auth(4096, path);
+        auth.setKdfIterations(1000);
+        auth.registerUser("replay.b", "pw-b");
+        auth.registerUser("replay.c", "pw-c");
+        std::cout << "Users before reload: " << auth.getUserCount() << std::endl;
+    }
+    
+    AuthModule reloaded(4096, path);
+    bool intact = reloaded.getUserCount() == 3 && reloaded.authenticateUser("replay.a", "pw-a") &&
+                  reloaded.authenticateUser("replay.b", "pw-b") && reloaded.authenticateUser("replay.c", "pw-c");
+    std::cout << "Records after a bad record replayed: " << (intact ? "PASS" : "FAIL") << std::endl;
+    std::cout << "Over-long name not mapped: " << (!reloaded.userExists(longName) ? "PASS" : "FAIL") << std::endl;
+}
+
+// Test that a store whose journal was lost keeps its users across reloads
+void testJournalLoss() {
+    displayHeader("JOURNAL LOSS TEST");
+    
+    const std::string path = "test_lost_journal_auth.dat";
+    std::remove(path.c_str());
+    std::remove((path + ".journal").c_str());
+    {
+        AuthModule auth(4096, path);
+        auth.setKdfIterations(1000);
+        auth.registerUser("lost.a", "pw-a");
+        auth.registerUser("lost.b", "pw-b");
+    }
+    std::remove((path + ".journal").c_str());
+    
+    {
+        AuthModule rebuilt(4096, path);
+        std::cout << "Users rebuilt from blocks: " << (rebuilt.getUserCount() == 2 ? "PASS" : "FAIL") << std::endl;
+    }
+    
+    AuthModule reloaded(4096, path);
+    bool intact = reloaded.getUserCount() == 2 && reloaded.authenticateUser("lost.a", "pw-a") &&
+                  reloaded.authenticateUser("lost.b", "pw-b");
+    std::cout << "Rebuilt users survive a second reload: " << (intact ? "PASS" : "FAIL") << std::endl;
+}
+
+// Test the role index and paginated listings
+void testRoleIndex() {
+    displayHeader("ROLE INDEX & PAGINATION TEST");
+    
+    AuthModule auth(4096, "test_roles_auth.dat");
+    auth.setKdfIterations(1000);
+    std::vector<std::pair<std::string, std::string>> accounts;
+    for (int i = 0; i < 25; ++i) {
+        accounts.emplace_back("role.user" + std::string(i < 10 ? "0" : "") + std::to_string(i), "rolepass");
+    }
+    auth.registerUsers(accounts);
+    auth.setUserType("role.user03", 1);
+    auth.setUserType("role.user07", 2);
+    auth.setUserType("role.user08", 2);
+    
+    std::cout << "Admin listing: " << (auth.getAdminUsers().size() == 1 ? "PASS" : "FAIL") << std::endl;
+    std::cout << "Staff listing: " << (auth.getStaffUsers().size() == 2 ? "PASS" : "FAIL") << std::endl;
+    std::cout << "Regular count: " << (auth.getUserCountByType(0) == 22 ? "PASS" : "FAIL") << std::endl;
+    std::cout << "Invalid role rejected: " << (!auth.setUserType("role.user00", 7) ? "PASS" : "FAIL") << std::endl;
+    
+    // Walk all users ten at a time and check order and completeness
+    std::vector<std::string> walked;
+    std::string cursor;
+    while (true) {
+        auto page = auth.getUsernamesPage(-1, cursor, 10);
+        walked.insert(walked.end(), page.begin(), page.end());
+        if (page.size() < 10) break;
+        cursor = page.back();
+    }
+    bool sorted = std::is_sorted(walked.begin(), walked.end());
+    std::cout << "Paginated walk covers all users in order: "
+              << (walked.size() == auth.getUserCount() && sorted ? "PASS" : "FAIL") << std::endl;
+    
+    auto staffPage = auth.getUsernamesPage(2, "role.user07", 10);
+    std::cout << "Role page after cursor: "
+              << (staffPage.size() == 1 && staffPage[0] == "role.user08" ? "PASS" : "FAIL") << std::endl;
+    
+    // Role survives reload and follows the session
+    std::string token = auth.login("role.user03", "rolepass");
+    auth.setUserType("role.user03", 2);
+    std::cout << "Session sees role change: " << (auth.getSessionRole(token) == 2 ? "PASS" : "FAIL") << std::endl;
+    AuthModule reloaded(4096, "test_roles_auth.dat");
+    std::cout << "Role persisted: " << (reloaded.getUserType("role.user03") == 2 ? "PASS" : "FAIL") << std::endl;
+    
+    auth.deleteUser("role.user07");
+    std::cout << "Deleted user leaves index: " << (auth.getStaffUsers().size() == 2 &&
+                                                  auth.getUserType("role.user07") == -1 ? "PASS" : "FAIL") << std::endl;
+    
+    for (const auto& account : accounts) {
+        auth.deleteUser(account.first);
+    }
+}
+
+// Test login throttling and lockout
+void testLoginThrottling() {
+    displayHeader("LOGIN THROTTLING TEST");
+    
+    AuthModule auth(4096, "test_throttle_auth.dat");
+    auth.setKdfIterations(1000);
+    auth.registerUser("throttle.user", "rightpass");
+    auth.registerUser("throttle.other", "otherpass");
+    
+    AuthModule::ThrottlePolicy policy;
+    policy.userBurst = 3.0;
+    policy.userRatePerSecond = 0.01;
+    policy.lockoutThreshold = 3;
+    policy.lockoutBaseSeconds = 60.0;
+    auth.setThrottlePolicy(policy);
+    
+    // Successful logins refund their token, so they are never throttled
+    bool repeatedOk = true;
+    for (int i = 0; i < 10; ++i) {
+        repeatedOk = repeatedOk && auth.authenticateUser("throttle.user", "rightpass");
+    }
+    std::cout << "Repeated good logins allowed: " << (repeatedOk ? "PASS" : "FAIL") << std::endl;
+    
+    // Three failures lock the account; even the right password is then refused
+    for (int i = 0; i < 3; ++i) {
+        auth.authenticateUser("throttle.user", "wrong" + std::to_string(i));
+    }
+    bool lockedOut = !auth.authenticateUser("throttle.user", "rightpass");
+    std::cout << "Locked out after failures: " << (lockedOut ? "PASS" : "FAIL") << std::endl;
+    std::cout << "Retry-after reported: " << (auth.getRetryAfterSeconds("throttle.user") > 0 ? "PASS" : "FAIL") << std::endl;
+    std::cout << "Other users unaffected: " << (auth.authenticateUser("throttle.other", "otherpass") ? "PASS" : "FAIL") << std::endl;
+    
+    // Spraying unknown usernames drains the global bucket, not memory
+    policy.globalBurst = 20.0;
+    policy.globalRatePerSecond = 0.01;
+    auth.setThrottlePolicy(policy);
+    for (int i = 0; i < 10000; ++i) {
+        auth.authenticateUser("spray" + std::to_string(i), "guess");
+    }
+    AuthModule::ThrottleStats stats = auth.getThrottleStats();
+    std::cout << "Global bucket shed spray: " << (stats.rejectedGlobal > 9000 ? "PASS" : "FAIL") << std::endl;
+    std::cout << "Table stays fixed-size: " << (stats.trackedUsernames <= stats.tableSlots ? "PASS" : "FAIL") << std::endl;
+    // Eviction never recycles a slot that is still locked out
+    bool stillLocked = auth.getRetryAfterSeconds("throttle.user") > 0 && !auth.authenticateUser("throttle.user", "rightpass");
+    std::cout << "Lockout survives spray: " << (stillLocked ? "PASS" : "FAIL") << std::endl;
+    std::cout << "Admitted " << stats.allowed << ", rejected global/user/lockout "
+              << stats.rejectedGlobal << "/" << stats.rejectedUser << "/" << stats.rejectedLockout
+              << ", lockouts " << stats.lockouts << ", evictions " << stats.evictions << std::endl;
+    
+    auth.deleteUser("throttle.user");
+    auth.deleteUser("throttle.other");
+}
+
 // Interactive test mode
 void interactiveTestMode(AuthModule& auth) {
     displayHeader("INTERACTIVE AUTH MODULE TEST");
@@ -351,6 +720,33 @@ int main(int argc, char* argv[]) {
             std::cout << "\n\n";
             
             testCredentialPersistence(authModule);
+            std::cout << "\n\n";
+            
+            testKdfAndAsyncVerification();
+            std::cout << "\n\n";
+            
+            testSessionTokens();
+            std::cout << "\n\n";
+            
+            testBlockReuse();
+            std::cout << "\n\n";
+            
+            testIncrementalPersistence();
+            std::cout << "\n\n";
+            
+            testUsernameLimits();
+            std::cout << "\n\n";
+            
+            testJournalReplay();
+            std::cout << "\n\n";
+            
+            testJournalLoss();
+            std::cout << "\n\n";
+            
+            testRoleIndex();
+            std::cout << "\n\n";
+            
+            testLoginThrottling();
             
             displayHeader("TEST COMPLETED SUCCESSFULLY");
             
@@ -131,6 +131,91 @@ int main() {
         assert(baseEntities.size() >= 4); // Should have at least 4 base feedback entities
         std::cout << "✓ Dual-layer storage working correctly" << std::endl;
         
+        // Test 9: Keyword matcher and sentiment lexicon
+        std::cout << "\n--- Test 9: Keyword Matcher and Sentiment Lexicon ---" << std::endl;
+        
+        KeywordMatcher matcher;
+        matcher.addKeyword("bad", 0);
+        matcher.addKeyword("crowd crush", 1);
+        matcher.addKeyword("disappoint*", 2);
+        matcher.build();
+        std::vector<int> hits;
+        auto collect = [&hits](int keyword, int) { hits.push_back(keyword); };
+        
+        matcher.scan("Lost my badge at the Sinbad show", collect);
+        assert(hits.empty()); // Whole words only
+        matcher.scan("BAD seats, near a Crowd Crush and DISAPPOINTING sound. Bad!", collect);
+        assert((hits == std::vector<int>{0, 1, 2, 0})); // Case-folded, phrases and prefixes in one pass
+        hits.clear();
+        matcher.scan("Sound was 'bad', the crowd's mood \"bad\" too", collect);
+        assert((hits == std::vector<int>{0, 0})); // Quotes are boundaries
+        hits.clear();
+        matcher.scan("bad's", collect);
+        assert(hits.empty()); // An apostrophe between letters is part of the word
+        
+        KeywordMatcher allBytes;
+        std::string everyByte;
+        for (int c = 255; c >= 0; --c) {
+            everyByte += static_cast<char>(c); // Ends in byte 0, so not a prefix keyword
+        }
+        allBytes.addKeyword(everyByte, 0);
+        allBytes.addKeyword("z", 1);
+        allBytes.build();
+        hits.clear();
+        allBytes.scan("a z " + everyByte, collect);
+        assert((hits == std::vector<int>{1, 0})); // Every byte value gets its own class
+        
+        FeedbackManager::collectFeedback(103, 1005, 3, "Badge pickup was slow but the show was great");
+        FeedbackManager::collectFeedback(103, 1006, 3, "The stage smelled of smoke");
+        auto event103 = FeedbackManager::viewEventFeedback(103);
+        assert(event103.size() == 2);
+        assert(event103[0]->sentiment == SentimentType::POSITIVE); // "bad" does not match "Badge"
+        assert(event103[1]->sentiment == SentimentType::NEUTRAL);
+        
+        FeedbackManager::collectFeedback(104, 1005, 3, "A fan was injured near the barrier");
+        FeedbackManager::collectFeedback(104, 1006, 3, "Two fires started behind the bar");
+        FeedbackManager::collectFeedback(104, 1007, 3, "The fireworks were amazing");
+        auto event104 = FeedbackManager::viewEventFeedback(104);
+        assert(event104.size() == 3);
+        assert(event104[0]->sentiment == SentimentType::CRITICAL); // "injur*" covers "injured"
+        assert(event104[1]->sentiment == SentimentType::CRITICAL); // "fires" listed explicitly
+        assert(event104[2]->sentiment == SentimentType::POSITIVE); // "fire" does not match "fireworks"
+        
+        {
+            std::ofstream lexicon("test_sentiment_lexicon.txt");
+            lexicon << "# Test lexicon\npositive great\nnegative slow\ncritical smoke  # new hazard\n";
+        }
+        assert(module.loadSentimentLexicon("test_sentiment_lexicon.txt"));
+        assert(event103[0]->sentiment == SentimentType::NEUTRAL); // One positive, one negative
+        assert(event103[1]->sentiment == SentimentType::CRITICAL);
+        assert(event103[1]->requires_escalation);
+        
+        {
+            std::ofstream lexicon("test_sentiment_lexicon.txt");
+            lexicon << "positive great\nangry terrible\n";
+        }
+        assert(!module.loadSentimentLexicon("test_sentiment_lexicon.txt")); // Unknown category
+        assert(!module.loadSentimentLexicon("missing_sentiment_lexicon.txt"));
+        assert(event103[1]->sentiment == SentimentType::CRITICAL); // Previous lexicon kept
+        std::remove("test_sentiment_lexicon.txt");
+        std::cout << "✓ Keywords matched as whole words in one pass; lexicon reload re-classifies feedback" << std::endl;
+        
+        // Test 10: Deleted feedback leaves the attendee index
+        std::cout << "\n--- Test 10: Attendee Index After Delete ---" << std::endl;
+        
+        std::remove("test_feedback_index.dat");
+        {
+            FeedbackModule indexed("test_feedback_index.dat");
+            auto submitted = indexed.createFeedback(105, 2001, 4, "Solid set");
+            assert(indexed.getFeedbackByAttendee(2001).size() == 1);
+            int id = static_cast<int>(std::hash<std::string>{}(submitted->submitted_at.iso8601String) % 1000000);
+            assert(indexed.deleteEntity(id));
+            assert(indexed.getAll().empty());
+            assert(indexed.getFeedbackByAttendee(2001).empty());
+        }
+        std::remove("test_feedback_index.dat");
+        std::cout << "✓ Deleted feedback no longer listed for its attendee" << std::endl;
+        
         std::cout << "\n=== All Advanced Feedback Module Tests Passed! ===" << std::endl;
         
         // Summary
@@ -143,6 +228,7 @@ int main() {
         std::cout << "✓ Dual-layer storage: Raw feedback + In-memory analysis" << std::endl;
         std::cout << "✓ Pointer-optimized sentiment scoring with priority queue" << std::endl;
         std::cout << "✓ Per-event feedback file serialization" << std::endl;
+        std::cout << "✓ Single-pass keyword matching with a reloadable sentiment lexicon" << std::endl;
         
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << std::endl;
@@ -0,0 +1,92 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include "../include/paymentModule.hpp"
+
+// End-to-end payment throughput: blocking processPayment vs. the async gateway pipeline
+// Usage: paymentBenchmark [payments=200] [latencyMs=20] [workers=8] [failureRate=0.05]
+
+// Utility function to display a separator line
+void displaySeparator(char symbol = '-', int length = 50) {
+    std::cout << std::string(length, symbol) << std::endl;
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char* argv[]) {
+    int paymentCount = argc > 1 ? std::atoi(argv[1]) : 200;
+    int latencyMs = argc > 2 ? std::atoi(argv[2]) : 20;
+    int workers = argc > 3 ? std::atoi(argv[3]) : 8;
+    double failureRate = argc > 4 ? std::atof(argv[4]) : 0.05;
+    if (paymentCount <= 0 || latencyMs < 0 || workers <= 0 || failureRate < 0.0 || failureRate > 1.0) {
+        std::cerr << "Usage: paymentBenchmark [payments] [latencyMs] [workers] [failureRate]" << std::endl;
+        return 1;
+    }
+
+    displaySeparator('=');
+    std::cout << "PAYMENT PIPELINE THROUGHPUT BENCHMARK" << std::endl;
+    displaySeparator('=');
+    std::cout << "Payments: " << paymentCount << ", gateway latency: " << latencyMs
+              << " ms, workers: " << workers << ", failure rate: " << failureRate << std::endl;
+
+    std::remove("bench_payments.dat");
+    std::remove("bench_payments.dat.rollup");
+    std::remove("bench_payments.dat.log");
+    int syncCompleted = 0, asyncCompleted = 0, asyncFailed = 0;
+    double syncSeconds = 0.0, asyncSeconds = 0.0;
+    {
+        PaymentManager::PaymentModule payments("bench_payments.dat");
+        payments.setGateway(std::make_shared<PaymentManager::SimulatedGateway>(latencyMs, failureRate), workers);
+
+        // Blocking: each purchase waits for its gateway round-trip
+        int syncCount = std::max(1, paymentCount / 10);
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < syncCount; ++i) {
+            if (!payments.processPayment(1, 25.0, "USD", "Credit Card").empty()) {
+                ++syncCompleted;
+            }
+        }
+        syncSeconds = secondsSince(start) / syncCount * paymentCount; // Extrapolated to the full run
+
+        // Pipelined: submit everything, then collect the verdicts
+        start = std::chrono::steady_clock::now();
+        std::vector<PaymentManager::PaymentModule::PaymentSubmission> pending;
+        pending.reserve(paymentCount);
+        for (int i = 0; i < paymentCount; ++i) {
+            pending.push_back(payments.submitPayment(1, 25.0, "USD", "Credit Card", "bench-" + std::to_string(i)));
+        }
+        double submitSeconds = secondsSince(start);
+        for (auto& submission : pending) {
+            if (submission.outcome.get() == Model::PaymentStatus::COMPLETED) {
+                ++asyncCompleted;
+            } else {
+                ++asyncFailed;
+            }
+        }
+        asyncSeconds = secondsSince(start);
+
+        displaySeparator();
+        std::cout << std::fixed << std::setprecision(1);
+        std::cout << "Blocking:   " << (paymentCount / syncSeconds) << " payments/sec ("
+                  << syncCompleted << "/" << syncCount << " sampled completed)" << std::endl;
+        std::cout << "Pipelined:  " << (paymentCount / asyncSeconds) << " payments/sec ("
+                  << asyncCompleted << " completed, " << asyncFailed << " declined)" << std::endl;
+        std::cout << "Submission: " << (paymentCount / submitSeconds) << " requests/sec accepted without blocking" << std::endl;
+        std::cout << std::setprecision(2) << "Speedup: " << (syncSeconds / asyncSeconds) << "x" << std::endl;
+        auto commits = payments.getCommitStats();
+        std::cout << "Group commit: " << commits.records << " log records in " << commits.batches << " fsyncs ("
+                  << (commits.batches ? static_cast<double>(commits.records) / commits.batches : 0.0) << " per fsync)" << std::endl;
+    }
+    std::remove("bench_payments.dat");
+    std::remove("bench_payments.dat.rollup");
+    std::remove("bench_payments.dat.log");
+
+    return asyncCompleted + asyncFailed == paymentCount ? 0 : 1;
+}
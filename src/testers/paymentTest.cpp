@@ -3,6 +3,15 @@
 #include <string>
 #include <iomanip>
 #include <vector>
+#include <fstream>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+#ifndef _WIN32
+#include <csignal>
+#include <sys/resource.h>
+#endif
 #include "../include/models.hpp"
 #include "../include/paymentModule.hpp"
 
@@ -37,7 +46,7 @@ void displayPayment(const std::shared_ptr<Model::Payment>& payment, bool detaile
     }
     
     std::cout << "Payment ID: " << payment->payment_id << std::endl;
-    std::cout << "Amount: " << std::fixed << std::setprecision(2) << payment->amount 
+    std::cout << "Amount: " << std::fixed << std::setprecision(2) << payment->amount.toMajor(payment->currency)
               << " " << payment->currency << std::endl;
     
     if (detailed) {
@@ -77,7 +86,7 @@ void displayPaymentList(const std::vector<std::shared_ptr<Model::Payment>>& paym
     // Table rows
     for (const auto& payment : payments) {
         std::cout << std::setw(8) << payment->payment_id
-                  << std::setw(12) << std::fixed << std::setprecision(2) << payment->amount
+                  << std::setw(12) << std::fixed << std::setprecision(2) << payment->amount.toMajor(payment->currency)
                   << std::setw(8) << payment->currency
                   << std::setw(15) << payment->payment_method
                   << std::setw(12) << getPaymentStatusString(payment->status)
@@ -422,6 +431,405 @@ void testTransactionManagement(PaymentManager::PaymentModule& module) {
     std::cout << std::endl;
 }
 
+// Test indexed lookups (transaction, attendee, status)
+void testIndexedLookups(PaymentManager::PaymentModule& module) {
+    displayHeader("INDEXED LOOKUP TEST");
+    
+    int paymentId = module.createPayment(4242, 80.00, "USD", "Credit Card", "TXN_INDEX_LOOKUP_4242");
+    auto byTransaction = module.getPaymentByTransactionId("TXN_INDEX_LOOKUP_4242");
+    std::cout << "Lookup by transaction ID: " << (byTransaction && byTransaction->payment_id == paymentId ? "PASS" : "FAIL") << std::endl;
+    
+    auto isIn = [](const std::vector<std::shared_ptr<Model::Payment>>& payments, int id) {
+        for (const auto& payment : payments) {
+            if (payment->payment_id == id) return true;
+        }
+        return false;
+    };
+    std::cout << "Pending index contains new payment: "
+              << (isIn(module.getPaymentsByStatus(Model::PaymentStatus::PENDING), paymentId) ? "PASS" : "FAIL") << std::endl;
+    
+    module.handleTransactionCallback("TXN_INDEX_LOOKUP_4242", "completed", "OK");
+    bool moved = !isIn(module.getPaymentsByStatus(Model::PaymentStatus::PENDING), paymentId) &&
+                 isIn(module.getPaymentsByStatus(Model::PaymentStatus::COMPLETED), paymentId);
+    std::cout << "Callback moves payment between status buckets: " << (moved ? "PASS" : "FAIL") << std::endl;
+    std::cout << "Attendee index: " << (isIn(module.getPaymentsByAttendee(4242), paymentId) ? "PASS" : "FAIL") << std::endl;
+    
+    // Indexes are rebuilt from the file (attendee ID is persisted)
+    {
+        PaymentManager::PaymentModule reloaded("test_payments.dat");
+        bool reloadOk = reloaded.getPaymentByTransactionId("TXN_INDEX_LOOKUP_4242") &&
+                        isIn(reloaded.getPaymentsByAttendee(4242), paymentId) &&
+                        isIn(reloaded.getPaymentsByStatus(Model::PaymentStatus::COMPLETED), paymentId);
+        std::cout << "Indexes survive reload: " << (reloadOk ? "PASS" : "FAIL") << std::endl;
+    }
+    
+    module.deleteEntity(paymentId);
+    bool gone = !module.getPaymentByTransactionId("TXN_INDEX_LOOKUP_4242") &&
+                !isIn(module.getPaymentsByStatus(Model::PaymentStatus::COMPLETED), paymentId) &&
+                !module.getPaymentById(paymentId);
+    std::cout << "Delete drops payment from indexes: " << (gone ? "PASS" : "FAIL") << std::endl;
+}
+
+// Test rollup-backed revenue against a direct scan of the payments
+void testRevenueRollups(PaymentManager::PaymentModule& module) {
+    displayHeader("REVENUE ROLLUP TEST");
+    
+    auto scanRevenue = [](const std::vector<std::shared_ptr<Model::Payment>>& payments,
+                          const std::string& start, const std::string& end, const std::string& currency) {
+        double total = 0.0;
+        for (const auto& payment : payments) {
+            const std::string& stamp = payment->payment_date_time.iso8601String;
+            if (payment->status == Model::PaymentStatus::COMPLETED && payment->amount.minor > 0 &&
+                stamp >= start && stamp <= end && (currency.empty() || payment->currency == currency)) {
+                total += payment->amount.toMajor(payment->currency);
+            }
+        }
+        return total;
+    };
+    
+    module.processPayment(5151, 42.50, "EUR", "PayPal");
+    module.processPayment(5151, 17.25, "USD", "Credit Card");
+    
+    std::string now = Model::DateTime::now().iso8601String;
+    std::string today = now.substr(0, 10);
+    std::string hour = now.substr(0, 13);
+    struct Range { std::string label, start, end, currency; };
+    std::vector<Range> ranges = {
+        {"All time, USD only", "2020-01-01T00:00:00Z", "2030-12-31T23:59:59Z", "USD"},
+        {"Today, EUR only", today + "T00:00:00Z", today + "T23:59:59Z", "EUR"},
+        {"Mid-hour bounds, USD only", hour + ":00:01Z", hour + ":59:58Z", "USD"},
+        {"Empty range", "2030-01-01T00:00:00Z", "2020-01-01T00:00:00Z", "USD"}
+    };
+    for (const auto& range : ranges) {
+        double expected = scanRevenue(module.getAll(), range.start, range.end, range.currency);
+        double actual = module.calculateRevenue(range.start, range.end, range.currency);
+        std::cout << range.label << " revenue matches scan: "
+                  << (std::fabs(expected - actual) < 0.005 ? "PASS" : "FAIL") << std::endl;
+    }
+    
+    auto stats = module.getPaymentStatistics();
+    std::cout << "Statistics count every payment: "
+              << (stats.total_payments == static_cast<int>(module.getAll().size()) ? "PASS" : "FAIL") << std::endl;
+    
+    // Persisted rollups are used on reload; a missing rollup file is rebuilt from the payments
+    double allTime = module.calculateRevenue("2020-01-01T00:00:00Z", "2030-12-31T23:59:59Z", "USD");
+    {
+        PaymentManager::PaymentModule reloaded("test_payments.dat");
+        double reloadedTotal = reloaded.calculateRevenue("2020-01-01T00:00:00Z", "2030-12-31T23:59:59Z", "USD");
+        std::cout << "Rollups survive reload: " << (std::fabs(reloadedTotal - allTime) < 0.005 ? "PASS" : "FAIL") << std::endl;
+    }
+    std::remove("test_payments.dat.rollup");
+    {
+        PaymentManager::PaymentModule rebuilt("test_payments.dat");
+        double rebuiltTotal = rebuilt.calculateRevenue("2020-01-01T00:00:00Z", "2030-12-31T23:59:59Z", "USD");
+        std::cout << "Rollups rebuilt without rollup file: " << (std::fabs(rebuiltTotal - allTime) < 0.005 ? "PASS" : "FAIL") << std::endl;
+    }
+}
+
+// Test recent payments and cursor paging against a full sort
+void testRecentPaymentPaging(PaymentManager::PaymentModule& module) {
+    displayHeader("RECENT PAYMENTS PAGING TEST");
+    
+    // Newest first; payments stamped in the same second are ordered by ID
+    std::vector<std::shared_ptr<Model::Payment>> sorted = module.getAll();
+    std::sort(sorted.begin(), sorted.end(),
+        [](const std::shared_ptr<Model::Payment>& a, const std::shared_ptr<Model::Payment>& b) {
+            if (a->payment_date_time.iso8601String != b->payment_date_time.iso8601String) {
+                return a->payment_date_time.iso8601String > b->payment_date_time.iso8601String;
+            }
+            return a->payment_id > b->payment_id;
+        });
+    
+    auto recent = module.getRecentPayments(5);
+    bool topOk = recent.size() == std::min<size_t>(5, sorted.size()) &&
+                 std::equal(recent.begin(), recent.end(), sorted.begin());
+    std::cout << "Top 5 recent payments match full sort: " << (topOk ? "PASS" : "FAIL") << std::endl;
+    
+    PaymentManager::PaymentModule::PaymentCursor cursor;
+    std::vector<std::shared_ptr<Model::Payment>> paged;
+    while (true) {
+        auto page = module.getRecentPaymentsPage(cursor, 3);
+        paged.insert(paged.end(), page.begin(), page.end());
+        if (page.size() < 3) break;
+    }
+    std::cout << "Cursor paging visits every payment in order: " << (paged == sorted ? "PASS" : "FAIL") << std::endl;
+    
+    PaymentManager::PaymentModule::PaymentCursor completedCursor;
+    auto completedPage = module.getRecentPaymentsPage(completedCursor, 1000, Model::PaymentStatus::COMPLETED);
+    bool filterOk = completedPage.size() == module.getPaymentsByStatus(Model::PaymentStatus::COMPLETED).size();
+    for (const auto& payment : completedPage) {
+        filterOk = filterOk && payment->status == Model::PaymentStatus::COMPLETED;
+    }
+    std::cout << "Status-filtered paging: " << (filterOk ? "PASS" : "FAIL") << std::endl;
+}
+
+// Test fixed-point amounts, exact refunds and columnar sums
+void testFixedPointAmounts(PaymentManager::PaymentModule& module) {
+    displayHeader("FIXED-POINT AMOUNT TEST");
+    
+    Model::Money dime = Model::Money::fromMajor(0.1, "USD");
+    Model::Money sum = dime + Model::Money::fromMajor(0.2, "USD");
+    std::cout << "0.10 + 0.20 == 0.30 exactly: " << (sum == Model::Money::fromMajor(0.3, "USD") ? "PASS" : "FAIL") << std::endl;
+    std::cout << "Formatting (" << (-sum).toString("USD") << ", " << Model::Money{1234}.toString("JPY") << "): "
+              << ((-sum).toString("USD") == "-0.30" && Model::Money{1234}.toString("JPY") == "1234" ? "PASS" : "FAIL") << std::endl;
+    
+    // A price computed in floating point still refunds in full
+    std::string txn = module.processPayment(6161, 0.1 + 0.2, "USD", "Credit Card");
+    auto payment = module.getPaymentByTransactionId(txn);
+    std::string refundTxn = payment ? module.processRefund(payment->payment_id, 0.3, "Exact refund") : "";
+    bool fullRefund = !refundTxn.empty() && payment->status == Model::PaymentStatus::REFUNDED;
+    std::cout << "Refund of 0.3 fully refunds a 0.1 + 0.2 payment: " << (fullRefund ? "PASS" : "FAIL") << std::endl;
+    
+    // Columnar sums agree with the records, to the minor unit
+    int64_t completedUsd = 0, refundsIssued = 0;
+    for (const auto& p : module.getAll()) {
+        if (p->currency != "USD") continue;
+        if (p->status == Model::PaymentStatus::COMPLETED) completedUsd += p->amount.minor;
+        if (p->amount.minor < 0) refundsIssued += p->amount.minor;
+    }
+    std::cout << "Columnar completed USD sum: "
+              << (module.sumAmounts(Model::PaymentStatus::COMPLETED, "USD").minor == completedUsd ? "PASS" : "FAIL") << std::endl;
+    std::cout << "Columnar refund sum: "
+              << (module.sumAmounts(std::nullopt, "USD", -1).minor == refundsIssued ? "PASS" : "FAIL") << std::endl;
+    
+    // Amounts round-trip through the file in minor units
+    {
+        PaymentManager::PaymentModule reloaded("test_payments.dat");
+        auto again = reloaded.getPaymentByTransactionId(txn);
+        std::cout << "Amount survives reload: " << (again && again->amount == sum ? "PASS" : "FAIL") << std::endl;
+    }
+}
+
+// Test the asynchronous gateway pipeline with a declining, slow gateway
+void testGatewayPipeline(PaymentManager::PaymentModule& module) {
+    displayHeader("GATEWAY PIPELINE TEST");
+    
+    auto gateway = std::make_shared<PaymentManager::SimulatedGateway>(5, 0.5, 7);
+    module.setGateway(gateway, 4);
+    
+    std::vector<PaymentManager::PaymentModule::PaymentSubmission> submissions;
+    for (int i = 0; i < 20; ++i) {
+        submissions.push_back(module.submitPayment(7070, 10.0 + i, "USD", "Credit Card",
+                                                   "order-7070-" + std::to_string(i)));
+    }
+    auto retry = module.submitPayment(7070, 10.0, "USD", "Credit Card", "order-7070-0");
+    std::cout << "Retried idempotency key returns original payment: "
+              << (retry.transaction_id == submissions[0].transaction_id ? "PASS" : "FAIL") << std::endl;
+    
+    int completed = 0, failed = 0;
+    bool recordsMatch = true;
+    for (auto& submission : submissions) {
+        Model::PaymentStatus outcome = submission.outcome.get();
+        auto payment = module.getPaymentByTransactionId(submission.transaction_id);
+        recordsMatch = recordsMatch && payment && payment->status == outcome;
+        (outcome == Model::PaymentStatus::COMPLETED ? completed : failed)++;
+    }
+    std::cout << "Completed " << completed << ", declined " << failed << std::endl;
+    std::cout << "Callbacks settle every record: " << (recordsMatch && completed + failed == 20 ? "PASS" : "FAIL") << std::endl;
+    std::cout << "Gateway charged once per key: " << (gateway->getChargeCount() == 20 ? "PASS" : "FAIL") << std::endl;
+    std::cout << "Declines surface as failed payments: " << (failed > 0 && completed > 0 ? "PASS" : "FAIL") << std::endl;
+    
+    module.setGateway(std::make_shared<PaymentManager::SimulatedGateway>());
+}
+
+// Test date-versioned exchange rates and consolidated revenue
+void testCurrencyConversion(PaymentManager::PaymentModule& module) {
+    displayHeader("CURRENCY CONVERSION TEST");
+    
+    module.setExchangeRate("2000-01-01", "EUR", 0.5);
+    module.setExchangeRate("2999-01-01", "EUR", 0.25); // Not yet in effect
+    std::string today = Model::DateTime::now().iso8601String.substr(0, 10);
+    Model::Money converted = module.convertAmount(Model::Money::fromMajor(10.0, "EUR"), "EUR", "USD", today);
+    std::cout << "10.00 EUR -> " << converted.toString("USD") << " USD at the rate in effect: "
+              << (converted == Model::Money::fromMajor(20.0, "USD") ? "PASS" : "FAIL") << std::endl;
+    Model::Money future = module.convertAmount(Model::Money::fromMajor(10.0, "EUR"), "EUR", "USD", "2999-06-01");
+    std::cout << "Later rate version applies from its date: "
+              << (future == Model::Money::fromMajor(40.0, "USD") ? "PASS" : "FAIL") << std::endl;
+    
+    module.processPayment(8181, 30.00, "EUR", "PayPal");
+    int64_t expected = 0;
+    for (const auto& p : module.getAll()) {
+        if (p->status != Model::PaymentStatus::COMPLETED || p->amount.minor <= 0) continue;
+        if (p->currency == "USD") expected += p->amount.minor;
+        else if (p->currency == "EUR") expected += p->amount.minor * 2;
+    }
+    bool onlyUsdEur = true;
+    for (const auto& currency : module.getCurrencies()) {
+        onlyUsdEur = onlyUsdEur && (currency == "USD" || currency == "EUR");
+    }
+    if (onlyUsdEur) {
+        Model::Money consolidated = module.calculateConsolidatedRevenue("2020-01-01T00:00:00Z", "2030-12-31T23:59:59Z", "USD");
+        std::cout << "Consolidated revenue converts EUR days: " << (consolidated.minor == expected ? "PASS" : "FAIL") << std::endl;
+        Model::Money columnar = module.sumAmountsConverted(Model::PaymentStatus::COMPLETED, "USD", today, 1);
+        std::cout << "Columnar converted total agrees: " << (columnar.minor == expected ? "PASS" : "FAIL") << std::endl;
+    }
+    
+    // Rates load from a file; comments and malformed lines are skipped
+    {
+        std::ofstream rateFile("test_rates.txt");
+        rateFile << "# date currency per-USD\n2000-01-01 GBP 0.5  # test rate\nnot a rate line\n";
+    }
+    bool loaded = module.loadRateTable("test_rates.txt");
+    Model::Money pounds = module.convertAmount(Model::Money::fromMajor(1.0, "USD"), "USD", "GBP", today);
+    std::cout << "Rate file loaded: " << (loaded && pounds == Model::Money::fromMajor(0.5, "GBP") ? "PASS" : "FAIL") << std::endl;
+    std::remove("test_rates.txt");
+}
+
+// Test that cached payment reports are dropped only by writes inside their period
+void testReportCache(PaymentManager::PaymentModule& module) {
+    displayHeader("PAYMENT REPORT CACHE TEST");
+    const std::string pastStart = "2001-01-01T00:00:00Z", pastEnd = "2001-12-31T23:59:59Z";
+    const std::string allStart = "2020-01-01T00:00:00Z", allEnd = "2030-12-31T23:59:59Z";
+    
+    ReportCacheStats before = module.getReportCacheStats();
+    std::string past = module.generatePaymentReport(pastStart, pastEnd);
+    std::string all = module.generatePaymentReport(allStart, allEnd);
+    bool repeated = module.generatePaymentReport(pastStart, pastEnd) == past &&
+                    module.generatePaymentReport(allStart, allEnd) == all;
+    ReportCacheStats warm = module.getReportCacheStats();
+    std::cout << "Repeated reports served from cache: "
+              << (repeated && warm.hits - before.hits == 2 ? "PASS" : "FAIL") << std::endl;
+    
+    // A payment stamped today invalidates the open period but not 2001
+    int payment_id = module.createPayment(7070, 12.34, "USD", "Card", "TXN_CACHE_7070");
+    module.updatePaymentStatus(payment_id, Model::PaymentStatus::COMPLETED);
+    ReportCacheStats afterWrite = module.getReportCacheStats();
+    std::string refreshed = module.generatePaymentReport(allStart, allEnd);
+    module.generatePaymentReport(pastStart, pastEnd);
+    ReportCacheStats afterRead = module.getReportCacheStats();
+    std::cout << "Write inside the period invalidates it: "
+              << (refreshed != all && afterRead.misses - afterWrite.misses == 1 ? "PASS" : "FAIL") << std::endl;
+    std::cout << "Other periods stay cached: " << (afterRead.hits - afterWrite.hits == 1 ? "PASS" : "FAIL") << std::endl;
+    
+    module.setExchangeRate("2000-01-01", "JPY", 150.0);
+    ReportCacheStats afterRates = module.getReportCacheStats();
+    std::cout << "Rate change clears the cache: " << (afterRates.entries == 0 ? "PASS" : "FAIL") << std::endl;
+    std::cout << "Hits " << afterRates.hits << ", misses " << afterRates.misses
+              << ", invalidated " << afterRates.invalidations << std::endl;
+}
+
+// Test group-commit logging, replay and torn-tail recovery
+void testGroupCommit() {
+    displayHeader("GROUP COMMIT TEST");
+    const std::string path = "test_payments_commit.dat";
+    for (const char* suffix : {"", ".rollup", ".log"}) {
+        std::remove((path + suffix).c_str());
+    }
+    
+    const int threads = 8, perThread = 25;
+    {
+        PaymentManager::PaymentModule module(path);
+        module.setGroupCommitWindow(std::chrono::microseconds(2000));
+        std::vector<std::thread> writers;
+        for (int t = 0; t < threads; ++t) {
+            writers.emplace_back([&module, t]() {
+                for (int i = 0; i < perThread; ++i) {
+                    module.createPayment(9000 + t, 5.0, "USD", "Credit Card", "TXN_COMMIT_" + std::to_string(t) + "_" + std::to_string(i));
+                }
+            });
+        }
+        for (auto& writer : writers) {
+            writer.join();
+        }
+        auto stats = module.getCommitStats();
+        std::cout << "Records committed: " << stats.records << " in " << stats.batches << " fsyncs" << std::endl;
+        std::cout << "Concurrent writers share fsyncs: "
+                  << (stats.records == threads * perThread && stats.batches < stats.records ? "PASS" : "FAIL") << std::endl;
+        
+        auto first = module.getPaymentByTransactionId("TXN_COMMIT_0_0");
+        module.updatePaymentStatus(first ? first->payment_id : -1, Model::PaymentStatus::COMPLETED);
+        auto last = module.getPaymentByTransactionId("TXN_COMMIT_0_1");
+        module.deleteEntity(last ? last->payment_id : -1);
+    }
+    
+    // No checkpoint ran: the reload rebuilds everything from the snapshot plus the log
+    {
+        PaymentManager::PaymentModule reloaded(path);
+        auto first = reloaded.getPaymentByTransactionId("TXN_COMMIT_0_0");
+        bool replayed = reloaded.getAll().size() == threads * perThread - 1 &&
+                        first && first->status == Model::PaymentStatus::COMPLETED &&
+                        !reloaded.getPaymentByTransactionId("TXN_COMMIT_0_1") &&
+                        reloaded.getCommitStats().checkpoints == 0;
+        std::cout << "Log replays creates, updates and deletes: " << (replayed ? "PASS" : "FAIL") << std::endl;
+        std::cout << "Replayed rollups agree: "
+                  << (reloaded.calculateRevenue("2020-01-01T00:00:00Z", "2030-12-31T23:59:59Z", "USD") == 5.0 ? "PASS" : "FAIL") << std::endl;
+    }
+    
+    // A record cut short by a crash is dropped and the log is checkpointed away
+    {
+        std::ofstream log(path + ".log", std::ios::binary | std::ios::app);
+        log.write("U\x01\x02", 3);
+    }
+    {
+        PaymentManager::PaymentModule recovered(path);
+        auto stats = recovered.getCommitStats();
+        bool recoveredOk = recovered.getAll().size() == threads * perThread - 1 && stats.checkpoints == 1 && stats.logRecords == 0;
+        std::cout << "Torn log tail recovered: " << (recoveredOk ? "PASS" : "FAIL") << std::endl;
+        recovered.createPayment(9999, 1.0, "USD", "Cash", "TXN_COMMIT_AFTER");
+    }
+    {
+        PaymentManager::PaymentModule reopened(path);
+        std::cout << "Log usable after recovery: "
+                  << (reopened.getPaymentByTransactionId("TXN_COMMIT_AFTER") ? "PASS" : "FAIL") << std::endl;
+    }
+    for (const char* suffix : {"", ".rollup", ".log"}) {
+        std::remove((path + suffix).c_str());
+    }
+}
+
+#ifndef _WIN32
+// Test that writes which cannot be made durable fail instead of reporting success
+void testCommitFailure() {
+    displayHeader("COMMIT FAILURE TEST");
+    const std::string path = "test_payments_fail.dat";
+    for (const char* suffix : {"", ".rollup", ".log"}) {
+        std::remove((path + suffix).c_str());
+    }
+    
+    {
+        PaymentManager::PaymentModule module(path);
+        int kept = module.createPayment(9100, 20.0, "USD", "Cash", "TXN_FAIL_KEPT");
+        module.updatePaymentStatus(kept, Model::PaymentStatus::COMPLETED);
+        
+        // A file size limit makes both the log append and the checkpoint fail
+        struct rlimit saved;
+        getrlimit(RLIMIT_FSIZE, &saved);
+        struct rlimit tiny = saved;
+        tiny.rlim_cur = 16;
+        std::signal(SIGXFSZ, SIG_IGN);
+        setrlimit(RLIMIT_FSIZE, &tiny);
+        int lost = module.createPayment(9100, 5.0, "USD", "Cash", "TXN_FAIL_LOST");
+        std::string refund = module.processRefund(kept, 0.0, "Not durable");
+        auto submission = module.submitPayment(9100, 7.0, "USD", "Cash", "fail-key");
+        setrlimit(RLIMIT_FSIZE, &saved);
+        std::signal(SIGXFSZ, SIG_DFL);
+        
+        auto original = module.getPaymentById(kept);
+        std::cout << "Failed create reported and undone: "
+                  << (lost == -1 && !module.getPaymentByTransactionId("TXN_FAIL_LOST") ? "PASS" : "FAIL") << std::endl;
+        std::cout << "Failed refund reported and undone: "
+                  << (refund.empty() && original && original->status == Model::PaymentStatus::COMPLETED &&
+                      module.getPaymentsByAttendee(9100).size() == 1 ? "PASS" : "FAIL") << std::endl;
+        std::cout << "Failed submission rejected: " << (submission.transaction_id.empty() ? "PASS" : "FAIL") << std::endl;
+        std::cout << "Failed commits counted: " << (module.getCommitStats().failedCommits >= 3 ? "PASS" : "FAIL") << std::endl;
+        
+        // Once the disk accepts writes again a checkpoint replaces the broken log
+        int after = module.createPayment(9100, 9.0, "USD", "Cash", "TXN_FAIL_AFTER");
+        std::cout << "Writes succeed after recovery: " << (after > 0 ? "PASS" : "FAIL") << std::endl;
+    }
+    {
+        PaymentManager::PaymentModule reloaded(path);
+        bool persisted = reloaded.getAll().size() == 2 && reloaded.getPaymentByTransactionId("TXN_FAIL_KEPT") &&
+                         reloaded.getPaymentByTransactionId("TXN_FAIL_AFTER") &&
+                         !reloaded.getPaymentByTransactionId("TXN_FAIL_LOST");
+        std::cout << "Only durable payments reloaded: " << (persisted ? "PASS" : "FAIL") << std::endl;
+    }
+    for (const char* suffix : {"", ".rollup", ".log"}) {
+        std::remove((path + suffix).c_str());
+    }
+}
+#endif
+
 int main() {
     std::cout << "\n\n";
     displayHeader("PAYMENT MODULE COMPREHENSIVE TEST");
@@ -460,6 +868,43 @@ int main() {
         
         // Test TRANSACTION MANAGEMENT operations
         testTransactionManagement(module);
+        std::cout << "\n\n";
+        
+        // Test indexed lookups
+        testIndexedLookups(module);
+        std::cout << "\n\n";
+        
+        // Test revenue rollups
+        testRevenueRollups(module);
+        std::cout << "\n\n";
+        
+        // Test recent payments paging
+        testRecentPaymentPaging(module);
+        std::cout << "\n\n";
+        
+        // Test fixed-point amounts
+        testFixedPointAmounts(module);
+        std::cout << "\n\n";
+        
+        // Test the gateway pipeline
+        testGatewayPipeline(module);
+        std::cout << "\n\n";
+        
+        // Test currency conversion
+        testCurrencyConversion(module);
+        std::cout << "\n\n";
+        
+        // Test the payment report cache
+        testReportCache(module);
+        std::cout << "\n\n";
+        
+        // Test group-commit persistence
+        testGroupCommit();
+        
+#ifndef _WIN32
+        // Test durability failures
+        testCommitFailure();
+#endif
         
         displayHeader("TEST COMPLETED SUCCESSFULLY");
     }
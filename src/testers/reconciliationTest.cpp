@@ -0,0 +1,147 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include "../include/models.hpp"
+#include "../include/reconciliation.hpp"
+
+// Ticket/payment reconciliation test
+// Usage: reconciliationTest [scaleRows=2000000]
+
+// Utility function to display a separator line
+void displaySeparator(char symbol = '-', int length = 50) {
+    std::cout << std::string(length, symbol) << std::endl;
+}
+
+// Utility function to display a section header
+void displayHeader(const std::string& title) {
+    displaySeparator('=');
+    std::cout << title << std::endl;
+    displaySeparator('=');
+}
+
+int countType(const Reconciliation::ReconciliationResult& result, Reconciliation::MismatchType type, int attendee_id) {
+    int count = 0;
+    for (const auto& mismatch : result.mismatches) {
+        if (mismatch.type == type && mismatch.attendee_id == attendee_id) ++count;
+    }
+    return count;
+}
+
+// Test each mismatch kind on hand-built rows
+void testMismatchDetection() {
+    displayHeader("MISMATCH DETECTION TEST");
+    using Model::TicketStatus;
+    using Model::PaymentStatus;
+    using Reconciliation::MismatchType;
+
+    std::vector<Reconciliation::TicketRow> tickets = {
+        {1, 10, 100, TicketStatus::SOLD},        // Attendee 1: paid, fine
+        {1, 10, 101, TicketStatus::CHECKED_IN},
+        {2, 10, 102, TicketStatus::SOLD},        // Attendee 2: never paid
+        {4, 11, 104, TicketStatus::CANCELLED},   // Attendee 4: one cancellation, two partial refunds
+        {5, 11, 105, TicketStatus::CANCELLED},   // Attendee 5: refunded more than paid
+        {5, 11, 106, TicketStatus::CANCELLED},
+    };
+    std::vector<Reconciliation::PaymentRow> payments = {
+        {1, 1, 5000, 0, PaymentStatus::COMPLETED},
+        {3, 2, 2500, 0, PaymentStatus::COMPLETED},  // Attendee 3: no ticket at all
+        {4, 3, 4000, 0, PaymentStatus::COMPLETED},
+        {4, 4, -2000, 0, PaymentStatus::REFUNDED},
+        {4, 5, -2000, 0, PaymentStatus::REFUNDED},
+        {5, 6, 3000, 1, PaymentStatus::COMPLETED},
+        {5, 7, -2000, 1, PaymentStatus::REFUNDED},
+        {5, 8, -2000, 1, PaymentStatus::REFUNDED},
+        {1, 9, 500, 0, PaymentStatus::FAILED},      // Declined attempts are ignored
+    };
+    auto result = Reconciliation::reconcile(tickets, payments, {"USD", "EUR"});
+    for (const auto& mismatch : result.mismatches) {
+        std::cout << Reconciliation::mismatchTypeToString(mismatch.type) << " attendee " << mismatch.attendee_id
+                  << " record " << mismatch.record_id << ": " << mismatch.detail << std::endl;
+    }
+
+    std::cout << "Paid attendee is clean: " << (countType(result, MismatchType::ATTENDEE_UNPAID, 1) == 0 &&
+                                                   countType(result, MismatchType::ORPHAN_PAYMENT, 1) == 0 ? "PASS" : "FAIL") << std::endl;
+    std::cout << "Unpaid attendee detected: " << (countType(result, MismatchType::ATTENDEE_UNPAID, 2) == 1 ? "PASS" : "FAIL") << std::endl;
+    std::cout << "Orphan payment detected: " << (countType(result, MismatchType::ORPHAN_PAYMENT, 3) == 1 ? "PASS" : "FAIL") << std::endl;
+    std::cout << "Fully refunded payment is not orphaned: " << (countType(result, MismatchType::ORPHAN_PAYMENT, 4) == 0 &&
+                                                                  countType(result, MismatchType::ORPHAN_PAYMENT, 5) == 0 ? "PASS" : "FAIL") << std::endl;
+    std::cout << "Refund without a voided ticket: " << (countType(result, MismatchType::REFUND_WITHOUT_VOID, 4) == 1 ? "PASS" : "FAIL") << std::endl;
+    std::cout << "Double refund detected: " << (countType(result, MismatchType::DOUBLE_REFUND, 5) == 1 &&
+                                                  countType(result, MismatchType::DOUBLE_REFUND, 4) == 0 ? "PASS" : "FAIL") << std::endl;
+    std::cout << "Concert counts: " << (result.concerts[10].sold == 3 && result.concerts[10].unpaid == 1 &&
+                                          result.concerts[11].voided == 3 ? "PASS" : "FAIL") << std::endl;
+    std::cout << "Attendees joined: " << (result.attendees == 5 ? "PASS" : "FAIL") << std::endl;
+}
+
+// Test reconciliation against live ticket and payment modules
+void testModuleReconciliation() {
+    displayHeader("MODULE RECONCILIATION TEST");
+    std::remove("test_recon_tickets.dat");
+    for (const char* suffix : {"", ".rollup", ".log"}) {
+        std::remove((std::string("test_recon_payments.dat") + suffix).c_str());
+    }
+    {
+        TicketManager::TicketModule tickets("test_recon_tickets.dat");
+        PaymentManager::PaymentModule payments("test_recon_payments.dat");
+
+        tickets.createTicketSafe(501, 7, "Regular", true);
+        tickets.createTicketSafe(502, 7, "Regular", true);
+        tickets.createTicketInventory(7, 5, "Regular", 100); // Unsold stock is never owed a payment
+        payments.updatePaymentStatus(payments.createPayment(501, 80.0, "USD", "Card", "TXN_RECON_501"),
+                                     Model::PaymentStatus::COMPLETED);
+
+        auto result = Reconciliation::reconcile(tickets, payments);
+        std::cout << "Unsold inventory skipped: " << (result.tickets == 2 ? "PASS" : "FAIL") << std::endl;
+        bool onlyUnpaid = result.mismatches.size() == 1 &&
+                          result.mismatches[0].type == Reconciliation::MismatchType::ATTENDEE_UNPAID &&
+                          result.mismatches[0].attendee_id == 502 && result.mismatches[0].concert_id == 7;
+        std::cout << "Module rows reconcile: " << (onlyUnpaid ? "PASS" : "FAIL") << std::endl;
+    }
+    std::remove("test_recon_tickets.dat");
+    for (const char* suffix : {"", ".rollup", ".log"}) {
+        std::remove((std::string("test_recon_payments.dat") + suffix).c_str());
+    }
+}
+
+// Time one pass over a large synthetic ledger
+void testReconciliationScale(size_t rows) {
+    displayHeader("RECONCILIATION SCALE TEST");
+    std::vector<Reconciliation::TicketRow> tickets;
+    std::vector<Reconciliation::PaymentRow> payments;
+    tickets.reserve(rows);
+    payments.reserve(rows / 2);
+    uint32_t state = 12345;
+    auto next = [&state]() { state = state * 1664525u + 1013904223u; return state >> 8; };
+    int attendees = static_cast<int>(rows / 2);
+    for (size_t i = 0; i < rows; ++i) {
+        int attendee = 1 + static_cast<int>(next() % attendees);
+        tickets.push_back({attendee, static_cast<int>(next() % 50), static_cast<int>(i), Model::TicketStatus::SOLD});
+    }
+    for (int attendee = 1; attendee <= attendees; ++attendee) {
+        if (attendee % 1000 != 0) { // Every thousandth attendee never paid
+            payments.push_back({attendee, attendee, 10000, 0, Model::PaymentStatus::COMPLETED});
+        }
+    }
+    auto result = Reconciliation::reconcile(tickets, payments, {"USD"});
+    std::cout << rows << " tickets, " << payments.size() << " payments: " << result.mismatches.size()
+              << " mismatches in " << result.seconds << "s" << std::endl;
+    std::cout << "Millions of rows in seconds: " << (result.seconds < 5.0 ? "PASS" : "FAIL") << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    size_t scaleRows = argc > 1 ? static_cast<size_t>(std::atol(argv[1])) : 2000000;
+    displayHeader("RECONCILIATION COMPREHENSIVE TEST");
+
+    testMismatchDetection();
+    std::cout << "\n\n";
+
+    testModuleReconciliation();
+    std::cout << "\n\n";
+
+    testReconciliationScale(scaleRows);
+
+    displayHeader("TEST COMPLETED SUCCESSFULLY");
+    return 0;
+}
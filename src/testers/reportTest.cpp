@@ -3,6 +3,13 @@
 #include <string>
 #include <iomanip>
 #include <vector>
+#include <cstdio>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <ctime>
+#include <thread>
 #include "../include/models.hpp"
 #include "../include/reportModule.hpp"
 
@@ -278,6 +285,900 @@ void testReportGeneration(ReportManager::ReportModule& module) {
     std::cout << std::endl;
 }
 
+// Files of a fixture, removed when it is built and again once it is gone
+struct FixtureFiles {
+    std::vector<std::string> paths;
+    explicit FixtureFiles(std::vector<std::string> files) : paths(std::move(files)) { removeAll(); }
+    ~FixtureFiles() { removeAll(); }
+    void removeAll() const {
+        for (const auto& path : paths) {
+            std::remove(path.c_str());
+        }
+    }
+};
+
+// Fresh data modules on test_<name>_* files, detached from the report
+// module they were attached to before they close
+struct ReportFixture : FixtureFiles {
+    ConcertModule concerts;
+    TicketManager::TicketModule tickets;
+    PaymentManager::PaymentModule payments;
+    AttendeeModule attendees;
+    FeedbackModule feedback;
+    CrewModule crews;
+    ReportManager::ReportModule* attachedTo = nullptr;
+
+    explicit ReportFixture(const std::string& name, std::vector<std::string> extraFiles = {})
+        : FixtureFiles(fileNames(name, std::move(extraFiles))),
+          concerts("test_" + name + "_concerts.dat"), tickets("test_" + name + "_tickets.dat"),
+          payments("test_" + name + "_payments.dat"), attendees("test_" + name + "_attendees.dat"),
+          feedback("test_" + name + "_feedback.dat"), crews("test_" + name + "_crews.dat") {}
+
+    ~ReportFixture() {
+        if (attachedTo) {
+            attachedTo->attachDataSources({});
+        }
+    }
+
+    void attach(ReportManager::ReportModule& module, const ReportManager::ReportModule::DataSources& used) {
+        attachedTo = &module;
+        module.attachDataSources(used);
+    }
+
+    static std::vector<std::string> fileNames(const std::string& name, std::vector<std::string> files) {
+        for (const char* kind : {"concerts.dat", "tickets.dat", "payments.dat", "payments.dat.rollup",
+                                 "payments.dat.log", "attendees.dat", "feedback.dat", "crews.dat"}) {
+            files.push_back("test_" + name + "_" + kind);
+        }
+        return files;
+    }
+};
+
+// Test metrics computed from live modules
+void testLiveMetrics(ReportManager::ReportModule& module) {
+    displayHeader("LIVE METRICS TEST");
+    {
+        ReportFixture data("report");
+        
+        auto concert = data.concerts.createConcert("Live Test Concert", "Metrics fixture", "2030-06-01T19:00:00Z", "2030-06-01T23:00:00Z");
+        concert->ticketInfo = std::make_shared<Model::ConcertTicket>();
+        concert->ticketInfo->base_price = 50.0;
+        concert->ticketInfo->quantity_available = 2;
+        concert->ticketInfo->quantity_sold = 2;
+        auto first = data.attendees.createAttendee("Report Fan One", "fan1@example.com", "555-0101");
+        auto second = data.attendees.createAttendee("Report Fan Two", "fan2@example.com", "555-0102");
+        int checkedIn = data.tickets.createTicketSafe(first->id, concert->id, "Regular", true);
+        data.tickets.createTicketSafe(second->id, concert->id, "Regular", true);
+        data.tickets.updateTicketStatus(checkedIn, Model::TicketStatus::CHECKED_IN);
+        data.tickets.createTicketInventory(concert->id, 2, "Regular", 100);
+        int paid = data.payments.createPayment(first->id, 50.0, "USD", "Card", "TXN_REPORT_1");
+        data.payments.updatePaymentStatus(paid, Model::PaymentStatus::COMPLETED);
+        data.payments.updatePaymentStatus(data.payments.createPayment(second->id, 50.0, "USD", "Card", "TXN_REPORT_2"),
+                                     Model::PaymentStatus::COMPLETED);
+        data.payments.processRefund(paid, 10.0, "Partial refund");
+        data.feedback.createFeedback(concert->id, first->id, 5, "Great show");
+        data.feedback.createFeedback(concert->id, second->id, 2, "Too loud");
+        auto crew = data.crews.createCrewMember("Report Crew", "crew@example.com", "555-0199");
+        data.crews.assignTaskToCrew(crew->id, "Stage setup", "Set up the main stage");
+        Model::DateTime in, out;
+        in.iso8601String = "2030-06-01T14:00:00Z";
+        out.iso8601String = "2030-06-01T22:00:00Z";
+        crew->check_in_time = in;
+        crew->check_out_time = out;
+        
+        data.attach(module, {&data.concerts, &data.tickets, &data.payments, &data.attendees, &data.feedback, &data.crews});
+        
+        auto summary = module.calculateSummaryMetrics();
+        std::cout << "Summary: " << summary.total_concerts << " concerts, " << summary.total_tickets_sold
+                  << " tickets, revenue " << summary.total_revenue << ", NPS " << summary.nps_score << std::endl;
+        bool summaryOk = summary.total_concerts == 1 && summary.active_concerts == 1 &&
+                         summary.total_tickets_sold == 2 && summary.total_attendees == 2 &&
+                         std::fabs(summary.total_revenue - 90.0) < 0.005 &&
+                         std::fabs(summary.overall_satisfaction_score - 3.5) < 1e-9 && summary.nps_score == 0.0 &&
+                         summary.most_popular_concert == "Live Test Concert";
+        std::cout << "Summary metrics from live modules: " << (summaryOk ? "PASS" : "FAIL") << std::endl;
+        
+        auto metrics = module.getConcertMetrics(concert->id);
+        bool concertOk = metrics.concert_name == "Live Test Concert" && metrics.tickets_sold == 2 &&
+                         metrics.tickets_available == 2 && metrics.total_registrations == 2 &&
+                         std::fabs(metrics.sales_volume - 100.0) < 0.005 &&
+                         std::fabs(metrics.capacity_utilization - 50.0) < 1e-9 &&
+                         std::fabs(metrics.attendee_engagement_score - 6.5) < 1e-9 &&
+                         metrics.total_feedback_count == 2 && metrics.top_payment_method == "Card";
+        std::cout << "Concert metrics from live modules: " << (concertOk ? "PASS" : "FAIL") << std::endl;
+        
+        std::string today = Model::DateTime::now().iso8601String.substr(0, 10);
+        std::string sales = module.generateSalesAnalyticsReport(today, today, "TEXT");
+        std::cout << "Sales report totals: "
+                  << (sales.find("Total Sales: 90.00 USD") != std::string::npos &&
+                      sales.find("Number of Transactions: 2") != std::string::npos &&
+                      sales.find("Top Selling Concert: Live Test Concert") != std::string::npos ? "PASS" : "FAIL") << std::endl;
+        std::string payroll = module.generatePayrollReport("2030-06-01", "2030-06-01", "TEXT");
+        std::cout << "Payroll from crew hours: "
+                  << (payroll.find("Total Payroll: $200.00") != std::string::npos &&
+                      payroll.find("Number of Staff: 1") != std::string::npos ? "PASS" : "FAIL") << std::endl;
+        
+        auto timings = module.getReportTimings();
+        for (const auto& timing : timings) {
+            std::cout << timing.first << ": " << std::fixed << std::setprecision(3) << timing.second.total_ms << " ms";
+            for (const auto& scan : timing.second.scan_ms) {
+                std::cout << " [" << scan.first << " " << scan.second << " ms]";
+            }
+            std::cout << std::endl;
+        }
+        bool timed = timings.size() == 4 && timings["summary"].scan_ms.size() == 5 &&
+                     timings["payroll"].scan_ms.count("crews") == 1;
+        std::cout << "Per-report compute time recorded: " << (timed ? "PASS" : "FAIL") << std::endl;
+        
+    }
+}
+
+// Test that the dashboard follows module changes without rescanning
+void testLiveDashboard(ReportManager::ReportModule& module) {
+    displayHeader("LIVE DASHBOARD TEST");
+    {
+        ReportFixture data("dash");
+        
+        auto concert = data.concerts.createConcert("Dashboard Concert", "Live fixture", "2030-07-01T19:00:00Z", "2030-07-01T23:00:00Z");
+        concert->ticketInfo = std::make_shared<Model::ConcertTicket>();
+        concert->ticketInfo->base_price = 40.0;
+        concert->ticketInfo->quantity_available = 8;
+        concert->ticketInfo->quantity_sold = 2;
+        int early = data.tickets.createTicketSafe(301, concert->id, "Regular", true);
+        data.payments.updatePaymentStatus(data.payments.createPayment(301, 40.0, "USD", "Card", "TXN_DASH_301"),
+                                     Model::PaymentStatus::COMPLETED);
+        
+        // Seeded by one scan, then kept current by events
+        data.attach(module, {&data.concerts, &data.tickets, &data.payments, &data.attendees, &data.feedback, nullptr});
+        auto before = module.generateDashboardData();
+        std::cout << "Seeded from existing data: "
+                  << (before.summary.total_tickets_sold == 1 && std::fabs(before.summary.total_revenue - 40.0) < 0.005 ? "PASS" : "FAIL") << std::endl;
+        
+        data.tickets.createTicketInventory(concert->id, 3, "Regular", 100);
+        data.tickets.purchaseAvailableTicket(302, concert->id, "Regular");
+        int dropped = data.tickets.createTicketSafe(303, concert->id, "Regular", true);
+        data.tickets.updateTicketStatus(early, Model::TicketStatus::CHECKED_IN);
+        data.tickets.cancelTicket(dropped);
+        int second = data.payments.createPayment(302, 40.0, "USD", "Card", "TXN_DASH_302");
+        data.payments.updatePaymentStatus(second, Model::PaymentStatus::COMPLETED);
+        data.payments.processRefund(second, 15.0, "Partial refund");
+        data.payments.updatePaymentStatus(data.payments.createPayment(303, 40.0, "EUR", "PayPal", "TXN_DASH_303"),
+                                     Model::PaymentStatus::FAILED);
+        data.feedback.createFeedback(concert->id, 301, 5, "Loved it");
+        data.feedback.createFeedback(concert->id, 302, 1, "Could not see the stage");
+        data.attendees.createAttendee("Dashboard Fan", "dash@example.com", "555-0201");
+        
+        auto live = module.generateDashboardData();
+        auto scanned = module.calculateSummaryMetrics();
+        std::cout << "Dashboard: " << live.summary.total_tickets_sold << " tickets, revenue "
+                  << live.summary.total_revenue << ", NPS " << live.summary.nps_score << std::endl;
+        bool matches = live.summary.total_tickets_sold == 2 && scanned.total_tickets_sold == 2 &&
+                       std::fabs(live.summary.total_revenue - 65.0) < 0.005 &&
+                       std::fabs(live.summary.total_revenue - scanned.total_revenue) < 0.005 &&
+                       live.summary.nps_score == scanned.nps_score &&
+                       live.summary.overall_satisfaction_score == scanned.overall_satisfaction_score &&
+                       live.summary.total_attendees == 1 && live.summary.most_popular_concert == "Dashboard Concert";
+        std::cout << "Events match a full rescan: " << (matches ? "PASS" : "FAIL") << std::endl;
+        
+        bool concertOk = live.recent_concerts.size() == 1 && live.recent_concerts[0].tickets_sold == 2 &&
+                         live.recent_concerts[0].tickets_available == 2 && live.recent_concerts[0].total_registrations == 2 &&
+                         std::fabs(live.recent_concerts[0].attendee_engagement_score - 6.5) < 1e-9 &&
+                         live.total_capacity == 10;
+        std::cout << "Per-concert counts follow transitions: " << (concertOk ? "PASS" : "FAIL") << std::endl;
+        int dailyTickets = 0;
+        for (const auto& day : live.daily_ticket_sales) {
+            dailyTickets += day.second;
+        }
+        double weekRevenue = 0.0;
+        for (const auto& day : live.daily_revenue_trend) {
+            weekRevenue += day.second;
+        }
+        int weekCheckIns = 0;
+        for (const auto& day : live.daily_check_ins) {
+            weekCheckIns += day.second;
+        }
+        std::cout << "Daily trend follows transitions: "
+                  << (dailyTickets == 2 && live.daily_revenue_trend.size() == 7 && live.daily_ticket_sales.size() == 7 &&
+                      std::fabs(weekRevenue - 65.0) < 0.005 && weekCheckIns == 1 ? "PASS" : "FAIL") << std::endl;
+        
+        // Reads during a sale: gateway workers settle payments while the dashboard is read
+        data.payments.setGateway(std::make_shared<PaymentManager::SimulatedGateway>(1, 0.0), 4);
+        std::vector<PaymentManager::PaymentModule::PaymentSubmission> pending;
+        for (int i = 0; i < 40; ++i) {
+            pending.push_back(data.payments.submitPayment(400 + i, 10.0, "USD", "Card"));
+        }
+        int reads = 0;
+        for (auto& submission : pending) {
+            while (submission.outcome.wait_for(std::chrono::milliseconds(0)) != std::future_status::ready) {
+                module.generateDashboardData();
+                ++reads;
+            }
+        }
+        data.payments.setGateway(std::make_shared<PaymentManager::SimulatedGateway>(0, 0.0), 1); // Drain the pool
+        auto settled = module.generateDashboardData();
+        std::cout << reads << " dashboard reads during the sale, revenue now " << settled.summary.total_revenue << std::endl;
+        std::cout << "Concurrent payments applied: "
+                  << (std::fabs(settled.summary.total_revenue - 465.0) < 0.005 &&
+                      std::fabs(settled.summary.total_revenue - module.calculateSummaryMetrics().total_revenue) < 0.005 ? "PASS" : "FAIL") << std::endl;
+        
+        auto timings = module.getReportTimings();
+        std::cout << "Dashboard read " << timings["dashboard"].total_ms << " ms vs summary scan "
+                  << timings["summary"].total_ms << " ms" << std::endl;
+        std::cout << "Dashboard read needs no scan: " << (timings["dashboard"].scan_ms.empty() ? "PASS" : "FAIL") << std::endl;
+        
+        module.attachDataSources({});
+        data.tickets.createTicketSafe(304, concert->id, "Regular", true);
+        std::cout << "Detached dashboard stops listening: "
+                  << (module.generateDashboardData().summary.total_tickets_sold == 0 ? "PASS" : "FAIL") << std::endl;
+    }
+}
+
+// Test that cached financial reports are dropped only by writes in their period
+void testReportCache(ReportManager::ReportModule& module) {
+    displayHeader("REPORT CACHE TEST");
+    {
+        ReportFixture data("cache");
+        const std::string pastStart = "2001-01-01", pastEnd = "2001-12-31";
+        const std::string openStart = "2020-01-01", openEnd = "2035-12-31";
+        
+        int paid = data.payments.createPayment(401, 100.0, "USD", "Card", "TXN_CACHE_401");
+        data.payments.updatePaymentStatus(paid, Model::PaymentStatus::COMPLETED);
+        data.payments.processRefund(paid, 25.0, "Partial refund");
+        data.attach(module, {nullptr, nullptr, &data.payments, nullptr, nullptr, &data.crews});
+        
+        auto summary = module.generateFinancialSummary(openStart, openEnd);
+        std::cout << "Summary computed from payments: "
+                  << (summary.total_revenue.toString(summary.base_currency) == "100.00" &&
+                      summary.refunds_issued.toString(summary.base_currency) == "25.00" &&
+                      summary.gross_profit.toString(summary.base_currency) == "75.00" &&
+                      summary.average_transaction_value.toString(summary.base_currency) == "100.00" ? "PASS" : "FAIL") << std::endl;
+        module.generateFinancialSummary(openStart, openEnd);
+        module.generateFinancialSummary(pastStart, pastEnd);
+        module.generateFinancialSummary(pastStart, pastEnd);
+        auto stats = module.getCacheStats();
+        std::cout << "Repeated summaries served from cache: "
+                  << (stats["financial_summary"].hits == 2 && stats["financial_summary"].misses == 2 ? "PASS" : "FAIL") << std::endl;
+        
+        std::string json = module.generateProfitLossStatement(openStart, openEnd, "JSON");
+        std::string csv = module.generateProfitLossStatement(openStart, openEnd, "CSV");
+        bool sameFormat = module.generateProfitLossStatement(openStart, openEnd, "JSON") == json;
+        stats = module.getCacheStats();
+        std::cout << "Formats cached separately: "
+                  << (json != csv && sameFormat && stats["profit_loss"].entries == 2 && stats["profit_loss"].hits == 1 ? "PASS" : "FAIL") << std::endl;
+        
+        // A payment stamped today lands in the open period only
+        data.payments.updatePaymentStatus(data.payments.createPayment(402, 50.0, "USD", "Card", "TXN_CACHE_402"),
+                                     Model::PaymentStatus::COMPLETED);
+        stats = module.getCacheStats();
+        std::cout << "Payment write drops covering entries: "
+                  << (stats["financial_summary"].entries == 1 && stats["profit_loss"].entries == 0 ? "PASS" : "FAIL") << std::endl;
+        uint64_t hitsBefore = stats["financial_summary"].hits;
+        auto refreshed = module.generateFinancialSummary(openStart, openEnd);
+        std::cout << "Rebuilt summary sees the write: "
+                  << (refreshed.total_revenue.toString(refreshed.base_currency) == "150.00" ? "PASS" : "FAIL") << std::endl;
+        module.generateFinancialSummary(pastStart, pastEnd);
+        std::cout << "Other periods stay cached: "
+                  << (module.getCacheStats()["financial_summary"].hits == hitsBefore + 1 ? "PASS" : "FAIL") << std::endl;
+        
+        auto crew = data.crews.createCrewMember("Cache Crew", "cache@example.com", "555-0404");
+        data.crews.checkInCrew(crew->id);
+        stats = module.getCacheStats();
+        std::cout << "Crew check-in drops covering entries: "
+                  << (stats["financial_summary"].entries == 1 && stats["financial_summary"].invalidations == 2 ? "PASS" : "FAIL") << std::endl;
+        
+        data.payments.setExchangeRate("2000-01-01", "JPY", 150.0);
+        module.generateFinancialSummary(pastStart, pastEnd);
+        stats = module.getCacheStats();
+        std::cout << "Rate change clears the cache: "
+                  << (stats["financial_summary"].misses == 4 && stats["financial_summary"].entries == 1 ? "PASS" : "FAIL") << std::endl;
+
+        // Many small live updates land on the same cent total as a fresh scan
+        for (int i = 0; i < 70; ++i) {
+            int dime = data.payments.createPayment(403, 0.1, "USD", "Card", "TXN_CACHE_DIME_" + std::to_string(i));
+            data.payments.updatePaymentStatus(dime, Model::PaymentStatus::COMPLETED);
+            if (i % 3 == 0) {
+                data.payments.processRefund(dime, 0.1, "Dime refund");
+            }
+        }
+        auto dimes = module.generateFinancialSummary(openStart, openEnd);
+        std::cout << "Live totals stay exact: "
+                  << (module.generateDashboardData().summary.total_revenue == module.calculateSummaryMetrics().total_revenue &&
+                      dimes.total_revenue.toString(dimes.base_currency) == "157.00" &&
+                      dimes.refunds_issued.toString(dimes.base_currency) == "27.40" ? "PASS" : "FAIL") << std::endl;
+
+    }
+}
+
+// Read a whole file into a string
+std::string readFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    std::ostringstream content;
+    content << in.rdbuf();
+    return content.str();
+}
+
+// Test streaming CSV/JSON exports and their escaping
+void testStreamingExport(ReportManager::ReportModule& module) {
+    displayHeader("STREAMING EXPORT TEST");
+    ReportFixture data("export", {"test_export_concerts.csv", "test_export_payments.json", "test_export_scale.csv"});
+    {
+        auto concert = data.concerts.createConcert("Rock, \"Live\"\nNight", "Export fixture", "2030-08-01T19:00:00Z", "2030-08-01T23:00:00Z");
+        data.tickets.createTicketSafe(601, concert->id, "Regular", true);
+        int paid = data.payments.createPayment(601, 1234.5, "USD", "Card \\ \"Visa\"", "TXN_EXPORT_601");
+        data.payments.updatePaymentStatus(paid, Model::PaymentStatus::COMPLETED);
+        data.payments.processRefund(paid, 0.25, "Partial refund");
+        data.payments.createPayment(601, 500.0, "GBP", "Tab\there", "TXN_EXPORT_602");
+        data.attach(module, {&data.concerts, &data.tickets, &data.payments, nullptr, nullptr, nullptr});
+        
+        long long concertRows = module.exportDataset("concerts", "CSV", "test_export_concerts.csv");
+        std::string csv = readFile("test_export_concerts.csv");
+        std::cout << csv;
+        std::cout << "CSV header and row count: "
+                  << (concertRows == 1 && csv.rfind("concert_id,name,start_date_time", 0) == 0 ? "PASS" : "FAIL") << std::endl;
+        std::cout << "CSV field quoting: "
+                  << (csv.find(",\"Rock, \"\"Live\"\"\nNight\",") != std::string::npos ? "PASS" : "FAIL") << std::endl;
+        
+        long long paymentRows = module.exportDataset("payments", "JSON", "test_export_payments.json");
+        std::string json = readFile("test_export_payments.json");
+        std::cout << json;
+        std::cout << "JSON row count: " << (paymentRows == 3 && json.front() == '[' && json.find("\n]\n") != std::string::npos ? "PASS" : "FAIL") << std::endl;
+        std::cout << "JSON string escaping: "
+                  << (json.find("\"payment_method\":\"Card \\\\ \\\"Visa\\\"\"") != std::string::npos &&
+                      json.find("\"Tab\\there\"") != std::string::npos ? "PASS" : "FAIL") << std::endl;
+        std::cout << "Exact decimal amounts: "
+                  << (json.find("\"amount\":1234.50,") != std::string::npos && json.find("\"amount\":-0.25,") != std::string::npos &&
+                      json.find("\"amount\":500.00,") != std::string::npos ? "PASS" : "FAIL") << std::endl;
+        
+        std::ostringstream stream;
+        long long ticketRows = module.exportDataset("tickets", "CSV", stream);
+        std::cout << "Stream export: " << (ticketRows == 1 && stream.str().find(",601,SOLD,") != std::string::npos ? "PASS" : "FAIL") << std::endl;
+        std::cout << "Unsupported requests rejected: "
+                  << (module.exportDataset("tickets", "XML", stream) == -1 && module.exportDataset("crews", "CSV", stream) == -1 ? "PASS" : "FAIL") << std::endl;
+        std::cout << "Report JSON is escaped: "
+                  << (module.generateProfitLossStatement("2001-01-01", "2001-12-31", "JSON").find("\\n") != std::string::npos ? "PASS" : "FAIL") << std::endl;
+    }
+    
+    // Bounded-memory throughput of the row writer itself
+    const int scaleRows = 2000000;
+    auto started = std::chrono::steady_clock::now();
+    std::FILE* file = std::fopen("test_export_scale.csv", "wb");
+    uint64_t bytes = 0;
+    if (file) {
+        ReportExport::OutputBuffer out(file);
+        ReportExport::CsvWriter writer(out, {"payment_id", "amount", "currency", "transaction_id"});
+        for (int i = 0; i < scaleRows; ++i) {
+            writer.beginRow();
+            writer.integer(i);
+            writer.money(Model::Money{static_cast<int64_t>(i) * 7 - 5000}, "USD");
+            writer.text("USD");
+            writer.text("TXN_SCALE");
+            writer.endRow();
+        }
+        writer.finish();
+        bytes = out.bytesWritten();
+        std::fclose(file);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    std::cout << scaleRows << " rows, " << bytes / (1024 * 1024) << " MiB in " << seconds << "s" << std::endl;
+    std::cout << "Millions of rows in seconds: " << (bytes > 0 && seconds < 5.0 ? "PASS" : "FAIL") << std::endl;
+}
+
+// Local epoch seconds for a calendar time
+std::time_t localTime(int year, int month, int day, int hour, int minute) {
+    std::tm local = {};
+    local.tm_year = year - 1900;
+    local.tm_mon = month - 1;
+    local.tm_mday = day;
+    local.tm_hour = hour;
+    local.tm_min = minute;
+    local.tm_isdst = -1;
+    return std::mktime(&local);
+}
+
+// Test cron recurrences, background runs, coalescing and persistence
+void testReportScheduler(ReportManager::ReportModule& module) {
+    displayHeader("REPORT SCHEDULER TEST");
+    using ReportScheduling::CronExpression;
+    
+    CronExpression cron;
+    std::time_t base = localTime(2030, 1, 15, 10, 7); // A Tuesday
+    bool nightly = CronExpression::parse("30 2 * * *", cron) && cron.next(base) == localTime(2030, 1, 16, 2, 30);
+    bool quarterly = CronExpression::parse("*/15 * * * *", cron) && cron.next(base) == localTime(2030, 1, 15, 10, 15);
+    bool monthly = CronExpression::parse("monthly", cron) && cron.next(base) == localTime(2030, 2, 1, 0, 0);
+    bool weekdays = CronExpression::parse("0 9 * * 1-5", cron) && cron.next(localTime(2030, 1, 18, 12, 0)) == localTime(2030, 1, 21, 9, 0);
+    bool leapDay = CronExpression::parse("0 0 29 2 *", cron) && cron.next(base) == localTime(2032, 2, 29, 0, 0);
+    std::cout << "Cron next-run times: " << (nightly && quarterly && monthly && weekdays && leapDay ? "PASS" : "FAIL") << std::endl;
+    std::cout << "Malformed cron rejected: "
+              << (!CronExpression::parse("61 * * * *", cron) && !CronExpression::parse("0 0 * *", cron) &&
+                  !CronExpression::parse("*/0 * * * *", cron) && !CronExpression::parse("fortnightly", cron) ? "PASS" : "FAIL") << std::endl;
+    
+    const std::string scheduleFile = "test_schedules.dat";
+    const std::string outputDir = "test_scheduled_reports";
+    std::remove(scheduleFile.c_str());
+    std::vector<std::string> outputs;
+    std::string id;
+    {
+        ReportScheduling::ReportScheduler scheduler(scheduleFile);
+        int started = 0;
+        bool capturedOnCaller = true;
+        std::thread::id renderThread;
+        const std::thread::id caller = std::this_thread::get_id();
+        scheduler.start([&](const ReportScheduling::ScheduledReport& schedule, const std::string& start_date,
+                            const std::string& end_date) -> ReportScheduling::ReportScheduler::Render {
+            ++started;
+            capturedOnCaller = capturedOnCaller && std::this_thread::get_id() == caller;
+            std::string text = schedule.report_type + " " + start_date + " " + end_date + "\n";
+            return [text, &renderThread]() {
+                renderThread = std::this_thread::get_id();
+                return text;
+            };
+        }, outputDir);
+        id = scheduler.schedule("sales", "30 2 * * *", {"finance@example.com"});
+        std::cout << "Invalid frequency rejected: " << (scheduler.schedule("sales", "nightly", {}).empty() ? "PASS" : "FAIL") << std::endl;
+        
+        scheduler.runNow(id);
+        scheduler.runNow(id); // Comes due before the first request has run
+        std::cout << "Queued runs wait for the owner: " << (started == 0 ? "PASS" : "FAIL") << std::endl;
+        size_t ran = scheduler.runDue();
+        std::cout << "Due runs captured on the calling thread: " << (ran == 1 && started == 1 && capturedOnCaller ? "PASS" : "FAIL") << std::endl;
+        bool idle = scheduler.waitUntilIdle(std::chrono::seconds(5));
+        std::cout << "Reports written on the worker: "
+                  << (idle && renderThread != std::thread::id() && renderThread != caller ? "PASS" : "FAIL") << std::endl;
+        
+        auto schedules = scheduler.getSchedules();
+        bool coalesced = scheduler.runDue() == 0 && schedules.size() == 1 && schedules[0].runs == 1 && schedules[0].coalesced == 1;
+        std::cout << "Overlapping run coalesced: " << (coalesced ? "PASS" : "FAIL") << std::endl;
+        std::ifstream output(schedules.empty() ? "" : schedules[0].last_output);
+        std::cout << "Report written to output directory: "
+                  << (output.good() && schedules[0].last_output.rfind(outputDir + "/sales_" + id, 0) == 0 ? "PASS" : "FAIL") << std::endl;
+        if (!schedules.empty()) outputs.push_back(schedules[0].last_output);
+    }
+    {
+        ReportScheduling::ReportScheduler reloaded(scheduleFile);
+        auto schedules = reloaded.getSchedules();
+        bool persisted = schedules.size() == 1 && schedules[0].id == id && schedules[0].runs == 1 &&
+                         schedules[0].recipients.size() == 1 && schedules[0].next_run > 0 && !schedules[0].running;
+        std::cout << "Schedules survive a restart: " << (persisted ? "PASS" : "FAIL") << std::endl;
+        std::cout << "New IDs stay unique: " << (reloaded.schedule("payroll", "daily", {}) != id ? "PASS" : "FAIL") << std::endl;
+        std::cout << "Cancel removes schedule: " << (reloaded.cancel(id) && !reloaded.cancel(id) ? "PASS" : "FAIL") << std::endl;
+    }
+    
+    // ReportModule runs its own report types through the scheduler
+    std::string moduleId = module.scheduleAutomaticReport("payroll", "weekly", {"ops@example.com"});
+    std::cout << "Unknown report type rejected: " << (module.scheduleAutomaticReport("horoscope", "daily", {}).empty() ? "PASS" : "FAIL") << std::endl;
+    module.startScheduledReports(outputDir);
+    bool ran = module.runScheduledReportNow(moduleId) && module.runDueScheduledReports() == 1 &&
+               module.waitForScheduledReports(std::chrono::seconds(5));
+    for (const auto& schedule : module.getScheduledReports()) {
+        if (schedule.id == moduleId) {
+            std::ifstream report(schedule.last_output);
+            std::string header;
+            std::getline(report, header);
+            ran = ran && schedule.runs == 1 && header.find(moduleId) != std::string::npos;
+            outputs.push_back(schedule.last_output);
+        }
+    }
+    module.stopScheduledReports();
+    std::cout << "Module report runs when pumped: " << (ran ? "PASS" : "FAIL") << std::endl;
+    std::cout << "Module schedule cancelled: " << (module.cancelScheduledReport(moduleId) ? "PASS" : "FAIL") << std::endl;
+    
+    for (const auto& path : outputs) {
+        std::remove(path.c_str());
+    }
+    std::remove(outputDir.c_str());
+    std::remove(scheduleFile.c_str());
+}
+
+// Test the columnar snapshot export and block-skipping queries
+void testColumnarSnapshot(ReportManager::ReportModule& module) {
+    displayHeader("COLUMNAR SNAPSHOT TEST");
+    ReportFixture data("snap", {"test_snapshot.mcol", "test_snapshot_scale.mcol"});
+    {
+        data.tickets.createTicketSafe(701, 21, "Regular", true);
+        data.tickets.createTicketSafe(702, 22, "VIP", true);
+        int first = data.payments.createPayment(701, 60.0, "USD", "Card", "TXN_SNAP_701");
+        data.payments.updatePaymentStatus(first, Model::PaymentStatus::COMPLETED);
+        data.payments.processRefund(first, 10.0, "Partial refund");
+        data.payments.updatePaymentStatus(data.payments.createPayment(702, 90.0, "USD", "PayPal", "TXN_SNAP_702"),
+                                     Model::PaymentStatus::COMPLETED);
+        data.payments.updatePaymentStatus(data.payments.createPayment(703, 30.0, "EUR", "Card", "TXN_SNAP_703"),
+                                     Model::PaymentStatus::FAILED);
+        data.feedback.createFeedback(21, 701, 4, "Good");
+        data.attach(module, {nullptr, &data.tickets, &data.payments, nullptr, &data.feedback, nullptr});
+        
+        long long rows = module.exportColumnarSnapshot("test_snapshot.mcol");
+        module.attachDataSources({});
+        Columnar::Snapshot snapshot;
+        bool opened = snapshot.open("test_snapshot.mcol");
+        const auto* paymentTable = opened ? snapshot.table("payments") : nullptr;
+        std::cout << "Snapshot is self-describing: "
+                  << (rows == 7 && paymentTable && paymentTable->rows == 4 && paymentTable->column("currency") &&
+                      paymentTable->column("currency")->dictionary.size() == 2 && snapshot.getTables().size() == 3 ? "PASS" : "FAIL") << std::endl;
+        
+        Columnar::Query revenue;
+        revenue.table = "payments";
+        revenue.groupBy = {{"concert_id", Columnar::Bucket::NONE}, {"paid_at", Columnar::Bucket::MONTH}};
+        revenue.sumColumn = "amount_minor";
+        revenue.filters = {{"status", Columnar::Filter::NE, 0, "FAILED"}, {"currency", Columnar::Filter::EQ, 0, "USD"}};
+        auto result = Columnar::runQuery(snapshot, revenue);
+        bool attributed = result.ok && result.rows.size() == 2 && result.rows[0].keys[0] == "21" &&
+                          result.rows[0].sum == 5000 && result.rows[1].keys[0] == "22" && result.rows[1].sum == 9000 &&
+                          result.rows[0].keys[1] == Model::DateTime::now().iso8601String.substr(0, 7);
+        std::cout << "Revenue by concert by month: " << (attributed ? "PASS" : "FAIL") << std::endl;
+        
+        Columnar::Query unknown;
+        unknown.table = "payments";
+        unknown.sumColumn = "price";
+        std::cout << "Unknown column reported: " << (!Columnar::runQuery(snapshot, unknown).ok ? "PASS" : "FAIL") << std::endl;
+        
+        Columnar::Query misbucketed;
+        misbucketed.table = "payments";
+        std::string groupError;
+        bool parsed = Columnar::parseGroupBy("concert_id:month", misbucketed.groupBy, groupError) &&
+                      !Columnar::parseGroupBy("paid_at:week", misbucketed.groupBy, groupError);
+        std::cout << "Bucket on non-timestamp column rejected: " <<
+                     (parsed && !Columnar::runQuery(snapshot, misbucketed).ok ? "PASS" : "FAIL") << std::endl;
+    }
+    
+    // Years of synthetic history: 3M payments across 60 months and 200 concerts
+    {
+        const int scaleRows = 3000000;
+        Columnar::TableBuilder payments("payments", {{"concert_id", Columnar::ColumnType::INT64},
+                                                     {"amount_minor", Columnar::ColumnType::INT64},
+                                                     {"currency", Columnar::ColumnType::STRING},
+                                                     {"paid_at", Columnar::ColumnType::TIMESTAMP}});
+        uint32_t state = 2024;
+        for (int i = 0; i < scaleRows; ++i) {
+            state = state * 1664525u + 1013904223u;
+            int month = i / (scaleRows / 60);
+            char stamp[32];
+            std::snprintf(stamp, sizeof(stamp), "%04d-%02d-%02dT12:00:00Z", 2025 + month / 12, month % 12 + 1, 1 + (i % 28));
+            payments.appendInt(0, (state >> 8) % 200);
+            payments.appendInt(1, 1000 + (state >> 20) % 9000);
+            payments.appendString(2, (state >> 4) % 10 == 0 ? "EUR" : "USD");
+            payments.appendTimestamp(3, stamp);
+        }
+        bool written = Columnar::writeSnapshot("test_snapshot_scale.mcol", {&payments});
+        Columnar::Snapshot snapshot;
+        bool opened = written && snapshot.open("test_snapshot_scale.mcol");
+        
+        Columnar::Query all;
+        all.table = "payments";
+        all.groupBy = {{"concert_id", Columnar::Bucket::NONE}, {"paid_at", Columnar::Bucket::MONTH}};
+        all.sumColumn = "amount_minor";
+        all.filters = {{"currency", Columnar::Filter::EQ, 0, "USD"}};
+        auto full = Columnar::runQuery(snapshot, all);
+        
+        Columnar::Query lastYear = all;
+        lastYear.filters.push_back({"paid_at", Columnar::Filter::GE, Columnar::packTimestamp("2029-01"), ""});
+        auto recent = Columnar::runQuery(snapshot, lastYear);
+        std::cout << "Full scan: " << full.rows.size() << " groups in " << full.seconds * 1000 << " ms; last year: "
+                  << recent.blocksScanned << " blocks scanned, " << recent.blocksSkipped << " skipped in "
+                  << recent.seconds * 1000 << " ms" << std::endl;
+        std::cout << "Revenue by concert by month under a second: "
+                  << (opened && full.ok && full.rows.size() == 200 * 60 && full.seconds < 1.0 ? "PASS" : "FAIL") << std::endl;
+        std::cout << "Date filter skips blocks: "
+                  << (recent.ok && recent.blocksSkipped > 0 && recent.rows.size() == 200 * 12 ? "PASS" : "FAIL") << std::endl;
+    }
+    
+    std::ofstream("test_snapshot.mcol", std::ios::binary | std::ios::trunc) << "not a snapshot";
+    Columnar::Snapshot corrupt;
+    std::cout << "Malformed snapshot rejected: " << (!corrupt.open("test_snapshot.mcol") ? "PASS" : "FAIL") << std::endl;
+}
+
+// Test ISO 8601 parsing and day/week/month bucketing
+void testTimeBuckets(ReportManager::ReportModule& module) {
+    displayHeader("TIME BUCKETS TEST");
+    using TimeBuckets::parseIso8601;
+    bool parsed = parseIso8601("1970-01-02") == 86400 && parseIso8601("2024-02-29T12:30:15Z") == 1709209815 &&
+                  parseIso8601("2024-02-29T12:30:15.250Z") == 1709209815 &&
+                  parseIso8601("2024-02-29T14:30:15+02:00") == 1709209815 &&
+                  parseIso8601("2024-02-29 07:30:15-0500") == 1709209815 && parseIso8601("1969-12-31T23:59:59Z") == -1;
+    std::cout << "Valid timestamps parsed: " << (parsed ? "PASS" : "FAIL") << std::endl;
+    const char* malformed[] = {"", "2023-02-29", "2024-13-01", "2024-1-05", "2024-01-05T25:00", "2024-01-05T10:00:00Q",
+                               "2024-01-05T10", "January 5"};
+    bool rejected = true;
+    for (const char* text : malformed) {
+        rejected = rejected && parseIso8601(text) == TimeBuckets::INVALID;
+    }
+    std::cout << "Malformed timestamps rejected: " << (rejected ? "PASS" : "FAIL") << std::endl;
+    
+    auto label = [](const char* date, TimeBuckets::Period period) {
+        return TimeBuckets::bucketLabel(TimeBuckets::dayOf(parseIso8601(date)), period);
+    };
+    bool weeks = label("2021-01-03", TimeBuckets::Period::WEEK) == "2020-W53" &&
+                 label("2021-01-04", TimeBuckets::Period::WEEK) == "2021-W01" &&
+                 label("2024-12-30", TimeBuckets::Period::WEEK) == "2025-W01" &&
+                 label("2026-06-15", TimeBuckets::Period::WEEK) == "2026-W25" &&
+                 label("2024-02-29", TimeBuckets::Period::MONTH) == "2024-02";
+    std::cout << "ISO week labels across year ends: " << (weeks ? "PASS" : "FAIL") << std::endl;
+    
+    std::map<std::string, int> daily = {{"2024-01-28", 6}, {"2024-01-29", 2}, {"2024-02-02", 3}, {"2024-02-05", 4},
+                                        {"2024-02-11", 1}, {"2024-02-12", 8}, {"2024-03-01", 9}};
+    int64_t first = TimeBuckets::dayOf(parseIso8601("2024-01-29"));
+    int64_t last = TimeBuckets::dayOf(parseIso8601("2024-02-11"));
+    auto days = TimeBuckets::rollUp(daily, first, last, TimeBuckets::Period::DAY);
+    auto isoWeeks = TimeBuckets::rollUp(daily, first, last, TimeBuckets::Period::WEEK);
+    auto months = TimeBuckets::rollUp(daily, first, last, TimeBuckets::Period::MONTH);
+    std::cout << "Sparse days zero-filled: "
+              << (days.size() == 14 && days["2024-01-30"] == 0 && days["2024-02-05"] == 4 && days["2024-02-11"] == 1 ? "PASS" : "FAIL") << std::endl;
+    std::cout << "Weekly and monthly roll-up: "
+              << (isoWeeks.size() == 2 && isoWeeks["2024-W05"] == 5 && isoWeeks["2024-W06"] == 5 &&
+                  months.size() == 2 && months["2024-01"] == 2 && months["2024-02"] == 8 ? "PASS" : "FAIL") << std::endl;
+    
+    {
+        ReportFixture data("buckets");
+        data.tickets.updateTicketStatus(data.tickets.createTicketSafe(801, 31, "Regular", true), Model::TicketStatus::CHECKED_IN);
+        data.tickets.updateTicketStatus(data.tickets.createTicketSafe(802, 31, "Regular", true), Model::TicketStatus::CHECKED_IN);
+        data.tickets.createTicketSafe(803, 31, "Regular", true);
+        int paid = data.payments.createPayment(801, 120.0, "USD", "Card", "TXN_BUCKET_801");
+        data.payments.updatePaymentStatus(paid, Model::PaymentStatus::COMPLETED);
+        data.payments.processRefund(paid, 20.0, "Partial refund");
+        data.attach(module, {nullptr, &data.tickets, &data.payments, nullptr, nullptr, nullptr});
+        
+        // Three weeks ending today; all activity happened today
+        int64_t today = TimeBuckets::dayOf(parseIso8601(Model::DateTime::now().iso8601String));
+        std::string todayLabel = TimeBuckets::bucketLabel(today, TimeBuckets::Period::DAY);
+        std::string from = TimeBuckets::bucketLabel(today - 20, TimeBuckets::Period::DAY);
+        auto revenue = module.getRevenueBreakdown(from, todayLabel, "daily");
+        double total = 0.0;
+        for (const auto& day : revenue) {
+            total += day.second;
+        }
+        std::cout << "Daily revenue from payments: "
+                  << (revenue.size() == 21 && std::fabs(revenue[todayLabel] - 100.0) < 0.005 &&
+                      std::fabs(total - 100.0) < 0.005 ? "PASS" : "FAIL") << std::endl;
+        
+        auto weekly = module.getRevenueBreakdown(from, todayLabel, "weekly");
+        auto monthly = module.getAttendanceTrends(from, todayLabel, "monthly");
+        std::string thisWeek = TimeBuckets::bucketLabel(today, TimeBuckets::Period::WEEK);
+        std::string thisMonth = TimeBuckets::bucketLabel(today, TimeBuckets::Period::MONTH);
+        std::cout << "Weekly revenue and monthly check-ins: "
+                  << ((weekly.size() == 3 || weekly.size() == 4) && std::fabs(weekly[thisWeek] - 100.0) < 0.005 &&
+                      monthly.size() >= 1 && monthly.size() <= 2 && monthly[thisMonth] == 2 ? "PASS" : "FAIL") << std::endl;
+        
+        auto quiet = module.getAttendanceTrends(from, TimeBuckets::bucketLabel(today - 1, TimeBuckets::Period::DAY), "daily");
+        bool allZero = quiet.size() == 20;
+        for (const auto& day : quiet) {
+            allZero = allZero && day.second == 0;
+        }
+        std::cout << "Quiet range is all zeros: " << (allZero ? "PASS" : "FAIL") << std::endl;
+        std::cout << "Bad period rejected: "
+                  << (module.getRevenueBreakdown(from, todayLabel, "hourly").empty() &&
+                      module.getAttendanceTrends("soon", "later", "daily").empty() ? "PASS" : "FAIL") << std::endl;
+        
+        std::string csv = module.exportDataForVisualization("attendance", from, todayLabel, "CSV", "weekly");
+        std::cout << csv;
+        std::cout << "Visualization export is per period: "
+                  << (csv.rfind("period,attendance\n", 0) == 0 && csv.find(thisWeek + ",2\n") != std::string::npos ? "PASS" : "FAIL") << std::endl;
+    }
+}
+
+// Test ad-hoc aggregation queries over module data
+void testAdHocQuery(ReportManager::ReportModule& module) {
+    displayHeader("AD-HOC QUERY TEST");
+    {
+        ReportFixture data("query");
+        data.tickets.createTicketSafe(901, 41, "Regular", true);
+        data.tickets.updateTicketStatus(data.tickets.createTicketSafe(902, 41, "Regular", true), Model::TicketStatus::CHECKED_IN);
+        data.tickets.updateTicketStatus(data.tickets.createTicketSafe(903, 41, "VIP", true), Model::TicketStatus::CHECKED_IN);
+        data.tickets.createTicketInventory(42, 2, "Regular", 50);
+        data.tickets.createTicketSafe(904, 42, "Regular", true);
+        data.payments.updatePaymentStatus(data.payments.createPayment(901, 50.0, "USD", "Card", "TXN_QUERY_901"), Model::PaymentStatus::COMPLETED);
+        data.payments.updatePaymentStatus(data.payments.createPayment(902, 70.0, "USD", "PayPal", "TXN_QUERY_902"), Model::PaymentStatus::COMPLETED);
+        data.payments.createPayment(903, 30.0, "EUR", "Card", "TXN_QUERY_903");
+        data.feedback.createFeedback(41, 901, 5, "Great");
+        data.feedback.createFeedback(41, 902, 2, "Too loud");
+        data.feedback.createFeedback(42, 904, 4, "Nice");
+        data.attach(module, {nullptr, &data.tickets, &data.payments, nullptr, &data.feedback, nullptr});
+        
+        auto byStatus = module.runQuery("tickets by=concert_id,status");
+        for (const auto& row : byStatus.rows) {
+            std::cout << row.keys[0] << " " << row.keys[1] << ": " << row.count << std::endl;
+        }
+        bool grouped = byStatus.ok && byStatus.rows.size() == 4 &&
+                       byStatus.rows[0].keys == std::vector<std::string>{"41", "CHECKED_IN"} && byStatus.rows[0].count == 2 &&
+                       byStatus.rows[1].keys == std::vector<std::string>{"41", "SOLD"} && byStatus.rows[1].count == 1 &&
+                       byStatus.rows[2].keys == std::vector<std::string>{"42", "AVAILABLE"} && byStatus.rows[2].count == 2 &&
+                       byStatus.rows[3].keys == std::vector<std::string>{"42", "SOLD"} && byStatus.rows[3].count == 1;
+        std::cout << "Tickets by concert by status: " << (grouped ? "PASS" : "FAIL") << std::endl;
+        
+        auto ratings = module.runQuery("feedback avg=rating min=rating max=rating by=concert_id");
+        std::cout << "Average, min and max: "
+                  << (ratings.ok && ratings.rows.size() == 2 && ratings.valueNames.size() == 3 &&
+                      std::fabs(ratings.rows[0].values[0] - 3.5) < 1e-9 && ratings.rows[0].values[1] == 2.0 &&
+                      ratings.rows[0].values[2] == 5.0 && ratings.rows[1].values[0] == 4.0 ? "PASS" : "FAIL") << std::endl;
+        
+        auto takings = module.runQuery("payments sum=amount by=currency where=status=COMPLETED where=amount>=60");
+        std::cout << "Filtered sum: "
+                  << (takings.ok && takings.rows.size() == 1 && takings.rows[0].keys[0] == "USD" &&
+                      std::fabs(takings.rows[0].values[0] - 70.0) < 0.005 && takings.rowsMatched == 1 &&
+                      takings.rowsScanned == 3 ? "PASS" : "FAIL") << std::endl;
+        
+        std::string thisYear = Model::DateTime::now().iso8601String.substr(0, 4);
+        auto byMonth = module.runQuery("tickets where=created_at>=" + thisYear + " where=status!=AVAILABLE by=created_at:year");
+        std::cout << "Timestamp filter and bucket: "
+                  << (byMonth.ok && byMonth.rows.size() == 1 && byMonth.rows[0].keys[0] == thisYear &&
+                      byMonth.rows[0].count == 4 ? "PASS" : "FAIL") << std::endl;
+        
+        bool rejected = !module.runQuery("tickets by=seat").ok && !module.runQuery("tickets where=status>SOLD").ok &&
+                        !module.runQuery("payments sum=currency").ok && !module.runQuery("tickets where=ticket_id=abc").ok &&
+                        !module.runQuery("tickets sort=status").ok && !module.runQuery("crews").ok &&
+                        !module.runQuery("").ok && !module.runQuery("venues").ok &&
+                        !module.runQuery("tickets by=concert_id:month").ok && !module.runQuery("tickets by=status:day").ok &&
+                        !module.runQuery("tickets by=created_at:").ok;
+        std::cout << "Bad queries rejected: " << (rejected ? "PASS" : "FAIL") << std::endl;
+    }
+    
+    // Large table: the threaded scan must agree with a single thread
+    using QueryEngine::ColumnType;
+    QueryEngine::Table table("sales", {{"concert_id", ColumnType::INT64}, {"status", ColumnType::STRING},
+                                       {"price", ColumnType::DOUBLE}, {"sold_at", ColumnType::TIMESTAMP}});
+    const char* statuses[] = {"SOLD", "CHECKED_IN", "CANCELLED"};
+    const int rows = 1000000;
+    for (int i = 0; i < rows; ++i) {
+        table.appendInt(0, i % 250);
+        table.appendString(1, statuses[(i / 7) % 3]);
+        table.appendDouble(2, 10.0 + i % 90);
+        char when[32];
+        std::snprintf(when, sizeof(when), "2030-%02d-%02dT12:00:00Z", 1 + i % 12, 1 + i % 28);
+        table.appendTimestamp(3, when);
+    }
+    QueryEngine::Query query;
+    query.table = "sales";
+    query.groupBy = {{"concert_id", QueryEngine::Bucket::NONE}, {"sold_at", QueryEngine::Bucket::MONTH}};
+    query.aggregates = {{QueryEngine::Aggregate::SUM, "price"}, {QueryEngine::Aggregate::MAX, "price"}};
+    query.filters = {{"status", QueryEngine::Filter::NE, "CANCELLED"}, {"price", QueryEngine::Filter::GE, "20"}};
+    auto single = QueryEngine::execute(table, query, 1);
+    auto threaded = QueryEngine::execute(table, query, 4);
+    bool same = single.ok && threaded.ok && single.rows.size() == threaded.rows.size() && single.rowsMatched == threaded.rowsMatched;
+    for (size_t i = 0; same && i < single.rows.size(); ++i) {
+        same = single.rows[i].keys == threaded.rows[i].keys && single.rows[i].count == threaded.rows[i].count &&
+               std::fabs(single.rows[i].values[0] - threaded.rows[i].values[0]) < 1e-6 &&
+               single.rows[i].values[1] == threaded.rows[i].values[1];
+    }
+    std::cout << rows << " rows into " << threaded.rows.size() << " groups: " << std::fixed << std::setprecision(1)
+              << single.seconds * 1000.0 << " ms on 1 thread, " << threaded.seconds * 1000.0 << " ms on "
+              << threaded.threads << std::endl;
+    std::cout << "Threaded scan matches single thread: " << (same && threaded.threads == 4 ? "PASS" : "FAIL") << std::endl;
+}
+
+// Test distinct-count and quantile sketches
+void testAnalyticsSketches() {
+    displayHeader("ANALYTICS SKETCHES TEST");
+    Sketches::HyperLogLog all, evens, odds;
+    for (uint64_t id = 1; id <= 200000; ++id) {
+        all.add(id);
+        all.add(id); // Repeats do not count
+        (id % 2 ? odds : evens).add(id);
+    }
+    Sketches::HyperLogLog merged = evens;
+    merged.merge(odds);
+    Sketches::HyperLogLog few;
+    for (uint64_t id = 1; id <= 20; ++id) {
+        few.add(id * 7919);
+    }
+    std::cout << "Distinct estimate for 200000 keys: " << all.estimate() << std::endl;
+    std::cout << "HyperLogLog within 5%: "
+              << (std::fabs(static_cast<double>(all.estimate()) - 200000.0) < 10000.0 && few.estimate() == 20 &&
+                  Sketches::HyperLogLog().estimate() == 0 ? "PASS" : "FAIL") << std::endl;
+    std::cout << "HyperLogLog merge equals union: " << (merged.estimate() == all.estimate() ? "PASS" : "FAIL") << std::endl;
+    
+    Sketches::QuantileSketch low, high;
+    for (int value = 1; value <= 10000; ++value) {
+        (value <= 5000 ? low : high).add(value);
+    }
+    Sketches::QuantileSketch combined = low;
+    combined.merge(high);
+    double median = combined.quantile(0.5), p99 = combined.quantile(0.99);
+    std::cout << "Median " << median << ", p99 " << p99 << " from " << combined.binCount() << " bins" << std::endl;
+    std::cout << "Quantiles within 1%: "
+              << (std::fabs(median - 5000.0) <= 50.0 && std::fabs(p99 - 9900.0) <= 99.0 && combined.binCount() < 1000 &&
+                  std::fabs(combined.quantile(0.0) - 1.0) <= 0.01 ? "PASS" : "FAIL") << std::endl;
+    for (int value = 1; value <= 5000; ++value) {
+        combined.remove(value);
+    }
+    std::cout << "Removal shifts quantiles: "
+              << (combined.count() == 5000 && std::fabs(combined.quantile(0.5) - 7500.0) <= 75.0 &&
+                  Sketches::QuantileSketch().quantile(0.5) == -1.0 ? "PASS" : "FAIL") << std::endl;
+
+    // Past MAX_BINS the lowest bins fold together; removals still keep the count exact
+    Sketches::QuantileSketch wide;
+    for (int step = 0; step < 3000; ++step) {
+        wide.add(std::pow(1.05, step));
+    }
+    bool folded = wide.binCount() == Sketches::QuantileSketch::MAX_BINS;
+    bool foldedRemoved = wide.remove(1.0) && wide.count() == 2999;
+    bool strayIgnored = !wide.remove(1e70) && !wide.remove(0.0) && wide.count() == 2999;
+    std::cout << "Removal from folded bins keeps the count: "
+              << (folded && foldedRemoved && strayIgnored ? "PASS" : "FAIL") << std::endl;
+
+    uint64_t savedDistinct = 0;
+    double savedMedianPrice = -1.0;
+    ReportFixture data("sketch", {"test_sketch_reports.dat", "test_sketch_reports.dat.sketches", "test_sketch_reports.dat.schedules"});
+    {
+        auto hall = std::make_shared<Model::Venue>();
+        hall->name = "Sketch Hall";
+        auto cheap = data.concerts.createConcert("Matinee", "Sketch fixture", "2030-05-10T14:00:00Z", "2030-05-10T17:00:00Z");
+        auto pricey = data.concerts.createConcert("Gala", "Sketch fixture", "2030-06-20T19:00:00Z", "2030-06-20T23:00:00Z");
+        cheap->venue = hall;
+        pricey->venue = hall;
+        cheap->ticketInfo = std::make_shared<Model::ConcertTicket>();
+        cheap->ticketInfo->base_price = 20.0;
+        pricey->ticketInfo = std::make_shared<Model::ConcertTicket>();
+        pricey->ticketInfo->base_price = 100.0;
+        std::vector<int> cheapTickets;
+        for (int attendee = 1001; attendee <= 1030; ++attendee) {
+            cheapTickets.push_back(data.tickets.createTicketSafe(attendee, cheap->id, "Regular", true));
+        }
+        for (int attendee = 1021; attendee <= 1030; ++attendee) {
+            data.tickets.createTicketSafe(attendee, pricey->id, "VIP", true);
+        }
+        data.payments.updatePaymentStatus(data.payments.createPayment(1001, 20.0, "USD", "Card", "TXN_SKETCH_1"), Model::PaymentStatus::COMPLETED);
+        data.payments.updatePaymentStatus(data.payments.createPayment(1021, 120.0, "USD", "Card", "TXN_SKETCH_2"), Model::PaymentStatus::COMPLETED);
+        data.payments.createPayment(1022, 999.0, "USD", "Card", "TXN_SKETCH_3"); // Pending, not counted
+        data.feedback.createFeedback(cheap->id, 1001, 2, "Meh");
+        data.feedback.createFeedback(cheap->id, 1002, 4, "Good");
+        
+        ReportManager::ReportModule sketched("test_sketch_reports.dat");
+        sketched.attachDataSources({&data.concerts, &data.tickets, &data.payments, nullptr, &data.feedback, nullptr});
+        std::cout << "Seeded distinct counts: "
+                  << (sketched.estimateDistinctAttendees() == 30 && sketched.estimateDistinctAttendees(cheap->id) == 30 &&
+                      sketched.estimateDistinctAttendees(pricey->id) == 10 &&
+                      sketched.estimateDistinctAttendeesByVenue("Sketch Hall") == 30 &&
+                      sketched.estimateDistinctAttendeesByMonth("2030-06") == 10 ? "PASS" : "FAIL") << std::endl;
+        std::cout << "Seeded quantiles: "
+                  << (std::fabs(sketched.getTicketPriceQuantile(0.5) - 20.0) <= 0.2 &&
+                      std::fabs(sketched.getTicketPriceQuantile(1.0) - 100.0) <= 1.0 &&
+                      std::fabs(sketched.getPaymentAmountQuantile("USD", 1.0) - 120.0) <= 1.2 &&
+                      sketched.getPaymentAmountQuantile("EUR", 0.5) == -1.0 &&
+                      std::fabs(sketched.getRatingQuantile(0.0) - 2.0) <= 0.02 ? "PASS" : "FAIL") << std::endl;
+        
+        // Events keep the sketches current
+        for (int attendee = 1031; attendee <= 1040; ++attendee) {
+            data.tickets.createTicketSafe(attendee, pricey->id, "VIP", true);
+        }
+        data.feedback.createFeedback(pricey->id, 1031, 5, "Superb");
+        data.feedback.createFeedback(pricey->id, 1032, 5, "Superb");
+        data.feedback.createFeedback(pricey->id, 1033, 5, "Superb");
+        auto dashboard = sketched.generateDashboardData();
+        std::cout << "Dashboard tiles follow events: "
+                  << (dashboard.distinct_attendees == 40 && sketched.estimateDistinctAttendees(pricey->id) == 20 &&
+                      std::fabs(dashboard.p90_ticket_price - 100.0) <= 1.0 &&
+                      std::fabs(dashboard.median_rating - 5.0) <= 0.05 ? "PASS" : "FAIL") << std::endl;
+        savedDistinct = dashboard.distinct_attendees;
+        savedMedianPrice = dashboard.median_ticket_price;
+        sketched.attachDataSources({});
+        
+        // Attaching nothing leaves nothing to count
+        std::cout << "Sketches follow the attached sources: " << (sketched.estimateDistinctAttendees() == 0 ? "PASS" : "FAIL") << std::endl;
+        sketched.attachDataSources({&data.concerts, &data.tickets, &data.payments, nullptr, &data.feedback, nullptr});
+        bool persisted = sketched.saveAnalyticsSketches();
+        
+        ReportManager::ReportModule reopened("test_sketch_reports.dat");
+        std::cout << "Sketches persist with the reports: "
+                  << (persisted && reopened.estimateDistinctAttendees() == savedDistinct &&
+                      reopened.getTicketPriceQuantile(0.5) == savedMedianPrice &&
+                      reopened.estimateDistinctAttendeesByMonth("2030-05") == 30 ? "PASS" : "FAIL") << std::endl;
+        
+        // Cancelling after a reprice takes back the price each ticket sold at
+        cheap->ticketInfo->base_price = 60.0;
+        data.tickets.updateTicketStatus(cheapTickets[0], Model::TicketStatus::CHECKED_IN);
+        for (int ticket : cheapTickets) {
+            data.tickets.cancelTicket(ticket);
+        }
+        std::cout << "Retraction uses the sale price: "
+                  << (std::fabs(sketched.getTicketPriceQuantile(0.0) - 100.0) <= 1.0 ? "PASS" : "FAIL") << std::endl;
+    }
+    
+    std::ofstream("test_sketch_reports.dat.sketches", std::ios::binary | std::ios::trunc) << "MUSESKT1 truncated";
+    {
+        ReportManager::ReportModule damaged("test_sketch_reports.dat");
+        std::cout << "Damaged sketch file ignored: "
+                  << (damaged.estimateDistinctAttendees() == 0 && damaged.getRatingQuantile(0.5) == -1.0 ? "PASS" : "FAIL") << std::endl;
+    }
+}
+
 // Main test function
 int main() {
     displayHeader("REPORT MODULE COMPREHENSIVE TEST");
@@ -303,6 +1204,33 @@ int main() {
         // Test Report Generation operations
         testReportGeneration(reportModule);
         
+        // Test metrics computed from live modules
+        testLiveMetrics(reportModule);
+        
+        // Test the event-maintained dashboard
+        testLiveDashboard(reportModule);
+        
+        // Test the financial report cache
+        testReportCache(reportModule);
+        
+        // Test streaming exports
+        testStreamingExport(reportModule);
+        
+        // Test the background report scheduler
+        testReportScheduler(reportModule);
+        
+        // Test the columnar analytics snapshot
+        testColumnarSnapshot(reportModule);
+        
+        // Test revenue and attendance bucketing
+        testTimeBuckets(reportModule);
+        
+        // Test ad-hoc aggregation queries
+        testAdHocQuery(reportModule);
+        
+        // Test the approximate analytics sketches
+        testAnalyticsSketches();
+        
         displayHeader("ALL TESTS COMPLETED SUCCESSFULLY");
         std::cout << "Report Module testing completed without critical errors." << std::endl;
         
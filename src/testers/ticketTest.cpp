@@ -54,7 +54,7 @@ void displayTicket(const std::shared_ptr<Model::Ticket>& ticket, bool detailed =
         
         auto payment = ticket->payment.lock();
         if (payment) {
-            std::cout << "Payment: ID " << payment->payment_id << " ($" << std::fixed << std::setprecision(2) << payment->amount << ")" << std::endl;
+            std::cout << "Payment: ID " << payment->payment_id << " ($" << std::fixed << std::setprecision(2) << payment->amount.toMajor(payment->currency) << ")" << std::endl;
         } else {
             std::cout << "Payment: [Not linked]" << std::endl;
         }